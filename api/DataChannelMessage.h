@@ -108,6 +108,36 @@ inline void addUserMediaMapEnd(utils::StringBuilder<1024>& outMessage)
 #endif
 }
 
+inline void addUserMediaMapDeltaStart(utils::StringBuilder<1024>& outMessage)
+{
+#if ENABLE_LEGACY_API
+    outMessage.append("{\"colibriClass\":\"UserMediaMapDelta\",\"endpoints\":[");
+#else
+    outMessage.append("{\"type\":\"UserMediaMapDelta\",\"endpoints\":[");
+#endif
+}
+
+inline void addUserMediaMapDeltaRemovedStart(utils::StringBuilder<1024>& outMessage)
+{
+    outMessage.append("],\"removed\":[");
+}
+
+inline void addUserMediaMapDeltaRemoved(utils::StringBuilder<1024>& outMessage, const char* endpointId)
+{
+    if (!outMessage.endsWidth('['))
+    {
+        outMessage.append(",");
+    }
+    outMessage.append("\"");
+    outMessage.append(endpointId);
+    outMessage.append("\"");
+}
+
+inline void addUserMediaMapDeltaEnd(utils::StringBuilder<1024>& outMessage)
+{
+    outMessage.append("]}");
+}
+
 inline void makeLastNAppend(utils::StringBuilder<1024>& outMessage, const char* endpointId, const bool isFirst)
 {
 #if ENABLE_LEGACY_API
@@ -74,6 +74,19 @@ nlohmann::json::const_iterator getEndpointMessagePayload(const nlohmann::json& m
     }
 }
 
+// Sent by clients that can apply UserMediaMapDelta messages to the last user media map they received
+bool isEnableUserMediaMapDelta(const nlohmann::json& messageJson)
+{
+    if (isLegacyApi(messageJson))
+    {
+        return messageJson["colibriClass"].get<std::string>().compare("EnableUserMediaMapDelta") == 0;
+    }
+    else
+    {
+        return messageJson["type"].get<std::string>().compare("EnableUserMediaMapDelta") == 0;
+    }
+}
+
 bool isUserMediaMap(const utils::SimpleJson& json)
 {
     char messageType[64];
@@ -16,6 +16,8 @@ bool isEndpointMessage(const nlohmann::json& messageJson);
 nlohmann::json::const_iterator getEndpointMessageTo(const nlohmann::json& messageJson);
 nlohmann::json::const_iterator getEndpointMessagePayload(const nlohmann::json& messageJson);
 
+bool isEnableUserMediaMapDelta(const nlohmann::json& messageJson);
+
 bool isUserMediaMap(const utils::SimpleJson&);
 
 bool isMinUplinkBitrate(const utils::SimpleJson&);
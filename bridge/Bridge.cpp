@@ -3,6 +3,7 @@
 #include "bridge/ApiRequestHandler.h"
 #include "bridge/MixerManager.h"
 #include "bridge/engine/Engine.h"
+#include "concurrency/ThreadUtils.h"
 #include "httpd/Httpd.h"
 #include "httpd/HttpdFactory.h"
 #include "jobmanager/JobManager.h"
@@ -55,21 +56,76 @@ std::vector<transport::SocketAddress> gatherInterfaces(const config::Config& con
     return interfaces;
 }
 
+namespace
+{
+std::vector<uint32_t> parseCpus(const std::string& cpuList, const char* name)
+{
+    std::vector<uint32_t> cpus;
+    if (!concurrency::parseCpuList(cpuList, cpus))
+    {
+        logger::error("Invalid cpu list %s \"%s\". Threads are not pinned", "main", name, cpuList.c_str());
+        cpus.clear();
+    }
+    return cpus;
+}
+
+// own cpu for each thread if there are enough, otherwise the threads share all cpus
+std::vector<uint32_t> cpusForThread(const std::vector<uint32_t>& cpus, uint32_t index, uint32_t threadCount)
+{
+    if (cpus.size() >= threadCount)
+    {
+        return {cpus[index]};
+    }
+    return cpus;
+}
+
+std::string toCpuList(const std::vector<uint32_t>& cpus)
+{
+    std::string cpuList;
+    for (const auto cpu : cpus)
+    {
+        cpuList += (cpuList.empty() ? "" : ",") + std::to_string(cpu);
+    }
+    return cpuList;
+}
+} // namespace
+
 Bridge::Bridge(const config::Config& config)
     : _initialized(false),
       _config(config),
       _idGenerator(std::make_unique<utils::IdGenerator>()),
       _ssrcGenerator(std::make_unique<utils::SsrcGenerator>()),
       _timers(std::make_unique<jobmanager::TimerQueue>(4096 * 8)),
-      _rtJobManager(std::make_unique<jobmanager::JobManager>(*_timers)),
+      _rtJobManager(std::make_unique<jobmanager::JobManager>(*_timers, 4096 * 8, config.workerLocalQueues)),
       _backgroundJobQueue(std::make_unique<jobmanager::JobManager>(*_timers)),
       _sslDtls(std::make_unique<transport::SslDtls>()),
       _network(transport::createRtcePoll()),
-      _mainPacketAllocator(std::make_unique<memory::PacketPoolAllocator>(32 * 1024, "main")),
-      _sendPacketAllocator(std::make_unique<memory::PacketPoolAllocator>(128 * 1024, "send")),
-      _audioPacketAllocator(std::make_unique<memory::AudioPacketPoolAllocator>(4 * 1024, "audio")),
-      _engine(std::make_unique<bridge::Engine>(*_backgroundJobQueue))
+      _mainPacketAllocator(std::make_unique<memory::PacketPoolAllocator>(32 * 1024, "main", true)),
+      _sendPacketAllocator(std::make_unique<memory::PacketPoolAllocator>(128 * 1024, "send", true)),
+      _sharedPacketAllocator(std::make_unique<memory::SharedPacketAllocator>(32 * 1024, "shared")),
+      _audioPacketAllocator(std::make_unique<memory::AudioPacketPoolAllocator>(4 * 1024, "audio"))
 {
+    const auto numEngines = std::max(1u, _config.numEngineThreads.get());
+    const auto engineCpus = parseCpus(_config.affinity.engineCpus, "engineCpus");
+    for (uint32_t i = 0; i < numEngines; ++i)
+    {
+        _engines.push_back(std::make_unique<bridge::Engine>(*_backgroundJobQueue));
+        if (engineCpus.empty())
+        {
+            continue;
+        }
+        const auto cpus = cpusForThread(engineCpus, i, numEngines);
+        if (_engines.back()->setCpuAffinity(cpus))
+        {
+            logger::info("Engine %u pinned to %s", "main", i, toCpuList(cpus).c_str());
+        }
+    }
+
+    const auto rtceCpus = parseCpus(_config.affinity.rtceCpus, "rtceCpus");
+    if (!rtceCpus.empty() && _network->setCpuAffinity(rtceCpus))
+    {
+        logger::info("Rtce pinned to %s", "main", _config.affinity.rtceCpus.get().c_str());
+    }
 }
 
 Bridge::~Bridge()
@@ -79,7 +135,10 @@ Bridge::~Bridge()
         _mixerManager->stop();
     }
 
-    _engine->stop();
+    for (auto& engine : _engines)
+    {
+        engine->stop();
+    }
 
     _transportFactory.reset(nullptr);
 
@@ -175,6 +234,7 @@ void Bridge::initialize(std::shared_ptr<transport::EndpointFactory> endpointFact
     _sctpConfig.transmitBufferSize = _config.sctp.bufferSize;
 
     _srtpClientFactory = std::make_unique<transport::SrtpClientFactory>(*_sslDtls);
+    _bweConfig.packetGroupMs = _config.bwe.packetGroupMs;
     _bweConfig.sanitize();
     _transportFactory = transport::createTransportFactory(*_rtJobManager,
         *_srtpClientFactory,
@@ -203,15 +263,22 @@ void Bridge::initialize(std::shared_ptr<transport::EndpointFactory> endpointFact
     _transportFactory->registerIceListener(*static_cast<transport::ServerEndpoint::IEvents*>(_probeServer.get()),
         credentials.first);
 
+    std::vector<bridge::Engine*> engines;
+    for (auto& engine : _engines)
+    {
+        engines.push_back(engine.get());
+    }
+
     _mixerManager = std::make_unique<bridge::MixerManager>(*_idGenerator,
         *_ssrcGenerator,
         *_rtJobManager,
         *_backgroundJobQueue,
         *_transportFactory,
-        *_engine,
+        engines,
         _config,
         *_mainPacketAllocator,
         *_sendPacketAllocator,
+        *_sharedPacketAllocator,
         *_audioPacketAllocator);
 
     _requestHandler = std::make_unique<bridge::ApiRequestHandler>(*_mixerManager, *_sslDtls, *_probeServer, _config);
@@ -239,14 +306,25 @@ void Bridge::startWorkerThreads()
         }
         else
         {
-            numWorkerThreads = std::max(hardwareConcurrency - 1, 1U);
+            const auto engineThreads = static_cast<uint32_t>(_engines.size());
+            numWorkerThreads = hardwareConcurrency > engineThreads ? hardwareConcurrency - engineThreads : 1U;
         }
     }
     logger::info("Starting %u worker threads", "main", numWorkerThreads);
 
+    const auto workerCpus = parseCpus(_config.affinity.workerCpus, "workerCpus");
     for (int i = 0; i < numWorkerThreads; ++i)
     {
         _workerThreads.push_back(std::make_unique<jobmanager::WorkerThread>(*_rtJobManager, true, "RTWorker"));
+        if (workerCpus.empty())
+        {
+            continue;
+        }
+        const auto cpus = cpusForThread(workerCpus, i, numWorkerThreads);
+        if (_workerThreads.back()->setCpuAffinity(cpus))
+        {
+            logger::info("Worker thread %d pinned to %s", "main", i, toCpuList(cpus).c_str());
+        }
     }
 }
 } // namespace bridge
@@ -5,6 +5,7 @@
 #include "httpd/HttpDaemon.h"
 #include "memory/AudioPacketPoolAllocator.h"
 #include "memory/PacketPoolAllocator.h"
+#include "memory/SharedPacket.h"
 #include "transport/ice/IceSession.h"
 #include "transport/sctp/SctpConfig.h"
 
@@ -77,10 +78,11 @@ private:
     const std::unique_ptr<transport::RtcePoll> _network;
     const std::unique_ptr<memory::PacketPoolAllocator> _mainPacketAllocator;
     const std::unique_ptr<memory::PacketPoolAllocator> _sendPacketAllocator;
+    const std::unique_ptr<memory::SharedPacketAllocator> _sharedPacketAllocator;
     const std::unique_ptr<memory::AudioPacketPoolAllocator> _audioPacketAllocator;
     std::unique_ptr<transport::TransportFactory> _transportFactory;
     std::unique_ptr<transport::ProbeServer> _probeServer;
-    const std::unique_ptr<bridge::Engine> _engine;
+    std::vector<std::unique_ptr<bridge::Engine>> _engines;
     std::unique_ptr<bridge::MixerManager> _mixerManager;
     std::unique_ptr<bridge::ApiRequestHandler> _requestHandler;
     std::unique_ptr<httpd::HttpDaemon> _httpd;
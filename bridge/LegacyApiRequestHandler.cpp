@@ -332,7 +332,6 @@ httpd::Response LegacyApiRequestHandler::patchConference(const httpd::Request& r
     {
         Mixer* mixer;
         auto scopedMixerLock = _mixerManager.getMixer(conferenceId, mixer);
-        assert(scopedMixerLock.owns_lock());
         if (!mixer)
         {
             httpd::Response response(httpd::StatusCode::NOT_FOUND);
@@ -174,6 +174,11 @@ void Mixer::markForDeletion()
     _markedForDeletion = true;
 }
 
+std::mutex& Mixer::getEndpointRequestLock(const std::string& endpointId)
+{
+    return _endpointRequestLocks[utils::hash<std::string>{}(endpointId) % _endpointRequestLocks.size()];
+}
+
 void Mixer::stopTransports()
 {
     std::lock_guard<std::mutex> locker(_configurationLock);
@@ -266,28 +271,33 @@ bool Mixer::hasPendingTransportJobs()
 
 bool Mixer::addBundleTransportIfNeeded(const std::string& endpointId, const ice::IceRole iceRole)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-    if (_bundleTransports.find(endpointId) != _bundleTransports.end())
     {
-        return true;
-    }
+        std::lock_guard<std::mutex> locker(_configurationLock);
+        if (_bundleTransports.find(endpointId) != _bundleTransports.end())
+        {
+            return true;
+        }
 
-    if (!_useGlobalPort && _rtpPorts.empty())
-    {
-        if (!_transportFactory.openRtpMuxPorts(_rtpPorts, 1024))
+        if (!_useGlobalPort && _rtpPorts.empty())
         {
-            logger::error("Failed to open isolated port for this conference, endpointId %s",
-                _loggableId.c_str(),
-                endpointId.c_str());
-            return false;
+            if (!_transportFactory.openRtpMuxPorts(_rtpPorts, 1024))
+            {
+                logger::error("Failed to open isolated port for this conference, endpointId %s",
+                    _loggableId.c_str(),
+                    endpointId.c_str());
+                return false;
+            }
         }
     }
 
+    // Requests on the same endpoint are serialized by the endpoint request lock. Other endpoints of this mixer need
+    // not wait for the transport to be created.
     const auto endpointIdHash = utils::hash<std::string>{}(endpointId);
     auto transport = _useGlobalPort
         ? _transportFactory.create(iceRole, 512, endpointIdHash)
         : _transportFactory.createOnPorts(iceRole, 512, endpointIdHash, _rtpPorts, 16, 256, true, true);
 
+    std::lock_guard<std::mutex> locker(_configurationLock);
     const auto emplaceResult = _bundleTransports.emplace(endpointId, transport);
     if (!emplaceResult.second)
     {
@@ -315,13 +325,16 @@ bool Mixer::addAudioStream(std::string& outId,
     bool isDtlsEnabled,
     utils::Optional<uint32_t> idleTimeoutSeconds)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-    if (_audioStreams.find(endpointId) != _audioStreams.end())
     {
-        logger::warn("AudioStream with endpointId %s already exists", _loggableId.c_str(), endpointId.c_str());
-        return false;
+        std::lock_guard<std::mutex> locker(_configurationLock);
+        if (_audioStreams.find(endpointId) != _audioStreams.end())
+        {
+            logger::warn("AudioStream with endpointId %s already exists", _loggableId.c_str(), endpointId.c_str());
+            return false;
+        }
     }
 
+    // created without the configuration lock, see addBundleTransportIfNeeded
     outId = std::to_string(_idGenerator.next());
     auto transport = iceRole.isSet()
         ? _transportFactory.create(iceRole.get(), 32, utils::hash<std::string>{}(endpointId))
@@ -335,6 +348,7 @@ bool Mixer::addAudioStream(std::string& outId,
         return false;
     }
 
+    std::lock_guard<std::mutex> locker(_configurationLock);
     const auto streamItr = _audioStreams.emplace(endpointId,
         std::make_unique<AudioStream>(outId,
             endpointId,
@@ -384,13 +398,16 @@ bool Mixer::addVideoStream(std::string& outId,
     bool isDtlsEnabled,
     utils::Optional<uint32_t> idleTimeoutSeconds)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-    if (_videoStreams.find(endpointId) != _videoStreams.end())
     {
-        logger::warn("VideoStream with endpointId %s already exists", _loggableId.c_str(), endpointId.c_str());
-        return false;
+        std::lock_guard<std::mutex> locker(_configurationLock);
+        if (_videoStreams.find(endpointId) != _videoStreams.end())
+        {
+            logger::warn("VideoStream with endpointId %s already exists", _loggableId.c_str(), endpointId.c_str());
+            return false;
+        }
     }
 
+    // created without the configuration lock, see addBundleTransportIfNeeded
     outId = std::to_string(_idGenerator.next());
     auto transport = iceRole.isSet()
         ? _transportFactory.create(iceRole.get(), 32, utils::hash<std::string>{}(endpointId))
@@ -404,6 +421,7 @@ bool Mixer::addVideoStream(std::string& outId,
         return false;
     }
 
+    std::lock_guard<std::mutex> locker(_configurationLock);
     const auto emplaceResult = _videoStreams.emplace(endpointId,
         std::make_unique<VideoStream>(outId,
             endpointId,
@@ -804,6 +822,7 @@ void Mixer::engineDataStreamRemoved(const EngineDataStream& engineStream)
 
 std::unordered_set<std::string> Mixer::getEndpoints() const
 {
+    std::lock_guard<std::mutex> locker(_configurationLock);
     std::unordered_set<std::string> endpoints;
     for (const auto& it : _audioStreams)
     {
@@ -867,7 +886,13 @@ bool Mixer::getEndpointExtendedInfo(const std::string& endpointId,
         return false;
     }
 
+    std::lock_guard<std::mutex> locker(_configurationLock);
     const auto audio = _audioStreams.find(endpointId);
+    if (audio == _audioStreams.cend())
+    {
+        return false;
+    }
+
     const auto transport = audio->second->transport;
     const auto& remoteSsrc = audio->second->remoteSsrc;
     if (remoteSsrc.isSet())
@@ -1117,39 +1142,6 @@ bool Mixer::getVideoStreamTransportDescription(const std::string& endpointId,
     return true;
 }
 
-void Mixer::allocateVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash)
-{
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    auto& videoPacketCaches = _videoPacketCaches[endpointIdHash];
-    auto findResult = videoPacketCaches.find(ssrc);
-    if (findResult != videoPacketCaches.cend())
-    {
-        return;
-    }
-
-    logger::info("Allocating videoPacketCache for ssrc %u, %lu", _loggableId.c_str(), ssrc, endpointIdHash);
-
-    auto videoPacketCache = std::make_unique<PacketCache>("VideoPacketCache", ssrc);
-    _engineMixer->asyncAddVideoPacketCache(ssrc, endpointIdHash, videoPacketCache.get());
-    videoPacketCaches.emplace(ssrc, std::move(videoPacketCache));
-}
-
-void Mixer::freeVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash)
-{
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    auto& videoPacketCaches = _videoPacketCaches[endpointIdHash];
-    auto findResult = videoPacketCaches.find(ssrc);
-    if (findResult == videoPacketCaches.cend())
-    {
-        return;
-    }
-
-    logger::info("Freeing videoPacketCache for ssrc %u, endpointIdHash %lu", _loggableId.c_str(), ssrc, endpointIdHash);
-    videoPacketCaches.erase(ssrc);
-}
-
 Mixer::Stats Mixer::getStats()
 {
     std::lock_guard<std::mutex> locker(_configurationLock);
@@ -1650,6 +1642,11 @@ bool Mixer::unpinEndpoint(const size_t endpointIdHash)
     return _engineMixer->asyncPinEndpoint(endpointIdHash, 0);
 }
 
+bool Mixer::enableUserMediaMapDelta(const size_t endpointIdHash)
+{
+    return _engineMixer->asyncEnableUserMediaMapDelta(endpointIdHash);
+}
+
 bool Mixer::isAudioStreamGatheringComplete(const std::string& endpointId)
 {
     std::lock_guard<std::mutex> locker(_configurationLock);
@@ -2301,6 +2298,7 @@ bool Mixer::startBarbellTransport(const std::string& barbellId)
 
 void Mixer::removeBarbell(const std::string& barbellId)
 {
+    std::lock_guard<std::mutex> locker(_configurationLock);
     auto barbellIt = _barbells.find(barbellId);
     if (barbellIt != _barbells.cend())
     {
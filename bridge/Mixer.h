@@ -9,10 +9,13 @@
 #include "transport/Endpoint.h"
 #include "transport/dtls/SrtpClient.h"
 #include "transport/ice/IceSession.h"
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -98,6 +101,9 @@ public:
     bool isMarkedForDeletion() const { return _markedForDeletion; }
     void stopTransports();
 
+    std::shared_timed_mutex& getRequestLock() { return _requestLock; }
+    std::mutex& getEndpointRequestLock(const std::string& endpointId);
+
     bool addBundleTransportIfNeeded(const std::string& endpointId, const ice::IceRole iceRole);
 
     bool addAudioStream(std::string& outId,
@@ -217,6 +223,7 @@ public:
 
     bool pinEndpoint(const size_t endpointIdHash, const std::string& pinnedEndpointId);
     bool unpinEndpoint(const size_t endpointIdHash);
+    bool enableUserMediaMapDelta(const size_t endpointIdHash);
 
     bool startAudioStreamTransport(const std::string& endpointId);
     bool startVideoStreamTransport(const std::string& endpointId);
@@ -258,9 +265,6 @@ public:
 
     bool getBarbellTransportDescription(const std::string& barbellId, TransportDescription& outTransportDescription);
 
-    void allocateVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash);
-    void freeVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash);
-
     bool addOrUpdateRecording(const std::string& conferenceId,
         const std::vector<api::RecordingChannel>& channels,
         const RecordingDescription& recordingDescription);
@@ -299,7 +303,7 @@ private:
     const config::Config& _config;
     const std::string _id;
     logger::LoggableId _loggableId;
-    bool _markedForDeletion;
+    std::atomic_bool _markedForDeletion;
 
     const std::vector<uint32_t> _audioSsrcs;
     const std::vector<api::SimulcastGroup> _videoSsrcs;
@@ -323,7 +327,6 @@ private:
     std::unordered_map<std::string, BundleTransport> _bundleTransports;
     bool _useGlobalPort;
     transport::Endpoints _rtpPorts;
-    std::unordered_map<size_t, std::unordered_map<uint32_t, std::unique_ptr<PacketCache>>> _videoPacketCaches;
     std::unordered_map<size_t, std::unordered_map<uint32_t, std::unique_ptr<PacketCache>>> _recordingRtpPacketCaches;
     std::unordered_map<size_t, std::unique_ptr<PacketCache>> _recordingEventPacketCache;
 
@@ -331,7 +334,11 @@ private:
     std::unordered_map<std::string, std::unique_ptr<EngineBarbell>> _engineBarbells;
     transport::Endpoints _barbellPorts;
 
-    std::mutex _configurationLock;
+    mutable std::mutex _configurationLock;
+
+    // Held by API requests for their whole duration, see ScopedMixerLock. Endpoint request locks are striped.
+    std::shared_timed_mutex _requestLock;
+    std::array<std::mutex, 64> _endpointRequestLocks;
 
     RecordingStream* findRecordingStream(const std::string& recordingId);
 
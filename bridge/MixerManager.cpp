@@ -21,9 +21,13 @@
 #include "utils/IdGenerator.h"
 #include "utils/Pacer.h"
 #include "utils/SsrcGenerator.h"
+#include "utils/StdExtensions.h"
 #include "utils/StringBuilder.h"
 #include "utils/Time.h"
 #include "webrtc/DataChannel.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
 #include <vector>
 
 namespace
@@ -80,25 +84,32 @@ MixerManager::MixerManager(utils::IdGenerator& idGenerator,
     jobmanager::JobManager& rtJobManager,
     jobmanager::JobManager& backgroundJobQueue,
     transport::TransportFactory& transportFactory,
-    Engine& engine,
+    const std::vector<Engine*>& engines,
     const config::Config& config,
     memory::PacketPoolAllocator& mainAllocator,
     memory::PacketPoolAllocator& sendAllocator,
+    memory::SharedPacketAllocator& sharedPacketAllocator,
     memory::AudioPacketPoolAllocator& audioAllocator)
     : _idGenerator(idGenerator),
       _ssrcGenerator(ssrcGenerator),
       _rtJobManager(rtJobManager),
       _backgroundJobQueue(backgroundJobQueue),
       _transportFactory(transportFactory),
-      _engine(engine),
       _config(config),
       _running(true),
       _statsRefreshPacer(500 * utils::Time::ms),
       _mainAllocator(mainAllocator),
       _sendAllocator(sendAllocator),
+      _sharedPacketAllocator(sharedPacketAllocator),
       _audioAllocator(audioAllocator)
 {
-    _engine.setMessageListener(this);
+    assert(!engines.empty());
+    _engines.reserve(engines.size());
+    for (auto* engine : engines)
+    {
+        engine->setMessageListener(this);
+        _engines.emplace_back(engine);
+    }
     _backgroundJobQueue.addJob<MixerManagerMainJob>(*this, _running, _statsRefreshPacer);
 }
 
@@ -117,7 +128,6 @@ Mixer* MixerManager::create(uint32_t lastN, bool useGlobalPort)
     lastN = std::min(lastN, maxLastN);
     logger::info("Create mixer, last-n %u", "MixerManager", lastN);
 
-    std::lock_guard<std::mutex> locker(_configurationLock);
     const auto id = std::to_string(_idGenerator.next());
     const auto localVideoSsrc = _ssrcGenerator.next();
 
@@ -150,14 +160,23 @@ Mixer* MixerManager::create(uint32_t lastN, bool useGlobalPort)
         videoPinSsrcs.push_back({_ssrcGenerator.next(), _ssrcGenerator.next()});
     }
 
+    EngineShard* selectedEngineShard = nullptr;
+    {
+        std::lock_guard<std::mutex> locker(_enginesLock);
+        selectedEngineShard = &selectEngine();
+        ++selectedEngineShard->mixerCount; // counted before it is added so concurrent creates spread out
+    }
+    auto& engineShard = *selectedEngineShard;
+
     auto engineMixer = std::make_unique<EngineMixer>(id,
         _rtJobManager,
-        _engine.getSynchronizationContext(),
+        engineShard.engine->getSynchronizationContext(),
         _backgroundJobQueue,
         *this,
         localVideoSsrc,
         _config,
         _sendAllocator,
+        _sharedPacketAllocator,
         _audioAllocator,
         audioSsrcs,
         videoSsrcs,
@@ -165,26 +184,22 @@ Mixer* MixerManager::create(uint32_t lastN, bool useGlobalPort)
     if (!engineMixer)
     {
         logger::error("Failed to create engineMixer", "MixerManager");
+        std::lock_guard<std::mutex> locker(_enginesLock);
+        --engineShard.mixerCount;
         return nullptr;
     }
 
-    auto mixerEmplaceResult = _mixers.emplace(id,
-        std::make_shared<Mixer>(id,
-            engineMixer->getLoggableId().getInstanceId(),
-            _transportFactory,
-            std::move(engineMixer),
-            _idGenerator,
-            _ssrcGenerator,
-            _config,
-            audioSsrcs,
-            videoSsrcs,
-            videoPinSsrcs,
-            useGlobalPort));
-    if (!mixerEmplaceResult.second)
-    {
-        logger::error("Failed to create mixer", "MixerManager");
-        return nullptr;
-    }
+    const auto mixer = std::make_shared<Mixer>(id,
+        engineMixer->getLoggableId().getInstanceId(),
+        _transportFactory,
+        std::move(engineMixer),
+        _idGenerator,
+        _ssrcGenerator,
+        _config,
+        audioSsrcs,
+        videoSsrcs,
+        videoPinSsrcs,
+        useGlobalPort);
 
     utils::StringBuilder<1024> b;
     b.append("local ").append(localVideoSsrc);
@@ -196,55 +211,77 @@ Mixer* MixerManager::create(uint32_t lastN, bool useGlobalPort)
         b.append(pinSsrc.main);
     }
 
+    auto& mixerShard = getShard(id);
+    {
+        std::lock_guard<std::mutex> locker(mixerShard.lock);
+        if (!mixerShard.mixers.emplace(id, mixer).second)
+        {
+            logger::error("Failed to create mixer", "MixerManager");
+            std::lock_guard<std::mutex> enginesLocker(_enginesLock);
+            --engineShard.mixerCount;
+            return nullptr;
+        }
+
+        mixerShard.mixerEngines.emplace(id, &engineShard);
+        engineShard.engine->asyncAddMixer(mixer->getEngineMixer());
+    }
+
     logger::info("Mixer-%zu id=%s, %s",
         "MixerManager",
-        mixerEmplaceResult.first->second->getLoggableId().getInstanceId(),
+        mixer->getLoggableId().getInstanceId(),
         id.c_str(),
         b.build().c_str());
 
-    _engine.asyncAddMixer(mixerEmplaceResult.first->second->getEngineMixer());
-    return mixerEmplaceResult.first->second.get();
+    return mixer.get();
 }
 
 void MixerManager::remove(const std::string& id)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-    auto findResult = _mixers.find(id);
-    if (findResult == _mixers.cend() || findResult->second->isMarkedForDeletion())
+    auto mixer = findMixer(id);
+    if (!mixer)
     {
         return;
     }
 
-    findResult->second->markForDeletion();
-    _engine.asyncRemoveMixer(findResult->second->getEngineMixer());
+    // waits for requests in progress. Requests that wait for the lock will find the mixer marked for deletion.
+    std::unique_lock<std::shared_timed_mutex> requestLocker(mixer->getRequestLock());
+    if (mixer->isMarkedForDeletion())
+    {
+        return;
+    }
+
+    mixer->markForDeletion();
+    getEngine(id).asyncRemoveMixer(mixer->getEngineMixer());
 }
 
 std::vector<std::string> MixerManager::getMixerIds()
 {
     std::vector<std::string> result;
 
-    std::lock_guard<std::mutex> locker(_configurationLock);
-    for (const auto& mixerPair : _mixers)
+    for (auto& mixerShard : _mixerShards)
     {
-        result.emplace_back(mixerPair.first);
+        std::lock_guard<std::mutex> locker(mixerShard.lock);
+        for (const auto& mixerPair : mixerShard.mixers)
+        {
+            result.emplace_back(mixerPair.first);
+        }
     }
 
     return result;
 }
 
-std::unique_lock<std::mutex> MixerManager::getMixer(const std::string& id, Mixer*& outMixer)
+ScopedMixerLock MixerManager::getMixer(const std::string& id, Mixer*& outMixer)
 {
-    std::unique_lock<std::mutex> locker(_configurationLock);
-
-    auto iterator = _mixers.find(id);
-    if (iterator != _mixers.cend() && !iterator->second->isMarkedForDeletion())
-    {
-        outMixer = iterator->second.get();
-        return locker;
-    }
+    ScopedMixerLock scopedMixerLock(findMixer(id));
+    outMixer = scopedMixerLock.getMixer();
+    return scopedMixerLock;
+}
 
-    outMixer = nullptr;
-    return locker;
+ScopedMixerLock MixerManager::getMixer(const std::string& id, const std::string& endpointId, Mixer*& outMixer)
+{
+    ScopedMixerLock scopedMixerLock(findMixer(id), endpointId);
+    outMixer = scopedMixerLock.getMixer();
+    return scopedMixerLock;
 }
 
 void MixerManager::stop()
@@ -255,22 +292,14 @@ void MixerManager::stop()
     }
 
     logger::info("stopping", "MixerManager");
+    for (const auto& mixer : getMixers())
     {
-        std::lock_guard<std::mutex> locker(_configurationLock);
-        for (auto it = _mixers.begin(); it != _mixers.end(); ++it)
-        {
-            if (!it->second->isMarkedForDeletion())
-            {
-                it->second->markForDeletion();
-                _engine.asyncRemoveMixer(it->second->getEngineMixer());
-            }
-        }
+        remove(mixer->getId());
     }
 
     for (;; usleep(10000))
     {
-        std::lock_guard<std::mutex> locker(_configurationLock);
-        if (_mixers.empty())
+        if (!hasMixers())
             break;
     }
 
@@ -297,14 +326,23 @@ void MixerManager::maintenance(uint64_t timestamp)
 
 void MixerManager::engineMixerRemoved(EngineMixer& engineMixer)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
     std::string mixerId(engineMixer.getId()); // copy id string to have it after EngineMixer is deleted
+    auto& mixerShard = getShard(mixerId);
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
-    auto findResult = _mixers.find(mixerId);
-    if (findResult != _mixers.end())
+    auto engineItr = mixerShard.mixerEngines.find(mixerId);
+    if (engineItr != mixerShard.mixerEngines.end())
+    {
+        std::lock_guard<std::mutex> enginesLocker(_enginesLock);
+        --engineItr->second->mixerCount;
+        mixerShard.mixerEngines.erase(engineItr);
+    }
+
+    auto findResult = mixerShard.mixers.find(mixerId);
+    if (findResult != mixerShard.mixers.end())
     {
         auto mixer = findResult->second;
-        _mixers.erase(mixerId);
+        mixerShard.mixers.erase(mixerId);
         mixer->stopTransports(); // this will stop new packets from coming in
         _backgroundJobQueue.addJob<bridge::FinalizeEngineMixerRemoval>(*this, mixer);
     }
@@ -312,22 +350,22 @@ void MixerManager::engineMixerRemoved(EngineMixer& engineMixer)
 
 void MixerManager::finalizeEngineMixerRemoval(const std::string& mixerId)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    if (_mixers.empty())
+    if (!hasMixers())
     {
         _mainAllocator.logAllocatedElements();
         _sendAllocator.logAllocatedElements();
+        _sharedPacketAllocator.logAllocatedElements();
         _audioAllocator.logAllocatedElements();
     }
 }
 
 void MixerManager::allocateAudioBuffer(EngineMixer& mixer, uint32_t ssrc)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(mixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
-    auto it = _mixers.find(mixer.getId());
-    if (it == _mixers.end())
+    auto it = mixerShard.mixers.find(mixer.getId());
+    if (it == mixerShard.mixers.end())
     {
         return;
     }
@@ -337,15 +375,16 @@ void MixerManager::allocateAudioBuffer(EngineMixer& mixer, uint32_t ssrc)
 
 void MixerManager::audioStreamRemoved(EngineMixer& mixer, const EngineAudioStream& audioStream)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(mixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
     logger::info("Removing audioStream endpointId %s from mixer %s",
         "MixerManager",
         audioStream.endpointId.c_str(),
         mixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(mixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerIter = mixerShard.mixers.find(mixer.getId());
+    if (mixerIter == mixerShard.mixers.cend())
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -359,15 +398,16 @@ void MixerManager::audioStreamRemoved(EngineMixer& mixer, const EngineAudioStrea
 
 void MixerManager::videoStreamRemoved(EngineMixer& engineMixer, const EngineVideoStream& videoStream)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(engineMixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
     logger::info("Removing videoStream endpointId %s from mixer %s",
         "MixerManager",
         videoStream.endpointId.c_str(),
         engineMixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(engineMixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerIter = mixerShard.mixers.find(engineMixer.getId());
+    if (mixerIter == mixerShard.mixers.cend())
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -381,15 +421,16 @@ void MixerManager::videoStreamRemoved(EngineMixer& engineMixer, const EngineVide
 
 void MixerManager::recordingStreamRemoved(EngineMixer& mixer, const EngineRecordingStream& recordingStream)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(mixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
     logger::info("Removing recordingStream  %s from mixer %s",
         "MixerManager",
         recordingStream.id.c_str(),
         mixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(mixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerIter = mixerShard.mixers.find(mixer.getId());
+    if (mixerIter == mixerShard.mixers.cend())
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -403,15 +444,16 @@ void MixerManager::recordingStreamRemoved(EngineMixer& mixer, const EngineRecord
 
 void MixerManager::dataStreamRemoved(EngineMixer& mixer, const EngineDataStream& dataStream)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(mixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
     logger::info("Removing dataStream endpointId %s from mixer %s",
         "MixerManager",
         dataStream.endpointId.c_str(),
         mixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(mixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerIter = mixerShard.mixers.find(mixer.getId());
+    if (mixerIter == mixerShard.mixers.cend())
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -435,32 +477,6 @@ void MixerManager::inboundSsrcContextRemoved(EngineMixer& mixer, uint32_t ssrc,
     delete opusDecoder;
 }
 
-void MixerManager::allocateVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
-{
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
-    {
-        return;
-    }
-
-    mixerItr->second->allocateVideoPacketCache(ssrc, endpointIdHash);
-}
-
-void MixerManager::freeVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
-{
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
-    {
-        return;
-    }
-
-    mixerItr->second->freeVideoPacketCache(ssrc, endpointIdHash);
-}
-
 void MixerManager::sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPacket, size_t endpointIdHash)
 {
     auto& sctpHeader = webrtc::streamMessageHeader(*msgPacket);
@@ -482,24 +498,32 @@ void MixerManager::sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPack
             if (api::DataChannelMessageParser::isPinnedEndpointsChanged(json))
             {
                 logger::debug("received pin msg %s", "MixerManager", body.c_str());
-                auto mixerIt = _mixers.find(mixer.getId());
-                if (mixerIt != _mixers.end())
+                auto ownerMixer = findMixer(mixer.getId());
+                if (ownerMixer)
                 {
                     const auto& pinnedEndpoints = api::DataChannelMessageParser::getPinnedEndpoint(json);
                     if (pinnedEndpoints.empty())
                     {
-                        mixerIt->second->unpinEndpoint(endpointIdHash);
+                        ownerMixer->unpinEndpoint(endpointIdHash);
                     }
                     else
                     {
-                        mixerIt->second->pinEndpoint(endpointIdHash, pinnedEndpoints[0]);
+                        ownerMixer->pinEndpoint(endpointIdHash, pinnedEndpoints[0]);
                     }
                 }
             }
+            else if (api::DataChannelMessageParser::isEnableUserMediaMapDelta(json))
+            {
+                auto ownerMixer = findMixer(mixer.getId());
+                if (ownerMixer)
+                {
+                    ownerMixer->enableUserMediaMapDelta(endpointIdHash);
+                }
+            }
             else if (api::DataChannelMessageParser::isEndpointMessage(json))
             {
-                auto mixerIt = _mixers.find(mixer.getId());
-                if (mixerIt == _mixers.end())
+                auto ownerMixer = findMixer(mixer.getId());
+                if (!ownerMixer)
                 {
                     return;
                 }
@@ -511,7 +535,7 @@ void MixerManager::sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPack
                     return;
                 }
 
-                mixerIt->second->sendEndpointMessage(toItr->get<std::string>(), endpointIdHash, payloadItr->dump());
+                ownerMixer->sendEndpointMessage(toItr->get<std::string>(), endpointIdHash, payloadItr->dump());
             }
         }
         catch (nlohmann::detail::parse_error e)
@@ -531,15 +555,16 @@ void MixerManager::sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPack
 
 void MixerManager::engineRecordingStopped(EngineMixer& mixer, const RecordingDescription& recordingDesc)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(mixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
     logger::info("Stopping recording %s from mixer %s",
         "MixerManager",
         recordingDesc.recordingId.c_str(),
         mixer.getLoggableId().c_str());
 
-    const auto mixerIter = _mixers.find(mixer.getId());
-    if (mixerIter == _mixers.cend())
+    const auto mixerIter = mixerShard.mixers.find(mixer.getId());
+    if (mixerIter == mixerShard.mixers.cend())
     {
         logger::info("Mixer %s (id=%s) does not exist",
             "MixerManager",
@@ -553,10 +578,11 @@ void MixerManager::engineRecordingStopped(EngineMixer& mixer, const RecordingDes
 
 void MixerManager::allocateRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(mixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
+    const auto mixerItr = mixerShard.mixers.find(mixer.getId());
+    if (mixerItr == mixerShard.mixers.cend())
     {
         return;
     }
@@ -566,10 +592,11 @@ void MixerManager::allocateRecordingRtpPacketCache(EngineMixer& mixer, uint32_t
 
 void MixerManager::freeRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(mixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
+    const auto mixerItr = mixerShard.mixers.find(mixer.getId());
+    if (mixerItr == mixerShard.mixers.cend())
     {
         return;
     }
@@ -579,10 +606,11 @@ void MixerManager::freeRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc
 
 void MixerManager::removeRecordingTransport(EngineMixer& mixer, EndpointIdString streamId, size_t endpointIdHash)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(mixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
-    const auto mixerItr = _mixers.find(mixer.getId());
-    if (mixerItr == _mixers.cend())
+    const auto mixerItr = mixerShard.mixers.find(mixer.getId());
+    if (mixerItr == mixerShard.mixers.cend())
     {
         return;
     }
@@ -592,10 +620,11 @@ void MixerManager::removeRecordingTransport(EngineMixer& mixer, EndpointIdString
 
 void MixerManager::barbellRemoved(EngineMixer& mixer, const EngineBarbell& barbell)
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
+    auto& mixerShard = getShard(mixer.getId());
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
 
-    auto mixerIt = _mixers.find(mixer.getId());
-    if (mixerIt != _mixers.end())
+    auto mixerIt = mixerShard.mixers.find(mixer.getId());
+    if (mixerIt != mixerShard.mixers.end())
     {
         mixerIt->second->engineBarbellRemoved(barbell);
     }
@@ -608,13 +637,15 @@ Stats::MixerManagerStats MixerManager::getStats()
     auto systemStats = _systemStatCollector.collect(_config.port, _config.ice.tcp.port);
 
     {
-        std::lock_guard<std::mutex> locker(_configurationLock);
+        std::lock_guard<std::mutex> locker(_statsLock);
 
         result.conferences = _stats.conferences;
         result.videoStreams = _stats.videoStreams;
         result.audioStreams = _stats.audioStreams;
         result.dataStreams = _stats.dataStreams;
         result.engineStats = _stats.engine;
+        result.engineShards = _stats.engineShards;
+        result.slowestMixers = _stats.slowestMixers;
         result.systemStats = systemStats;
         result.largestConference = _stats.largestConference;
     }
@@ -624,6 +655,8 @@ Stats::MixerManagerStats MixerManager::getStats()
     result.jobQueueLength = _rtJobManager.getCount();
     result.receivePoolSize = _mainAllocator.size();
     result.sendPoolSize = _sendAllocator.size();
+    result.receivePoolResidentKb = _mainAllocator.getResidentBytes() / 1024;
+    result.sendPoolResidentKb = _sendAllocator.getResidentBytes() / 1024;
     result.udpSharedEndpointsSendQueue = udpMetrics.sendQueue;
     result.udpSharedEndpointsReceiveKbps = static_cast<uint32_t>(udpMetrics.receiveKbps);
     result.udpSharedEndpointsSendKbps = static_cast<uint32_t>(udpMetrics.sendKbps);
@@ -631,31 +664,198 @@ Stats::MixerManagerStats MixerManager::getStats()
     return result;
 }
 
+// Samples the mixers without holding any shard lock so that stats collection does not delay API requests
 void MixerManager::updateStats()
 {
-    std::lock_guard<std::mutex> locker(_configurationLock);
-
-    _stats.conferences = _mixers.size();
-    _stats.videoStreams = 0;
-    _stats.audioStreams = 0;
-    _stats.dataStreams = 0;
-    _stats.largestConference = 0;
+    const auto mixers = getMixers();
 
-    for (const auto& mixer : _mixers)
+    MixerStats stats;
+    stats.conferences = mixers.size();
+    for (const auto& mixer : mixers)
     {
-        const auto stats = mixer.second->getStats();
-        _stats.videoStreams += stats.videoStreams;
-        _stats.audioStreams += stats.audioStreams;
-        _stats.dataStreams += stats.videoStreams;
-        _stats.largestConference = std::max(stats.transports, _stats.largestConference);
+        const auto mixerStats = mixer->getStats();
+        stats.videoStreams += mixerStats.videoStreams;
+        stats.audioStreams += mixerStats.audioStreams;
+        stats.dataStreams += mixerStats.videoStreams;
+        stats.largestConference = std::max(mixerStats.transports, stats.largestConference);
+
+        Stats::MixerTickStats tickStats;
+        if (mixer->getEngineMixer()->getTickProfile(tickStats.profile) && tickStats.profile.total.count() > 0)
+        {
+            tickStats.mixerId = mixer->getId();
+            stats.slowestMixers.push_back(std::move(tickStats));
+        }
     }
 
-    _stats.engine = _engine.getStats();
+    const size_t slowestMixersCount = std::min(size_t(5), stats.slowestMixers.size());
+    std::partial_sort(stats.slowestMixers.begin(),
+        stats.slowestMixers.begin() + slowestMixersCount,
+        stats.slowestMixers.end(),
+        [](const Stats::MixerTickStats& a, const Stats::MixerTickStats& b) {
+            return a.profile.total.percentile(0.99) > b.profile.total.percentile(0.99);
+        });
+    stats.slowestMixers.resize(slowestMixersCount);
+
+    {
+        std::lock_guard<std::mutex> locker(_enginesLock);
+        for (auto& engineShard : _engines)
+        {
+            engineShard.stats = engineShard.engine->getStats();
+            Stats::EngineShardStats shardStats;
+            shardStats.mixers = engineShard.mixerCount;
+            shardStats.load = engineShard.stats.load;
+            stats.engineShards.push_back(shardStats);
+        }
+
+        stats.engine = _engines.front().stats;
+        for (size_t i = 1; i < _engines.size(); ++i)
+        {
+            stats.engine += _engines[i].stats;
+        }
+    }
 
     if (_mainAllocator.size() < 512)
     {
-        logger::warn("stats main pool %zu, mixers %zu", "MixerManager", _mainAllocator.size(), _mixers.size());
+        logger::warn("stats main pool %zu, mixers %zu", "MixerManager", _mainAllocator.size(), mixers.size());
+    }
+
+    // _stats is only written on this thread and may be read here without the lock
+    const auto timestamp = utils::Time::getAbsoluteTime();
+    const bool logProfile = _config.tickProfileLogIntervalSec > 0 &&
+        utils::Time::diffGE(_stats.lastTickProfileLog, timestamp, _config.tickProfileLogIntervalSec * utils::Time::sec);
+    stats.lastTickProfileLog = logProfile ? timestamp : _stats.lastTickProfileLog;
+
+    {
+        std::lock_guard<std::mutex> locker(_statsLock);
+        _stats = std::move(stats);
+    }
+
+    if (logProfile)
+    {
+        logTickProfile();
+    }
+}
+
+void MixerManager::logTickProfile()
+{
+    const auto& tickTime = _stats.engine.tickTime;
+    if (_stats.slowestMixers.empty())
+    {
+        logger::info("engine tick p50 %uus, p99 %uus, max %uus",
+            "MixerManager",
+            tickTime.percentile(0.5),
+            tickTime.percentile(0.99),
+            tickTime.maxUs);
+        return;
+    }
+
+    const auto& slowest = _stats.slowestMixers.front();
+    const auto slowestPhase = slowest.profile.slowestPhase();
+    logger::info("engine tick p50 %uus, p99 %uus, max %uus. Slowest mixer %s p99 %uus, max %uus, %s p99 %uus",
+        "MixerManager",
+        tickTime.percentile(0.5),
+        tickTime.percentile(0.99),
+        tickTime.maxUs,
+        slowest.mixerId.c_str(),
+        slowest.profile.total.percentile(0.99),
+        slowest.profile.total.maxUs,
+        EngineStats::toString(slowestPhase),
+        slowest.profile[slowestPhase].percentile(0.99));
+}
+
+// Places new mixers on the engine with the lowest predicted load. Mixers added since the last stats sample are
+// assumed to cost as much as the average mixer measured across all engines. Loads within loadTolerance of the lowest
+// count as equal and then the engine with the fewest mixers wins, so lightly loaded engines fill evenly instead of
+// following measurement noise.
+MixerManager::EngineShard& MixerManager::selectEngine()
+{
+    const double loadTolerance = 0.05;
+
+    uint32_t sampledMixers = 0;
+    double sampledLoad = 0;
+    for (const auto& engineShard : _engines)
+    {
+        sampledMixers += engineShard.stats.mixers;
+        sampledLoad += engineShard.stats.load;
+    }
+    const double mixerCost = (sampledMixers > 0 ? sampledLoad / sampledMixers : 0.01);
+
+    auto predictLoad = [mixerCost](const EngineShard& engineShard) {
+        const double unsampledMixers =
+            static_cast<double>(engineShard.mixerCount) - static_cast<double>(engineShard.stats.mixers);
+        return engineShard.stats.load + std::max(0.0, unsampledMixers) * mixerCost;
+    };
+
+    double lowestLoad = std::numeric_limits<double>::max();
+    for (const auto& engineShard : _engines)
+    {
+        lowestLoad = std::min(lowestLoad, predictLoad(engineShard));
+    }
+
+    EngineShard* selected = nullptr;
+    for (auto& engineShard : _engines)
+    {
+        if (predictLoad(engineShard) <= lowestLoad + loadTolerance &&
+            (!selected || engineShard.mixerCount < selected->mixerCount))
+        {
+            selected = &engineShard;
+        }
+    }
+
+    return *selected;
+}
+
+Engine& MixerManager::getEngine(const std::string& mixerId)
+{
+    auto& mixerShard = getShard(mixerId);
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
+    auto it = mixerShard.mixerEngines.find(mixerId);
+    assert(it != mixerShard.mixerEngines.end());
+    return *it->second->engine;
+}
+
+MixerManager::MixerShard& MixerManager::getShard(const std::string& mixerId)
+{
+    return _mixerShards[utils::hash<std::string>{}(mixerId) % _mixerShards.size()];
+}
+
+std::shared_ptr<Mixer> MixerManager::findMixer(const std::string& mixerId)
+{
+    auto& mixerShard = getShard(mixerId);
+    std::lock_guard<std::mutex> locker(mixerShard.lock);
+    auto it = mixerShard.mixers.find(mixerId);
+    if (it == mixerShard.mixers.end())
+    {
+        return nullptr;
+    }
+    return it->second;
+}
+
+std::vector<std::shared_ptr<Mixer>> MixerManager::getMixers()
+{
+    std::vector<std::shared_ptr<Mixer>> result;
+    for (auto& mixerShard : _mixerShards)
+    {
+        std::lock_guard<std::mutex> locker(mixerShard.lock);
+        for (const auto& mixerPair : mixerShard.mixers)
+        {
+            result.push_back(mixerPair.second);
+        }
+    }
+    return result;
+}
+
+bool MixerManager::hasMixers()
+{
+    for (auto& mixerShard : _mixerShards)
+    {
+        std::lock_guard<std::mutex> locker(mixerShard.lock);
+        if (!mixerShard.mixers.empty())
+        {
+            return true;
+        }
     }
+    return false;
 }
 
 } // namespace bridge
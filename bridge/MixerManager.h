@@ -1,12 +1,15 @@
 #pragma once
 
 #include "bridge/MixerManagerAsync.h"
+#include "bridge/ScopedMixerLock.h"
 #include "bridge/Stats.h"
 #include "bridge/engine/EngineMixer.h"
 #include "bridge/engine/EngineStats.h"
 #include "concurrency/MpmcQueue.h"
 #include "memory/PacketPoolAllocator.h"
+#include "memory/SharedPacket.h"
 #include "utils/Pacer.h"
+#include <array>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -52,10 +55,11 @@ public:
         jobmanager::JobManager& rtJobManager,
         jobmanager::JobManager& backgroundJobQueue,
         transport::TransportFactory& transportFactory,
-        bridge::Engine& engine,
+        const std::vector<bridge::Engine*>& engines,
         const config::Config& config,
         memory::PacketPoolAllocator& mainAllocator,
         memory::PacketPoolAllocator& sendAllocator,
+        memory::SharedPacketAllocator& sharedPacketAllocator,
         memory::AudioPacketPoolAllocator& audioAllocator);
 
     ~MixerManager();
@@ -64,7 +68,10 @@ public:
     bridge::Mixer* create(uint32_t lastN, bool useGlobalPort);
     void remove(const std::string& id);
     std::vector<std::string> getMixerIds();
-    std::unique_lock<std::mutex> getMixer(const std::string& id, Mixer*& outMixer);
+    // exclusive access for conference wide requests
+    ScopedMixerLock getMixer(const std::string& id, Mixer*& outMixer);
+    // excludes other requests on the same endpoint only
+    ScopedMixerLock getMixer(const std::string& id, const std::string& endpointId, Mixer*& outMixer);
 
     void stop();
     void maintenance(uint64_t timestamp);
@@ -83,29 +90,62 @@ private:
         uint64_t lastRefreshTimestamp = 0;
         uint32_t largestConference = 0;
         EngineStats::EngineStats engine;
+        std::vector<Stats::EngineShardStats> engineShards;
+        std::vector<Stats::MixerTickStats> slowestMixers;
+        uint64_t lastTickProfileLog = 0;
     };
 
+    struct EngineShard
+    {
+        explicit EngineShard(Engine* engine_) : engine(engine_), mixerCount(0) {}
+
+        Engine* engine;
+        uint32_t mixerCount;
+        EngineStats::EngineStats stats;
+    };
+
+    // Mixers are spread over shards by id so that requests and engine events for different conferences rarely
+    // contend. Requests hold a shard lock only to look up the mixer, see getMixer.
+    struct MixerShard
+    {
+        std::mutex lock;
+        std::unordered_map<std::string, std::shared_ptr<Mixer>> mixers;
+        std::unordered_map<std::string, EngineShard*> mixerEngines;
+    };
+
+    static const size_t mixerShardCount = 16;
+
     utils::IdGenerator& _idGenerator;
     utils::SsrcGenerator& _ssrcGenerator;
     jobmanager::JobManager& _rtJobManager;
     jobmanager::JobManager& _backgroundJobQueue;
     transport::TransportFactory& _transportFactory;
-    Engine& _engine;
+    std::vector<EngineShard> _engines;
+    std::mutex _enginesLock; // mixerCount and stats of _engines
     const config::Config& _config;
 
-    std::unordered_map<std::string, std::shared_ptr<Mixer>> _mixers;
+    std::array<MixerShard, mixerShardCount> _mixerShards;
 
     std::atomic<bool> _running;
     utils::Pacer _statsRefreshPacer;
-    std::mutex _configurationLock;
 
+    std::mutex _statsLock;
     MixerStats _stats;
     Stats::SystemStatsCollector _systemStatCollector;
     memory::PacketPoolAllocator& _mainAllocator;
     memory::PacketPoolAllocator& _sendAllocator;
+    memory::SharedPacketAllocator& _sharedPacketAllocator;
     memory::AudioPacketPoolAllocator& _audioAllocator;
 
     void updateStats();
+    void logTickProfile();
+    EngineShard& selectEngine();
+    Engine& getEngine(const std::string& mixerId);
+
+    MixerShard& getShard(const std::string& mixerId);
+    std::shared_ptr<Mixer> findMixer(const std::string& mixerId);
+    std::vector<std::shared_ptr<Mixer>> getMixers();
+    bool hasMixers();
 
     // Async interface
     bool post(utils::Function&& task) override { return _backgroundJobQueue.post(std::move(task)); }
@@ -113,8 +153,6 @@ private:
     void allocateAudioBuffer(EngineMixer& mixer, uint32_t ssrc) override;
     void audioStreamRemoved(EngineMixer& mixer, const EngineAudioStream& audioStream) override;
     void engineMixerRemoved(EngineMixer& mixer) override;
-    void freeVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash) override;
-    void allocateVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash) override;
     void allocateRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash) override;
     void videoStreamRemoved(EngineMixer& engineMixer, const EngineVideoStream& videoStream) override;
     void sctpReceived(EngineMixer& mixer, memory::UniquePacket msgPacket, size_t endpointIdHash) override;
@@ -30,16 +30,6 @@ bool MixerManagerAsync::asyncEngineMixerRemoved(EngineMixer& mixer)
     return post(utils::bind(&MixerManagerAsync::engineMixerRemoved, this, std::ref(mixer)));
 }
 
-bool MixerManagerAsync::asyncFreeVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
-{
-    return post(utils::bind(&MixerManagerAsync::freeVideoPacketCache, this, std::ref(mixer), ssrc, endpointIdHash));
-}
-
-bool MixerManagerAsync::asyncAllocateVideoPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
-{
-    return post(utils::bind(&MixerManagerAsync::allocateVideoPacketCache, this, std::ref(mixer), ssrc, endpointIdHash));
-}
-
 bool MixerManagerAsync::asyncAllocateRecordingRtpPacketCache(EngineMixer& mixer, uint32_t ssrc, size_t endpointIdHash)
 {
     return post(
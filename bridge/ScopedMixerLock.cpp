@@ -0,0 +1,34 @@
+#include "bridge/ScopedMixerLock.h"
+#include "bridge/Mixer.h"
+
+namespace bridge
+{
+
+ScopedMixerLock::ScopedMixerLock(std::shared_ptr<Mixer> mixer) : _mixer(std::move(mixer))
+{
+    if (_mixer)
+    {
+        _conferenceLock = std::unique_lock<std::shared_timed_mutex>(_mixer->getRequestLock());
+    }
+}
+
+ScopedMixerLock::ScopedMixerLock(std::shared_ptr<Mixer> mixer, const std::string& endpointId)
+    : _mixer(std::move(mixer))
+{
+    if (_mixer)
+    {
+        _sharedConferenceLock = std::shared_lock<std::shared_timed_mutex>(_mixer->getRequestLock());
+        _endpointLock = std::unique_lock<std::mutex>(_mixer->getEndpointRequestLock(endpointId));
+    }
+}
+
+Mixer* ScopedMixerLock::getMixer() const
+{
+    if (!_mixer || _mixer->isMarkedForDeletion())
+    {
+        return nullptr;
+    }
+    return _mixer.get();
+}
+
+} // namespace bridge
@@ -0,0 +1,39 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+namespace bridge
+{
+class Mixer;
+
+/**
+ * Keeps a mixer alive and holds its request locks for the duration of an API request. Conference wide requests get
+ * exclusive access to the mixer. Endpoint requests run concurrently with requests on other endpoints of the mixer and
+ * rely on Mixer's configuration lock for its shared state.
+ *
+ * Lock order is request locks, MixerManager shard lock, Mixer configuration lock.
+ */
+class ScopedMixerLock
+{
+public:
+    ScopedMixerLock() = default;
+    explicit ScopedMixerLock(std::shared_ptr<Mixer> mixer);
+    ScopedMixerLock(std::shared_ptr<Mixer> mixer, const std::string& endpointId);
+
+    ScopedMixerLock(ScopedMixerLock&&) = default;
+    ScopedMixerLock& operator=(ScopedMixerLock&&) = default;
+
+    // nullptr if the mixer does not exist or was removed while waiting for the lock
+    Mixer* getMixer() const;
+
+private:
+    // declared before the locks so they are released before the mixer may be deleted
+    std::shared_ptr<Mixer> _mixer;
+    std::unique_lock<std::shared_timed_mutex> _conferenceLock;
+    std::shared_lock<std::shared_timed_mutex> _sharedConferenceLock;
+    std::unique_lock<std::mutex> _endpointLock;
+};
+
+} // namespace bridge
@@ -26,6 +26,43 @@ json to_json(const T (&data)[N])
 }
 } // namespace nlohmann
 
+namespace
+{
+nlohmann::json toJson(const bridge::EngineStats::LatencyHistogram& histogram)
+{
+    nlohmann::json result;
+    result["count"] = histogram.count();
+    result["p50"] = histogram.percentile(0.5);
+    result["p90"] = histogram.percentile(0.9);
+    result["p99"] = histogram.percentile(0.99);
+    result["max"] = histogram.maxUs;
+
+    // non empty buckets keyed by their lower bound in us
+    auto buckets = nlohmann::json::object();
+    for (size_t i = 0; i < bridge::EngineStats::LatencyHistogram::bucketCount; ++i)
+    {
+        if (histogram.counts[i] > 0)
+        {
+            buckets[std::to_string(bridge::EngineStats::LatencyHistogram::bucketLowerBound(i))] = histogram.counts[i];
+        }
+    }
+    result["hist"] = buckets;
+    return result;
+}
+
+nlohmann::json toJson(const bridge::EngineStats::TickProfile& profile)
+{
+    nlohmann::json result;
+    result["total"] = toJson(profile.total);
+    for (size_t i = 0; i < bridge::EngineStats::TickProfile::phaseCount; ++i)
+    {
+        const auto phase = static_cast<bridge::EngineStats::TickPhase>(i);
+        result[bridge::EngineStats::toString(phase)] = toJson(profile[phase]);
+    }
+    return result;
+}
+} // namespace
+
 namespace bridge
 {
 
@@ -85,6 +122,7 @@ std::string MixerManagerStats::describe()
     result["threads"] = systemStats.totalNumberOfThreads;
     result["cpu_usage"] = systemStats.processCPU;
     result["cpu_engine"] = systemStats.engineCpu;
+    result["cpu_engine_max"] = systemStats.engineCpuMax;
     result["cpu_rtce"] = systemStats.rtceCpu;
     result["cpu_workers"] = systemStats.workerCpu;
     result["cpu_manager"] = systemStats.managerCpu;
@@ -120,6 +158,8 @@ std::string MixerManagerStats::describe()
 
     result["send_pool"] = sendPoolSize;
     result["receive_pool"] = receivePoolSize;
+    result["send_pool_resident_kb"] = sendPoolResidentKb;
+    result["receive_pool_resident_kb"] = receivePoolResidentKb;
 
     result["loss_upload_hist"] = nlohmann::to_json(engineStats.activeMixers.outbound.transport.lossGroup);
     result["loss_download_hist"] = nlohmann::to_json(engineStats.activeMixers.inbound.transport.lossGroup);
@@ -127,6 +167,27 @@ std::string MixerManagerStats::describe()
     result["rtt_download_hist"] = nlohmann::to_json(engineStats.activeMixers.inbound.transport.rttGroup);
 
     result["engine_slips"] = engineStats.timeSlipCount;
+    result["engine_threads"] = engineStats.engines;
+    result["engine_load"] = engineStats.load / std::max(1u, engineStats.engines);
+    result["engine_load_max"] = engineStats.maxLoad;
+    result["engine_tick_us"] = toJson(engineStats.tickTime);
+    result["mixer_tick_us"] = toJson(engineStats.activeMixers.tickProfile);
+
+    auto engineShardsJson = nlohmann::json::array();
+    for (const auto& engineShard : engineShards)
+    {
+        engineShardsJson.push_back({{"mixers", engineShard.mixers}, {"load", engineShard.load}});
+    }
+    result["engine_shards"] = engineShardsJson;
+
+    auto slowestMixersJson = nlohmann::json::array();
+    for (const auto& mixer : slowestMixers)
+    {
+        auto mixerJson = toJson(mixer.profile);
+        mixerJson["id"] = mixer.mixerId;
+        slowestMixersJson.push_back(mixerJson);
+    }
+    result["slowest_mixers"] = slowestMixersJson;
 
     return result.dump(4);
 }
@@ -282,8 +343,10 @@ SystemStats SystemStatsCollector::collect(uint16_t httpPort, uint16_t tcpRtpPort
         }
         else if (!std::strcmp(taskSample.name, "(Engine)"))
         {
-            stats.engineCpu =
+            const double engineCpu =
                 cpuCount * static_cast<double>(taskSample.utime + taskSample.stime) / (1 + systemDiff.totalJiffies());
+            stats.engineCpu += engineCpu;
+            stats.engineCpuMax = std::max(stats.engineCpuMax, engineCpu);
         }
         else if (!std::strcmp(taskSample.name, "(MixerManager)"))
         {
@@ -4,6 +4,8 @@
 #include "concurrency/MpmcPublish.h"
 #include <array>
 #include <inttypes.h>
+#include <string>
+#include <vector>
 
 namespace bridge
 {
@@ -44,12 +46,25 @@ struct SystemStats
 
     double workerCpu = 0;
     double rtceCpu = 0;
-    double engineCpu = 0;
+    double engineCpu = 0; // summed over engine threads
+    double engineCpuMax = 0; // busiest engine thread
     double managerCpu = 0;
 
     struct ConnectionsStats connections;
 };
 
+struct MixerTickStats
+{
+    std::string mixerId;
+    EngineStats::TickProfile profile;
+};
+
+struct EngineShardStats
+{
+    uint32_t mixers = 0;
+    double load = 0;
+};
+
 struct MixerManagerStats
 {
     SystemStats systemStats;
@@ -59,14 +74,20 @@ struct MixerManagerStats
     uint32_t dataStreams = 0;
     uint32_t largestConference = 0;
     EngineStats::EngineStats engineStats;
+    std::vector<EngineShardStats> engineShards;
     uint32_t jobQueueLength = 0;
 
     uint32_t receivePoolSize = 0;
     uint32_t sendPoolSize = 0;
+    uint32_t receivePoolResidentKb = 0;
+    uint32_t sendPoolResidentKb = 0;
     uint32_t udpSharedEndpointsSendQueue = 0;
     uint32_t udpSharedEndpointsReceiveKbps = 0;
     uint32_t udpSharedEndpointsSendKbps = 0;
 
+    // mixers with the highest 99th percentile iteration time
+    std::vector<MixerTickStats> slowestMixers;
+
     std::string describe();
 };
 
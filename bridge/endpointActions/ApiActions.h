@@ -1,9 +1,9 @@
 #pragma once
 #include "ActionContext.h"
+#include "bridge/ScopedMixerLock.h"
 #include "httpd/Request.h"
 #include "httpd/Response.h"
 #include "utils/StringTokenizer.h"
-#include <mutex>
 #include <string>
 
 namespace bridge
@@ -11,7 +11,8 @@ namespace bridge
 class Mixer;
 
 class RequestLogger;
-std::unique_lock<std::mutex> getConferenceMixer(ActionContext*, const std::string&, Mixer*&);
+ScopedMixerLock getConferenceMixer(ActionContext*, const std::string&, Mixer*&);
+ScopedMixerLock getConferenceMixer(ActionContext*, const std::string&, const std::string&, Mixer*&);
 
 httpd::Response allocateConference(ActionContext*, RequestLogger&, const httpd::Request&);
 
@@ -11,12 +11,23 @@
 
 namespace bridge
 {
-std::unique_lock<std::mutex> getConferenceMixer(ActionContext* context,
+ScopedMixerLock getConferenceMixer(ActionContext* context, const std::string& conferenceId, Mixer*& outMixer)
+{
+    auto scopedMixerLock = context->mixerManager.getMixer(conferenceId, outMixer);
+    if (!outMixer)
+    {
+        throw httpd::RequestErrorException(httpd::StatusCode::NOT_FOUND,
+            utils::format("Conference '%s' not found", conferenceId.c_str()));
+    }
+    return scopedMixerLock;
+}
+
+ScopedMixerLock getConferenceMixer(ActionContext* context,
     const std::string& conferenceId,
+    const std::string& endpointId,
     Mixer*& outMixer)
 {
-    auto scopedMixerLock = context->mixerManager.getMixer(conferenceId, outMixer);
-    assert(scopedMixerLock.owns_lock());
+    auto scopedMixerLock = context->mixerManager.getMixer(conferenceId, endpointId, outMixer);
     if (!outMixer)
     {
         throw httpd::RequestErrorException(httpd::StatusCode::NOT_FOUND,
@@ -2,9 +2,9 @@
 #include "ApiActions.h"
 #include "api/EndpointDescription.h"
 #include "bridge/RtpMap.h"
+#include "bridge/ScopedMixerLock.h"
 #include "bridge/engine/SimulcastStream.h"
 #include "bridge/engine/SsrcWhitelist.h"
-#include <mutex>
 #include <vector>
 
 namespace ice
@@ -19,8 +19,10 @@ std::pair<std::vector<ice::IceCandidate>, std::pair<std::string, std::string>> g
     const api::Transport&);
 std::pair<std::vector<ice::IceCandidate>, std::pair<std::string, std::string>> getIceCandidatesAndCredentials(
     const api::Ice& ice);
-std::unique_lock<std::mutex> getConferenceMixer(ActionContext*,
+ScopedMixerLock getConferenceMixer(ActionContext*, const std::string& conferenceId, bridge::Mixer*& outMixer);
+ScopedMixerLock getConferenceMixer(ActionContext*,
     const std::string& conferenceId,
+    const std::string& endpointId,
     bridge::Mixer*& outMixer);
 api::Candidate iceCandidateToApi(const ice::IceCandidate&);
 void addDefaultAudioProperties(api::Audio&);
@@ -267,7 +267,7 @@ httpd::Response allocateEndpoint(ActionContext* context,
             "Endpoint id must be less in length than a GUUID excluding curly braces");
     }
 
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, conferenceId, endpointId, mixer);
 
     utils::Optional<std::string> audioChannelId;
     utils::Optional<std::string> videoChannelId;
@@ -712,7 +712,7 @@ httpd::Response configureEndpoint(ActionContext* context,
     const std::string& endpointId)
 {
     Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, conferenceId, endpointId, mixer);
 
     if (endpointDescription.audio.isSet())
     {
@@ -778,7 +778,7 @@ httpd::Response reconfigureEndpoint(ActionContext* context,
     const std::string& endpointId)
 {
     Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, conferenceId, endpointId, mixer);
 
     const bool isAudioSet = endpointDescription.audio.isSet();
     const bool isVideoSet = endpointDescription.video.isSet();
@@ -904,7 +904,7 @@ httpd::Response expireEndpoint(ActionContext* context,
     const std::string& endpointId)
 {
     Mixer* mixer;
-    auto scopedMixerLock = getConferenceMixer(context, conferenceId, mixer);
+    auto scopedMixerLock = getConferenceMixer(context, conferenceId, endpointId, mixer);
 
     mixer->removeAudioStream(endpointId);
     mixer->removeVideoStream(endpointId);
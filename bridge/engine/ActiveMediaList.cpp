@@ -14,6 +14,7 @@ namespace bridge
 {
 
 const float ActiveMediaList::AudioParticipant::MIN_NOISE = 7;
+const size_t ActiveMediaList::maxRankedSpeakers;
 
 ActiveMediaList::AudioParticipant::AudioParticipant(const char* id)
     : audioLevel(0.0),
@@ -110,6 +111,8 @@ ActiveMediaList::ActiveMediaList(size_t instanceId,
       _audioSsrcRewriteMap(SsrcRewrite::ssrcArraySize * 2),
       _dominantSpeaker(0),
       _nominatedSpeaker(0),
+      _rankedSpeakerCount(0),
+      _rankedSpeakersRevision(0),
       _videoParticipants(maxParticipants),
       _videoSsrcs(SsrcRewrite::ssrcArraySize * 2),
       _videoFeedbackSsrcLookupMap(SsrcRewrite::ssrcArraySize * 2),
@@ -122,6 +125,7 @@ ActiveMediaList::ActiveMediaList(size_t instanceId,
       _lastRunTimestamp(0),
       _dominationTimestamp(0),
       _ssrcMapRevision(0),
+      _activeVideoListReorders(0),
       _transactionCounter(audioSsrcs[0])
 {
     assert(videoSsrcs.size() >= _maxActiveListSize + 2);
@@ -518,6 +522,11 @@ void ActiveMediaList::process(const uint64_t timestamp,
     size_t speakerCount = rankSpeakers();
     if (speakerCount == 0)
     {
+        if (_rankedSpeakerCount != 0)
+        {
+            _rankedSpeakerCount = 0;
+            ++_rankedSpeakersRevision;
+        }
         return;
     }
 
@@ -529,9 +538,11 @@ void ActiveMediaList::process(const uint64_t timestamp,
     auto nominatedSpeaker = heap.top();
 
     TActiveTalkersSnapshot activeTalkersSnapshot;
+    size_t rank = 0;
     for (size_t i = 0; i < _audioLastN && !heap.empty(); ++i)
     {
         const auto& top = heap.top();
+        setRankedSpeaker(rank++, top.participant);
         outAudioMapChanged |= updateActiveAudioList(top.participant);
         auto const& curParticipant = _audioParticipants.find(top.participant);
 
@@ -550,6 +561,20 @@ void ActiveMediaList::process(const uint64_t timestamp,
     }
     _activeTalkerSnapshot.write(activeTalkersSnapshot);
 
+    for (; rank < maxRankedSpeakers && !heap.empty(); heap.pop())
+    {
+        setRankedSpeaker(rank++, heap.top().participant);
+    }
+    if (rank > maxRankedSpeakers)
+    {
+        rank = maxRankedSpeakers;
+    }
+    if (rank != _rankedSpeakerCount)
+    {
+        _rankedSpeakerCount = rank;
+        ++_rankedSpeakersRevision;
+    }
+
     if (outAudioMapChanged && logger::_logLevel >= logger::Level::DBG)
     {
         logAudioList();
@@ -589,6 +614,20 @@ void ActiveMediaList::process(const uint64_t timestamp,
     }
 }
 
+void ActiveMediaList::setRankedSpeaker(const size_t rank, const size_t endpointIdHash)
+{
+    if (rank >= maxRankedSpeakers)
+    {
+        return;
+    }
+
+    if (rank >= _rankedSpeakerCount || _rankedSpeakers[rank] != endpointIdHash)
+    {
+        _rankedSpeakers[rank] = endpointIdHash;
+        ++_rankedSpeakersRevision;
+    }
+}
+
 bool ActiveMediaList::updateActiveAudioList(const size_t endpointIdHash)
 {
 #if DEBUG
@@ -665,6 +704,7 @@ bool ActiveMediaList::updateActiveVideoList(const size_t endpointIdHash)
                 _activeVideoList.pushToTail(endpointIdHash);
                 _activeVideoListLookupMap.erase(endpointIdHash);
                 _activeVideoListLookupMap.emplace(endpointIdHash, _activeVideoList.tail());
+                ++_activeVideoListReorders;
                 return true;
             }
             videoListEntry = videoListEntry->_previous;
@@ -844,6 +884,146 @@ bool ActiveMediaList::makeUserMediaMapMessage(const size_t lastN,
     return true;
 }
 
+// Same content as makeUserMediaMapMessage for an endpoint that pins no one and is not in the active video list
+bool ActiveMediaList::makeUserMediaMap(const size_t lastN, UserMediaMap& outMap) const
+{
+    outMap.count = 0;
+    if (lastN > _defaultLastN || lastN == 0)
+    {
+        assert(false);
+        return false;
+    }
+
+    const auto maxEntries = std::min(lastN, outMap.entries.size());
+    for (auto videoListEntry = _activeVideoList.tail(); videoListEntry && outMap.count < maxEntries;
+         videoListEntry = videoListEntry->_previous)
+    {
+        const auto videoEndpointIdhash = videoListEntry->_data;
+        const auto* videoParticipant = _videoParticipants.getItem(videoEndpointIdhash);
+        if (!videoParticipant)
+        {
+            continue;
+        }
+
+        auto& entry = outMap.entries[outMap.count++];
+        entry.endpointIdHash = videoEndpointIdhash;
+        entry.endpointId = videoParticipant->endpointId;
+        entry.ssrcCount = 0;
+
+        const auto rewriteMapItr = _videoSsrcRewriteMap.find(videoEndpointIdhash);
+        if (rewriteMapItr != _videoSsrcRewriteMap.end())
+        {
+            entry.ssrcs[entry.ssrcCount++] = rewriteMapItr->second[0].main;
+        }
+
+        if (_videoScreenShareSsrcMapping.isSet() && _videoScreenShareSsrcMapping.get().first == videoEndpointIdhash)
+        {
+            entry.ssrcs[entry.ssrcCount++] = _videoScreenShareSsrcMapping.get().second.rewriteSsrc;
+        }
+    }
+
+    return true;
+}
+
+void ActiveMediaList::makeUserMediaMapMessage(const UserMediaMap& map, utils::StringBuilder<1024>& outMessage)
+{
+    api::DataChannelMessage::addUserMediaMapStart(outMessage);
+    for (size_t i = 0; i < map.count; ++i)
+    {
+        const auto& entry = map.entries[i];
+        api::DataChannelMessage::addUserMediaEndpointStart(outMessage, entry.endpointId.c_str());
+        for (size_t j = 0; j < entry.ssrcCount; ++j)
+        {
+            api::DataChannelMessage::addUserMediaSsrc(outMessage, entry.ssrcs[j]);
+        }
+        api::DataChannelMessage::addUserMediaEndpointEnd(outMessage);
+    }
+    api::DataChannelMessage::addUserMediaMapEnd(outMessage);
+}
+
+namespace
+{
+const UserMediaMap::Entry* findUserMediaMapEntry(const UserMediaMap& map, const size_t endpointIdHash)
+{
+    for (size_t i = 0; i < map.count; ++i)
+    {
+        if (map.entries[i].endpointIdHash == endpointIdHash)
+        {
+            return &map.entries[i];
+        }
+    }
+    return nullptr;
+}
+} // namespace
+
+// Lists the endpoints that were added to map or whose ssrcs changed, and the endpoints that were removed from it.
+// Returns false if nothing changed.
+bool ActiveMediaList::makeUserMediaMapDeltaMessage(const UserMediaMap& previousMap,
+    const UserMediaMap& map,
+    utils::StringBuilder<1024>& outMessage)
+{
+    bool hasChanges = false;
+
+    api::DataChannelMessage::addUserMediaMapDeltaStart(outMessage);
+    for (size_t i = 0; i < map.count; ++i)
+    {
+        const auto& entry = map.entries[i];
+        const auto* previousEntry = findUserMediaMapEntry(previousMap, entry.endpointIdHash);
+        if (previousEntry && *previousEntry == entry)
+        {
+            continue;
+        }
+
+        api::DataChannelMessage::addUserMediaEndpointStart(outMessage, entry.endpointId.c_str());
+        for (size_t j = 0; j < entry.ssrcCount; ++j)
+        {
+            api::DataChannelMessage::addUserMediaSsrc(outMessage, entry.ssrcs[j]);
+        }
+        api::DataChannelMessage::addUserMediaEndpointEnd(outMessage);
+        hasChanges = true;
+    }
+
+    api::DataChannelMessage::addUserMediaMapDeltaRemovedStart(outMessage);
+    for (size_t i = 0; i < previousMap.count; ++i)
+    {
+        const auto& previousEntry = previousMap.entries[i];
+        if (!findUserMediaMapEntry(map, previousEntry.endpointIdHash))
+        {
+            api::DataChannelMessage::addUserMediaMapDeltaRemoved(outMessage, previousEntry.endpointId.c_str());
+            hasChanges = true;
+        }
+    }
+    api::DataChannelMessage::addUserMediaMapDeltaEnd(outMessage);
+
+    return hasChanges;
+}
+
+bool ActiveMediaList::isInSharedMessageRange(const size_t lastN, const size_t endpointIdHash) const
+{
+    if (!_activeVideoListLookupMap.contains(endpointIdHash))
+    {
+        return false;
+    }
+
+    // The last-n list counts every other entry, the user media map only those with a video participant. Walking
+    // until lastN video participants have been seen covers both.
+    size_t count = 0;
+    for (auto videoListEntry = _activeVideoList.tail(); videoListEntry && count < lastN;
+         videoListEntry = videoListEntry->_previous)
+    {
+        if (videoListEntry->_data == endpointIdHash)
+        {
+            return true;
+        }
+        if (_videoParticipants.contains(videoListEntry->_data))
+        {
+            ++count;
+        }
+    }
+
+    return false;
+}
+
 void ActiveMediaList::makeDominantSpeakerMessage(utils::StringBuilder<256>& outMessage)
 {
     if (_dominantSpeaker == 0)
@@ -6,6 +6,7 @@
 #include "bridge/engine/NeighbourMembership.h"
 #include "bridge/engine/SimulcastLevel.h"
 #include "bridge/engine/SimulcastStream.h"
+#include "bridge/engine/UserMediaMap.h"
 #include "concurrency/MpmcHashmap.h"
 #include "concurrency/MpmcPublish.h"
 #include "concurrency/MpmcQueue.h"
@@ -155,10 +156,34 @@ public:
         const concurrency::MpmcHashmap32<size_t, EngineVideoStream*>& engineVideoStreams,
         utils::StringBuilder<1024>& outMessage);
 
+    bool makeUserMediaMap(const size_t lastN, UserMediaMap& outMap) const;
+    static void makeUserMediaMapMessage(const UserMediaMap& map, utils::StringBuilder<1024>& outMessage);
+    static bool makeUserMediaMapDeltaMessage(const UserMediaMap& previousMap,
+        const UserMediaMap& map,
+        utils::StringBuilder<1024>& outMessage);
+
+    /**
+     * True if the last-n list or user media map of endpointIdHash may differ from the shared ones because the
+     * endpoint itself is among the entries they are made from. Pinning also makes them differ.
+     */
+    bool isInSharedMessageRange(const size_t lastN, const size_t endpointIdHash) const;
+
     bool makeBarbellUserMediaMapMessage(utils::StringBuilder<1024>& outMessage,
         const engine::EndpointMembershipsMap& membershipMap);
 
     uint32_t getMapRevision() const { return _ssrcMapRevision; }
+
+    static const size_t maxRankedSpeakers = 16;
+    /** Loudest speakers from the latest ranking, loudest first. Only valid on the engine thread. */
+    inline const size_t* getRankedSpeakers(size_t& outCount) const
+    {
+        outCount = _rankedSpeakerCount;
+        return _rankedSpeakers.data();
+    }
+    /** Changes when the set or order of ranked speakers changes. */
+    uint32_t getRankedSpeakersRevision() const { return _rankedSpeakersRevision; }
+    // Changes when the ssrc maps or the order of the active video list change, both of which affect video routing.
+    uint32_t getVideoRoutingRevision() const { return _ssrcMapRevision + _activeVideoListReorders; }
 #if DEBUG
     void checkInvariant();
 #endif
@@ -284,6 +309,11 @@ private:
     std::atomic_size_t _dominantSpeaker;
     size_t _nominatedSpeaker;
     std::array<AudioParticipantScore, maxParticipants> _highestScoringSpeakers;
+    std::array<size_t, maxRankedSpeakers> _rankedSpeakers;
+    size_t _rankedSpeakerCount;
+    uint32_t _rankedSpeakersRevision;
+
+    void setRankedSpeaker(const size_t rank, const size_t endpointIdHash);
 
     concurrency::MpmcHashmap32<size_t, VideoParticipant> _videoParticipants;
     concurrency::MpmcQueue<api::SimulcastGroup> _videoSsrcs;
@@ -303,6 +333,7 @@ private:
     uint64_t _dominationTimestamp;
     uint64_t _nominationTimestamp;
     uint32_t _ssrcMapRevision;
+    uint32_t _activeVideoListReorders;
     uint32_t _transactionCounter;
 
     size_t rankSpeakers();
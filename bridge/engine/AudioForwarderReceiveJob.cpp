@@ -34,7 +34,7 @@ void AudioForwarderReceiveJob::onPacketDecoded(const int32_t decodedFrames, cons
     logger::error("Unable to decode opus packet, error code %d", "OpusDecodeJob", decodedFrames);
 }
 
-void AudioForwarderReceiveJob::decodeOpus(const memory::Packet& opusPacket)
+void AudioForwarderReceiveJob::decodeOpus(const memory::Packet& opusPacket, const bool reportAudioLevel)
 {
     if (!_ssrcContext.opusDecoder)
     {
@@ -96,6 +96,13 @@ void AudioForwarderReceiveJob::decodeOpus(const memory::Packet& opusPacket)
 
     const auto decodedFrames =
         decoder.decode(_extendedSequenceNumber, payloadStart, payloadLength, decodedData, framesInPacketBuffer);
+
+    if (reportAudioLevel && decodedFrames > 0)
+    {
+        const auto audioLevel = _ssrcContext.voiceActivityDetector.onFrame(reinterpret_cast<int16_t*>(decodedData),
+            decodedFrames * codec::Opus::channelsPerFrame);
+        _activeMediaList.onNewAudioLevel(_packet->endpointIdHash, audioLevel, false);
+    }
     onPacketDecoded(decodedFrames, decodedData);
 }
 
@@ -129,14 +136,15 @@ void AudioForwarderReceiveJob::run()
         return;
     }
 
+    const bool decodeAudio = _hasMixedAudioStreams && _ssrcContext.rtpMap.format == bridge::RtpMap::Format::OPUS;
     bool silence = false;
+    utils::Optional<uint8_t> audioLevel;
     const auto rtpHeaderExtensions = rtpHeader->getExtensionHeader();
     if (rtpHeaderExtensions)
     {
         auto c9infoExtId = _ssrcContext.rtpMap.c9infoExtId.valueOr(0);
         auto audioLevelExtId = _ssrcContext.rtpMap.audioLevelExtId.valueOr(0);
 
-        utils::Optional<uint8_t> audioLevel;
         utils::Optional<bool> isPtt;
         uint32_t c9UserId = 0;
 
@@ -173,9 +181,12 @@ void AudioForwarderReceiveJob::run()
             _engineMixer.mapSsrc2UserId(_ssrcContext.ssrc, c9UserId);
         }
 
-        _activeMediaList.onNewAudioLevel(_packet->endpointIdHash,
-            audioLevel.valueOr(120),
-            isPtt.isSet() && isPtt.get());
+        if (audioLevel.isSet() || !decodeAudio)
+        {
+            _activeMediaList.onNewAudioLevel(_packet->endpointIdHash,
+                audioLevel.valueOr(120),
+                isPtt.isSet() && isPtt.get());
+        }
 
         if (silence)
         {
@@ -213,9 +224,21 @@ void AudioForwarderReceiveJob::run()
     }
     _ssrcContext.lastUnprotectedExtendedSequenceNumber = _extendedSequenceNumber;
 
-    if (_hasMixedAudioStreams && _ssrcContext.rtpMap.format == bridge::RtpMap::Format::OPUS)
+    if (decodeAudio && audioLevel.isSet() && !_ssrcContext.decodeSelected.load(std::memory_order_relaxed))
     {
-        decodeOpus(*_packet);
+        // Not among the loudest speakers. The level from the header keeps the sender ranked without decoding.
+        _ssrcContext.decodeSkipped = true;
+    }
+    else if (decodeAudio)
+    {
+        if (_ssrcContext.decodeSkipped)
+        {
+            // restart the decoder rather than concealing all packets that were skipped
+            _ssrcContext.opusDecoder.reset();
+            _ssrcContext.decodeSkipped = false;
+        }
+        // without level in the header the level is taken from the decoded audio
+        decodeOpus(*_packet, !audioLevel.isSet());
     }
 
     if (_ssrcContext.markNextPacket && !silence)
@@ -36,7 +36,7 @@ public:
     void run() override;
 
 private:
-    void decodeOpus(const memory::Packet& opusPacket);
+    void decodeOpus(const memory::Packet& opusPacket, const bool reportAudioLevel);
     void onPacketDecoded(const int32_t decodedFrames, const uint8_t* decodedData);
 
     memory::UniquePacket _packet;
@@ -41,7 +41,7 @@ namespace bridge
 
 AudioForwarderRewriteAndSendJob::AudioForwarderRewriteAndSendJob(SsrcOutboundContext& outboundContext,
     SsrcInboundContext& senderInboundContext,
-    memory::UniquePacket packet,
+    memory::SharedPacket packet,
     const uint32_t extendedSequenceNumber,
     transport::Transport& transport)
     : jobmanager::CountedJob(transport.getJobCounter()),
@@ -57,29 +57,39 @@ AudioForwarderRewriteAndSendJob::AudioForwarderRewriteAndSendJob(SsrcOutboundCon
 
 void AudioForwarderRewriteAndSendJob::run()
 {
-    auto header = rtp::RtpHeader::fromPacket(*_packet);
-    if (!header)
+    const auto* inboundHeader = rtp::RtpHeader::fromPacket(*_packet);
+    if (!inboundHeader)
     {
         return;
     }
 
-    if (!_outboundContext.shouldSend(header->ssrc.get(), _extendedSequenceNumber))
+    if (!_outboundContext.shouldSend(inboundHeader->ssrc.get(), _extendedSequenceNumber))
     {
         logger::warn("%s dropping packet ssrc %u, seq %u, timestamp %u, last sent seq %u, offset %d",
             "AudioForwarderRewriteAndSendJob",
             _transport.getLoggableId().c_str(),
-            header->ssrc.get(),
+            inboundHeader->ssrc.get(),
             _extendedSequenceNumber,
-            header->timestamp.get(),
+            inboundHeader->timestamp.get(),
             _outboundContext.rewrite.lastSent.sequenceNumber,
             _outboundContext.rewrite.offset.sequenceNumber);
         return;
     }
 
+    auto packet = _packet.makeWritable(_outboundContext.allocator);
+    if (!packet)
+    {
+        logger::warn("%s send allocator depleted",
+            "AudioForwarderRewriteAndSendJob",
+            _transport.getLoggableId().c_str());
+        return;
+    }
+    auto header = rtp::RtpHeader::fromPacket(*packet);
+
     bridge::AudioRewriter::rewrite(_outboundContext, _extendedSequenceNumber, *header);
 
     rewriteHeaderExtensions(*header, _senderInboundContext, _outboundContext);
-    _transport.protectAndSend(std::move(_packet));
+    _transport.protectAndSend(std::move(packet));
 }
 
 } // namespace bridge
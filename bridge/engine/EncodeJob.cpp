@@ -5,16 +5,71 @@
 #include "codec/OpusEncoder.h"
 #include "memory/Packet.h"
 #include "rtp/RtpHeader.h"
+#include <cstring>
 
 namespace bridge
 {
 
+namespace
+{
+
+memory::UniquePacket createOpusPacket(SsrcOutboundContext& outboundContext, const int audioLevel)
+{
+    auto opusPacket = memory::makeUniquePacket(outboundContext.allocator);
+    if (!opusPacket)
+    {
+        return opusPacket;
+    }
+
+    auto opusHeader = rtp::RtpHeader::create(*opusPacket);
+
+    rtp::RtpHeaderExtension extensionHead(opusHeader->getExtensionHeader());
+    auto cursor = extensionHead.extensions().begin();
+    if (outboundContext.rtpMap.absSendTimeExtId.isSet())
+    {
+        rtp::GeneralExtension1Byteheader absSendTime(outboundContext.rtpMap.absSendTimeExtId.get(), 3);
+        extensionHead.addExtension(cursor, absSendTime);
+    }
+    if (outboundContext.rtpMap.audioLevelExtId.isSet())
+    {
+        rtp::GeneralExtension1Byteheader audioLevelExtension(outboundContext.rtpMap.audioLevelExtId.get(), 1);
+        audioLevelExtension.data[0] = audioLevel;
+        extensionHead.addExtension(cursor, audioLevelExtension);
+    }
+    if (!extensionHead.empty())
+    {
+        opusHeader->setExtensions(extensionHead);
+        opusPacket->setLength(opusHeader->headerLength());
+    }
+
+    return opusPacket;
+}
+
+void sendOpusPacket(memory::UniquePacket opusPacket,
+    const size_t payloadLength,
+    SsrcOutboundContext& outboundContext,
+    transport::Transport& transport,
+    const uint64_t rtpTimestamp)
+{
+    auto opusHeader = rtp::RtpHeader::fromPacket(*opusPacket);
+    opusPacket->setLength(opusHeader->headerLength() + payloadLength);
+    opusHeader->ssrc = outboundContext.ssrc;
+    opusHeader->timestamp = (rtpTimestamp * 48llu) & 0xFFFFFFFFllu;
+    opusHeader->sequenceNumber = ++outboundContext.rewrite.lastSent.sequenceNumber & 0xFFFFu;
+    opusHeader->payloadType = outboundContext.rtpMap.payloadType;
+    transport.protectAndSend(std::move(opusPacket));
+}
+
+} // namespace
+
 EncodeJob::EncodeJob(memory::UniqueAudioPacket packet,
+    memory::UniqueAudioPacket primer,
     SsrcOutboundContext& outboundContext,
     transport::Transport& transport,
     const uint64_t rtpTimestamp)
     : jobmanager::CountedJob(transport.getJobCounter()),
       _packet(std::move(packet)),
+      _primer(std::move(primer)),
       _outboundContext(outboundContext),
       _transport(transport),
       _rtpTimestamp(rtpTimestamp)
@@ -34,37 +89,33 @@ void EncodeJob::run()
     auto& targetFormat = _outboundContext.rtpMap;
     if (targetFormat.format == bridge::RtpMap::Format::OPUS)
     {
-        if (!_outboundContext.opusEncoder)
+        if (!_outboundContext.opusEncoder || _primer)
         {
             _outboundContext.opusEncoder.reset(new codec::OpusEncoder());
         }
 
-        auto opusPacket = memory::makeUniquePacket(_outboundContext.allocator);
+        const auto audioLevel = targetFormat.audioLevelExtId.isSet() ? codec::computeAudioLevel(*_packet) : 0;
+        auto opusPacket = createOpusPacket(_outboundContext, audioLevel);
         if (!opusPacket)
         {
             logger::error("failed to make packet for opus encoded data", "OpusEncodeJob");
             return;
         }
 
-        auto opusHeader = rtp::RtpHeader::create(*opusPacket);
-
-        rtp::RtpHeaderExtension extensionHead(opusHeader->getExtensionHeader());
-        auto cursor = extensionHead.extensions().begin();
-        if (_outboundContext.rtpMap.absSendTimeExtId.isSet())
-        {
-            rtp::GeneralExtension1Byteheader absSendTime(_outboundContext.rtpMap.absSendTimeExtId.get(), 3);
-            extensionHead.addExtension(cursor, absSendTime);
-        }
-        if (_outboundContext.rtpMap.audioLevelExtId.isSet())
-        {
-            rtp::GeneralExtension1Byteheader audioLevel(_outboundContext.rtpMap.audioLevelExtId.get(), 1);
-            audioLevel.data[0] = codec::computeAudioLevel(*_packet);
-            extensionHead.addExtension(cursor, audioLevel);
-        }
-        if (!extensionHead.empty())
+        auto opusHeader = rtp::RtpHeader::fromPacket(*opusPacket);
+        if (_primer)
         {
-            opusHeader->setExtensions(extensionHead);
-            opusPacket->setLength(opusHeader->headerLength());
+            const auto primerHeader = rtp::RtpHeader::fromPacket(*_primer);
+            if (primerHeader)
+            {
+                const uint32_t primerLength = _primer->getLength() - primerHeader->headerLength();
+                // output is overwritten by the actual frame below
+                _outboundContext.opusEncoder->encode(reinterpret_cast<int16_t*>(primerHeader->getPayload()),
+                    primerLength / EngineMixer::bytesPerSample / EngineMixer::channelsPerFrame,
+                    opusHeader->getPayload(),
+                    opusPacket->size - opusHeader->headerLength());
+            }
+            _primer.reset();
         }
 
         const uint32_t payloadLength = _packet->getLength() - pcm16Header->headerLength();
@@ -82,12 +133,7 @@ void EncodeJob::run()
             return;
         }
 
-        opusPacket->setLength(opusHeader->headerLength() + encodedBytes);
-        opusHeader->ssrc = _outboundContext.ssrc;
-        opusHeader->timestamp = (_rtpTimestamp * 48llu) & 0xFFFFFFFFllu;
-        opusHeader->sequenceNumber = ++_outboundContext.rewrite.lastSent.sequenceNumber & 0xFFFFu;
-        opusHeader->payloadType = targetFormat.payloadType;
-        _transport.protectAndSend(std::move(opusPacket));
+        sendOpusPacket(std::move(opusPacket), encodedBytes, _outboundContext, _transport, _rtpTimestamp);
     }
     else
     {
@@ -96,4 +142,48 @@ void EncodeJob::run()
     }
 }
 
+SendEncodedAudioJob::SendEncodedAudioJob(const memory::SharedPacket& opusPayload,
+    const int audioLevel,
+    SsrcOutboundContext& outboundContext,
+    transport::Transport& transport,
+    const uint64_t rtpTimestamp)
+    : jobmanager::CountedJob(transport.getJobCounter()),
+      _opusPayload(opusPayload),
+      _audioLevel(audioLevel),
+      _outboundContext(outboundContext),
+      _transport(transport),
+      _rtpTimestamp(rtpTimestamp)
+{
+    assert(_opusPayload);
+}
+
+void SendEncodedAudioJob::run()
+{
+    auto& targetFormat = _outboundContext.rtpMap;
+    if (targetFormat.format != bridge::RtpMap::Format::OPUS)
+    {
+        logger::warn("Unknown target format %u", "SendEncodedAudioJob", static_cast<uint16_t>(targetFormat.format));
+        return;
+    }
+
+    auto opusPacket = createOpusPacket(_outboundContext, _audioLevel);
+    if (!opusPacket)
+    {
+        logger::error("failed to make packet for opus encoded data", "SendEncodedAudioJob");
+        return;
+    }
+
+    auto opusHeader = rtp::RtpHeader::fromPacket(*opusPacket);
+    const auto payloadLength = _opusPayload->getLength();
+    if (opusHeader->headerLength() + payloadLength > opusPacket->size)
+    {
+        logger::error("encoded audio does not fit, %zu", "SendEncodedAudioJob", payloadLength);
+        return;
+    }
+
+    std::memcpy(opusHeader->getPayload(), _opusPayload->get(), payloadLength);
+    _opusPayload.reset();
+    sendOpusPacket(std::move(opusPacket), payloadLength, _outboundContext, _transport, _rtpTimestamp);
+}
+
 } // namespace bridge
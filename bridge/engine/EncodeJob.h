@@ -2,6 +2,7 @@
 
 #include "jobmanager/Job.h"
 #include "memory/AudioPacketPoolAllocator.h"
+#include "memory/SharedPacket.h"
 #include <cstdint>
 
 namespace transport
@@ -14,10 +15,15 @@ namespace bridge
 
 class SsrcOutboundContext;
 
+/**
+ * Encodes a pcm packet with the receiver's own opus encoder. If a primer is given, the encoder is restarted and fed the
+ * primer first. That is the audio the receiver last got from another encoder, which the new encoder then continues.
+ */
 class EncodeJob : public jobmanager::CountedJob
 {
 public:
     EncodeJob(memory::UniqueAudioPacket packet,
+        memory::UniqueAudioPacket primer,
         SsrcOutboundContext& outboundContext,
         transport::Transport& transport,
         const uint64_t rtpTimestamp);
@@ -26,6 +32,30 @@ public:
 
 private:
     memory::UniqueAudioPacket _packet;
+    memory::UniqueAudioPacket _primer;
+    SsrcOutboundContext& _outboundContext;
+    transport::Transport& _transport;
+    uint64_t _rtpTimestamp;
+};
+
+/**
+ * Sends an opus payload that was encoded once for several receivers. Each receiver gets its own rtp header with the
+ * header extensions, ssrc and sequence numbers of its outbound context.
+ */
+class SendEncodedAudioJob : public jobmanager::CountedJob
+{
+public:
+    SendEncodedAudioJob(const memory::SharedPacket& opusPayload,
+        const int audioLevel,
+        SsrcOutboundContext& outboundContext,
+        transport::Transport& transport,
+        const uint64_t rtpTimestamp);
+
+    void run() override;
+
+private:
+    memory::SharedPacket _opusPayload;
+    int _audioLevel;
     SsrcOutboundContext& _outboundContext;
     transport::Transport& _transport;
     uint64_t _rtpTimestamp;
@@ -26,6 +26,8 @@ Engine::Engine(jobmanager::JobManager& backgroundJobQueue)
     : _messageListener(nullptr),
       _running(true),
       _tickCounter(0),
+      _mixerCount(0),
+      _busyTime(0),
       _tasks(1024),
       _thread([this] { this->run(); })
 {
@@ -40,6 +42,11 @@ void Engine::setMessageListener(MixerManagerAsync* messageListener)
     _messageListener = messageListener;
 }
 
+bool Engine::setCpuAffinity(const std::vector<uint32_t>& cpus)
+{
+    return concurrency::setCpuAffinity(_thread, cpus);
+}
+
 void Engine::stop()
 {
     _running = false;
@@ -67,11 +74,15 @@ void Engine::run()
         }
         pacer.tick(timestamp);
 
+        const uint64_t tickStart = timestamp;
+        const auto tickStartCycles = utils::Time::getCycleCount();
         for (auto mixerEntry = _mixers.head(); mixerEntry; mixerEntry = mixerEntry->_next)
         {
             assert(mixerEntry->_data);
             mixerEntry->_data->run(timestamp);
         }
+        currentStatSample.tickTime.add(
+            utils::Time::cyclesToNs(utils::Time::getCycleCount() - tickStartCycles) / utils::Time::us);
 
         if (++_tickCounter % STATS_UPDATE_TICKS == 0)
         {
@@ -80,11 +91,13 @@ void Engine::run()
 
         // process tasks and forward packets until next tick is near
         timestamp = utils::Time::getAbsoluteTime();
+        _busyTime += timestamp - tickStart;
         int64_t toSleep = pacer.timeToNextTick(timestamp);
         int64_t nextForwardCycle = toSleep - utils::Time::ms;
         while (toSleep > IDLE_MARGIN)
         {
             // forward packets every ms
+            const uint64_t workStart = timestamp;
             if (toSleep < nextForwardCycle && toSleep >= static_cast<int64_t>(utils::Time::ms))
             {
                 for (auto mixerEntry = _mixers.head(); mixerEntry; mixerEntry = mixerEntry->_next)
@@ -97,6 +110,7 @@ void Engine::run()
 
             const auto pendingTasks = processTasks(128);
             timestamp = utils::Time::getAbsoluteTime();
+            _busyTime += timestamp - workStart;
             toSleep = pacer.timeToNextTick(timestamp);
             if (!pendingTasks && toSleep > 0)
             {
@@ -144,8 +158,14 @@ void Engine::updateStats(uint64_t& statsPollTime, EngineStats::EngineStats& curr
 
     currentStatSample.pollPeriodMs =
         static_cast<uint32_t>(std::max(uint64_t(1), (pollTime - statsPollTime) / uint64_t(1000000)));
+    currentStatSample.mixers = _mixerCount;
+    currentStatSample.load =
+        std::min(1.0, static_cast<double>(_busyTime) / std::max(uint64_t(1), pollTime - statsPollTime));
+    currentStatSample.maxLoad = currentStatSample.load;
     _stats.write(currentStatSample);
     statsPollTime = pollTime;
+    _busyTime = 0;
+    currentStatSample.tickTime = EngineStats::LatencyHistogram();
 }
 
 void Engine::addMixer(EngineMixer* engineMixer)
@@ -155,7 +175,9 @@ void Engine::addMixer(EngineMixer* engineMixer)
     {
         logger::error("Unable to add EngineMixer %s to Engine", "Engine", engineMixer->getLoggableId().c_str());
         _messageListener->asyncEngineMixerRemoved(*engineMixer);
+        return;
     }
+    ++_mixerCount;
 }
 
 void Engine::removeMixer(EngineMixer* engineMixer)
@@ -166,6 +188,10 @@ void Engine::removeMixer(EngineMixer* engineMixer)
     {
         logger::error("Unable to remove EngineMixer %s from Engine", "Engine", engineMixer->getLoggableId().c_str());
     }
+    else
+    {
+        --_mixerCount;
+    }
 
     _messageListener->asyncEngineMixerRemoved(*engineMixer);
 }
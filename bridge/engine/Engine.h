@@ -9,6 +9,7 @@
 #include "utils/Trackers.h"
 #include <sys/types.h>
 #include <thread>
+#include <vector>
 
 namespace jobmanager
 {
@@ -29,6 +30,7 @@ public:
     Engine(jobmanager::JobManager& backgroundJobQueue);
 
     void setMessageListener(MixerManagerAsync* messageListener);
+    bool setCpuAffinity(const std::vector<uint32_t>& cpus);
     void stop();
     void run();
 
@@ -52,6 +54,8 @@ private:
 
     concurrency::MpmcPublish<EngineStats::EngineStats, 4> _stats;
     uint32_t _tickCounter;
+    uint32_t _mixerCount;
+    uint64_t _busyTime;
 
     concurrency::MpmcQueue<utils::Function> _tasks;
 
@@ -38,7 +38,9 @@ struct EngineAudioStream
           rtpMap(rtpMap),
           ssrcRewrite(ssrcRewrite),
           idleTimeoutSeconds(idleTimeoutSeconds),
-          createdAt(utils::Time::getAbsoluteTime())
+          createdAt(utils::Time::getAbsoluteTime()),
+          sharedMixReceiver(false),
+          lastMixFrame(0)
     {
         for (auto& neighbour : neighbourList)
         {
@@ -61,6 +63,10 @@ struct EngineAudioStream
     const uint64_t createdAt;
 
     memory::Map<uint32_t, bool, MAX_NEIGHBOUR_COUNT> neighbours;
+
+    // engine thread only. See MixEncoder
+    bool sharedMixReceiver; // last packet came from the shared mix encoder
+    uint64_t lastMixFrame; // last MixEncoder frame that sends to this stream
 };
 
 } // namespace bridge
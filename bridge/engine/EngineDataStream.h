@@ -21,6 +21,8 @@ struct EngineDataStream
           transport(transport),
           stream(transport.getId(), transport),
           hasSeenInitialSpeakerList(false),
+          userMediaMapDelta(false),
+          userMediaMapVersion(0),
           idleTimeoutSeconds(idleTimeoutSeconds),
           createdAt(utils::Time::getAbsoluteTime())
     {
@@ -31,6 +33,8 @@ struct EngineDataStream
     transport::RtcTransport& transport;
     webrtc::WebRtcDataStream stream;
     bool hasSeenInitialSpeakerList;
+    bool userMediaMapDelta; // endpoint accepts UserMediaMapDelta messages
+    uint32_t userMediaMapVersion; // version of the shared user media map it last received, 0 if another map
     const uint32_t idleTimeoutSeconds;
     const uint64_t createdAt;
 };
@@ -14,6 +14,7 @@
 #include "bridge/engine/EngineRecordingStream.h"
 #include "bridge/engine/EngineStreamDirector.h"
 #include "bridge/engine/EngineVideoStream.h"
+#include "bridge/engine/MixEncoder.h"
 #include "bridge/engine/ProcessMissingVideoPacketsJob.h"
 #include "bridge/engine/ProcessUnackedRecordingEventPacketsJob.h"
 #include "bridge/engine/RecordingAudioForwarderSendJob.h"
@@ -66,38 +67,21 @@ memory::UniquePacket createGoodBye(uint32_t ssrc, memory::PacketPoolAllocator& a
     return packet;
 }
 
-class RemovePacketCacheJob : public jobmanager::CountedJob
+// Releases the retransmission state on the transport thread, and with it possibly the last reference to a
+// VideoPacketStore, so the engine thread does not have to.
+class RemoveRtxRewriteMapJob : public jobmanager::CountedJob
 {
 public:
-    RemovePacketCacheJob(bridge::EngineMixer& mixer,
-        transport::Transport& transport,
-        bridge::SsrcOutboundContext& outboundContext,
-        bridge::MixerManagerAsync& mixerManager)
+    RemoveRtxRewriteMapJob(transport::Transport& transport, bridge::SsrcOutboundContext& outboundContext)
         : CountedJob(transport.getJobCounter()),
-          _mixer(mixer),
-          _outboundContext(outboundContext),
-          _mixerManager(mixerManager),
-          _endpointIdHash(transport.getEndpointIdHash())
+          _outboundContext(outboundContext)
     {
     }
 
-    void run() override
-    {
-        if (_outboundContext.packetCache.isSet() && _outboundContext.packetCache.get())
-        {
-            const auto posted = _mixerManager.asyncFreeVideoPacketCache(_mixer, _outboundContext.ssrc, _endpointIdHash);
-            if (posted)
-            {
-                _outboundContext.packetCache.clear();
-            }
-        }
-    }
+    void run() override { _outboundContext.rtxRewriteMap.reset(); }
 
 private:
-    bridge::EngineMixer& _mixer;
     bridge::SsrcOutboundContext& _outboundContext;
-    bridge::MixerManagerAsync& _mixerManager;
-    size_t _endpointIdHash;
 };
 
 class FinalizeNonSsrcRewriteOutboundContextJob : public jobmanager::CountedJob
@@ -107,14 +91,12 @@ public:
         transport::RtcTransport& transport,
         bridge::SsrcOutboundContext& outboundContext,
         concurrency::SynchronizationContext& engineSyncContext,
-        bridge::MixerManagerAsync& mixerManager,
         uint32_t feedbackSsrc)
         : CountedJob(transport.getJobCounter()),
           _mixer(mixer),
           _outboundContext(outboundContext),
           _transport(transport),
           _engineSyncContext(engineSyncContext),
-          _mixerManager(mixerManager),
           _feedbackSsrc(feedbackSsrc)
     {
     }
@@ -130,11 +112,7 @@ public:
             _transport.protectAndSend(std::move(packet));
         }
 
-        if (_outboundContext.packetCache.isSet() && _outboundContext.packetCache.get())
-        {
-            // Run RemovePacketCacheJob inside of this job
-            RemovePacketCacheJob(_mixer, _transport, _outboundContext, _mixerManager).run();
-        }
+        _outboundContext.rtxRewriteMap.reset();
 
         _transport.removeSrtpLocalSsrc(ssrc);
 
@@ -148,7 +126,6 @@ private:
     bridge::SsrcOutboundContext& _outboundContext;
     transport::RtcTransport& _transport;
     concurrency::SynchronizationContext& _engineSyncContext;
-    bridge::MixerManagerAsync& _mixerManager;
     uint32_t _feedbackSsrc;
 };
 
@@ -253,6 +230,7 @@ EngineMixer::EngineMixer(const std::string& id,
     const uint32_t localVideoSsrc,
     const config::Config& config,
     memory::PacketPoolAllocator& sendAllocator,
+    memory::SharedPacketAllocator& sharedPacketAllocator,
     memory::AudioPacketPoolAllocator& audioAllocator,
     const std::vector<uint32_t>& audioSsrcs,
     const std::vector<api::SimulcastGroup>& videoSsrcs,
@@ -268,6 +246,11 @@ EngineMixer::EngineMixer(const std::string& id,
       _incomingMixerAudioRtp(maxPendingPackets),
       _incomingRtcp(maxPendingRtcpPackets),
       _incomingForwarderVideoRtp(maxPendingPackets),
+      _videoRoutes(maxSsrcs),
+      _videoForwardTargetsCached(0),
+      _videoRoutesGeneration(0),
+      _videoRoutesDirectorRevision(0),
+      _videoRoutesMediaListRevision(0),
       _engineAudioStreams(maxStreamsPerModality),
       _engineVideoStreams(maxStreamsPerModality),
       _engineDataStreams(maxStreamsPerModality),
@@ -280,6 +263,7 @@ EngineMixer::EngineMixer(const std::string& id,
       _localVideoSsrc(localVideoSsrc),
       _rtpTimestampSource(1000),
       _sendAllocator(sendAllocator),
+      _sharedPacketAllocator(sharedPacketAllocator),
       _audioAllocator(audioAllocator),
       _lastReceiveTime(utils::Time::getAbsoluteTime()),
       _engineStreamDirector(std::make_unique<EngineStreamDirector>(_loggableId.getInstanceId(), config, lastN)),
@@ -294,6 +278,7 @@ EngineMixer::EngineMixer(const std::string& id,
       _config(config),
       _lastN(lastN),
       _numMixedAudioStreams(0),
+      _userMediaMapVersion(1),
       _lastVideoBandwidthCheck(0),
       _lastVideoPacketProcessed(0),
       _lastTickJobStartTimestamp(0),
@@ -302,12 +287,18 @@ EngineMixer::EngineMixer(const std::string& id,
       _minUplinkEstimate(0),
       _backgroundJobQueue(backgroundJobQueue),
       _lastRecordingAckProcessed(utils::Time::getAbsoluteTime()),
+      _decodeSelectionRevision(0),
+      _lastDecodeSelectionUpdate(0),
       _slidesPresent(false)
 {
     assert(audioSsrcs.size() <= SsrcRewrite::ssrcArraySize);
     assert(videoSsrcs.size() <= SsrcRewrite::ssrcArraySize);
 
     memset(_mixedData, 0, samplesPerIteration * sizeof(int16_t));
+    memset(_tickPhaseCycles, 0, sizeof(_tickPhaseCycles));
+    _audioForwardTargets.reserve(maxStreamsPerModality);
+    _videoForwardTargets.reserve(maxStreamsPerModality);
+    _mixEncoder = std::make_unique<MixEncoder>(_jobManager, _sendAllocator, _sharedPacketAllocator);
 }
 
 EngineMixer::~EngineMixer() {}
@@ -479,10 +470,8 @@ void EngineMixer::removeStream(const EngineVideoStream* engineVideoStream)
     {
         if (!ssrcOutboundContextPair.second.markedForDeletion)
         {
-            engineVideoStream->transport.getJobQueue().addJob<RemovePacketCacheJob>(*this,
-                engineVideoStream->transport,
-                ssrcOutboundContextPair.second,
-                _messageListener);
+            engineVideoStream->transport.getJobQueue().addJob<RemoveRtxRewriteMapJob>(engineVideoStream->transport,
+                ssrcOutboundContextPair.second);
         }
     }
 
@@ -763,39 +752,7 @@ void EngineMixer::reconfigureVideoStream(const transport::RtcTransport& transpor
     sendVideoStreamToRecording(*engineVideoStream, true);
 
     engineVideoStream->ssrcWhitelist = ssrcWhitelist;
-}
-
-void EngineMixer::addVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash, PacketCache* videoPacketCache)
-{
-    transport::RtcTransport* transport = nullptr;
-    bridge::SsrcOutboundContext* ssrcContext = nullptr;
-    auto* videoStream = _engineVideoStreams.getItem(endpointIdHash);
-    if (videoStream)
-    {
-        ssrcContext = videoStream->ssrcOutboundContexts.getItem(ssrc);
-        transport = &videoStream->transport;
-    }
-    else
-    {
-        auto* barbell = _engineBarbells.getItem(endpointIdHash);
-        if (barbell)
-        {
-            ssrcContext = barbell->ssrcOutboundContexts.getItem(ssrc);
-            transport = &barbell->transport;
-        }
-    }
-
-    if (ssrcContext && transport)
-    {
-        if (!transport->getJobQueue().addJob<AddPacketCacheJob>(*transport, *ssrcContext, videoPacketCache))
-        {
-            logger::warn("JobQueue full. Failed to add packet cache to %zu, ssrc %u, %s",
-                _loggableId.c_str(),
-                endpointIdHash,
-                ssrc,
-                transport->getLoggableId().c_str());
-        }
-    }
+    _engineStreamDirector->invalidateRouting();
 }
 
 void EngineMixer::addAudioBuffer(const uint32_t ssrc, AudioBuffer* audioBuffer)
@@ -990,19 +947,26 @@ void EngineMixer::forwardPackets(const uint64_t engineTimestamp)
 void EngineMixer::run(const uint64_t engineIterationStartTimestamp)
 {
     _rtpTimestampSource += framesPerIteration1kHz;
+    const auto tickStart = utils::Time::getCycleCount();
+    auto phaseStart = tickStart;
 
     // 1. Process all incoming packets
     processBarbellSctp(engineIterationStartTimestamp);
     forwardPackets(engineIterationStartTimestamp);
+    phaseStart = recordTickPhase(EngineStats::TickPhase::INCOMING, phaseStart);
     processIncomingRtcpPackets(engineIterationStartTimestamp);
+    phaseStart = recordTickPhase(EngineStats::TickPhase::RTCP, phaseStart);
 
     // 2. Check for stale streams
     checkPacketCounters(engineIterationStartTimestamp);
+    phaseStart = recordTickPhase(EngineStats::TickPhase::MAINTENANCE, phaseStart);
 
     runDominantSpeakerCheck(engineIterationStartTimestamp);
+    phaseStart = recordTickPhase(EngineStats::TickPhase::DOMINANT_SPEAKER, phaseStart);
     sendMessagesToNewDataStreams();
     markSsrcsInUse(engineIterationStartTimestamp);
     processMissingPackets(engineIterationStartTimestamp); // must run after checkPacketCounters
+    phaseStart = recordTickPhase(EngineStats::TickPhase::MAINTENANCE, phaseStart);
 
     // 3. Update bandwidth estimates
     if (_config.rctl.useUplinkEstimate)
@@ -1010,17 +974,40 @@ void EngineMixer::run(const uint64_t engineIterationStartTimestamp)
         checkIfRateControlIsNeeded(engineIterationStartTimestamp);
         updateDirectorUplinkEstimates(engineIterationStartTimestamp);
         checkVideoBandwidth(engineIterationStartTimestamp);
+        phaseStart = recordTickPhase(EngineStats::TickPhase::BANDWIDTH, phaseStart);
     }
 
     // 4. Perform audio mixing
     mixSsrcBuffers();
     processAudioStreams();
+    phaseStart = recordTickPhase(EngineStats::TickPhase::MIXING, phaseStart);
 
     // 5. Check if Transports are alive
     removeIdleStreams(engineIterationStartTimestamp);
+    phaseStart = recordTickPhase(EngineStats::TickPhase::MAINTENANCE, phaseStart);
 
     // 6. Maintain transports.
     runTransportTicks(engineIterationStartTimestamp);
+    phaseStart = recordTickPhase(EngineStats::TickPhase::TRANSPORT_TICKS, phaseStart);
+
+    for (size_t i = 0; i < EngineStats::TickProfile::phaseCount; ++i)
+    {
+        _tickProfile.phases[i].add(utils::Time::cyclesToNs(_tickPhaseCycles[i]) / utils::Time::us);
+        _tickPhaseCycles[i] = 0;
+    }
+    _tickProfile.total.add(utils::Time::cyclesToNs(phaseStart - tickStart) / utils::Time::us);
+}
+
+uint64_t EngineMixer::recordTickPhase(const EngineStats::TickPhase phase, const uint64_t phaseStart)
+{
+    const auto now = utils::Time::getCycleCount();
+    _tickPhaseCycles[static_cast<size_t>(phase)] += now - phaseStart;
+    return now;
+}
+
+bool EngineMixer::getTickProfile(EngineStats::TickProfile& profile) const
+{
+    return _publishedTickProfile.read(profile);
 }
 
 void EngineMixer::processMissingPackets(const uint64_t timestamp)
@@ -1068,6 +1055,54 @@ void EngineMixer::runDominantSpeakerCheck(const uint64_t engineIterationStartTim
     {
         sendUserMediaMapMessageOverBarbells();
     }
+
+    updateMixedDecodeSelection(engineIterationStartTimestamp);
+}
+
+/**
+ * With a mixed decode limit only the loudest speakers are decoded and mixed. The next few in rank are decoded but not
+ * mixed, so their buffers are filled when they move up. The selection is refreshed when the ranking changes and
+ * periodically to pick up new inbound contexts.
+ */
+void EngineMixer::updateMixedDecodeSelection(const uint64_t timestamp)
+{
+    const auto decodeLimit = _config.audio.mixedDecodeLimit.get();
+    if (decodeLimit == 0 || _numMixedAudioStreams == 0)
+    {
+        return;
+    }
+
+    const auto revision = _activeMediaList->getRankedSpeakersRevision();
+    if (revision == _decodeSelectionRevision &&
+        utils::Time::diffLT(_lastDecodeSelectionUpdate, timestamp, utils::Time::sec))
+    {
+        return;
+    }
+    _decodeSelectionRevision = revision;
+    _lastDecodeSelectionUpdate = timestamp;
+
+    size_t rankedCount = 0;
+    const auto* rankedSpeakers = _activeMediaList->getRankedSpeakers(rankedCount);
+    const auto decodeCount = std::min<size_t>(rankedCount, decodeLimit + _config.audio.mixedDecodeLookahead);
+
+    for (auto& ssrcInboundContextEntry : _ssrcInboundContexts)
+    {
+        auto* ssrcContext = ssrcInboundContextEntry.second;
+        if (!ssrcContext || ssrcContext->rtpMap.format != RtpMap::Format::OPUS)
+        {
+            continue;
+        }
+
+        const auto endpointIdHash = ssrcContext->endpointIdHash.load();
+        size_t rank = 0;
+        while (rank < decodeCount && rankedSpeakers[rank] != endpointIdHash)
+        {
+            ++rank;
+        }
+
+        ssrcContext->mixSelected = rank < decodeLimit && rank < decodeCount;
+        ssrcContext->decodeSelected.store(rank < decodeCount, std::memory_order_relaxed);
+    }
 }
 
 void EngineMixer::markSsrcsInUse(const uint64_t timestamp)
@@ -1380,6 +1415,10 @@ EngineStats::MixerStats EngineMixer::gatherStats(const uint64_t iterationStartTi
         }
     }
 
+    stats.tickProfile = _tickProfile;
+    _publishedTickProfile.write(_tickProfile);
+    _tickProfile = EngineStats::TickProfile();
+
     return stats;
 }
 
@@ -1586,12 +1625,23 @@ void EngineMixer::pinEndpoint(const size_t endpointIdHash, const size_t targetEn
                     newPinSsrc.ssrc);
             }
         }
+        _engineStreamDirector->invalidateRouting();
     }
 
     sendLastNListMessage(endpointIdHash);
     sendUserMediaMapMessage(endpointIdHash);
 }
 
+void EngineMixer::enableUserMediaMapDelta(const size_t endpointIdHash)
+{
+    auto* dataStream = _engineDataStreams.getItem(endpointIdHash);
+    if (dataStream)
+    {
+        logger::debug("EndpointIdHash %zu accepts user media map delta", _loggableId.c_str(), endpointIdHash);
+        dataStream->userMediaMapDelta = true;
+    }
+}
+
 void EngineMixer::sendEndpointMessage(const size_t toEndpointIdHash,
     const size_t fromEndpointIdHash,
     memory::UniqueAudioPacket packet)
@@ -1970,6 +2020,7 @@ void EngineMixer::onOutboundContextFinalized(size_t ownerEndpointHash,
             {
                 videoStream->ssrcOutboundContexts.erase(feedbackSsrc);
             }
+            _engineStreamDirector->invalidateRouting();
         }
 
         return;
@@ -2336,12 +2387,86 @@ bool areNeighbours(const TMap& table1, const TMap& table2)
     return false;
 }
 
+template <class PacketInfoT>
+void prefetchPacketBatch(PacketInfoT* batch, const size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (batch[i].packet())
+        {
+            __builtin_prefetch(batch[i].packet()->get());
+        }
+        if (batch[i].inboundContext())
+        {
+            __builtin_prefetch(batch[i].inboundContext());
+        }
+    }
+}
+
+/**
+ * Releases the packets of a batch and the job counter references they hold on their transports. Consecutive packets
+ * mostly come from the same transport, so its counter is decremented once per run instead of once per packet.
+ */
+template <class PacketInfoT>
+void releasePacketBatch(PacketInfoT* batch, const size_t count)
+{
+    for (size_t i = 0; i < count;)
+    {
+        auto* transport = batch[i].detachTransport();
+        batch[i].packet().reset();
+        uint32_t references = 1;
+        for (++i; i < count && batch[i].transport() == transport; ++i)
+        {
+            batch[i].detachTransport();
+            batch[i].packet().reset();
+            ++references;
+        }
+
+        if (transport)
+        {
+#if DEBUG
+            const auto previous = transport->getJobCounter().fetch_sub(references);
+            assert(previous >= references);
+#else
+            transport->getJobCounter().fetch_sub(references);
+#endif
+        }
+    }
+}
+
 } // namespace
 
-void EngineMixer::forwardAudioRtpPacket(IncomingPacketInfo& packetInfo, uint64_t timestamp)
+/**
+ * Resolves the receivers of the packet's inbound ssrc once per incoming batch. The receivers only depend on the sender
+ * and on the audio streams, which do not change while a batch is processed.
+ */
+const EngineMixer::AudioForwardRoute& EngineMixer::obtainAudioForwardRoute(IncomingPacketInfo& packetInfo,
+    const memory::SharedPacket& packet,
+    AudioForwardRoute* routes,
+    size_t& routeCount)
 {
-    const auto* rtpHeader = rtp::RtpHeader::fromPacket(*packetInfo.packet());
+    const auto* inboundContext = packetInfo.inboundContext();
+    for (size_t i = 0; i < routeCount; ++i)
+    {
+        if (routes[i].inboundContext == inboundContext)
+        {
+            return routes[i];
+        }
+    }
+
+    if (_audioForwardTargets.size() + _engineAudioStreams.size() > _audioForwardTargets.capacity())
+    {
+        _audioForwardTargets.clear();
+        routeCount = 0;
+    }
+
+    auto& route = routes[routeCount++];
+    route.inboundContext = inboundContext;
+    route.begin = _audioForwardTargets.size();
+
+    const auto* rtpHeader = rtp::RtpHeader::fromPacket(*packet);
     auto srcUserId = getC9UserId(rtpHeader->ssrc);
+    auto* srcMemberships = _neighbourMemberships.getItem(packet->endpointIdHash);
 
     for (auto& audioStreamEntry : _engineAudioStreams)
     {
@@ -2358,7 +2483,6 @@ void EngineMixer::forwardAudioRtpPacket(IncomingPacketInfo& packetInfo, uint64_t
 
         if (!audioStream->neighbours.empty())
         {
-            auto* srcMemberships = _neighbourMemberships.getItem(packetInfo.packet()->endpointIdHash);
             if (srcMemberships && isNeighbour(srcMemberships->memberships, audioStream->neighbours))
             {
                 continue;
@@ -2367,13 +2491,13 @@ void EngineMixer::forwardAudioRtpPacket(IncomingPacketInfo& packetInfo, uint64_t
 
         if (audioStream->transport.isConnected())
         {
-            auto ssrc = packetInfo.inboundContext()->ssrc;
+            auto ssrc = inboundContext->ssrc;
             const bool ssrcRewrite = audioStream->ssrcRewrite;
             SsrcOutboundContext* ssrcOutboundContext;
             if (ssrcRewrite)
             {
                 const auto& audioSsrcRewriteMap = _activeMediaList->getAudioSsrcRewriteMap();
-                const auto rewriteMapItr = audioSsrcRewriteMap.find(packetInfo.packet()->endpointIdHash);
+                const auto rewriteMapItr = audioSsrcRewriteMap.find(packet->endpointIdHash);
                 if (rewriteMapItr == audioSsrcRewriteMap.end())
                 {
                     continue;
@@ -2397,24 +2521,33 @@ void EngineMixer::forwardAudioRtpPacket(IncomingPacketInfo& packetInfo, uint64_t
                 continue;
             }
 
-            auto packet = memory::makeUniquePacket(_sendAllocator, *packetInfo.packet());
-            if (packet)
-            {
-                audioStream->transport.getJobQueue().addJob<AudioForwarderRewriteAndSendJob>(*ssrcOutboundContext,
-                    *(packetInfo.inboundContext()),
-                    std::move(packet),
-                    packetInfo.extendedSequenceNumber(),
-                    audioStream->transport);
-            }
-            else
-            {
-                logger::warn("send allocator depleted. forwardAudioRtpPacket", _loggableId.c_str());
-            }
+            _audioForwardTargets.push_back({audioStream, ssrcOutboundContext});
         }
     }
+
+    route.end = _audioForwardTargets.size();
+    return route;
+}
+
+void EngineMixer::forwardAudioRtpPacket(IncomingPacketInfo& packetInfo,
+    const memory::SharedPacket& packet,
+    const AudioForwardRoute& route)
+{
+    for (auto i = route.begin; i < route.end; ++i)
+    {
+        auto& target = _audioForwardTargets[i];
+        target.audioStream->transport.getJobQueue().addJob<AudioForwarderRewriteAndSendJob>(
+            *target.ssrcOutboundContext,
+            *(packetInfo.inboundContext()),
+            packet,
+            packetInfo.extendedSequenceNumber(),
+            target.audioStream->transport);
+    }
 }
 
-void EngineMixer::forwardAudioRtpPacketRecording(IncomingPacketInfo& packetInfo, uint64_t timestamp)
+void EngineMixer::forwardAudioRtpPacketRecording(IncomingPacketInfo& packetInfo,
+    const memory::SharedPacket& packet,
+    uint64_t timestamp)
 {
     if (EngineBarbell::isFromBarbell(packetInfo.transport()->getTag()) || !packetInfo.inboundContext())
     {
@@ -2439,26 +2572,20 @@ void EngineMixer::forwardAudioRtpPacketRecording(IncomingPacketInfo& packetInfo,
         for (const auto& transportEntry : recordingStream->transports)
         {
             ssrcOutboundContext->onRtpSent(timestamp);
-            auto packet = memory::makeUniquePacket(_sendAllocator, *packetInfo.packet());
-            if (packet)
-            {
-                transportEntry.second.getJobQueue().addJob<RecordingAudioForwarderSendJob>(*ssrcOutboundContext,
-                    std::move(packet),
-                    transportEntry.second,
-                    packetInfo.extendedSequenceNumber(),
-                    _messageListener,
-                    transportEntry.first,
-                    *this);
-            }
-            else
-            {
-                logger::warn("send allocator depleted RecFwdSend", _loggableId.c_str());
-            }
+            transportEntry.second.getJobQueue().addJob<RecordingAudioForwarderSendJob>(*ssrcOutboundContext,
+                packet,
+                transportEntry.second,
+                packetInfo.extendedSequenceNumber(),
+                _messageListener,
+                transportEntry.first,
+                *this);
         }
     }
 }
 
-void EngineMixer::forwardAudioRtpPacketOverBarbell(IncomingPacketInfo& packetInfo, uint64_t timestamp)
+void EngineMixer::forwardAudioRtpPacketOverBarbell(IncomingPacketInfo& packetInfo,
+    const memory::SharedPacket& packet,
+    uint64_t timestamp)
 {
     if (EngineBarbell::isFromBarbell(packetInfo.transport()->getTag()))
     {
@@ -2469,7 +2596,7 @@ void EngineMixer::forwardAudioRtpPacketOverBarbell(IncomingPacketInfo& packetInf
     {
         auto& barbell = *it.second;
         const auto& audioSsrcRewriteMap = _activeMediaList->getAudioSsrcRewriteMap();
-        const auto rewriteMapItr = audioSsrcRewriteMap.find(packetInfo.packet()->endpointIdHash);
+        const auto rewriteMapItr = audioSsrcRewriteMap.find(packet->endpointIdHash);
         if (rewriteMapItr == audioSsrcRewriteMap.end())
         {
             continue;
@@ -2484,19 +2611,11 @@ void EngineMixer::forwardAudioRtpPacketOverBarbell(IncomingPacketInfo& packetInf
             continue;
         }
 
-        auto packet = memory::makeUniquePacket(_sendAllocator, *packetInfo.packet());
-        if (packet)
-        {
-            barbell.transport.getJobQueue().addJob<AudioForwarderRewriteAndSendJob>(*ssrcOutboundContext,
-                *(packetInfo.inboundContext()),
-                std::move(packet),
-                packetInfo.extendedSequenceNumber(),
-                barbell.transport);
-        }
-        else
-        {
-            logger::warn("send allocator depleted. forwardAudioRtpPacketOverBarbell", _loggableId.c_str());
-        }
+        barbell.transport.getJobQueue().addJob<AudioForwarderRewriteAndSendJob>(*ssrcOutboundContext,
+            *(packetInfo.inboundContext()),
+            packet,
+            packetInfo.extendedSequenceNumber(),
+            barbell.transport);
     }
 }
 
@@ -2556,43 +2675,83 @@ void EngineMixer::processIncomingRtpPackets(const uint64_t timestamp)
 {
     uint32_t numRtpPackets = 0;
 
-    for (IncomingPacketInfo packetInfo; _incomingForwarderAudioRtp.pop(packetInfo);)
+    IncomingPacketInfo batch[incomingPacketBatchSize];
+    AudioForwardRoute audioRoutes[incomingPacketBatchSize];
+    for (size_t count = 0; (count = _incomingForwarderAudioRtp.pop(batch, incomingPacketBatchSize)) > 0;)
     {
-        ++numRtpPackets;
+        numRtpPackets += count;
+        prefetchPacketBatch(batch, count);
+        _audioForwardTargets.clear();
+        size_t audioRouteCount = 0;
 
-        const auto rtpHeader = rtp::RtpHeader::fromPacket(*packetInfo.packet());
-        if (!rtpHeader)
+        for (size_t i = 0; i < count; ++i)
         {
-            continue;
+            auto& packetInfo = batch[i];
+            const auto rtpHeader = rtp::RtpHeader::fromPacket(*packetInfo.packet());
+            if (!rtpHeader)
+            {
+                continue;
+            }
+
+            const auto packet = memory::makeSharedPacket(_sharedPacketAllocator, packetInfo.packet());
+            if (!packet)
+            {
+                logger::warn("shared packet allocator depleted. forwarder audio", _loggableId.c_str());
+                continue;
+            }
+
+            const auto& route = obtainAudioForwardRoute(packetInfo, packet, audioRoutes, audioRouteCount);
+            forwardAudioRtpPacket(packetInfo, packet, route);
+            forwardAudioRtpPacketRecording(packetInfo, packet, timestamp);
+            forwardAudioRtpPacketOverBarbell(packetInfo, packet, timestamp);
         }
 
-        forwardAudioRtpPacket(packetInfo, timestamp);
-        forwardAudioRtpPacketRecording(packetInfo, timestamp);
-        forwardAudioRtpPacketOverBarbell(packetInfo, timestamp);
+        releasePacketBatch(batch, count);
     }
 
-    for (IncomingPacketInfo packetInfo; _incomingForwarderVideoRtp.pop(packetInfo);)
+    for (size_t count = 0; (count = _incomingForwarderVideoRtp.pop(batch, incomingPacketBatchSize)) > 0;)
     {
-        ++numRtpPackets;
-        auto ssrcContext = packetInfo.inboundContext();
-        if (ssrcContext && !ssrcContext->activeMedia)
+        numRtpPackets += count;
+        prefetchPacketBatch(batch, count);
+
+        for (size_t i = 0; i < count; ++i)
         {
-            _engineStreamDirector->streamActiveStateChanged(packetInfo.packet()->endpointIdHash,
-                ssrcContext->ssrc,
-                true);
-            ssrcContext->activeMedia = true;
+            auto& packetInfo = batch[i];
+            auto ssrcContext = packetInfo.inboundContext();
+            if (ssrcContext && !ssrcContext->activeMedia)
+            {
+                _engineStreamDirector->streamActiveStateChanged(packetInfo.packet()->endpointIdHash,
+                    ssrcContext->ssrc,
+                    true);
+                ssrcContext->activeMedia = true;
+            }
+
+            const auto packet = memory::makeSharedPacket(_sharedPacketAllocator, packetInfo.packet());
+            if (!packet)
+            {
+                logger::warn("shared packet allocator depleted. forwarder video", _loggableId.c_str());
+                continue;
+            }
+
+            forwardVideoRtpPacket(packetInfo, packet, timestamp);
+            forwardVideoRtpPacketOverBarbell(packetInfo, packet, timestamp);
+            forwardVideoRtpPacketRecording(packetInfo, packet, timestamp);
         }
 
-        forwardVideoRtpPacket(packetInfo, timestamp);
-        forwardVideoRtpPacketOverBarbell(packetInfo, timestamp);
-        forwardVideoRtpPacketRecording(packetInfo, timestamp);
+        releasePacketBatch(batch, count);
     }
 
     bool overrunLogSpamGuard = false;
-    for (IncomingAudioPacketInfo packetInfo; _incomingMixerAudioRtp.pop(packetInfo);)
+    IncomingAudioPacketInfo audioBatch[incomingPacketBatchSize];
+    for (size_t count = 0; (count = _incomingMixerAudioRtp.pop(audioBatch, incomingPacketBatchSize)) > 0;)
     {
-        ++numRtpPackets;
-        addPacketToMixerBuffers(packetInfo, timestamp, overrunLogSpamGuard);
+        numRtpPackets += count;
+        prefetchPacketBatch(audioBatch, count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            addPacketToMixerBuffers(audioBatch[i], timestamp, overrunLogSpamGuard);
+        }
+        releasePacketBatch(audioBatch, count);
     }
 
     if (numRtpPackets == 0)
@@ -2610,14 +2769,16 @@ void EngineMixer::processIncomingRtpPackets(const uint64_t timestamp)
     }
 }
 
-void EngineMixer::forwardVideoRtpPacketOverBarbell(IncomingPacketInfo& packetInfo, const uint64_t timestamp)
+void EngineMixer::forwardVideoRtpPacketOverBarbell(IncomingPacketInfo& packetInfo,
+    const memory::SharedPacket& packet,
+    const uint64_t timestamp)
 {
     if (EngineBarbell::isFromBarbell(packetInfo.transport()->getTag()) || !packetInfo.inboundContext())
     {
         return;
     }
 
-    const auto senderEndpointIdHash = packetInfo.packet()->endpointIdHash;
+    const auto senderEndpointIdHash = packet->endpointIdHash;
     for (auto& it : _engineBarbells)
     {
         auto& barbell = *it.second;
@@ -2652,37 +2813,46 @@ void EngineMixer::forwardVideoRtpPacketOverBarbell(IncomingPacketInfo& packetInf
         }
 
         ssrcOutboundContext->onRtpSent(timestamp); // marks that we have active jobs on this ssrc context
-        auto packet = memory::makeUniquePacket(_sendAllocator, *packetInfo.packet());
-        if (packet)
-        {
-            barbell.transport.getJobQueue().addJob<VideoForwarderRewriteAndSendJob>(*ssrcOutboundContext,
-                *(packetInfo.inboundContext()),
-                std::move(packet),
-                barbell.transport,
-                packetInfo.extendedSequenceNumber(),
-                _messageListener,
-                barbell.idHash,
-                *this);
-        }
-        else
-        {
-            logger::warn("send allocator depleted fwdVideoOverBarbell", _loggableId.c_str());
-        }
+        barbell.transport.getJobQueue().addJob<VideoForwarderRewriteAndSendJob>(*ssrcOutboundContext,
+            *(packetInfo.inboundContext()),
+            packet,
+            barbell.transport,
+            packetInfo.extendedSequenceNumber());
     }
 }
 
-void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const uint64_t timestamp)
+/**
+ * Builds the list of video receivers and their outbound contexts for an inbound ssrc. The result only depends on
+ * state covered by the stream director and active media list revisions, so it is reused until one of them changes.
+ * A revision change starts a new generation instead of clearing the table, and routes are rebuilt lazily per ssrc.
+ * Routes where an outbound context could not be obtained are not cached, so the receiver is retried on the next packet.
+ */
+const EngineMixer::VideoForwardRoute* EngineMixer::obtainVideoForwardRoute(IncomingPacketInfo& packetInfo,
+    const size_t senderEndpointIdHash)
 {
-    auto rtpHeader = rtp::RtpHeader::fromPacket(*packetInfo.packet());
-    if (!rtpHeader)
+    const auto directorRevision = _engineStreamDirector->getRoutingRevision();
+    const auto mediaListRevision = _activeMediaList->getVideoRoutingRevision();
+    if (directorRevision != _videoRoutesDirectorRevision || mediaListRevision != _videoRoutesMediaListRevision)
     {
-        assert(false); // this should have been checked multiple times by now. Transport, ReceiveJob, RtxReceiveJob
-        return;
+        ++_videoRoutesGeneration;
+        _videoForwardTargets.clear();
+        _videoForwardTargetsCached = 0;
+        _videoRoutesDirectorRevision = directorRevision;
+        _videoRoutesMediaListRevision = mediaListRevision;
     }
 
-    const auto senderEndpointIdHash = packetInfo.packet()->endpointIdHash;
+    const auto* inboundContext = packetInfo.inboundContext();
+    auto* cachedRoute = _videoRoutes.getItem(inboundContext->ssrc);
+    if (cachedRoute && cachedRoute->generation == _videoRoutesGeneration)
+    {
+        return cachedRoute;
+    }
 
-    _lastVideoPacketProcessed = timestamp;
+    _videoForwardTargets.resize(_videoForwardTargetsCached); // drop the previous uncached route
+    bool complete = true;
+
+    VideoForwardRoute route;
+    route.begin = _videoForwardTargets.size();
 
     for (auto& videoStreamEntry : _engineVideoStreams)
     {
@@ -2698,7 +2868,7 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
             continue;
         }
 
-        if (!_engineStreamDirector->shouldForwardSsrc(endpointIdHash, packetInfo.inboundContext()->ssrc))
+        if (!_engineStreamDirector->shouldForwardSsrc(endpointIdHash, inboundContext->ssrc))
         {
             auto* senderVideoStream = _engineVideoStreams.getItem(senderEndpointIdHash);
             if (senderVideoStream)
@@ -2719,7 +2889,7 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
             continue;
         }
 
-        if (shouldSkipBecauseOfWhitelist(*videoStream, packetInfo.inboundContext()->ssrc))
+        if (shouldSkipBecauseOfWhitelist(*videoStream, inboundContext->ssrc))
         {
             continue;
         }
@@ -2731,7 +2901,7 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
         {
             const auto& screenShareSsrcMapping = _activeMediaList->getVideoScreenShareSsrcMapping();
             if (screenShareSsrcMapping.isSet() && screenShareSsrcMapping.get().first == senderEndpointIdHash &&
-                screenShareSsrcMapping.get().second.ssrc == packetInfo.inboundContext()->ssrc)
+                screenShareSsrcMapping.get().second.ssrc == inboundContext->ssrc)
             {
                 ssrc = screenShareSsrcMapping.get().second.rewriteSsrc;
             }
@@ -2767,7 +2937,7 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
         else
         {
             // non rewrite recipients gets the video sent on same ssrc as level 0.
-            ssrc = packetInfo.inboundContext()->defaultLevelSsrc;
+            ssrc = inboundContext->defaultLevelSsrc;
             ssrcOutboundContext = obtainOutboundForwardSsrcContext(videoStream->endpointIdHash,
                 videoStream->ssrcOutboundContexts,
                 ssrc,
@@ -2776,35 +2946,72 @@ void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const ui
 
         if (!ssrcOutboundContext)
         {
+            complete = false;
             continue;
         }
 
-        if (!videoStream->transport.isConnected())
+        _videoForwardTargets.push_back({videoStream, ssrcOutboundContext});
+    }
+
+    route.generation = _videoRoutesGeneration;
+    route.end = _videoForwardTargets.size();
+    if (complete)
+    {
+        if (cachedRoute)
         {
-            return;
+            *cachedRoute = route;
+            _videoForwardTargetsCached = route.end;
+            return cachedRoute;
         }
 
-        ssrcOutboundContext->onRtpSent(timestamp); // marks that we have active jobs on this ssrc context
-        auto packet = memory::makeUniquePacket(_sendAllocator, *packetInfo.packet());
-        if (packet)
+        auto emplaceResult = _videoRoutes.emplace(inboundContext->ssrc, route);
+        if (emplaceResult.second)
         {
-            videoStream->transport.getJobQueue().addJob<VideoForwarderRewriteAndSendJob>(*ssrcOutboundContext,
-                *(packetInfo.inboundContext()),
-                std::move(packet),
-                videoStream->transport,
-                packetInfo.extendedSequenceNumber(),
-                _messageListener,
-                videoStream->endpointIdHash,
-                *this);
+            _videoForwardTargetsCached = route.end;
+            return &emplaceResult.first->second;
         }
-        else
+        // route map is full. Forward without caching.
+    }
+
+    _videoUncachedRoute = route;
+    return &_videoUncachedRoute;
+}
+
+void EngineMixer::forwardVideoRtpPacket(IncomingPacketInfo& packetInfo,
+    const memory::SharedPacket& packet,
+    const uint64_t timestamp)
+{
+    auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+    if (!rtpHeader)
+    {
+        assert(false); // this should have been checked multiple times by now. Transport, ReceiveJob, RtxReceiveJob
+        return;
+    }
+
+    _lastVideoPacketProcessed = timestamp;
+
+    const auto* route = obtainVideoForwardRoute(packetInfo, packet->endpointIdHash);
+    for (auto i = route->begin; i < route->end; ++i)
+    {
+        auto& target = _videoForwardTargets[i];
+        auto* videoStream = target.videoStream;
+        if (!videoStream->transport.isConnected())
         {
-            logger::warn("send allocator depleted FwdRewrite", _loggableId.c_str());
+            return;
         }
+
+        target.ssrcOutboundContext->onRtpSent(timestamp); // marks that we have active jobs on this ssrc context
+        videoStream->transport.getJobQueue().addJob<VideoForwarderRewriteAndSendJob>(*target.ssrcOutboundContext,
+            *(packetInfo.inboundContext()),
+            packet,
+            videoStream->transport,
+            packetInfo.extendedSequenceNumber());
     }
 }
 
-void EngineMixer::forwardVideoRtpPacketRecording(IncomingPacketInfo& packetInfo, const uint64_t timestamp)
+void EngineMixer::forwardVideoRtpPacketRecording(IncomingPacketInfo& packetInfo,
+    const memory::SharedPacket& packet,
+    const uint64_t timestamp)
 {
     if (EngineBarbell::isFromBarbell(packetInfo.transport()->getTag()) || !packetInfo.inboundContext())
     {
@@ -2835,22 +3042,14 @@ void EngineMixer::forwardVideoRtpPacketRecording(IncomingPacketInfo& packetInfo,
         for (const auto& transportEntry : recordingStream->transports)
         {
             ssrcOutboundContext->onRtpSent(timestamp); // active jobs on this ssrc context
-            auto packet = memory::makeUniquePacket(_sendAllocator, *packetInfo.packet());
-            if (packet)
-            {
-                transportEntry.second.getJobQueue().addJob<RecordingVideoForwarderSendJob>(*ssrcOutboundContext,
-                    *(packetInfo.inboundContext()),
-                    std::move(packet),
-                    transportEntry.second,
-                    packetInfo.extendedSequenceNumber(),
-                    _messageListener,
-                    transportEntry.first,
-                    *this);
-            }
-            else
-            {
-                logger::warn("send allocator depleted FwdRewrite", _loggableId.c_str());
-            }
+            transportEntry.second.getJobQueue().addJob<RecordingVideoForwarderSendJob>(*ssrcOutboundContext,
+                *(packetInfo.inboundContext()),
+                packet,
+                transportEntry.second,
+                packetInfo.extendedSequenceNumber(),
+                _messageListener,
+                transportEntry.first,
+                *this);
         }
     }
 }
@@ -3073,12 +3272,17 @@ void EngineMixer::processIncomingTransportFbRtcpPacket(const transport::RtcTrans
 void EngineMixer::mixSsrcBuffers()
 {
     memset(_mixedData, 0, samplesPerIteration * codec::Opus::bytesPerSample);
+    const bool decodeLimited = _config.audio.mixedDecodeLimit != 0;
     for (auto& mixerAudioBufferEntry : _mixerSsrcAudioBuffers)
     {
         if (!mixerAudioBufferEntry.second)
         {
             continue;
         }
+        if (decodeLimited && !isSelectedForMix(mixerAudioBufferEntry.first, *mixerAudioBufferEntry.second))
+        {
+            continue;
+        }
         if (mixerAudioBufferEntry.second->isPreBuffering())
         {
             continue;
@@ -3099,8 +3303,44 @@ void EngineMixer::mixSsrcBuffers()
     }
 }
 
+/**
+ * Keeps the buffers of senders outside the mixed decode limit out of the mix. Pre-buffering buffers do not contribute
+ * and are not removed from the mix for their own stream. Buffers of senders decoded as look ahead are kept at the
+ * pre-buffer length, so the sender is heard at once when moving up in rank.
+ */
+bool EngineMixer::isSelectedForMix(const uint32_t ssrc, AudioBuffer& audioBuffer)
+{
+    auto ssrcContextItr = _ssrcInboundContexts.find(ssrc);
+    if (ssrcContextItr == _ssrcInboundContexts.end() || !ssrcContextItr->second || ssrcContextItr->second->mixSelected)
+    {
+        return true;
+    }
+
+    audioBuffer.setPreBuffering();
+    if (!ssrcContextItr->second->decodeSelected.load(std::memory_order_relaxed))
+    {
+        audioBuffer.drop(audioBuffer.getLength());
+    }
+    else if (audioBuffer.getLength() >= preBufferSamples + samplesPerIteration)
+    {
+        audioBuffer.drop(samplesPerIteration);
+    }
+    return false;
+}
+
 inline void EngineMixer::processAudioStreams()
 {
+    MixEncoder::Frame* mixFrame = nullptr;
+    bool mixFrameAttempted = false;
+    auto obtainMixFrame = [&]() {
+        if (!mixFrameAttempted)
+        {
+            mixFrameAttempted = true;
+            mixFrame = _mixEncoder->beginFrame(_mixedData, _rtpTimestampSource);
+        }
+        return mixFrame;
+    };
+
     for (auto& audioStreamEntry : _engineAudioStreams)
     {
         auto audioStream = audioStreamEntry.second;
@@ -3127,20 +3367,35 @@ inline void EngineMixer::processAudioStreams()
             continue;
         }
 
-        auto audioPacket = memory::makeUniquePacket(_audioAllocator);
-        if (!audioPacket)
+        if (!isContributingToMix && audioStream->neighbours.empty())
         {
-            return;
-        }
+            // Everyone that does not contribute and has no neighbours hears the full mix. It is encoded once per
+            // iteration by the MixEncoder, off the engine thread.
+            auto* ssrcContext = obtainOutboundSsrcContext(audioStream->endpointIdHash,
+                audioStream->ssrcOutboundContexts,
+                audioStream->localSsrc,
+                audioStream->rtpMap);
 
-        auto rtpHeader = rtp::RtpHeader::create(*audioPacket);
-        rtpHeader->ssrc = audioStream->localSsrc;
+            if (!ssrcContext)
+            {
+                continue;
+            }
+            if (obtainMixFrame())
+            {
+                _mixEncoder->addReceiver(*mixFrame, *ssrcContext, audioStream->transport);
+                audioStream->sharedMixReceiver = true;
+                audioStream->lastMixFrame = mixFrame->sequence;
+                continue;
+            }
+        }
 
-        auto payloadStart = rtpHeader->getPayload();
-        const auto headerLength = rtpHeader->headerLength();
-        audioPacket->setLength(headerLength + samplesPerIteration * bytesPerSample);
-        memcpy(payloadStart, _mixedData, samplesPerIteration * bytesPerSample);
+        auto audioPacket = createMixPacket(_mixedData, audioStream->localSsrc);
+        if (!audioPacket)
+        {
+            break;
+        }
 
+        auto payloadStart = rtp::RtpHeader::fromPacket(*audioPacket)->getPayload();
         if (isContributingToMix && audioBuffer)
         {
             audioBuffer->removeFromMix(reinterpret_cast<int16_t*>(payloadStart),
@@ -3174,14 +3429,62 @@ inline void EngineMixer::processAudioStreams()
             audioStream->localSsrc,
             audioStream->rtpMap);
 
-        if (ssrcContext)
+        if (!ssrcContext)
         {
-            audioStream->transport.getJobQueue().addJob<EncodeJob>(std::move(audioPacket),
+            continue;
+        }
+
+        // Leaving the shared mix. The own encoder is primed with what the receiver heard last, and the packet must
+        // not overtake shared mix frames still queued for the receiver.
+        memory::UniqueAudioPacket primer;
+        if (audioStream->sharedMixReceiver)
+        {
+            audioStream->sharedMixReceiver = false;
+            primer = createMixPacket(_mixEncoder->getLastSentMix(), audioStream->localSsrc);
+        }
+
+        if (_mixEncoder->isQueued(audioStream->lastMixFrame) && obtainMixFrame())
+        {
+            _mixEncoder->addHandover(*mixFrame,
+                std::move(audioPacket),
+                std::move(primer),
                 *ssrcContext,
-                audioStream->transport,
-                _rtpTimestampSource);
+                audioStream->transport);
+            audioStream->lastMixFrame = mixFrame->sequence;
+            continue;
         }
+
+        audioStream->transport.getJobQueue().addJob<EncodeJob>(std::move(audioPacket),
+            std::move(primer),
+            *ssrcContext,
+            audioStream->transport,
+            _rtpTimestampSource);
+    }
+
+    if (mixFrame)
+    {
+        _mixEncoder->post(*mixFrame);
+    }
+    else
+    {
+        _mixEncoder->skip();
+    }
+}
+
+memory::UniqueAudioPacket EngineMixer::createMixPacket(const int16_t* mixedData, const uint32_t ssrc)
+{
+    auto audioPacket = memory::makeUniquePacket(_audioAllocator);
+    if (!audioPacket)
+    {
+        return audioPacket;
     }
+
+    auto rtpHeader = rtp::RtpHeader::create(*audioPacket);
+    rtpHeader->ssrc = ssrc;
+
+    audioPacket->setLength(rtpHeader->headerLength() + samplesPerIteration * bytesPerSample);
+    memcpy(rtpHeader->getPayload(), mixedData, samplesPerIteration * bytesPerSample);
+    return audioPacket;
 }
 
 void EngineMixer::sendLastNListMessage(const size_t endpointIdHash)
@@ -3209,10 +3512,13 @@ void EngineMixer::sendLastNListMessage(const size_t endpointIdHash)
     dataStream->stream.sendString(lastNListMessage.get(), lastNListMessage.getLength());
 }
 
+// Endpoints that pin no one and are not among the endpoints listed get the same list, which is made once.
 void EngineMixer::sendLastNListMessageToAll()
 {
-    utils::StringBuilder<1024> lastNListMessage;
+    utils::StringBuilder<1024> sharedLastNListMessage;
+    _activeMediaList->makeLastNListMessage(_lastN, 0, 0, sharedLastNListMessage);
 
+    utils::StringBuilder<1024> lastNListMessage;
     for (auto& dataStreamEntry : _engineDataStreams)
     {
         const auto endpointIdHash = dataStreamEntry.first;
@@ -3228,8 +3534,14 @@ void EngineMixer::sendLastNListMessageToAll()
             continue;
         }
 
-        lastNListMessage.clear();
         auto pinTarget = _engineStreamDirector->getPinTarget(endpointIdHash);
+        if (!pinTarget && !_activeMediaList->isInSharedMessageRange(_lastN, endpointIdHash))
+        {
+            dataStream->stream.sendString(sharedLastNListMessage.get(), sharedLastNListMessage.getLength());
+            continue;
+        }
+
+        lastNListMessage.clear();
         _activeMediaList->makeLastNListMessage(_lastN, endpointIdHash, pinTarget, lastNListMessage);
 
         dataStream->stream.sendString(lastNListMessage.get(), lastNListMessage.getLength());
@@ -3268,6 +3580,7 @@ void EngineMixer::sendMessagesToNewDataStreams()
         if (videoStream->ssrcRewrite)
         {
             userMediaMapMessage.clear();
+            dataStream->userMediaMapVersion = 0;
             if (_activeMediaList->makeUserMediaMapMessage(_lastN,
                     dataStreamEntry.first,
                     pinTarget,
@@ -3347,10 +3660,27 @@ void EngineMixer::sendUserMediaMapMessage(const size_t endpointIdHash)
         userMediaMapMessage);
 
     dataStream->stream.sendString(userMediaMapMessage.get(), userMediaMapMessage.getLength());
+    dataStream->userMediaMapVersion = 0;
 }
 
+// Endpoints that pin no one and are not in the map get the shared map, which is made once. Those that accept deltas
+// and received the previous shared map only get the changes.
 void EngineMixer::sendUserMediaMapMessageToAll()
 {
+    UserMediaMap sharedMap;
+    _activeMediaList->makeUserMediaMap(_lastN, sharedMap);
+
+    utils::StringBuilder<1024> sharedMessage;
+    ActiveMediaList::makeUserMediaMapMessage(sharedMap, sharedMessage);
+
+    const auto previousVersion = _userMediaMapVersion;
+    utils::StringBuilder<1024> deltaMessage;
+    if (ActiveMediaList::makeUserMediaMapDeltaMessage(_userMediaMap, sharedMap, deltaMessage))
+    {
+        _userMediaMap = sharedMap;
+        ++_userMediaMapVersion;
+    }
+
     utils::StringBuilder<1024> userMediaMapMessage;
     for (auto dataStreamEntry : _engineDataStreams)
     {
@@ -3367,15 +3697,33 @@ void EngineMixer::sendUserMediaMapMessageToAll()
             continue;
         }
 
-        userMediaMapMessage.clear();
         const auto pinTarget = _engineStreamDirector->getPinTarget(endpointIdHash);
-        _activeMediaList->makeUserMediaMapMessage(_lastN,
-            endpointIdHash,
-            pinTarget,
-            _engineVideoStreams,
-            userMediaMapMessage);
+        if (pinTarget || _activeMediaList->isInSharedMessageRange(_lastN, endpointIdHash))
+        {
+            userMediaMapMessage.clear();
+            _activeMediaList->makeUserMediaMapMessage(_lastN,
+                endpointIdHash,
+                pinTarget,
+                _engineVideoStreams,
+                userMediaMapMessage);
 
-        dataStream->stream.sendString(userMediaMapMessage.get(), userMediaMapMessage.getLength());
+            dataStream->stream.sendString(userMediaMapMessage.get(), userMediaMapMessage.getLength());
+            dataStream->userMediaMapVersion = 0;
+            continue;
+        }
+
+        if (dataStream->userMediaMapDelta && dataStream->userMediaMapVersion == previousVersion)
+        {
+            if (_userMediaMapVersion != previousVersion)
+            {
+                dataStream->stream.sendString(deltaMessage.get(), deltaMessage.getLength());
+            }
+        }
+        else
+        {
+            dataStream->stream.sendString(sharedMessage.get(), sharedMessage.getLength());
+        }
+        dataStream->userMediaMapVersion = _userMediaMapVersion;
     }
 }
 
@@ -3528,7 +3876,6 @@ void EngineMixer::markAssociatedAudioOutboundContextsForDeletion(const EngineAud
                 audioStream->transport,
                 outboundContextItr->second,
                 _engineSyncContext,
-                _messageListener,
                 feedbackSsrc);
         }
     }
@@ -3561,7 +3908,6 @@ void EngineMixer::markAssociatedVideoOutboundContextsForDeletion(const EngineVid
                 videoStream->transport,
                 *outboundContext,
                 _engineSyncContext,
-                _messageListener,
                 feedbackSsrc);
         }
 
@@ -3583,6 +3929,7 @@ void EngineMixer::decommissionInboundContext(const uint32_t ssrc)
     if (ssrcContext)
     {
         _ssrcInboundContexts.erase(ssrc); // remove first or internalRemoveInboundSsrc may assert
+        _videoRoutes.erase(ssrc);
         ssrcContext->sender->postOnQueue(utils::bind(&EngineMixer::internalRemoveInboundSsrc, this, ssrc));
         logger::info("Decommissioned inbound ssrc context %u", _loggableId.c_str(), ssrc);
     }
@@ -4739,13 +5086,6 @@ bool EngineMixer::asyncRemoveStream(const EngineDataStream* stream)
     return post([=]() { this->removeStream(stream); });
 }
 
-bool EngineMixer::asyncAddVideoPacketCache(const uint32_t ssrc,
-    const size_t endpointIdHash,
-    PacketCache* videoPacketCache)
-{
-    return post(utils::bind(&EngineMixer::addVideoPacketCache, this, ssrc, endpointIdHash, videoPacketCache));
-}
-
 bool EngineMixer::asyncReconfigureAudioStream(const transport::RtcTransport& transport, const uint32_t remoteSsrc)
 {
     return post(utils::bind(&EngineMixer::reconfigureAudioStream, this, std::cref(transport), remoteSsrc));
@@ -4776,6 +5116,11 @@ bool EngineMixer::asyncPinEndpoint(const size_t endpointIdHash, const size_t tar
     return post(utils::bind(&EngineMixer::pinEndpoint, this, endpointIdHash, targetEndpointIdHash));
 }
 
+bool EngineMixer::asyncEnableUserMediaMapDelta(const size_t endpointIdHash)
+{
+    return post(utils::bind(&EngineMixer::enableUserMediaMapDelta, this, endpointIdHash));
+}
+
 bool EngineMixer::asyncSendEndpointMessage(const size_t toEndpointIdHash,
     const size_t fromEndpointIdHash,
     memory::UniqueAudioPacket& packet)
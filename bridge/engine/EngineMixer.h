@@ -7,16 +7,20 @@
 #include "bridge/engine/NeighbourMembership.h"
 #include "bridge/engine/SimulcastStream.h"
 #include "bridge/engine/SsrcInboundContext.h"
+#include "bridge/engine/UserMediaMap.h"
 #include "concurrency/MpmcHashmap.h"
+#include "concurrency/MpmcPublish.h"
 #include "concurrency/SynchronizationContext.h"
 #include "memory/AudioPacketPoolAllocator.h"
 #include "memory/Map.h"
 #include "memory/PacketPoolAllocator.h"
 #include "memory/RingBuffer.h"
+#include "memory/SharedPacket.h"
 #include "transport/RtcTransport.h"
 #include <cstddef>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -49,6 +53,7 @@ namespace bridge
 {
 class EngineStreamDirector;
 class ActiveMediaList;
+class MixEncoder;
 class PacketCache;
 struct SsrcWhitelist;
 struct RecordingDescription;
@@ -90,6 +95,7 @@ public:
         const uint32_t localVideoSsrc,
         const config::Config& config,
         memory::PacketPoolAllocator& sendAllocator,
+        memory::SharedPacketAllocator& sharedPacketAllocator,
         memory::AudioPacketPoolAllocator& audioAllocator,
         const std::vector<uint32_t>& audioSsrcs,
         const std::vector<api::SimulcastGroup>& videoSsrcs,
@@ -103,6 +109,8 @@ public:
     void forwardPackets(const uint64_t engineTimestamp);
     void clear();
     EngineStats::MixerStats gatherStats(const uint64_t engineIterationStartTimestamp);
+    // Phase timings of the iterations covered by the latest gatherStats. Thread safe.
+    bool getTickProfile(EngineStats::TickProfile& profile) const;
 
     void run(const uint64_t engineIterationStartTimestamp);
     // --
@@ -163,13 +171,13 @@ public: // EngineMixer async interface. Will execute on engine thread
     bool asyncRemoveStream(const EngineAudioStream* engineAudioStream);
     bool asyncRemoveStream(const EngineVideoStream* stream);
     bool asyncRemoveStream(const EngineDataStream* stream);
-    bool asyncAddVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash, PacketCache* videoPacketCache);
     bool asyncReconfigureAudioStream(const transport::RtcTransport& transport, const uint32_t remoteSsrc);
     bool asyncStartTransport(transport::RtcTransport& transport);
     bool asyncAddAudioStream(EngineAudioStream* engineAudioStream);
     bool asyncAddVideoStream(EngineVideoStream* engineVideoStream);
     bool asyncAddDataSteam(EngineDataStream* engineDataStream);
     bool asyncPinEndpoint(const size_t endpointIdHash, const size_t targetEndpointIdHash);
+    bool asyncEnableUserMediaMapDelta(const size_t endpointIdHash);
     bool asyncSendEndpointMessage(const size_t toEndpointIdHash,
         const size_t fromEndpointIdHash,
         memory::UniqueAudioPacket& packet);
@@ -206,8 +214,8 @@ private: // impl async interface
     void startTransport(transport::RtcTransport& transport);
     void startRecordingTransport(transport::RecordingTransport& transport);
     void reconfigureAudioStream(const transport::RtcTransport& transport, const uint32_t remoteSsrc);
-    void addVideoPacketCache(const uint32_t ssrc, const size_t endpointIdHash, PacketCache* videoPacketCache);
     void pinEndpoint(const size_t endpointIdHash, const size_t targetEndpointIdHash);
+    void enableUserMediaMapDelta(const size_t endpointIdHash);
     void sendEndpointMessage(const size_t toEndpointIdHash,
         const size_t fromEndpointIdHash,
         memory::UniqueAudioPacket packet);
@@ -233,6 +241,7 @@ public: // private but called from helper method
 
 private:
     static const size_t maxPendingPackets = 8192;
+    static const size_t incomingPacketBatchSize = 32;
     static const size_t maxPendingRtcpPackets = 2048;
     static const size_t maxSsrcs = 8192;
     static const size_t maxStreamsPerModality = 4096;
@@ -318,6 +327,9 @@ private:
         inline const PacketT& packet() const { return _packet; }
         inline uint32_t extendedSequenceNumber() const { return _extendedSequenceNumber; }
 
+        // Hands over the job counter reference to the caller, who must decrement it.
+        inline transport::RtcTransport* detachTransport() { return std::exchange(_transport, nullptr); }
+
     private:
         void release()
         {
@@ -350,6 +362,34 @@ private:
     using IncomingPacketInfo = IncomingPacketAggregate<memory::UniquePacket>;
     using IncomingAudioPacketInfo = IncomingPacketAggregate<memory::UniqueAudioPacket>;
 
+    struct AudioForwardTarget
+    {
+        EngineAudioStream* audioStream;
+        SsrcOutboundContext* ssrcOutboundContext;
+    };
+
+    // Range in _audioForwardTargets of the receivers of an inbound ssrc, valid during one incoming packet batch.
+    struct AudioForwardRoute
+    {
+        const SsrcInboundContext* inboundContext;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    struct VideoForwardTarget
+    {
+        EngineVideoStream* videoStream;
+        SsrcOutboundContext* ssrcOutboundContext;
+    };
+
+    // Range in _videoForwardTargets of the receivers of an inbound ssrc. Valid while generation is current.
+    struct VideoForwardRoute
+    {
+        uint32_t generation;
+        uint32_t begin;
+        uint32_t end;
+    };
+
     std::string _id;
     logger::LoggableId _loggableId;
 
@@ -364,6 +404,16 @@ private:
     concurrency::MpmcQueue<IncomingAudioPacketInfo> _incomingMixerAudioRtp;
     concurrency::MpmcQueue<IncomingPacketInfo> _incomingRtcp;
     concurrency::MpmcQueue<IncomingPacketInfo> _incomingForwarderVideoRtp;
+    std::vector<AudioForwardTarget> _audioForwardTargets;
+
+    // video routing table per inbound ssrc. Routes of older generations are rebuilt on their next packet.
+    concurrency::MpmcHashmap32<uint32_t, VideoForwardRoute> _videoRoutes;
+    std::vector<VideoForwardTarget> _videoForwardTargets;
+    uint32_t _videoForwardTargetsCached; // targets after this belong to _videoUncachedRoute
+    VideoForwardRoute _videoUncachedRoute;
+    uint32_t _videoRoutesGeneration;
+    uint32_t _videoRoutesDirectorRevision;
+    uint32_t _videoRoutesMediaListRevision;
 
     concurrency::MpmcHashmap32<size_t, EngineAudioStream*> _engineAudioStreams;
     concurrency::MpmcHashmap32<size_t, EngineVideoStream*> _engineVideoStreams;
@@ -383,12 +433,18 @@ private:
 
     int16_t _mixedData[samplesPerIteration];
     uint64_t _rtpTimestampSource; // 1kHz. it works with wrapping since it is truncated to uint32.
+    std::unique_ptr<MixEncoder> _mixEncoder; // shared by all receivers of the full mix
 
     memory::PacketPoolAllocator& _sendAllocator;
+    memory::SharedPacketAllocator& _sharedPacketAllocator;
     memory::AudioPacketPoolAllocator& _audioAllocator;
 
     uint64_t _lastReceiveTime;
 
+    uint64_t _tickPhaseCycles[EngineStats::TickProfile::phaseCount];
+    EngineStats::TickProfile _tickProfile;
+    concurrency::MpmcPublish<EngineStats::TickProfile, 4> _publishedTickProfile;
+
     uint64_t _lastCounterCheck;
 
     std::unique_ptr<EngineStreamDirector> _engineStreamDirector;
@@ -398,6 +454,8 @@ private:
     const config::Config& _config;
     uint32_t _lastN;
     uint32_t _numMixedAudioStreams;
+    UserMediaMap _userMediaMap; // last shared user media map sent
+    uint32_t _userMediaMapVersion;
 
     uint64_t _lastVideoBandwidthCheck;
     uint64_t _lastVideoPacketProcessed;
@@ -408,6 +466,8 @@ private:
     jobmanager::JobManager& _backgroundJobQueue; // to non-real time world
 
     uint64_t _lastRecordingAckProcessed;
+    uint32_t _decodeSelectionRevision;
+    uint64_t _lastDecodeSelectionUpdate;
     bool _slidesPresent;
 
     uint32_t getMinRemoteClientDownlinkBandwidth() const;
@@ -418,12 +478,29 @@ private:
 
     void processBarbellSctp(const uint64_t timestamp);
     void processIncomingRtpPackets(const uint64_t timestamp);
-    void forwardVideoRtpPacket(IncomingPacketInfo& packetInfo, const uint64_t timestamp);
-    void forwardVideoRtpPacketRecording(IncomingPacketInfo& packetInfo, const uint64_t timestamp);
-    void forwardVideoRtpPacketOverBarbell(IncomingPacketInfo& packetInfo, const uint64_t timestamp);
-    void forwardAudioRtpPacket(IncomingPacketInfo& packetInfo, uint64_t timestamp);
-    void forwardAudioRtpPacketOverBarbell(IncomingPacketInfo& packetInfo, uint64_t timestamp);
-    void forwardAudioRtpPacketRecording(IncomingPacketInfo& packetInfo, uint64_t timestamp);
+    const VideoForwardRoute* obtainVideoForwardRoute(IncomingPacketInfo& packetInfo, const size_t senderEndpointIdHash);
+    void forwardVideoRtpPacket(IncomingPacketInfo& packetInfo,
+        const memory::SharedPacket& packet,
+        const uint64_t timestamp);
+    void forwardVideoRtpPacketRecording(IncomingPacketInfo& packetInfo,
+        const memory::SharedPacket& packet,
+        const uint64_t timestamp);
+    void forwardVideoRtpPacketOverBarbell(IncomingPacketInfo& packetInfo,
+        const memory::SharedPacket& packet,
+        const uint64_t timestamp);
+    const AudioForwardRoute& obtainAudioForwardRoute(IncomingPacketInfo& packetInfo,
+        const memory::SharedPacket& packet,
+        AudioForwardRoute* routes,
+        size_t& routeCount);
+    void forwardAudioRtpPacket(IncomingPacketInfo& packetInfo,
+        const memory::SharedPacket& packet,
+        const AudioForwardRoute& route);
+    void forwardAudioRtpPacketOverBarbell(IncomingPacketInfo& packetInfo,
+        const memory::SharedPacket& packet,
+        uint64_t timestamp);
+    void forwardAudioRtpPacketRecording(IncomingPacketInfo& packetInfo,
+        const memory::SharedPacket& packet,
+        uint64_t timestamp);
     void addPacketToMixerBuffers(const IncomingAudioPacketInfo& packet, const uint64_t timestamp, bool logSpamGuard);
 
     void processIncomingRtcpPackets(const uint64_t timestamp);
@@ -442,7 +519,11 @@ private:
     void removeIdleStreams(const uint64_t timestamp);
 
     void mixSsrcBuffers();
+    bool isSelectedForMix(const uint32_t ssrc, AudioBuffer& audioBuffer);
+    void updateMixedDecodeSelection(const uint64_t timestamp);
     void processAudioStreams();
+    uint64_t recordTickPhase(const EngineStats::TickPhase phase, const uint64_t phaseStart);
+    memory::UniqueAudioPacket createMixPacket(const int16_t* mixedData, const uint32_t ssrc);
     void runDominantSpeakerCheck(const uint64_t engineIterationStartTimestamp);
     void updateDirectorUplinkEstimates(const uint64_t engineIterationStartTimestamp);
     void processMissingPackets(const uint64_t timestamp);
@@ -4,6 +4,7 @@
 #include "transport/TransportStats.h"
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 namespace bridge
 {
@@ -11,6 +12,156 @@ namespace bridge
 namespace EngineStats
 {
 
+// Latency histogram in microseconds with four linear sub buckets per power of two, so percentiles are within 25%.
+// Covers up to about one second.
+struct LatencyHistogram
+{
+    static constexpr size_t bucketCount = 80;
+
+    LatencyHistogram() { std::memset(counts, 0, sizeof(counts)); }
+
+    static size_t bucketOf(const uint64_t valueUs)
+    {
+        if (valueUs < 4)
+        {
+            return valueUs;
+        }
+        const size_t exponent = 63 - __builtin_clzll(valueUs);
+        const size_t index = 4 * (exponent - 1) + ((valueUs >> (exponent - 2)) & 3);
+        return std::min(index, bucketCount - 1);
+    }
+
+    static uint64_t bucketLowerBound(const size_t index)
+    {
+        if (index < 4)
+        {
+            return index;
+        }
+        return uint64_t(4 + index % 4) << (index / 4 - 1);
+    }
+
+    void add(const uint64_t valueUs)
+    {
+        ++counts[bucketOf(valueUs)];
+        maxUs = std::max(maxUs, static_cast<uint32_t>(std::min(valueUs, uint64_t(0xFFFFFFFFu))));
+    }
+
+    uint32_t count() const
+    {
+        uint32_t total = 0;
+        for (auto value : counts)
+        {
+            total += value;
+        }
+        return total;
+    }
+
+    // Upper bound of the bucket holding the percentile. 0 if empty.
+    uint32_t percentile(const double fraction) const
+    {
+        const auto total = count();
+        if (total == 0)
+        {
+            return 0;
+        }
+
+        const auto target = std::max(1u, static_cast<uint32_t>(fraction * total + 0.5));
+        uint32_t accumulated = 0;
+        for (size_t i = 0; i < bucketCount; ++i)
+        {
+            accumulated += counts[i];
+            if (accumulated >= target)
+            {
+                return std::min(maxUs, static_cast<uint32_t>(bucketLowerBound(i + 1) - 1));
+            }
+        }
+        return maxUs;
+    }
+
+    LatencyHistogram& operator+=(const LatencyHistogram& b)
+    {
+        for (size_t i = 0; i < bucketCount; ++i)
+        {
+            counts[i] += b.counts[i];
+        }
+        maxUs = std::max(maxUs, b.maxUs);
+        return *this;
+    }
+
+    uint32_t counts[bucketCount];
+    uint32_t maxUs = 0;
+};
+
+// Phases of an EngineMixer iteration
+enum class TickPhase
+{
+    INCOMING = 0,
+    RTCP,
+    MAINTENANCE,
+    DOMINANT_SPEAKER,
+    BANDWIDTH,
+    MIXING,
+    TRANSPORT_TICKS,
+    COUNT
+};
+
+inline const char* toString(const TickPhase phase)
+{
+    switch (phase)
+    {
+    case TickPhase::INCOMING:
+        return "incoming";
+    case TickPhase::RTCP:
+        return "rtcp";
+    case TickPhase::MAINTENANCE:
+        return "maintenance";
+    case TickPhase::DOMINANT_SPEAKER:
+        return "dominant_speaker";
+    case TickPhase::BANDWIDTH:
+        return "bandwidth";
+    case TickPhase::MIXING:
+        return "mixing";
+    case TickPhase::TRANSPORT_TICKS:
+        return "transport_ticks";
+    default:
+        return "unknown";
+    }
+}
+
+struct TickProfile
+{
+    static constexpr size_t phaseCount = static_cast<size_t>(TickPhase::COUNT);
+
+    LatencyHistogram& operator[](const TickPhase phase) { return phases[static_cast<size_t>(phase)]; }
+    const LatencyHistogram& operator[](const TickPhase phase) const { return phases[static_cast<size_t>(phase)]; }
+
+    TickPhase slowestPhase() const
+    {
+        size_t slowest = 0;
+        for (size_t i = 1; i < phaseCount; ++i)
+        {
+            if (phases[i].percentile(0.99) > phases[slowest].percentile(0.99))
+            {
+                slowest = i;
+            }
+        }
+        return static_cast<TickPhase>(slowest);
+    }
+
+    TickProfile& operator+=(const TickProfile& b)
+    {
+        for (size_t i = 0; i < phaseCount; ++i)
+        {
+            phases[i] += b.phases[i];
+        }
+        total += b.total;
+        return *this;
+    }
+
+    LatencyHistogram phases[phaseCount];
+    LatencyHistogram total;
+};
+
 struct MixerStats
 {
     double audioInQueueSamples = 0;
@@ -33,6 +184,8 @@ struct MixerStats
     uint32_t pacingQueue = 0;
     uint32_t rtxPacingQueue = 0;
 
+    TickProfile tickProfile;
+
     MixerStats& operator+=(const MixerStats& b)
     {
         audioInQueueSamples += b.audioInQueueSamples;
@@ -49,6 +202,7 @@ struct MixerStats
 
         pacingQueue += b.pacingQueue;
         rtxPacingQueue += b.rtxPacingQueue;
+        tickProfile += b.tickProfile;
 
         return *this;
     }
@@ -62,7 +216,29 @@ struct EngineStats
 
     uint32_t pollPeriodMs = 1;
 
+    uint32_t engines = 1;
+    uint32_t mixers = 0;
+    // fraction of the poll period spent running mixers and tasks, summed over engines
+    double load = 0;
+    // load of the busiest engine
+    double maxLoad = 0;
+    // time to run all mixers in an engine iteration, since the previous stats sample
+    LatencyHistogram tickTime;
+
     MixerStats activeMixers;
+
+    EngineStats& operator+=(const EngineStats& b)
+    {
+        timeSlipCount += b.timeSlipCount;
+        pollPeriodMs = std::max(pollPeriodMs, b.pollPeriodMs);
+        engines += b.engines;
+        mixers += b.mixers;
+        load += b.load;
+        maxLoad = std::max(maxLoad, b.maxLoad);
+        tickTime += b.tickTime;
+        activeMixers += b.activeMixers;
+        return *this;
+    }
 };
 
 } // namespace EngineStats
@@ -67,7 +67,9 @@ public:
           _requiredMidLevelBandwidth(0),
           _maxDefaultLevelBandwidthKbps(config.maxDefaultLevelBandwidthKbps),
           _lastN(lastN),
-          _slidesBitrateKbps(0)
+          _slidesBitrateKbps(0),
+          _slidesSsrc(0),
+          _routingRevision(0)
     {
     }
 
@@ -87,6 +89,7 @@ public:
         memset(&emptyStream, 0, sizeof(SimulcastStream));
         _participantStreams.emplace(endpointIdHash,
             makeParticipantStreams(emptyStream, utils::Optional<SimulcastStream>()));
+        invalidateRouting();
     }
 
     void addParticipant(const size_t endpointIdHash,
@@ -138,6 +141,7 @@ public:
             _participantStreams.emplace(endpointIdHash,
                 makeParticipantStreams(primary, utils::Optional<SimulcastStream>()));
         }
+        invalidateRouting();
     }
 
     void removeParticipant(const size_t endpointIdHash)
@@ -164,6 +168,7 @@ public:
             _requiredMidLevelBandwidth -= bwe::BandwidthUtils::getSimulcastLevelKbps(midQuality);
         }
         _participantStreams.erase(endpointIdHash);
+        invalidateRouting();
 
         logger::info("removeParticipant, endpointIdHash %lu", _loggableId.c_str(), endpointIdHash);
         return;
@@ -190,6 +195,7 @@ public:
 
         _pinMap.erase(endpointIdHash);
         _reversePinMap.erase(endpointIdHash);
+        invalidateRouting();
 
         for (const auto& pinMapEntry : _pinMap)
         {
@@ -225,6 +231,7 @@ public:
             _reversePinMap.emplace(targetEndpointIdHash, count);
             _pinMap.emplace(endpointIdHash, targetEndpointIdHash);
         }
+        invalidateRouting();
 
         logger::info("pin, endpointIdHash %lu, targetEndpointIdHash %lu, oldTarget %lu",
             _loggableId.c_str(),
@@ -277,7 +284,11 @@ public:
         QualityLevel desiredPinQuality, unpinnedQuality;
         getVideoQualityLimits(endpointIdHash, participantStream, desiredPinQuality, unpinnedQuality);
 
-        participantStream.unpinQualityLevel = unpinnedQuality;
+        if (participantStream.unpinQualityLevel != unpinnedQuality)
+        {
+            participantStream.unpinQualityLevel = unpinnedQuality;
+            invalidateRouting();
+        }
 
         if (desiredPinQuality == participantStream.pinQualityLevel)
         {
@@ -296,6 +307,7 @@ public:
 
             participantStream.pinQualityLevel = desiredPinQuality;
             participantStream.lowEstimateTimestamp = timestamp;
+            invalidateRouting();
             return true;
         }
 
@@ -313,6 +325,7 @@ public:
 
             participantStream.pinQualityLevel = desiredPinQuality;
             participantStream.lowEstimateTimestamp = timestamp;
+            invalidateRouting();
             return true;
         }
         else
@@ -552,6 +565,7 @@ public:
             {
                 simulcastLevel.mediaActive = active;
                 setHighestActiveIndex(endpointIdHash, primary);
+                invalidateRouting();
                 return;
             }
         }
@@ -564,6 +578,7 @@ public:
                 {
                     simulcastLevel.mediaActive = active;
                     setHighestActiveIndex(endpointIdHash, secondary.get());
+                    invalidateRouting();
                     return;
                 }
             }
@@ -655,10 +670,23 @@ public:
 
     void setSlidesSsrcAndBitrate(size_t slidesSsrc, uint32_t bwKbps)
     {
+        if (_slidesSsrc != slidesSsrc || _slidesBitrateKbps != bwKbps)
+        {
+            invalidateRouting();
+        }
         _slidesSsrc = slidesSsrc;
         _slidesBitrateKbps = bwKbps;
     }
 
+    /**
+     * Revision of the forwarding decisions. It changes whenever the result of shouldForwardSsrc may have changed, so
+     * routing tables built from it are valid as long as the revision is unchanged.
+     */
+    uint32_t getRoutingRevision() const { return _routingRevision; }
+
+    /** Invalidates routing tables after a change outside the director, like stream or ssrc rewrite changes. */
+    void invalidateRouting() { ++_routingRevision; }
+
 private:
     /** All bandwidth valuea are in kbps. */
     struct ConfigRow
@@ -701,6 +729,8 @@ private:
     /** SSRC for slides. */
     size_t _slidesSsrc;
 
+    uint32_t _routingRevision;
+
     inline QualityLevel highestActiveQuality(const size_t endpointIdHash, const uint32_t ssrc)
     {
         const auto participantStreamsItr = _participantStreams.find(endpointIdHash);
@@ -0,0 +1,167 @@
+#include "bridge/engine/MixEncoder.h"
+#include "bridge/engine/EncodeJob.h"
+#include "codec/AudioLevel.h"
+#include "codec/OpusEncoder.h"
+#include "logger/Logger.h"
+#include "transport/Transport.h"
+#include <cstring>
+
+namespace bridge
+{
+
+class MixEncoder::EncodeFrameJob : public jobmanager::Job
+{
+public:
+    EncodeFrameJob(MixEncoder& owner, Frame& frame) : _owner(owner), _frame(frame) {}
+
+    void run() override { _owner.encode(_frame); }
+
+private:
+    MixEncoder& _owner;
+    Frame& _frame;
+};
+
+MixEncoder::MixEncoder(jobmanager::JobManager& jobManager,
+    memory::PacketPoolAllocator& sendAllocator,
+    memory::SharedPacketAllocator& sharedPacketAllocator)
+    : _sendAllocator(sendAllocator),
+      _sharedPacketAllocator(sharedPacketAllocator),
+      _frameSequence(0),
+      _idle(true),
+      _encodedSequence(0),
+      _jobQueue(jobManager, frameCount * 2)
+{
+    std::memset(_lastSentMix, 0, sizeof(_lastSentMix));
+}
+
+MixEncoder::~MixEncoder() {}
+
+MixEncoder::Frame* MixEncoder::beginFrame(const int16_t* mixedData, const uint64_t rtpTimestamp)
+{
+    auto& frame = _frames[(_frameSequence + 1) % frameCount];
+    if (frame.queued.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+
+    frame.sequence = ++_frameSequence;
+    std::memcpy(frame.pcm, mixedData, sizeof(frame.pcm));
+    frame.rtpTimestamp = rtpTimestamp;
+    frame.resetEncoder = false;
+    return &frame;
+}
+
+void MixEncoder::addReceiver(Frame& frame, SsrcOutboundContext& outboundContext, transport::Transport& transport)
+{
+    ++transport.getJobCounter(); // released when the frame has been sent
+    frame.receivers.push_back({&outboundContext, &transport});
+}
+
+void MixEncoder::addHandover(Frame& frame,
+    memory::UniqueAudioPacket packet,
+    memory::UniqueAudioPacket primer,
+    SsrcOutboundContext& outboundContext,
+    transport::Transport& transport)
+{
+    ++transport.getJobCounter(); // released when the EncodeJob has been added
+    Handover handover;
+    handover.packet = std::move(packet);
+    handover.primer = std::move(primer);
+    handover.outboundContext = &outboundContext;
+    handover.transport = &transport;
+    frame.handovers.push_back(std::move(handover));
+}
+
+void MixEncoder::post(Frame& frame)
+{
+    if (frame.receivers.empty())
+    {
+        // the encoder state would be stale by the time someone hears the full mix again
+        _idle = true;
+        if (frame.handovers.empty())
+        {
+            return;
+        }
+    }
+    else
+    {
+        frame.resetEncoder = _idle;
+        _idle = false;
+        std::memcpy(_lastSentMix, frame.pcm, sizeof(_lastSentMix));
+    }
+
+    frame.queued.store(true, std::memory_order_release);
+    if (!_jobQueue.addJob<EncodeFrameJob>(*this, frame))
+    {
+        // cannot happen as the queue has room for all frames. Send nothing rather than block the engine.
+        logger::error("Failed to queue mix frame", "MixEncoder");
+        frame.receivers.clear();
+        frame.handovers.clear();
+        frame.queued.store(false, std::memory_order_release);
+        _idle = true;
+    }
+}
+
+void MixEncoder::encode(Frame& frame)
+{
+    memory::SharedPacket payload;
+    int audioLevel = 0;
+    if (!frame.receivers.empty())
+    {
+        if (frame.resetEncoder || !_encoder)
+        {
+            _encoder.reset(new codec::OpusEncoder());
+        }
+
+        auto packet = memory::makeUniquePacket(_sendAllocator);
+        if (!packet)
+        {
+            logger::warn("send allocator depleted, mix frame dropped", "MixEncoder");
+        }
+        else
+        {
+            const auto encodedBytes =
+                _encoder->encode(frame.pcm, EngineMixer::framesPerIteration48kHz, packet->get(), packet->size);
+            if (encodedBytes <= 0)
+            {
+                logger::error("Failed to encode opus, %d", "MixEncoder", encodedBytes);
+            }
+            else
+            {
+                packet->setLength(encodedBytes);
+                audioLevel = codec::computeAudioLevel(frame.pcm, EngineMixer::samplesPerIteration);
+                payload = memory::makeSharedPacket(_sharedPacketAllocator, packet);
+            }
+        }
+    }
+
+    for (auto& receiver : frame.receivers)
+    {
+        if (payload)
+        {
+            receiver.transport->getJobQueue().addJob<SendEncodedAudioJob>(payload,
+                audioLevel,
+                *receiver.outboundContext,
+                *receiver.transport,
+                frame.rtpTimestamp);
+        }
+        --receiver.transport->getJobCounter();
+    }
+
+    for (auto& handover : frame.handovers)
+    {
+        handover.transport->getJobQueue().addJob<EncodeJob>(std::move(handover.packet),
+            std::move(handover.primer),
+            *handover.outboundContext,
+            *handover.transport,
+            frame.rtpTimestamp);
+        --handover.transport->getJobCounter();
+    }
+
+    frame.receivers.clear();
+    frame.handovers.clear();
+    _encodedSequence.store(frame.sequence, std::memory_order_release);
+    frame.queued.store(false, std::memory_order_release);
+}
+
+} // namespace bridge
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "bridge/engine/EngineMixer.h"
+#include "jobmanager/JobQueue.h"
+#include "memory/AudioPacketPoolAllocator.h"
+#include "memory/PacketPoolAllocator.h"
+#include "memory/SharedPacket.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace codec
+{
+class OpusEncoder;
+}
+
+namespace transport
+{
+class Transport;
+}
+
+namespace bridge
+{
+
+class SsrcOutboundContext;
+
+/**
+ * Encodes the full audio mix of an EngineMixer once per iteration for all receivers that hear the full mix. The engine
+ * thread fills in a Frame and posts it. Frames are encoded in order on a serial job queue, which owns the opus encoder,
+ * and the encoded payload is handed to a SendEncodedAudioJob per receiver.
+ *
+ * A receiver that leaves the shared mix while one of its frames is still queued here must not have its own EncodeJob
+ * overtake that frame. Such jobs are handed over to the frame being posted and added after the shared sends.
+ *
+ * Frames are started, filled and posted on the engine thread only.
+ */
+class MixEncoder
+{
+public:
+    MixEncoder(jobmanager::JobManager& jobManager,
+        memory::PacketPoolAllocator& sendAllocator,
+        memory::SharedPacketAllocator& sharedPacketAllocator);
+    ~MixEncoder();
+
+    struct Receiver
+    {
+        SsrcOutboundContext* outboundContext;
+        transport::Transport* transport;
+    };
+
+    struct Handover
+    {
+        memory::UniqueAudioPacket packet;
+        memory::UniqueAudioPacket primer;
+        SsrcOutboundContext* outboundContext;
+        transport::Transport* transport;
+    };
+
+    struct Frame
+    {
+        Frame() : sequence(0), rtpTimestamp(0), resetEncoder(false), queued(false) {}
+
+        uint64_t sequence;
+        int16_t pcm[EngineMixer::samplesPerIteration];
+        uint64_t rtpTimestamp;
+        bool resetEncoder;
+        std::vector<Receiver> receivers;
+        std::vector<Handover> handovers;
+        std::atomic_bool queued;
+    };
+
+    // nullptr if all frames are still queued
+    Frame* beginFrame(const int16_t* mixedData, const uint64_t rtpTimestamp);
+    void addReceiver(Frame& frame, SsrcOutboundContext& outboundContext, transport::Transport& transport);
+    void addHandover(Frame& frame,
+        memory::UniqueAudioPacket packet,
+        memory::UniqueAudioPacket primer,
+        SsrcOutboundContext& outboundContext,
+        transport::Transport& transport);
+    void post(Frame& frame);
+    // called instead of post in iterations without a frame
+    void skip() { _idle = true; }
+
+    // true if the frame has not been encoded and sent yet
+    bool isQueued(const uint64_t frameSequence) const
+    {
+        return frameSequence > _encodedSequence.load(std::memory_order_acquire);
+    }
+
+    // the full mix as last sent to receivers of the shared mix
+    const int16_t* getLastSentMix() const { return _lastSentMix; }
+
+private:
+    static constexpr size_t frameCount = 8;
+
+    class EncodeFrameJob;
+
+    void encode(Frame& frame);
+
+    memory::PacketPoolAllocator& _sendAllocator;
+    memory::SharedPacketAllocator& _sharedPacketAllocator;
+
+    std::array<Frame, frameCount> _frames;
+    uint64_t _frameSequence;
+    bool _idle;
+    int16_t _lastSentMix[EngineMixer::samplesPerIteration];
+
+    std::unique_ptr<codec::OpusEncoder> _encoder; // used on _jobQueue only
+    std::atomic_uint64_t _encodedSequence;
+
+    jobmanager::JobQueue _jobQueue; // last, to finish pending frames before anything else is destroyed
+};
+
+} // namespace bridge
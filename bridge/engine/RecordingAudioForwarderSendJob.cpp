@@ -10,7 +10,7 @@
 namespace bridge
 {
 RecordingAudioForwarderSendJob::RecordingAudioForwarderSendJob(SsrcOutboundContext& outboundContext,
-    memory::UniquePacket packet,
+    memory::SharedPacket packet,
     transport::RecordingTransport& transport,
     const uint32_t extendedSequenceNumber,
     MixerManagerAsync& mixerManager,
@@ -31,27 +31,35 @@ RecordingAudioForwarderSendJob::RecordingAudioForwarderSendJob(SsrcOutboundConte
 
 void RecordingAudioForwarderSendJob::run()
 {
-    auto rtpHeader = rtp::RtpHeader::fromPacket(*_packet);
-    if (!rtpHeader || !_transport.isConnected())
+    const auto* inboundHeader = rtp::RtpHeader::fromPacket(*_packet);
+    if (!inboundHeader || !_transport.isConnected())
     {
         if (!_transport.isConnected())
         {
             logger::debug("Dropping forwarded packet ssrc %u, seq %u. Not connected",
                 "RecordingAudioForwarderSendJob",
-                uint32_t(rtpHeader->ssrc),
-                uint16_t(rtpHeader->sequenceNumber));
+                uint32_t(inboundHeader->ssrc),
+                uint16_t(inboundHeader->sequenceNumber));
         }
 
         return;
     }
 
     uint16_t nextSequenceNumber = 0;
-    if (!_outboundContext.shouldSend(rtpHeader->ssrc, _extendedSequenceNumber))
+    if (!_outboundContext.shouldSend(inboundHeader->ssrc, _extendedSequenceNumber))
     {
         logger::debug("Dropping rec audio packet - sequence number...", "RecordingAudioForwarderSendJob");
         return;
     }
 
+    auto packet = _packet.makeWritable(_outboundContext.allocator);
+    if (!packet)
+    {
+        logger::warn("send allocator depleted", "RecordingAudioForwarderSendJob");
+        return;
+    }
+    auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+
     bridge::AudioRewriter::rewrite(_outboundContext, _extendedSequenceNumber, *rtpHeader);
 
     if (_outboundContext.packetCache.isSet())
@@ -59,7 +67,7 @@ void RecordingAudioForwarderSendJob::run()
         auto packetCache = _outboundContext.packetCache.get();
         if (packetCache)
         {
-            if (!packetCache->add(*_packet, nextSequenceNumber))
+            if (!packetCache->add(*packet, nextSequenceNumber))
             {
                 logger::warn("Failed to cache rec audio packet", "RecordingAudioForwarderSendJob");
             }
@@ -76,6 +84,6 @@ void RecordingAudioForwarderSendJob::run()
         _mixerManager.asyncAllocateRecordingRtpPacketCache(_mixer, _outboundContext.ssrc, _endpointIdHash);
     }
 
-    _transport.protectAndSend(std::move(_packet));
+    _transport.protectAndSend(std::move(packet));
 }
 } // namespace bridge
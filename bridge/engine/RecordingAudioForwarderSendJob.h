@@ -1,7 +1,7 @@
 #pragma once
 
 #include "jobmanager/Job.h"
-#include "memory/PacketPoolAllocator.h"
+#include "memory/SharedPacket.h"
 #include <cstdint>
 
 namespace memory
@@ -25,7 +25,7 @@ class RecordingAudioForwarderSendJob : public jobmanager::CountedJob
 {
 public:
     RecordingAudioForwarderSendJob(SsrcOutboundContext& outboundContext,
-        memory::UniquePacket packet,
+        memory::SharedPacket packet,
         transport::RecordingTransport& transport,
         const uint32_t extendedSequenceNumber,
         MixerManagerAsync& mixerManager,
@@ -36,7 +36,7 @@ public:
 
 private:
     SsrcOutboundContext& _outboundContext;
-    memory::UniquePacket _packet;
+    memory::SharedPacket _packet;
     transport::RecordingTransport& _transport;
     uint32_t _extendedSequenceNumber;
     MixerManagerAsync& _mixerManager;
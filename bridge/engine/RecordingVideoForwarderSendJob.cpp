@@ -12,7 +12,7 @@ namespace bridge
 
 RecordingVideoForwarderSendJob::RecordingVideoForwarderSendJob(SsrcOutboundContext& outboundContext,
     SsrcInboundContext& senderInboundContext,
-    memory::UniquePacket packet,
+    memory::SharedPacket packet,
     transport::Transport& transport,
     const uint32_t extendedSequenceNumber,
     MixerManagerAsync& mixerManager,
@@ -34,8 +34,8 @@ RecordingVideoForwarderSendJob::RecordingVideoForwarderSendJob(SsrcOutboundConte
 
 void RecordingVideoForwarderSendJob::run()
 {
-    auto rtpHeader = rtp::RtpHeader::fromPacket(*_packet);
-    if (!rtpHeader)
+    const auto* inboundHeader = rtp::RtpHeader::fromPacket(*_packet);
+    if (!inboundHeader)
     {
         assert(false); // should have been checked multiple times
         return;
@@ -46,7 +46,7 @@ void RecordingVideoForwarderSendJob::run()
         logger::warn("%s rtx packet should not reach rewrite and send. ssrc %u, seq %u",
             "RecordingVideoForwarderSendJob",
             _transport.getLoggableId().c_str(),
-            rtpHeader->ssrc.get(),
+            inboundHeader->ssrc.get(),
             _extendedSequenceNumber);
         return;
     }
@@ -62,11 +62,11 @@ void RecordingVideoForwarderSendJob::run()
         _mixerManager.asyncAllocateRecordingRtpPacketCache(_mixer, _outboundContext.ssrc, _endpointIdHash);
     }
 
-    const bool isKeyFrame = codec::Vp8Header::isKeyFrame(rtpHeader->getPayload(),
-        codec::Vp8Header::getPayloadDescriptorSize(rtpHeader->getPayload(),
-            _packet->getLength() - rtpHeader->headerLength()));
+    const bool isKeyFrame = codec::Vp8Header::isKeyFrame(inboundHeader->getPayload(),
+        codec::Vp8Header::getPayloadDescriptorSize(inboundHeader->getPayload(),
+            _packet->getLength() - inboundHeader->headerLength()));
 
-    const auto ssrc = rtpHeader->ssrc.get();
+    const auto ssrc = inboundHeader->ssrc.get();
     if (ssrc != _outboundContext.originalSsrc)
     {
         if (!isKeyFrame)
@@ -100,9 +100,19 @@ void RecordingVideoForwarderSendJob::run()
         return;
     }
 
+    auto packet = _packet.makeWritable(_outboundContext.allocator);
+    if (!packet)
+    {
+        logger::warn("%s send allocator depleted",
+            "RecordingVideoForwarderSendJob",
+            _transport.getLoggableId().c_str());
+        return;
+    }
+    auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+
     uint32_t rewrittenExtendedSequenceNumber = 0;
     if (!Vp8Rewriter::rewrite(_outboundContext,
-            *_packet,
+            *packet,
             _extendedSequenceNumber,
             _transport.getLoggableId().c_str(),
             rewrittenExtendedSequenceNumber,
@@ -116,7 +126,7 @@ void RecordingVideoForwarderSendJob::run()
 
     if (_outboundContext.packetCache.isSet() && _outboundContext.packetCache.get())
     {
-        if (!_outboundContext.packetCache.get()->add(*_packet, rtpHeader->sequenceNumber))
+        if (!_outboundContext.packetCache.get()->add(*packet, rtpHeader->sequenceNumber))
         {
             logger::warn("%s failed to add packet to cache. ssrc %u, seq %u",
                 "RecordingVideoForwarderSendJob",
@@ -126,7 +136,7 @@ void RecordingVideoForwarderSendJob::run()
         }
     }
 
-    _transport.protectAndSend(std::move(_packet));
+    _transport.protectAndSend(std::move(packet));
 }
 
 } // namespace bridge
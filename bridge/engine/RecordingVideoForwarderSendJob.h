@@ -1,7 +1,7 @@
 #pragma once
 
 #include "jobmanager/Job.h"
-#include "memory/PacketPoolAllocator.h"
+#include "memory/SharedPacket.h"
 
 namespace transport
 {
@@ -20,7 +20,7 @@ class RecordingVideoForwarderSendJob : public jobmanager::CountedJob
 public:
     RecordingVideoForwarderSendJob(SsrcOutboundContext& outboundContext,
         SsrcInboundContext& senderInboundContext,
-        memory::UniquePacket packet,
+        memory::SharedPacket packet,
         transport::Transport& transport,
         const uint32_t extendedSequenceNumber,
         MixerManagerAsync& mixerManager,
@@ -32,7 +32,7 @@ public:
 private:
     SsrcOutboundContext& _outboundContext;
     SsrcInboundContext& _senderInboundContext;
-    memory::UniquePacket _packet;
+    memory::SharedPacket _packet;
     transport::Transport& _transport;
     uint32_t _extendedSequenceNumber;
     MixerManagerAsync& _mixerManager;
@@ -0,0 +1,74 @@
+#include "bridge/engine/RtxRewriteMap.h"
+#include "bridge/engine/VideoPacketStore.h"
+#include <cstring>
+
+namespace bridge
+{
+
+RtxRewriteMap::RtxRewriteMap() : _lastSourceId(0)
+{
+    std::memset(_entries, 0, sizeof(_entries));
+}
+
+void RtxRewriteMap::add(const uint32_t outboundSequenceNumber,
+    const uint32_t inboundSequenceNumber,
+    const std::shared_ptr<VideoPacketStore>& store,
+    const int32_t timestampOffset,
+    const int16_t picIdOffset,
+    const int16_t tl0PicIdxOffset,
+    const utils::Optional<uint8_t>& absSendTimeExtId)
+{
+    if (!isCurrentSource(store.get(), timestampOffset, picIdOffset, tl0PicIdxOffset, absSendTimeExtId))
+    {
+        // entries that refer to the replaced source can no longer be retransmitted
+        auto& source = _sources[++_lastSourceId % maxSources];
+        source.id = _lastSourceId;
+        source.store = store;
+        source.timestampOffset = timestampOffset;
+        source.picIdOffset = picIdOffset;
+        source.tl0PicIdxOffset = tl0PicIdxOffset;
+        source.absSendTimeExtId = absSendTimeExtId;
+    }
+
+    auto& entry = _entries[outboundSequenceNumber % maxPackets];
+    entry.outboundSequenceNumber = outboundSequenceNumber;
+    entry.inboundSequenceNumber = inboundSequenceNumber;
+    entry.sourceId = _lastSourceId;
+}
+
+const RtxRewriteMap::Source* RtxRewriteMap::find(const uint16_t sequenceNumber, uint32_t& inboundSequenceNumber) const
+{
+    const auto& entry = _entries[sequenceNumber % maxPackets];
+    if (entry.sourceId == 0 || (entry.outboundSequenceNumber & 0xFFFFu) != sequenceNumber)
+    {
+        return nullptr;
+    }
+
+    const auto& source = _sources[entry.sourceId % maxSources];
+    if (source.id != entry.sourceId)
+    {
+        return nullptr;
+    }
+
+    inboundSequenceNumber = entry.inboundSequenceNumber;
+    return &source;
+}
+
+bool RtxRewriteMap::isCurrentSource(const VideoPacketStore* store,
+    const int32_t timestampOffset,
+    const int16_t picIdOffset,
+    const int16_t tl0PicIdxOffset,
+    const utils::Optional<uint8_t>& absSendTimeExtId) const
+{
+    if (_lastSourceId == 0)
+    {
+        return false;
+    }
+
+    const auto& source = _sources[_lastSourceId % maxSources];
+    return source.store.get() == store && source.timestampOffset == timestampOffset &&
+        source.picIdOffset == picIdOffset && source.tl0PicIdxOffset == tl0PicIdxOffset &&
+        source.absSendTimeExtId == absSendTimeExtId;
+}
+
+} // namespace bridge
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "utils/Optional.h"
+#include <cstdint>
+#include <memory>
+
+namespace bridge
+{
+
+class VideoPacketStore;
+
+/**
+ * Remembers, for the packets recently forwarded on an outbound video SSRC, which inbound packet they were made from
+ * and with which offsets. A retransmission copies the inbound packet from its VideoPacketStore and redoes the rewrite,
+ * so there is no need to keep a rewritten copy per receiver.
+ *
+ * RtxRewriteMap is not thread safe. It is used from the receiver's transport jobs only.
+ */
+class RtxRewriteMap
+{
+public:
+    struct Source
+    {
+        Source() : id(0), timestampOffset(0), picIdOffset(0), tl0PicIdxOffset(0) {}
+
+        uint32_t id;
+        std::shared_ptr<VideoPacketStore> store;
+        int32_t timestampOffset;
+        int16_t picIdOffset;
+        int16_t tl0PicIdxOffset;
+        utils::Optional<uint8_t> absSendTimeExtId; // as sent by the sender
+    };
+
+    RtxRewriteMap();
+
+    void add(const uint32_t outboundSequenceNumber,
+        const uint32_t inboundSequenceNumber,
+        const std::shared_ptr<VideoPacketStore>& store,
+        const int32_t timestampOffset,
+        const int16_t picIdOffset,
+        const int16_t tl0PicIdxOffset,
+        const utils::Optional<uint8_t>& absSendTimeExtId);
+
+    const Source* find(const uint16_t sequenceNumber, uint32_t& inboundSequenceNumber) const;
+
+    constexpr static size_t maxPackets = 512;
+    constexpr static size_t maxSources = 4;
+
+private:
+    struct Entry
+    {
+        uint32_t outboundSequenceNumber;
+        uint32_t inboundSequenceNumber;
+        uint32_t sourceId; // 0 if unused
+    };
+
+    bool isCurrentSource(const VideoPacketStore* store,
+        const int32_t timestampOffset,
+        const int16_t picIdOffset,
+        const int16_t tl0PicIdxOffset,
+        const utils::Optional<uint8_t>& absSendTimeExtId) const;
+
+    Entry _entries[maxPackets];
+    Source _sources[maxSources];
+    uint32_t _lastSourceId;
+};
+
+} // namespace bridge
@@ -3,6 +3,7 @@
 #include "bridge/RtpMap.h"
 #include "bridge/engine/PliScheduler.h"
 #include "bridge/engine/VideoMissingPacketsTracker.h"
+#include "codec/AudioLevel.h"
 #include "codec/OpusDecoder.h"
 #include "jobmanager/JobQueue.h"
 #include "transport/RtcTransport.h"
@@ -20,6 +21,7 @@ namespace bridge
 {
 
 struct RtpMap;
+class VideoPacketStore;
 
 /**
  * Maintains state and media graph for an inbound SSRC media stream
@@ -42,11 +44,14 @@ public:
           lastReceivedExtendedSequenceNumber(0),
           packetsProcessed(0),
           lastUnprotectedExtendedSequenceNumber(0),
+          decodeSkipped(false),
           activeMedia(false),
           inactiveTransitionCount(0),
+          mixSelected(true),
           isSsrcUsed(true),
           endpointIdHash(sender ? sender->getEndpointIdHash() : 0),
           shouldDropPackets(false),
+          decodeSelected(true),
           _lastReceiveTime(timestamp)
     {
     }
@@ -86,11 +91,15 @@ public:
     uint32_t packetsProcessed;
     uint32_t lastUnprotectedExtendedSequenceNumber;
     std::shared_ptr<VideoMissingPacketsTracker> videoMissingPacketsTracker;
+    std::shared_ptr<VideoPacketStore> packetStore; // read by receivers' transport jobs for retransmission
     std::unique_ptr<codec::OpusDecoder> opusDecoder;
+    codec::VoiceActivityDetector voiceActivityDetector;
+    bool decodeSkipped; // packets were forwarded without decoding and the decoder must restart
 
     // engine variables ==============================================
     bool activeMedia;
     uint32_t inactiveTransitionCount; // used to decide shouldDropPackets and turn this simulcast level off
+    bool mixSelected; // decoded audio is added to the mix
 
     // engine + transport thread access =============================
     std::atomic_bool isSsrcUsed; // for early discarding of video
@@ -99,6 +108,9 @@ public:
     /** If an inbound stream is considered unstable, we can, in a simulcast scenario, decide to drop an inbound stream
      * early to avoid toggling between quality levels. If this is set to true, all incoming packets will be dropped. */
     std::atomic_bool shouldDropPackets;
+    /** Cleared by the engine when the mixer decode limit excludes this sender. Packets that carry an audio level are
+     * then forwarded without being decoded. */
+    std::atomic_bool decodeSelected;
 
 private:
     std::atomic_uint64_t _lastReceiveTime;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "bridge/RtpMap.h"
+#include "bridge/engine/RtxRewriteMap.h"
 #include "codec/OpusEncoder.h"
 #include "memory/PacketPoolAllocator.h"
 #include "utils/Optional.h"
@@ -94,6 +95,10 @@ public:
     uint16_t lastRespondedNackBlp;
     uint64_t lastRespondedNackTimestamp;
 
+    // source of the packets recently forwarded, for retransmission. Created on first forwarded packet
+    std::unique_ptr<RtxRewriteMap> rtxRewriteMap;
+
+    // recording only
     utils::Optional<PacketCache*> packetCache;
 
     /// ==== both Engine and Transport
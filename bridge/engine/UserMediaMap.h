@@ -0,0 +1,42 @@
+#pragma once
+
+#include "bridge/engine/EndpointId.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace bridge
+{
+
+/**
+ * The user media map of an endpoint that pins no one and is outside the part of the active video list that makes up
+ * its map. All such endpoints receive the same map, so it is made once. See ActiveMediaList::makeUserMediaMap.
+ */
+struct UserMediaMap
+{
+    struct Entry
+    {
+        bool operator==(const Entry& other) const
+        {
+            return endpointIdHash == other.endpointIdHash && ssrcCount == other.ssrcCount &&
+                std::equal(ssrcs, ssrcs + ssrcCount, other.ssrcs);
+        }
+
+        size_t endpointIdHash;
+        EndpointIdString endpointId;
+        uint32_t ssrcs[2]; // main video and screen share
+        size_t ssrcCount;
+    };
+
+    bool operator==(const UserMediaMap& other) const
+    {
+        return count == other.count && std::equal(entries.cbegin(), entries.cbegin() + count, other.entries.cbegin());
+    }
+    bool operator!=(const UserMediaMap& other) const { return !(*this == other); }
+
+    std::array<Entry, 32> entries; // same capacity as the active video list
+    size_t count = 0;
+};
+
+} // namespace bridge
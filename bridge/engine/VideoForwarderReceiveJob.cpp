@@ -1,6 +1,7 @@
 #include "bridge/engine/VideoForwarderReceiveJob.h"
 #include "bridge/engine/EngineMixer.h"
 #include "bridge/engine/SendPliJob.h"
+#include "bridge/engine/VideoPacketStore.h"
 #include "codec/Vp8Header.h"
 #include "logger/Logger.h"
 #include "memory/Packet.h"
@@ -111,6 +112,10 @@ void VideoForwarderReceiveJob::run()
     {
         _ssrcContext.lastReceivedExtendedSequenceNumber = _extendedSequenceNumber;
         _ssrcContext.videoMissingPacketsTracker = std::make_shared<VideoMissingPacketsTracker>();
+        if (!_ssrcContext.packetStore)
+        {
+            _ssrcContext.packetStore = std::make_shared<VideoPacketStore>("VideoPacketStore", _ssrcContext.ssrc);
+        }
 
         logger::info("Adding missing packet tracker for %s, ssrc %u",
             "VideoForwarderReceiveJob",
@@ -254,6 +259,7 @@ void VideoForwarderReceiveJob::run()
     }
 
     assert(rtpHeader->payloadType == utils::checkedCast<uint16_t>(_ssrcContext.rtpMap.payloadType));
+    _ssrcContext.packetStore->add(*_packet, _extendedSequenceNumber);
     _engineMixer.onForwarderVideoRtpPacketDecrypted(_ssrcContext, std::move(_packet), _extendedSequenceNumber);
 }
 
@@ -1,32 +1,24 @@
 #include "bridge/engine/VideoForwarderRewriteAndSendJob.h"
-#include "bridge/MixerManagerAsync.h"
-#include "bridge/engine/PacketCache.h"
+#include "bridge/engine/RtxRewriteMap.h"
 #include "bridge/engine/SsrcInboundContext.h"
 #include "bridge/engine/SsrcOutboundContext.h"
 #include "bridge/engine/Vp8Rewriter.h"
 #include "transport/Transport.h"
-#include "utils/Function.h"
 
 namespace bridge
 {
 
 VideoForwarderRewriteAndSendJob::VideoForwarderRewriteAndSendJob(SsrcOutboundContext& outboundContext,
     SsrcInboundContext& senderInboundContext,
-    memory::UniquePacket packet,
+    memory::SharedPacket packet,
     transport::Transport& transport,
-    const uint32_t extendedSequenceNumber,
-    MixerManagerAsync& mixerManager,
-    size_t endpointIdHash,
-    EngineMixer& mixer)
+    const uint32_t extendedSequenceNumber)
     : jobmanager::CountedJob(transport.getJobCounter()),
       _outboundContext(outboundContext),
       _senderInboundContext(senderInboundContext),
       _packet(std::move(packet)),
       _transport(transport),
-      _extendedSequenceNumber(extendedSequenceNumber),
-      _mixerManager(mixerManager),
-      _endpointIdHash(endpointIdHash),
-      _mixer(mixer)
+      _extendedSequenceNumber(extendedSequenceNumber)
 {
     assert(_packet);
     assert(_packet->getLength() > 0);
@@ -34,8 +26,8 @@ VideoForwarderRewriteAndSendJob::VideoForwarderRewriteAndSendJob(SsrcOutboundCon
 
 void VideoForwarderRewriteAndSendJob::run()
 {
-    auto rtpHeader = rtp::RtpHeader::fromPacket(*_packet);
-    if (!rtpHeader)
+    const auto* inboundHeader = rtp::RtpHeader::fromPacket(*_packet);
+    if (!inboundHeader)
     {
         assert(false); // should have been checked multiple times
         return;
@@ -46,27 +38,16 @@ void VideoForwarderRewriteAndSendJob::run()
         logger::warn("%s rtx packet should not reach rewrite and send. ssrc %u, seq %u",
             "VideoForwarderRewriteAndSendJob",
             _transport.getLoggableId().c_str(),
-            rtpHeader->ssrc.get(),
+            inboundHeader->ssrc.get(),
             _extendedSequenceNumber);
         return;
     }
 
-    if (!_outboundContext.packetCache.isSet())
-    {
-        logger::debug("New ssrc %u seen on %s, sending request to add videoPacketCache to transport",
-            "VideoForwarderRewriteAndSendJob",
-            _outboundContext.ssrc,
-            _transport.getLoggableId().c_str());
-
-        _outboundContext.packetCache.set(nullptr);
-        _mixerManager.asyncAllocateVideoPacketCache(_mixer, _outboundContext.ssrc, _endpointIdHash);
-    }
-
-    const bool isKeyFrame = codec::Vp8Header::isKeyFrame(rtpHeader->getPayload(),
-        codec::Vp8Header::getPayloadDescriptorSize(rtpHeader->getPayload(),
-            _packet->getLength() - rtpHeader->headerLength()));
+    const bool isKeyFrame = codec::Vp8Header::isKeyFrame(inboundHeader->getPayload(),
+        codec::Vp8Header::getPayloadDescriptorSize(inboundHeader->getPayload(),
+            _packet->getLength() - inboundHeader->headerLength()));
 
-    const auto ssrc = rtpHeader->ssrc.get();
+    const auto ssrc = inboundHeader->ssrc.get();
     if (ssrc != _outboundContext.originalSsrc)
     {
         if (!isKeyFrame)
@@ -95,12 +76,12 @@ void VideoForwarderRewriteAndSendJob::run()
         }
     }
 
-    if (!_outboundContext.shouldSend(rtpHeader->ssrc, _extendedSequenceNumber))
+    if (!_outboundContext.shouldSend(inboundHeader->ssrc, _extendedSequenceNumber))
     {
         logger::debug("%s dropping packet. Rewrite not suitable ssrc %u, seq %u",
             "VideoForwarderRewriteAndSendJob",
             _transport.getLoggableId().c_str(),
-            rtpHeader->ssrc.get(),
+            inboundHeader->ssrc.get(),
             _extendedSequenceNumber);
 
         return;
@@ -111,9 +92,19 @@ void VideoForwarderRewriteAndSendJob::run()
         return;
     }
 
+    auto packet = _packet.makeWritable(_outboundContext.allocator);
+    if (!packet)
+    {
+        logger::warn("%s send allocator depleted",
+            "VideoForwarderRewriteAndSendJob",
+            _transport.getLoggableId().c_str());
+        return;
+    }
+    auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+
     uint32_t rewrittenExtendedSequenceNumber = 0;
     if (!Vp8Rewriter::rewrite(_outboundContext,
-            *_packet,
+            *packet,
             _extendedSequenceNumber,
             _transport.getLoggableId().c_str(),
             rewrittenExtendedSequenceNumber,
@@ -125,19 +116,24 @@ void VideoForwarderRewriteAndSendJob::run()
     rtpHeader->payloadType = _outboundContext.rtpMap.payloadType;
     rewriteHeaderExtensions(rtpHeader, _senderInboundContext, _outboundContext);
 
-    if (_outboundContext.packetCache.isSet() && _outboundContext.packetCache.get())
+    if (_senderInboundContext.packetStore)
     {
-        if (!_outboundContext.packetCache.get()->add(*_packet, rtpHeader->sequenceNumber))
+        if (!_outboundContext.rtxRewriteMap)
         {
-            logger::warn("%s failed to add packet to cache. ssrc %u, seq %u",
-                "VideoForwarderRewriteAndSendJob",
-                _transport.getLoggableId().c_str(),
-                rtpHeader->ssrc.get(),
-                rtpHeader->sequenceNumber.get());
+            _outboundContext.rtxRewriteMap = std::make_unique<RtxRewriteMap>();
         }
+
+        const auto& offset = _outboundContext.rewrite.offset;
+        _outboundContext.rtxRewriteMap->add(rewrittenExtendedSequenceNumber,
+            _extendedSequenceNumber,
+            _senderInboundContext.packetStore,
+            offset.timestamp,
+            offset.picId,
+            offset.tl0PicIdx,
+            _senderInboundContext.rtpMap.absSendTimeExtId);
     }
 
-    _transport.protectAndSend(std::move(_packet));
+    _transport.protectAndSend(std::move(packet));
 }
 
 } // namespace bridge
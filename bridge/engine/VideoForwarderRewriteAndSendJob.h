@@ -1,7 +1,7 @@
 #pragma once
 
 #include "jobmanager/Job.h"
-#include "memory/PacketPoolAllocator.h"
+#include "memory/SharedPacket.h"
 
 namespace transport
 {
@@ -10,34 +10,26 @@ class Transport;
 
 namespace bridge
 {
-class MixerManagerAsync;
 class SsrcOutboundContext;
 class SsrcInboundContext;
-class EngineMixer;
 
 class VideoForwarderRewriteAndSendJob : public jobmanager::CountedJob
 {
 public:
     VideoForwarderRewriteAndSendJob(SsrcOutboundContext& outboundContext,
         SsrcInboundContext& senderInboundContext,
-        memory::UniquePacket packet,
+        memory::SharedPacket packet,
         transport::Transport& transport,
-        const uint32_t extendedSequenceNumber,
-        MixerManagerAsync& mixerManager,
-        size_t endpointIdHash,
-        EngineMixer& mixer);
+        const uint32_t extendedSequenceNumber);
 
     void run() override;
 
 private:
     SsrcOutboundContext& _outboundContext;
     SsrcInboundContext& _senderInboundContext;
-    memory::UniquePacket _packet;
+    memory::SharedPacket _packet;
     transport::Transport& _transport;
     uint32_t _extendedSequenceNumber;
-    MixerManagerAsync& _mixerManager;
-    size_t _endpointIdHash;
-    EngineMixer& _mixer;
 };
 
 } // namespace bridge
@@ -1,6 +1,7 @@
 #include "bridge/engine/VideoForwarderRtxReceiveJob.h"
 #include "bridge/engine/EngineBarbell.h"
 #include "bridge/engine/EngineMixer.h"
+#include "bridge/engine/VideoPacketStore.h"
 #include "bridge/engine/Vp8Rewriter.h"
 #include "logger/Logger.h"
 #include "memory/Packet.h"
@@ -87,6 +88,10 @@ void VideoForwarderRtxReceiveJob::run()
         return;
     }
 
+    if (_ssrcContext.packetStore)
+    {
+        _ssrcContext.packetStore->add(*_packet, extendedSequenceNumber);
+    }
     _engineMixer.onForwarderVideoRtpPacketDecrypted(_ssrcContext, std::move(_packet), extendedSequenceNumber);
 }
 
@@ -1,6 +1,8 @@
 #include "bridge/engine/VideoNackReceiveJob.h"
-#include "bridge/engine/PacketCache.h"
+#include "bridge/engine/RtxRewriteMap.h"
 #include "bridge/engine/SsrcOutboundContext.h"
+#include "bridge/engine/VideoPacketStore.h"
+#include "bridge/engine/Vp8Rewriter.h"
 #include "rtp/RtpHeader.h"
 #include "transport/RtcTransport.h"
 
@@ -36,8 +38,8 @@ void VideoNackReceiveJob::run()
         _blp,
         _sender.getLoggableId().c_str());
 
-    // it may be that we post a few of these jobs before cache has been set, but that is ok
-    if (!_sender.isConnected() || !_mainOutboundContext.packetCache.isSet() || !_mainOutboundContext.packetCache.get())
+    // nothing has been forwarded yet if the rewrite map is missing
+    if (!_sender.isConnected() || !_mainOutboundContext.rtxRewriteMap)
     {
         return;
     }
@@ -89,34 +91,43 @@ void VideoNackReceiveJob::sendIfCached(const uint16_t sequenceNumber)
         return;
     }
 
-    const auto cachedPacket = _mainOutboundContext.packetCache.get()->get(sequenceNumber);
-    if (!cachedPacket)
+    uint32_t inboundSequenceNumber = 0;
+    const auto* source = _mainOutboundContext.rtxRewriteMap->find(sequenceNumber, inboundSequenceNumber);
+    if (!source)
     {
         return;
     }
 
-    const auto cachedRtpHeader = rtp::RtpHeader::fromPacket(*cachedPacket);
-    if (!cachedRtpHeader)
+    auto packet = memory::makeUniquePacket(_rtxSsrcOutboundContext.allocator);
+    if (!packet)
     {
         return;
     }
 
-    auto packet = memory::makeUniquePacket(_rtxSsrcOutboundContext.allocator);
-    if (!packet)
+    // fails if the sender's packet has been replaced in the store since
+    if (!source->store->get(inboundSequenceNumber, *packet) ||
+        packet->getLength() + sizeof(uint16_t) > memory::Packet::size)
+    {
+        return;
+    }
+
+    auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+    if (!rtpHeader)
     {
         return;
     }
 
-    const auto cachedRtpHeaderLength = cachedRtpHeader->headerLength();
-    const auto cachedPayload = cachedRtpHeader->getPayload();
-    const auto cachedSequenceNumber = cachedRtpHeader->sequenceNumber.get();
+    // redo the rewrite applied when the packet was forwarded
+    auto payload = rtpHeader->getPayload();
+    rtpHeader->timestamp = rtpHeader->timestamp.get() + source->timestampOffset;
+    codec::Vp8Header::setPicId(payload, codec::Vp8Header::getPicId(payload) + source->picIdOffset);
+    codec::Vp8Header::setTl0PicIdx(payload, codec::Vp8Header::getTl0PicIdx(payload) + source->tl0PicIdxOffset);
+    rewriteHeaderExtensions(rtpHeader, source->absSendTimeExtId, _mainOutboundContext.rtpMap.absSendTimeExtId);
 
-    memcpy(packet->get(), cachedPacket->get(), cachedRtpHeaderLength);
-    auto copyHead = packet->get() + cachedRtpHeaderLength;
-    reinterpret_cast<uint16_t*>(copyHead)[0] = hton<uint16_t>(cachedSequenceNumber);
-    copyHead += sizeof(uint16_t);
-    memcpy(copyHead, cachedPayload, cachedPacket->getLength() - cachedRtpHeaderLength);
-    packet->setLength(cachedPacket->getLength() + sizeof(uint16_t));
+    const auto headerLength = rtpHeader->headerLength();
+    std::memmove(payload + sizeof(uint16_t), payload, packet->getLength() - headerLength);
+    reinterpret_cast<uint16_t*>(payload)[0] = hton<uint16_t>(sequenceNumber);
+    packet->setLength(packet->getLength() + sizeof(uint16_t));
 
     NACK_LOG("Sending cached packet seq %u, rtxSsrc %u, seq %u",
         "VideoNackReceiveJob",
@@ -124,12 +135,6 @@ void VideoNackReceiveJob::sendIfCached(const uint16_t sequenceNumber)
         _rtxSsrcOutboundContext.ssrc.get(),
         _rtxSsrcOutboundContext.sequenceCounter & 0xFFFFu);
 
-    auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
-    if (!rtpHeader)
-    {
-        return;
-    }
-
     rtpHeader->ssrc = _rtxSsrcOutboundContext.ssrc;
     rtpHeader->payloadType = _rtxSsrcOutboundContext.rtpMap.payloadType;
     rtpHeader->sequenceNumber = ++_rtxSsrcOutboundContext.rewrite.lastSent.sequenceNumber & 0xFFFF;
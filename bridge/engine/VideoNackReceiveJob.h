@@ -12,7 +12,6 @@ namespace bridge
 {
 
 class SsrcOutboundContext;
-class PacketCache;
 
 class VideoNackReceiveJob : public jobmanager::CountedJob
 {
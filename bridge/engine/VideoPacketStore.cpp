@@ -0,0 +1,84 @@
+#include "bridge/engine/VideoPacketStore.h"
+#include "memory/PageAllocator.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+namespace bridge
+{
+
+VideoPacketStore::VideoPacketStore(const char* loggableId, const uint32_t ssrc)
+    : _loggableId(loggableId),
+      _slots(nullptr),
+      _mappedSize(sizeof(Slot) * maxPackets)
+{
+    _slots = reinterpret_cast<Slot*>(memory::mapPages(_mappedSize));
+    assert(_slots);
+    for (size_t i = 0; i < maxPackets; ++i)
+    {
+        new (&_slots[i]) Slot();
+    }
+    logger::info("Creating packet store for ssrc %u", _loggableId.c_str(), ssrc);
+}
+
+VideoPacketStore::~VideoPacketStore()
+{
+    for (size_t i = 0; i < maxPackets; ++i)
+    {
+        _slots[i].~Slot();
+    }
+    memory::unmapPages(_slots, _mappedSize);
+}
+
+void VideoPacketStore::add(const memory::Packet& packet, const uint32_t extendedSequenceNumber)
+{
+    auto& slot = _slots[extendedSequenceNumber % maxPackets];
+    const auto version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const size_t length = packet.getLength();
+    const auto* data = packet.get();
+    for (size_t offset = 0; offset < length; offset += sizeof(uint64_t))
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, data + offset, std::min(sizeof(uint64_t), length - offset));
+        slot.words[offset / sizeof(uint64_t)].store(word, std::memory_order_relaxed);
+    }
+    slot.length.store(length, std::memory_order_relaxed);
+    slot.extendedSequenceNumber.store(extendedSequenceNumber, std::memory_order_relaxed);
+
+    slot.version.store(version + 2, std::memory_order_release);
+}
+
+bool VideoPacketStore::get(const uint32_t extendedSequenceNumber, memory::Packet& target) const
+{
+    const auto& slot = _slots[extendedSequenceNumber % maxPackets];
+    const auto version = slot.version.load(std::memory_order_acquire);
+    if ((version & 1) != 0 || slot.extendedSequenceNumber.load(std::memory_order_relaxed) != extendedSequenceNumber)
+    {
+        return false;
+    }
+
+    // length and words may be from another packet if the writer is active, which the version check below reveals
+    const size_t length =
+        std::min(static_cast<size_t>(slot.length.load(std::memory_order_relaxed)), memory::Packet::size);
+    auto* data = target.get();
+    for (size_t offset = 0; offset < length; offset += sizeof(uint64_t))
+    {
+        const uint64_t word = slot.words[offset / sizeof(uint64_t)].load(std::memory_order_relaxed);
+        std::memcpy(data + offset, &word, std::min(sizeof(uint64_t), length - offset));
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.version.load(std::memory_order_relaxed) != version)
+    {
+        return false;
+    }
+
+    target.setLength(length);
+    return true;
+}
+
+} // namespace bridge
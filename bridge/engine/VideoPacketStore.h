@@ -0,0 +1,49 @@
+#pragma once
+
+#include "logger/Logger.h"
+#include "memory/Packet.h"
+#include <atomic>
+#include <cstdint>
+
+namespace bridge
+{
+
+/**
+ * Holds the last maxPackets decrypted packets of an inbound video SSRC, indexed by extended sequence number. There is
+ * one store per inbound SSRC, shared by all receivers of that stream, and they re-apply their own rewrite when
+ * retransmitting. See RtxRewriteMap.
+ *
+ * Packets are added from the sender's transport job context only. Any thread may copy packets out. A copy fails if the
+ * packet has been replaced meanwhile. Slots are guarded by a sequence lock and the packet is copied in and out through
+ * relaxed atomic words, so a reader overlapping the writer sees a changed version rather than racing on plain memory.
+ */
+class VideoPacketStore
+{
+public:
+    VideoPacketStore(const char* loggableId, const uint32_t ssrc);
+    ~VideoPacketStore();
+
+    void add(const memory::Packet& packet, const uint32_t extendedSequenceNumber);
+    bool get(const uint32_t extendedSequenceNumber, memory::Packet& target) const;
+
+    constexpr static size_t maxPackets = 512;
+
+private:
+    constexpr static size_t wordCount = (memory::Packet::size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot
+    {
+        Slot() : version(0), extendedSequenceNumber(~0u), length(0) {}
+
+        std::atomic_uint32_t version; // odd while packet is written
+        std::atomic_uint32_t extendedSequenceNumber;
+        std::atomic_uint32_t length;
+        std::atomic_uint64_t words[wordCount];
+    };
+
+    logger::LoggableId _loggableId;
+    Slot* _slots;
+    size_t _mappedSize;
+};
+
+} // namespace bridge
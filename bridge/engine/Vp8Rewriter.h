@@ -195,8 +195,8 @@ inline uint16_t rewriteRtxPacket(memory::Packet& packet,
 } // namespace Vp8Rewriter
 
 inline void rewriteHeaderExtensions(rtp::RtpHeader* rtpHeader,
-    const bridge::SsrcInboundContext& senderInboundContext,
-    const bridge::SsrcOutboundContext& receiverOutboundContext)
+    const utils::Optional<uint8_t>& senderAbsSendTimeExtId,
+    const utils::Optional<uint8_t>& receiverAbsSendTimeExtId)
 {
     assert(rtpHeader);
 
@@ -206,22 +206,29 @@ inline void rewriteHeaderExtensions(rtp::RtpHeader* rtpHeader,
         return;
     }
 
-    const bool senderHasAbsSendTimeEx = senderInboundContext.rtpMap.absSendTimeExtId.isSet();
-    const bool receiverHasAbsSendTimeEx = receiverOutboundContext.rtpMap.absSendTimeExtId.isSet();
-    const bool absSendTimeExNeedToBeRewritten = senderHasAbsSendTimeEx && receiverHasAbsSendTimeEx &&
-        senderInboundContext.rtpMap.absSendTimeExtId.get() != receiverOutboundContext.rtpMap.absSendTimeExtId.get();
+    const bool absSendTimeExNeedToBeRewritten = senderAbsSendTimeExtId.isSet() &&
+        receiverAbsSendTimeExtId.isSet() && senderAbsSendTimeExtId.get() != receiverAbsSendTimeExtId.get();
 
     if (absSendTimeExNeedToBeRewritten)
     {
         for (auto& rtpHeaderExtension : headerExtensions->extensions())
         {
-            if (rtpHeaderExtension.getId() == senderInboundContext.rtpMap.absSendTimeExtId.get())
+            if (rtpHeaderExtension.getId() == senderAbsSendTimeExtId.get())
             {
-                rtpHeaderExtension.setId(receiverOutboundContext.rtpMap.absSendTimeExtId.get());
+                rtpHeaderExtension.setId(receiverAbsSendTimeExtId.get());
                 return;
             }
         }
     }
 }
 
+inline void rewriteHeaderExtensions(rtp::RtpHeader* rtpHeader,
+    const bridge::SsrcInboundContext& senderInboundContext,
+    const bridge::SsrcOutboundContext& receiverOutboundContext)
+{
+    rewriteHeaderExtensions(rtpHeader,
+        senderInboundContext.rtpMap.absSendTimeExtId,
+        receiverOutboundContext.rtpMap.absSendTimeExtId);
+}
+
 } // namespace bridge
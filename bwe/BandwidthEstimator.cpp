@@ -69,7 +69,6 @@ void BandwidthEstimator::update(uint32_t packetSize, uint64_t transmitTimeNs, ui
         _previousReceiveTime = receiveTimeNs - 5 * utils::Time::ms;
     }
 
-    const double tau = std::max(0.0, static_cast<double>(transmitTimeNs - _previousTransmitTime) / utils::Time::ms);
     const double observedDelay =
         static_cast<double>(static_cast<int64_t>(receiveTimeNs - transmitTimeNs - _baseClockOffset)) / utils::Time::ms;
 
@@ -77,6 +76,56 @@ void BandwidthEstimator::update(uint32_t packetSize, uint64_t transmitTimeNs, ui
     const double congestionScale = analyseCongestion(actualDelay, packetSize, receiveTimeNs);
 
     _receiveBandwidth.update(packetSize * 8, receiveTimeNs);
+
+    if (_config.packetGroupMs == 0)
+    {
+        updateFilter(packetSize, transmitTimeNs, receiveTimeNs, observedDelay, congestionScale);
+        return;
+    }
+
+    if (_packetGroup.count > 0 &&
+        static_cast<int64_t>(transmitTimeNs - _packetGroup.startTransmitTime) >
+            static_cast<int64_t>(_config.packetGroupMs * utils::Time::ms))
+    {
+        flushPacketGroup();
+    }
+
+    // the filter sees the group as one packet sent and received with its last packet
+    if (_packetGroup.count == 0)
+    {
+        _packetGroup.startTransmitTime = transmitTimeNs;
+    }
+    ++_packetGroup.count;
+    _packetGroup.size += packetSize;
+    _packetGroup.transmitTime = transmitTimeNs;
+    _packetGroup.receiveTime = receiveTimeNs;
+    _packetGroup.observedDelay = observedDelay;
+    _packetGroup.congestionScale = std::min(_packetGroup.congestionScale, congestionScale);
+}
+
+void BandwidthEstimator::flushPacketGroup()
+{
+    if (_packetGroup.count == 0)
+    {
+        return;
+    }
+
+    updateFilter(_packetGroup.size,
+        _packetGroup.transmitTime,
+        _packetGroup.receiveTime,
+        _packetGroup.observedDelay,
+        _packetGroup.congestionScale);
+    _packetGroup = PacketGroup();
+}
+
+void BandwidthEstimator::updateFilter(uint32_t packetSize,
+    uint64_t transmitTimeNs,
+    uint64_t receiveTimeNs,
+    double observedDelay,
+    double congestionScale)
+{
+    const double tau = std::max(0.0, static_cast<double>(transmitTimeNs - _previousTransmitTime) / utils::Time::ms);
+
     // predict mean state
     std::array<math::Matrix<double, 3>, SIGMA_POINTS> sigmaPoints;
     generateSigmaPoints(_state, _covarianceP, _processNoise, sigmaPoints);
@@ -334,6 +383,7 @@ double BandwidthEstimator::predictDelay(const math::Matrix<double, 3>& state)
 
 void BandwidthEstimator::reset()
 {
+    _packetGroup = PacketGroup();
     _state(0) = 0;
     _state(1) = _config.estimate.initialKbpsDownlink;
     _state(2) = 8000;
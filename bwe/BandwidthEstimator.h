@@ -54,6 +54,9 @@ struct Config
 
     const uint32_t mtu = 1470;
 
+    // Packets sent within this interval are aggregated into one filter update. 0 updates on every packet.
+    uint32_t packetGroupMs = 0;
+
     // use this before initializing Estimator as some values can cause division by zero
     void sanitize();
 };
@@ -83,6 +86,24 @@ public:
     void reset();
 
 private:
+    struct PacketGroup
+    {
+        uint32_t count = 0;
+        uint32_t size = 0;
+        uint64_t startTransmitTime = 0;
+        uint64_t transmitTime = 0;
+        uint64_t receiveTime = 0;
+        double observedDelay = 0;
+        double congestionScale = 1.0;
+    };
+
+    void updateFilter(uint32_t packetSize,
+        uint64_t transmitTimeNs,
+        uint64_t receiveTimeNs,
+        double observedDelay,
+        double congestionScale);
+    void flushPacketGroup();
+
     void generateSigmaPoints(const math::Matrix<double, 3>& state,
         const math::Matrix<double, 3, 3>& covP,
         const math::Matrix<double, 3>& processNoise,
@@ -116,6 +137,7 @@ private:
     uint64_t _previousTransmitTime;
     uint64_t _previousReceiveTime;
     double _observedDelay;
+    PacketGroup _packetGroup;
 
     struct CongestionDips
     {
@@ -2,19 +2,90 @@
 #include "memory/AudioPacketPoolAllocator.h"
 #include "rtp/RtpHeader.h"
 #include <cmath>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
-namespace codec
+namespace
 {
 
-int computeAudioLevel(const int16_t* payload, int count)
+using EnergyFunction = uint64_t (*)(const int16_t*, int);
+
+uint64_t energyScalar(const int16_t* payload, const int count)
 {
-    const double overload = 0x8000;
-    double rms = 0;
+    uint64_t energy = 0;
     for (int i = 0; i < count; ++i)
     {
-        double sample = double(payload[i]);
-        rms += sample * sample;
+        energy += static_cast<int32_t>(payload[i]) * payload[i];
+    }
+    return energy;
+}
+
+#if defined(__x86_64__)
+// madd sums two squares into a lane. That fits in uint32 even for -32768, so lanes are widened as unsigned.
+
+uint64_t energySse2(const int16_t* payload, const int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = zero;
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(payload + i));
+        const __m128i squares = _mm_madd_epi16(samples, samples);
+        sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(squares, zero));
+        sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(squares, zero));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+    return lanes[0] + lanes[1] + energyScalar(payload + i, count - i);
+}
+
+__attribute__((target("avx2"))) uint64_t energyAvx2(const int16_t* payload, const int count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sum = zero;
+    int i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(payload + i));
+        const __m256i squares = _mm256_madd_epi16(samples, samples);
+        sum = _mm256_add_epi64(sum, _mm256_unpacklo_epi32(squares, zero));
+        sum = _mm256_add_epi64(sum, _mm256_unpackhi_epi32(squares, zero));
     }
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sum);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + energySse2(payload + i, count - i);
+}
+#endif
+
+EnergyFunction selectEnergyFunction()
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") ? energyAvx2 : energySse2;
+#else
+    return energyScalar;
+#endif
+}
+
+} // namespace
+
+namespace codec
+{
+
+uint64_t computeSampleEnergy(const int16_t* payload, int count)
+{
+    static const EnergyFunction energyFunction = selectEnergyFunction();
+    return energyFunction(payload, count);
+}
+
+int computeAudioLevel(const int16_t* payload, int count)
+{
+    const double overload = 0x8000;
+    double rms = static_cast<double>(computeSampleEnergy(payload, count));
     rms /= (overload * overload);
     rms = count ? std::sqrt(rms / count) : 0;
     rms = std::max(rms, 1e-9);
@@ -36,4 +107,38 @@ int computeAudioLevel(const memory::AudioPacket& packet)
     return dBO;
 }
 
+uint8_t VoiceActivityDetector::onFrame(const int16_t* payload, int count)
+{
+    // Levels are attenuation in dB, so a lower value is louder
+    const uint8_t maxVoiceLevel = 70;
+    const float voiceMargin = 9.0f;
+    const uint32_t hangoverFrames = 15;
+
+    const auto level = computeAudioLevel(payload, count);
+    if (_noiseLevel < 0)
+    {
+        _noiseLevel = level;
+    }
+    else if (level >= _noiseLevel)
+    {
+        // quieter than the noise floor, follow it quickly
+        _noiseLevel += 0.2f * (level - _noiseLevel);
+    }
+    else
+    {
+        _noiseLevel -= 0.01f * (_noiseLevel - level);
+    }
+
+    if (level <= maxVoiceLevel && level + voiceMargin <= _noiseLevel)
+    {
+        _hangover = hangoverFrames;
+    }
+    else if (_hangover > 0)
+    {
+        --_hangover;
+    }
+
+    return _hangover > 0 ? level : 127;
+}
+
 } // namespace codec
@@ -15,4 +15,30 @@ namespace codec
 int computeAudioLevel(const memory::AudioPacket& packet);
 int computeAudioLevel(const int16_t* payload, int count);
 
+// Sum of squared samples. Uses AVX2 or SSE2 when the cpu supports it.
+uint64_t computeSampleEnergy(const int16_t* payload, int count);
+
+/**
+ * Energy based voice activity detection for streams that do not carry the audio level header extension. The level
+ * of each decoded frame is compared to a tracked noise floor. Frames that are not voice are reported as silence so
+ * steady background noise does not rank as speech. Not thread safe.
+ */
+class VoiceActivityDetector
+{
+public:
+    VoiceActivityDetector() : _noiseLevel(-1), _hangover(0) {}
+
+    /**
+     * @return audio level in the same scale as the audio level header extension, 0 being the loudest (0 dBov) and
+     * 127 the most silent (-127 dBov).
+     */
+    uint8_t onFrame(const int16_t* payload, int count);
+
+    bool isVoiceActive() const { return _hangover > 0; }
+
+private:
+    float _noiseLevel; // negative until the first frame
+    uint32_t _hangover;
+};
+
 } // namespace codec
@@ -1,4 +1,5 @@
 #pragma once
+#include "memory/PageAllocator.h"
 #include <algorithm>
 #include <atomic>
 #include <cassert>
@@ -27,7 +28,7 @@ class MpmcQueue
 
 public:
     typedef T value_type;
-    explicit MpmcQueue(uint32_t maxElements) : _maxElements(maxElements), _blockSize(calculateNeededSpace(maxElements))
+    explicit MpmcQueue(uint32_t maxElements) : _maxElements(maxElements), _blockSize(sizeof(Entry) * maxElements)
     {
         _readCursor = 0;
         _writeCursor = 0;
@@ -36,9 +37,8 @@ public:
         _cacheLineSeparator1[0] = 0;
         _cacheLineSeparator2[0] = 0;
 
-        _elements = reinterpret_cast<Entry*>(
-            mmap(nullptr, _blockSize, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0));
-        assert(reinterpret_cast<intptr_t>(_elements) != -1);
+        _elements = reinterpret_cast<Entry*>(memory::mapPages(_blockSize));
+        assert(_elements);
 
         for (uint32_t i = 0; i < _maxElements; ++i)
         {
@@ -52,7 +52,7 @@ public:
         {
             _elements[i].~Entry();
         }
-        munmap(_elements, _blockSize);
+        memory::unmapPages(_elements, _blockSize);
     }
 
     // return false if empty
@@ -85,6 +85,48 @@ public:
         }
     }
 
+    // pops up to maxCount consecutive elements into targets with one cursor update.
+    // return number of elements popped, 0 if empty
+    size_t pop(T* targets, const size_t maxCount)
+    {
+        uint32_t pos = _readCursor;
+        for (;;)
+        {
+            const auto available = static_cast<int32_t>(_writeCursor.load(std::memory_order_consume) - pos);
+            const uint32_t limit = std::min(static_cast<uint32_t>(std::max(0, available)),
+                static_cast<uint32_t>(std::min(maxCount, static_cast<size_t>(_maxElements))));
+
+            uint32_t count = 0;
+            while (count < limit &&
+                _elements[(pos + count) % _maxElements].state.load(std::memory_order_consume) == CellState::committed)
+            {
+                ++count;
+            }
+
+            if (count == 0)
+            {
+                if (pos == _readCursor)
+                {
+                    return 0;
+                }
+                pos = _readCursor;
+                continue;
+            }
+
+            if (_readCursor.compare_exchange_weak(pos, pos + count))
+            {
+                // All slots in [pos, pos + count) were committed below the write cursor and are now owned by us.
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    auto& entry = _elements[(pos + i) % _maxElements];
+                    targets[i] = std::move(entry.value);
+                    entry.state.store(CellState::emptySlot, std::memory_order_release);
+                }
+                return count;
+            }
+        }
+    }
+
     // return false if full
     // to reduce spin contention, avoid filling queue to full
     bool push(T&& obj)
@@ -117,6 +159,48 @@ public:
         }
     }
 
+    // pushes up to count consecutive elements from items with one cursor update.
+    // return number of elements pushed, 0 if full
+    size_t push(T* items, const size_t count)
+    {
+        uint32_t pos = _writeCursor;
+        for (;;)
+        {
+            const auto used = static_cast<int32_t>(pos - _readCursor.load(std::memory_order_consume));
+            const uint32_t free = _maxElements - std::min(_maxElements, static_cast<uint32_t>(std::max(0, used)));
+            const uint32_t limit = static_cast<uint32_t>(std::min(count, static_cast<size_t>(free)));
+
+            uint32_t slots = 0;
+            while (slots < limit &&
+                _elements[(pos + slots) % _maxElements].state.load(std::memory_order_consume) == CellState::emptySlot)
+            {
+                ++slots;
+            }
+
+            if (slots == 0)
+            {
+                if (pos == _writeCursor)
+                {
+                    return 0;
+                }
+                pos = _writeCursor;
+                continue;
+            }
+
+            if (_writeCursor.compare_exchange_weak(pos, pos + slots))
+            {
+                // Readers stop at the first slot that is not yet committed, so filling in order is safe.
+                for (uint32_t i = 0; i < slots; ++i)
+                {
+                    auto& entry = _elements[(pos + i) % _maxElements];
+                    entry.value = std::move(items[i]);
+                    entry.state.store(CellState::committed, std::memory_order_release);
+                }
+                return slots;
+            }
+        }
+    }
+
     template <typename... U>
     bool push(U&&... args)
     {
@@ -153,15 +237,7 @@ private:
     std::atomic_uint32_t _writeCursor;
     uint64_t _cacheLineSeparator2[7];
     Entry* _elements;
-    const size_t _blockSize;
-
-    static size_t calculateNeededSpace(uint32_t maxElements)
-    {
-        auto neededSize = sizeof(Entry) * maxElements;
-        const auto pageSize = getpagesize();
-        const auto remaining = neededSize % pageSize;
-        return neededSize + (remaining != 0 ? pageSize - remaining : 0);
-    }
+    size_t _blockSize; // mapped size
 
     bool isWritable(const uint32_t pos) const
     {
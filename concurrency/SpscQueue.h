@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+namespace concurrency
+{
+// Ring buffer for exactly one producer thread and one consumer thread.
+// Elements are written and read in place to avoid copying large entries.
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(uint32_t maxElements)
+        : _maxElements(maxElements),
+          _readCursor(0),
+          _writeCursor(0),
+          _elements(new T[maxElements])
+    {
+        assert(0x100000000ull % _maxElements == 0); // "size % 2^32 must be zero";
+        _cacheLineSeparator1[0] = 0;
+        _cacheLineSeparator2[0] = 0;
+    }
+
+    // producer. returns slot to fill in, or nullptr if full. The slot is not visible until commitPush.
+    T* beginPush()
+    {
+        const uint32_t pos = _writeCursor.load(std::memory_order_relaxed);
+        if (pos - _readCursor.load(std::memory_order_acquire) >= _maxElements)
+        {
+            return nullptr;
+        }
+        return &_elements[pos % _maxElements];
+    }
+
+    void commitPush() { _writeCursor.fetch_add(1, std::memory_order_release); }
+
+    bool push(const T& obj)
+    {
+        auto* slot = beginPush();
+        if (!slot)
+        {
+            return false;
+        }
+        *slot = obj;
+        commitPush();
+        return true;
+    }
+
+    // consumer. returns oldest element or nullptr if empty. The element stays valid until pop.
+    T* front()
+    {
+        const uint32_t pos = _readCursor.load(std::memory_order_relaxed);
+        if (pos == _writeCursor.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        return &_elements[pos % _maxElements];
+    }
+
+    void pop() { _readCursor.fetch_add(1, std::memory_order_release); }
+
+    size_t size() const
+    {
+        return _writeCursor.load(std::memory_order_relaxed) - _readCursor.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    uint32_t capacity() const { return _maxElements; }
+
+private:
+    const uint32_t _maxElements;
+    std::atomic_uint32_t _readCursor;
+    uint64_t _cacheLineSeparator1[7];
+    std::atomic_uint32_t _writeCursor;
+    uint64_t _cacheLineSeparator2[7];
+    std::unique_ptr<T[]> _elements;
+};
+} // namespace concurrency
@@ -4,10 +4,14 @@
 #include <mach/thread_act.h>
 #else
 #include <pthread.h>
+#include <sched.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <unistd.h>
 #endif
 #include "logger/Logger.h"
+#include <cerrno>
+#include <cstdlib>
 namespace concurrency
 {
 bool setPriority(std::thread& thread, Priority priority)
@@ -122,4 +126,100 @@ void getThreadName(pthread_t threadId, char* name, size_t& length)
     }
     length = rc;
 }
+
+bool parseCpuList(const std::string& cpuList, std::vector<uint32_t>& cpus)
+{
+    cpus.clear();
+    const char* p = cpuList.c_str();
+    while (*p)
+    {
+        char* end = nullptr;
+        const auto first = std::strtoul(p, &end, 10);
+        if (end == p)
+        {
+            return false;
+        }
+
+        auto last = first;
+        p = end;
+        if (*p == '-')
+        {
+            ++p;
+            last = std::strtoul(p, &end, 10);
+            if (end == p || last < first)
+            {
+                return false;
+            }
+            p = end;
+        }
+
+        for (auto cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+
+        if (*p == ',')
+        {
+            ++p;
+        }
+        else if (*p)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool setCpuAffinity(std::thread& thread, const std::vector<uint32_t>& cpus)
+{
+#ifdef __APPLE__
+    logger::warn("cpu affinity is not supported", "");
+    return false;
+#else
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (auto cpu : cpus)
+    {
+        if (cpu >= CPU_SETSIZE)
+        {
+            logger::warn("cpu %u out of range", "", cpu);
+            return false;
+        }
+        CPU_SET(cpu, &cpuSet);
+    }
+
+    const auto rc = pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet);
+    if (rc != 0)
+    {
+        logger::warn("Failed to set cpu affinity %d", "", rc);
+        return false;
+    }
+    return true;
+#endif
+}
+
+bool setPreferredNumaNode(int node)
+{
+#ifdef __APPLE__
+    logger::warn("NUMA memory policy is not supported", "");
+    return false;
+#else
+    const int preferredPolicy = 1; // MPOL_PREFERRED in linux/mempolicy.h
+    const auto bitsPerMask = sizeof(unsigned long) * 8;
+    unsigned long nodeMask[4] = {0};
+    if (node < 0 || static_cast<size_t>(node) >= bitsPerMask * 4)
+    {
+        logger::warn("NUMA node %d out of range", "", node);
+        return false;
+    }
+    nodeMask[node / bitsPerMask] = 1ul << (node % bitsPerMask);
+
+    if (syscall(SYS_set_mempolicy, preferredPolicy, nodeMask, bitsPerMask * 4 + 1) != 0)
+    {
+        logger::warn("Failed to set NUMA memory policy %d", "", errno);
+        return false;
+    }
+    return true;
+#endif
+}
 } // namespace concurrency
@@ -1,5 +1,7 @@
 #pragma once
+#include <string>
 #include <thread>
+#include <vector>
 namespace concurrency
 {
 enum class Priority
@@ -12,4 +14,14 @@ void setThreadName(const char* name);
 
 void getThreadName(char* name, size_t& length);
 void getThreadName(pthread_t threadId, char* name, size_t& length);
+
+// Parses a cpu list like "0-3,8,10-11". Empty list gives no cpus. Returns false on syntax error.
+bool parseCpuList(const std::string& cpuList, std::vector<uint32_t>& cpus);
+
+// Restricts thread to the cpus. Not supported on mac.
+bool setCpuAffinity(std::thread& thread, const std::vector<uint32_t>& cpus);
+
+// Makes memory allocated by the calling thread, and threads it starts later, prefer the NUMA node. Pages are placed
+// when first touched. Linux only.
+bool setPreferredNumaNode(int node);
 } // namespace concurrency
@@ -14,14 +14,42 @@ public:
     CFG_PROP(std::string, address, "127.0.0.1");
     CFG_PROP(bool, logStdOut, true);
     CFG_PROP(std::string, logLevel, "INFO");
+    // Format log lines on the logger thread instead of the calling thread.
+    CFG_PROP(bool, logDeferredFormatting, false);
+    // Max lines per second from each DEBUG and INFO log statement. 0 disables the limit.
+    CFG_PROP(uint32_t, logRateLimit, 0);
 
     // If mixer does not receive any packets during this timeout, it's considered abandoned and is garbage collected.
     CFG_PROP(int, mixerInactivityTimeoutMs, 2 * 60 * 1000);
     CFG_PROP(int, numWorkerTreads, 0);
+    // Give each worker a local job queue. Jobs of a serial job queue then stay on one worker unless stolen.
+    CFG_PROP(bool, workerLocalQueues, true);
+    // Number of realtime engine threads. Each mixer is placed on one engine thread.
+    CFG_PROP(uint32_t, numEngineThreads, 1);
+    // Interval for logging engine tick percentiles and the slowest mixer. 0 disables the log line.
+    CFG_PROP(uint32_t, tickProfileLogIntervalSec, 0);
     CFG_PROP(std::string, logFile, "/tmp/smb.log");
 
     CFG_PROP(uint32_t, defaultLastN, 5);
 
+    CFG_GROUP()
+    // Cpu lists like "2-3,8". Empty leaves the threads to the scheduler. When a list has at least one cpu per thread,
+    // each thread is pinned to its own cpu, otherwise the threads share the listed cpus.
+    CFG_PROP(std::string, engineCpus, "");
+    CFG_PROP(std::string, rtceCpus, "");
+    CFG_PROP(std::string, workerCpus, "");
+    // NUMA node that memory is allocated from, preferably. -1 leaves the kernel default.
+    CFG_PROP(int, numaNode, -1);
+    CFG_GROUP_END(affinity);
+
+    CFG_GROUP()
+    // Page size for packet pools and job queues: "off", "transparent" or "hugetlb". hugetlb needs reserved huge pages
+    // (vm.nr_hugepages) and falls back to transparent huge pages if there are not enough.
+    CFG_PROP(std::string, hugePages, "off");
+    // Touch all pool memory at startup so the first packets do not cause page faults.
+    CFG_PROP(bool, prefault, false);
+    CFG_GROUP_END(pools);
+
     CFG_PROP(uint32_t, maxDefaultLevelBandwidthKbps, 3000);
     CFG_PROP(uint32_t, rtpForwardInterval, 10); // ms
 
@@ -37,6 +65,10 @@ public:
     CFG_PROP(uint32_t, lastN, 3);
     CFG_PROP(uint32_t, lastNextra, 2);
     CFG_PROP(uint32_t, activeTalkerSilenceThresholdDb, 18);
+    // Max number of loudest speakers that are decoded and mixed for mixed audio. 0 decodes and mixes everyone.
+    CFG_PROP(uint32_t, mixedDecodeLimit, 0);
+    // Speakers ranked right below the decode limit are decoded but not mixed, so they can be mixed at once.
+    CFG_PROP(uint32_t, mixedDecodeLookahead, 2);
     CFG_GROUP_END(audio);
 
     CFG_GROUP()
@@ -55,6 +87,10 @@ public:
     CFG_PROP(uint16_t, udpPortRangeLow, 10006);
     CFG_PROP(uint16_t, udpPortRangeHigh, 26000);
     CFG_PROP(uint32_t, sharedPorts, 1);
+    // SO_REUSEPORT sockets per shared port. Each flow is received on a fixed socket with its own receive job queue
+    CFG_PROP(uint32_t, receiveQueues, 1);
+    // UDP GSO and GRO on shared ports, if supported by the kernel
+    CFG_PROP(bool, udpOffload, false);
     CFG_PROP(uint32_t, maxCandidateCount, 5 * 3);
 
     CFG_GROUP()
@@ -69,7 +105,9 @@ public:
     CFG_GROUP()
     CFG_PROP(bool, logDownlinkEstimates, true);
     CFG_PROP(std::string, packetLogLocation, "");
+    CFG_PROP(uint32_t, packetLogFileSizeKb, 4 * 1024); // per transport, one previous file is kept
     CFG_PROP(double, packetOverhead, 0.1);
+    CFG_PROP(uint32_t, packetGroupMs, 0); // aggregate packets sent within this interval into one estimator update
     CFG_PROP(bool, enable, true);
     CFG_GROUP_END(bwe);
 
@@ -4,9 +4,14 @@
 #include <cstring>
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
 
 namespace
 {
+const uint32_t castagnoliPolynomial = 0x1EDC6F41u;
+
 unsigned char reverse(unsigned char b)
 {
     b = (b & 0xF0) >> 4 | (b & 0x0F) << 4;
@@ -14,6 +19,36 @@ unsigned char reverse(unsigned char b)
     b = (b & 0xAA) >> 1 | (b & 0x55) << 1;
     return b;
 }
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t crc32cSse42(uint32_t crc, const uint8_t* data, size_t length)
+{
+    uint64_t crc64 = crc;
+    for (; length >= sizeof(uint64_t); length -= sizeof(uint64_t), data += sizeof(uint64_t))
+    {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        crc64 = _mm_crc32_u64(crc64, value);
+    }
+
+    crc = static_cast<uint32_t>(crc64);
+    for (; length > 0; --length)
+    {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+#endif
+
+bool hasCrc32Instruction()
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#else
+    return false;
+#endif
+}
 } // namespace
 
 namespace crypto
@@ -48,6 +83,23 @@ void HMAC::reset(const void* key, int keyLength)
     }
 }
 
+HMAC::HMAC(const HMAC& prepared) : _ctx(HMAC_CTX_new()), _keyLength(0)
+{
+    reset(prepared);
+}
+
+void HMAC::reset(const HMAC& prepared)
+{
+    std::memcpy(_key, prepared._key, prepared._keyLength);
+    _keyLength = prepared._keyLength;
+    // HMAC_CTX_copy does not modify the source context
+    if (HMAC_CTX_copy(_ctx, prepared._ctx) != 1)
+    {
+        assert(false);
+        reset(_key, _keyLength);
+    }
+}
+
 void HMAC::reset()
 {
     HMAC_CTX_reset(_ctx);
@@ -94,6 +146,7 @@ void MD5::reset()
 }
 
 Crc32Polynomial::Crc32Polynomial(uint32_t polynomial)
+    : _useCrc32Instruction(polynomial == castagnoliPolynomial && hasCrc32Instruction())
 {
     uint32_t revPolynomial = 0;
     for (size_t i = 0; i < sizeof(uint32_t); ++i)
@@ -117,8 +170,47 @@ Crc32Polynomial::Crc32Polynomial(uint32_t polynomial)
                 remainder = (remainder >> 1);
             }
         }
-        _table[static_cast<size_t>(b)] = remainder;
+        _table[0][static_cast<size_t>(b)] = remainder;
     } while (0 != ++b);
+
+    for (size_t i = 0; i < 256; ++i)
+    {
+        for (size_t slice = 1; slice < 8; ++slice)
+        {
+            const auto previous = _table[slice - 1][i];
+            _table[slice][i] = (previous >> 8) ^ _table[0][previous & 0xFFu];
+        }
+    }
+}
+
+uint32_t Crc32Polynomial::update(uint32_t crc, const uint8_t* data, size_t length) const
+{
+#if defined(__x86_64__)
+    if (_useCrc32Instruction)
+    {
+        return crc32cSse42(crc, data, length);
+    }
+#endif
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; length >= 8; length -= 8, data += 8)
+    {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, data, sizeof(low));
+        std::memcpy(&high, data + sizeof(low), sizeof(high));
+        low ^= crc;
+        crc = _table[7][low & 0xFFu] ^ _table[6][(low >> 8) & 0xFFu] ^ _table[5][(low >> 16) & 0xFFu] ^
+            _table[4][low >> 24] ^ _table[3][high & 0xFFu] ^ _table[2][(high >> 8) & 0xFFu] ^
+            _table[1][(high >> 16) & 0xFFu] ^ _table[0][high >> 24];
+    }
+#endif
+
+    for (; length > 0; --length)
+    {
+        crc = _table[0][*data++ ^ (crc & 0xFFu)] ^ (crc >> 8);
+    }
+    return crc;
 }
 
 Crc32::Crc32(const Crc32Polynomial& polynomial) : _polynomial(polynomial), _crc(0xFFFFFFFFul) {}
@@ -130,11 +222,9 @@ void Crc32::reset()
 
 void Crc32::add(const void* data, int length)
 {
-    int i;
-    auto p = reinterpret_cast<const uint8_t*>(data);
-    for (i = 0; i < length; i++)
+    if (length > 0)
     {
-        _crc = _polynomial[*p++ ^ (_crc & 0xff)] ^ (_crc >> 8);
+        _crc = _polynomial.update(_crc, reinterpret_cast<const uint8_t*>(data), length);
     }
 }
 
@@ -12,12 +12,17 @@ class HMAC
 {
 public:
     HMAC(const void* key, int keyLength);
+    // clones the keyed state of prepared, which avoids hashing the key again
+    HMAC(const HMAC& prepared);
     ~HMAC();
 
+    HMAC& operator=(const HMAC&) = delete;
+
     void add(const void* data, int length);
 
     void compute(uint8_t* sha) const;
     void reset(const void* key, int keyLength);
+    void reset(const HMAC& prepared);
     void reset();
 
     template <typename IntType>
@@ -53,14 +58,22 @@ private:
     struct evp_md_ctx_st* _ctx;
 };
 
+/**
+ * Tables for a reflected CRC32 polynomial. Data is processed 8 bytes at a time with slice-by-8 tables. For the
+ * Castagnoli polynomial (CRC32C) the SSE4.2 crc32 instruction is used instead, if the cpu has it.
+ */
 class Crc32Polynomial
 {
 public:
     explicit Crc32Polynomial(uint32_t polynomial);
-    inline uint32_t operator[](uint8_t pos) const { return _table[pos]; }
+    inline uint32_t operator[](uint8_t pos) const { return _table[0][pos]; }
+
+    // crc is the running, not inverted, value
+    uint32_t update(uint32_t crc, const uint8_t* data, size_t length) const;
 
 private:
-    uint32_t _table[256];
+    uint32_t _table[8][256];
+    bool _useCrc32Instruction;
 };
 class Crc32
 {
@@ -6,6 +6,7 @@
 #include "utils/Trackers.h"
 #include <list>
 #include <memory>
+#include <mutex>
 #include <unistd.h>
 
 namespace jobmanager
@@ -24,6 +25,10 @@ namespace jobmanager
  * yielding or using MultiStepJob. It is only when the jobs reach JobManager main queue that yielding cause more jobs to
  * run "simultaneously".
  *
+ * Each registered WorkerThread has a local queue in addition to the shared queue. Jobs posted with addJobOnWorker go
+ * to that worker's queue, which keeps jobs from the same JobQueue on one core. Idle workers steal from the local queues
+ * of other workers.
+ *
  * JobManager facilitates timer jobs. Use addTimedJob to post a job that will be run after a specific timeout.
  * You have to handle re-triggering yourself. You can abort a specific timer by id, or a group of related timers using a
  * group id.
@@ -32,14 +37,37 @@ namespace jobmanager
 class JobManager // TODO rename to MainJobQueue or MpmcJobQueue
 {
 public:
-    JobManager(TimerQueue& timerQueue, size_t poolSize = 4096 * 8)
+    static const uint32_t noWorker = ~0u;
+
+    JobManager(TimerQueue& timerQueue, size_t poolSize = 4096 * 8, bool workerQueues = true)
         : _jobQueue(poolSize),
           _jobPool(poolSize, "JobManagerPool"),
           _running(true),
+          _workerQueuesEnabled(workerQueues),
+          _workerCount(0),
           _timers(timerQueue)
     {
     }
 
+    // returns index of the new worker's local queue, or noWorker if worker queues are disabled
+    uint32_t registerWorker()
+    {
+        if (!_workerQueuesEnabled)
+        {
+            return noWorker;
+        }
+
+        std::lock_guard<std::mutex> lock(_registerMutex);
+        const auto index = _workerCount.load();
+        if (index == maxWorkers)
+        {
+            return noWorker;
+        }
+        _workerQueues[index] = std::make_unique<WorkerQueue>(workerQueueSize);
+        _workerCount.store(index + 1, std::memory_order_release);
+        return index;
+    }
+
     template <typename JOB_TYPE, typename... U>
     JOB_TYPE* allocateJob(U&&... args)
     {
@@ -64,6 +92,23 @@ public:
         return addJobItem(job);
     }
 
+    // queues the job on a worker's local queue, or on the shared queue if there is no such worker or it is full
+    template <typename JOB_TYPE, typename... U>
+    bool addJobOnWorker(uint32_t workerIndex, U&&... args)
+    {
+        auto job = allocateJob<JOB_TYPE>(std::forward<U>(args)...);
+        if (!job)
+        {
+            return false;
+        }
+        if (workerIndex < _workerCount.load(std::memory_order_acquire) &&
+            _workerQueues[workerIndex]->jobs.push(job))
+        {
+            return true;
+        }
+        return addJobItem(job);
+    }
+
     template <typename JOB_TYPE, typename... U>
     bool addTimedJob(uint32_t groupId, uint32_t id, uint64_t timeoutUs, U&&... args)
     {
@@ -111,6 +156,31 @@ public:
         return true;
     }
 
+    // returns number of jobs queued. Jobs that did not fit are freed.
+    size_t addJobItems(MultiStepJob** jobs, const size_t count)
+    {
+        size_t pushed = 0;
+        while (pushed < count)
+        {
+            const auto n = _jobQueue.push(jobs + pushed, count - pushed);
+            if (n == 0)
+            {
+                break;
+            }
+            pushed += n;
+        }
+
+        if (pushed < count)
+        {
+            assert(false);
+            for (size_t i = pushed; i < count; ++i)
+            {
+                freeJob(jobs[i]);
+            }
+        }
+        return pushed;
+    }
+
     void freeJob(MultiStepJob* job)
     {
         assert(job);
@@ -130,17 +200,45 @@ public:
         return addJob<CallableCountedJob<std::decay_t<Callable>>>(jobsCounter, std::forward<Callable>(callable));
     }
 
-    MultiStepJob* pop()
+    // Worker takes from its local queue first, then from the shared queue, then steals from other workers.
+    MultiStepJob* pop(uint32_t workerIndex = noWorker)
     {
+        if (!_running.load(std::memory_order::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+
         MultiStepJob* job;
-        if (_running.load(std::memory_order::memory_order_relaxed) && _jobQueue.pop(job))
+        const auto workerCount = _workerCount.load(std::memory_order_acquire);
+        if (workerIndex < workerCount)
+        {
+            auto& local = *_workerQueues[workerIndex];
+            // visit the shared queue now and then so it is not starved by busy local queues
+            if ((++local.popCount % sharedQueueInterval) == 0 && _jobQueue.pop(job))
+            {
+                return job;
+            }
+            if (local.jobs.pop(job))
+            {
+                return job;
+            }
+        }
+
+        if (_jobQueue.pop(job))
         {
             return job;
         }
-        else
+
+        const uint32_t start = (workerIndex < workerCount ? workerIndex + 1 : 0);
+        for (uint32_t i = 0; i < workerCount; ++i)
         {
-            return nullptr;
+            const auto victim = (start + i) % workerCount;
+            if (victim != workerIndex && _workerQueues[victim]->jobs.pop(job))
+            {
+                return job;
+            }
         }
+        return nullptr;
     }
 
     void stop() { _running = false; }
@@ -153,10 +251,27 @@ public:
     static const auto maxJobSize = 26 * sizeof(uint64_t);
 
 private:
+    static const uint32_t maxWorkers = 256;
+    static const uint32_t workerQueueSize = 4096;
+    static const uint32_t sharedQueueInterval = 16;
+
+    struct WorkerQueue
+    {
+        explicit WorkerQueue(uint32_t size) : jobs(size), popCount(0) {}
+
+        concurrency::MpmcQueue<MultiStepJob*> jobs;
+        uint32_t popCount; // owning worker only
+    };
+
     concurrency::MpmcQueue<MultiStepJob*> _jobQueue;
     memory::PoolAllocator<maxJobSize> _jobPool;
     std::atomic<bool> _running;
 
+    const bool _workerQueuesEnabled;
+    std::unique_ptr<WorkerQueue> _workerQueues[maxWorkers];
+    std::atomic_uint32_t _workerCount;
+    std::mutex _registerMutex;
+
     TimerQueue& _timers;
 };
 
@@ -19,6 +19,7 @@ class JobQueue
 public:
     explicit JobQueue(JobManager& jobManager, size_t poolSize = 4096)
         : _jobManager(jobManager),
+          _homeWorker(JobManager::noWorker),
           _jobCount(0),
           _running(true),
           _jobQueue(poolSize),
@@ -99,7 +100,7 @@ public:
 private:
     void startProcessing()
     {
-        if (!_jobManager.addJob<RunJob>(*this))
+        if (!_jobManager.addJobOnWorker<RunJob>(_homeWorker.load(std::memory_order_relaxed), *this))
         {
             _noNeedToRecover.clear();
         }
@@ -121,6 +122,8 @@ private:
 
         bool runStep() override
         {
+            // keep following jobs on this worker, where the queue owner's state is likely in cache
+            _owner._homeWorker.store(WorkerThread::getWorkerIndex(_owner._jobManager), std::memory_order_relaxed);
             if (_actualWork)
             {
                 auto runAgain = _actualWork->runStep();
@@ -199,6 +202,7 @@ private:
     static const auto maxJobSize = JobManager::maxJobSize;
 
     JobManager& _jobManager;
+    std::atomic_uint32_t _homeWorker; // worker that last ran this queue
 
     std::atomic_flag _noNeedToRecover = ATOMIC_FLAG_INIT;
     std::atomic_uint32_t _jobCount;
@@ -4,9 +4,56 @@
 
 namespace jobmanager
 {
+namespace
+{
+const uint64_t tickNs = utils::Time::ms;
+
+// Level 0 has one slot per tick. Each higher level has slots spanning a full turn of the level below.
+// The top level reaches 2^26 ticks, about 18h. Timers further out are parked there and placed again when
+// their slot is cascaded.
+const uint32_t level0Bits = 8;
+const uint32_t levelBits = 6;
+const uint32_t levelCount = 4;
+const uint32_t level0Slots = 1 << level0Bits;
+const uint32_t levelSlots = 1 << levelBits;
+const uint64_t maxSpan = uint64_t(1) << (level0Bits + (levelCount - 1) * levelBits);
+const uint32_t dueSlot = level0Slots + (levelCount - 1) * levelSlots; // timers that expired before being placed
+const uint32_t slotCount = dueSlot + 1;
+const size_t dispatchBatchSize = 64;
+const size_t changeBatchSize = 32;
+
+uint32_t hashGroup(uint32_t groupId)
+{
+    return static_cast<uint32_t>((groupId * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+uint32_t hashTimer(uint32_t groupId, uint32_t id)
+{
+    return static_cast<uint32_t>((((uint64_t(groupId) << 32) | id) * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+size_t groupTableSize(size_t maxElements)
+{
+    size_t size = 64;
+    while (size < maxElements * 2)
+    {
+        size *= 2;
+    }
+    return size;
+}
+} // namespace
+
+const uint32_t TimerQueue::npos;
 
 TimerQueue::TimerQueue(size_t maxElements)
-    : _newTimers(maxElements),
+    : _freeNodes(npos),
+      _slots(slotCount, npos),
+      _groups(groupTableSize(maxElements), GroupSlot{0, npos}),
+      _groupCount(0),
+      _timerIndex(groupTableSize(maxElements), npos),
+      _timerCount(0),
+      _currentTick(0),
+      _newTimers(maxElements),
       _idCounter(0),
       _running(true),
       _timeReference(utils::Time::getAbsoluteTime()),
@@ -73,35 +120,29 @@ void TimerQueue::stop()
 
 void TimerQueue::run()
 {
-    _timers.reserve(256);
     concurrency::setThreadName("TimerQueue");
-    TimerEntry entry;
+    ChangeTimer changes[changeBatchSize];
     while (_running.load(std::memory_order::memory_order_relaxed))
     {
-        ChangeTimer timerJob;
-        while (_newTimers.pop(timerJob))
-        {
-            changeTimer(timerJob);
-        }
-
-        if (!_timers.empty())
+        for (auto count = _newTimers.pop(changes, changeBatchSize); count > 0;
+             count = _newTimers.pop(changes, changeBatchSize))
         {
-            auto firstTimer = _timers.front();
-            int64_t toWait = firstTimer.endTime - getInternalTime();
-            if (toWait <= 0)
+            for (size_t i = 0; i < count; ++i)
             {
-                popTimer(entry);
-                entry.jobManager->addJobItem(entry.job);
-            }
-            else
-            {
-                utils::Time::nanoSleep(std::min(1 * utils::Time::ms, static_cast<uint64_t>(toWait)));
+                changeTimer(changes[i]);
             }
         }
-        else
+
+        const auto timestamp = getInternalTime();
+        const uint64_t tick = timestamp / tickNs;
+        while (_currentTick < tick)
         {
-            utils::Time::nanoSleep(1 * utils::Time::ms);
+            advance(_currentTick + 1);
         }
+        expire(dueSlot);
+        dispatchExpired();
+
+        utils::Time::nanoSleep((_currentTick + 1) * tickNs - timestamp);
     }
 
     ChangeTimer nEntry;
@@ -113,73 +154,401 @@ void TimerQueue::run()
         }
     }
 
-    while (popTimer(entry))
+    for (auto& node : _nodes)
     {
-        entry.jobManager->freeJob(entry.job);
+        if (node.job)
+        {
+            node.jobManager->freeJob(node.job);
+            node.job = nullptr;
+        }
     }
 }
 
-bool TimerQueue::popTimer(TimerEntry& entry)
+void TimerQueue::changeTimer(ChangeTimer& timerJob)
 {
-    if (_timers.empty())
+    if (timerJob.type == ChangeTimer::add)
     {
-        return false;
+        insert(timerJob.entry);
+        return;
     }
-    entry = _timers.front();
-    if (_timers.size() == 1)
+
+    if (timerJob.type == ChangeTimer::removeSingle)
     {
-        _timers.clear();
-        return true;
+        const auto nodeIndex = findTimer(timerJob.entry.groupId, timerJob.entry.id);
+        if (nodeIndex != npos)
+        {
+            auto& node = _nodes[nodeIndex];
+            unlink(nodeIndex);
+            removeFromGroup(nodeIndex);
+            removeFromIndex(nodeIndex);
+            node.jobManager->freeJob(node.job);
+            release(nodeIndex);
+        }
+    }
+    else if (timerJob.type == ChangeTimer::removeGroup)
+    {
+        const auto position = findGroup(timerJob.entry.groupId);
+        if (position == npos)
+        {
+            return;
+        }
+
+        for (auto nodeIndex = _groups[position].head; nodeIndex != npos;)
+        {
+            auto& node = _nodes[nodeIndex];
+            const auto groupNext = node.groupNext;
+            unlink(nodeIndex);
+            removeFromIndex(nodeIndex);
+            node.jobManager->freeJob(node.job);
+            release(nodeIndex);
+            nodeIndex = groupNext;
+        }
+        eraseGroupSlot(position);
     }
-    std::pop_heap(_timers.begin(), _timers.end());
-    _timers.pop_back();
-    return true;
 }
 
-void TimerQueue::changeTimer(ChangeTimer& timerJob)
+void TimerQueue::insert(const TimerEntry& entry)
 {
-    if (timerJob.type == ChangeTimer::add)
+    uint32_t nodeIndex = _freeNodes;
+    if (nodeIndex == npos)
     {
-        _timers.push_back(timerJob.entry);
-        std::push_heap(_timers.begin(), _timers.end());
+        nodeIndex = _nodes.size();
+        _nodes.emplace_back();
     }
-    else if (timerJob.type == ChangeTimer::removeSingle)
+    else
+    {
+        _freeNodes = _nodes[nodeIndex].next;
+    }
+
+    auto& node = _nodes[nodeIndex];
+    node.expiryTick = (entry.endTime + tickNs - 1) / tickNs;
+    node.id = entry.id;
+    node.groupId = entry.groupId;
+    node.job = entry.job;
+    node.jobManager = entry.jobManager;
+    place(nodeIndex);
+    addToGroup(nodeIndex);
+    addToIndex(nodeIndex);
+}
+
+void TimerQueue::place(uint32_t nodeIndex)
+{
+    auto& node = _nodes[nodeIndex];
+    uint32_t slot = dueSlot;
+    if (node.expiryTick > _currentTick)
     {
-        for (auto it = _timers.begin(); it != _timers.end();)
+        const uint64_t delta = std::min(node.expiryTick - _currentTick, maxSpan - 1);
+        const uint64_t tick = _currentTick + delta;
+        if (delta < level0Slots)
+        {
+            slot = tick & (level0Slots - 1);
+        }
+        else
         {
-            if (it->id == timerJob.entry.id && it->groupId == timerJob.entry.groupId)
+            uint32_t level = 1;
+            uint32_t shift = level0Bits;
+            while (delta >= (uint64_t(1) << (shift + levelBits)))
             {
-                auto entry = *it;
-                it = _timers.erase(it);
-                entry.jobManager->freeJob(entry.job);
-                std::make_heap(_timers.begin(), _timers.end());
-                return;
+                ++level;
+                shift += levelBits;
             }
-            else
-                ++it;
+            slot = level0Slots + (level - 1) * levelSlots + ((tick >> shift) & (levelSlots - 1));
         }
     }
-    else if (timerJob.type == ChangeTimer::removeGroup)
+
+    node.slot = slot;
+    node.prev = npos;
+    node.next = _slots[slot];
+    if (node.next != npos)
+    {
+        _nodes[node.next].prev = nodeIndex;
+    }
+    _slots[slot] = nodeIndex;
+}
+
+void TimerQueue::unlink(uint32_t nodeIndex)
+{
+    auto& node = _nodes[nodeIndex];
+    if (node.prev == npos)
+    {
+        _slots[node.slot] = node.next;
+    }
+    else
     {
-        bool modified = false;
-        for (auto it = _timers.begin(); it != _timers.end();)
+        _nodes[node.prev].next = node.next;
+    }
+
+    if (node.next != npos)
+    {
+        _nodes[node.next].prev = node.prev;
+    }
+}
+
+void TimerQueue::release(uint32_t nodeIndex)
+{
+    auto& node = _nodes[nodeIndex];
+    node.job = nullptr;
+    node.next = _freeNodes;
+    _freeNodes = nodeIndex;
+}
+
+void TimerQueue::advance(uint64_t tick)
+{
+    _currentTick = tick;
+    if ((tick & (level0Slots - 1)) == 0)
+    {
+        uint32_t shift = level0Bits;
+        for (uint32_t level = 1; level < levelCount; ++level, shift += levelBits)
         {
-            if (it->groupId == timerJob.entry.groupId)
-            {
-                auto entry = *it;
-                it = _timers.erase(it);
-                modified = true;
-                entry.jobManager->freeJob(entry.job);
-            }
-            else
+            const uint32_t index = (tick >> shift) & (levelSlots - 1);
+            cascade(level0Slots + (level - 1) * levelSlots + index);
+            if (index != 0)
             {
-                ++it;
+                break;
             }
         }
-        if (modified)
+    }
+    expire(tick & (level0Slots - 1));
+}
+
+// re-place timers of a higher level slot that is now within reach of the level below
+void TimerQueue::cascade(uint32_t slot)
+{
+    auto nodeIndex = _slots[slot];
+    _slots[slot] = npos;
+    while (nodeIndex != npos)
+    {
+        const auto next = _nodes[nodeIndex].next;
+        place(nodeIndex);
+        nodeIndex = next;
+    }
+}
+
+void TimerQueue::expire(uint32_t slot)
+{
+    auto nodeIndex = _slots[slot];
+    _slots[slot] = npos;
+    while (nodeIndex != npos)
+    {
+        auto& node = _nodes[nodeIndex];
+        const auto next = node.next;
+        _expired.emplace_back(node.job, node.jobManager);
+        removeFromGroup(nodeIndex);
+        removeFromIndex(nodeIndex);
+        release(nodeIndex);
+        nodeIndex = next;
+    }
+}
+
+void TimerQueue::dispatchExpired()
+{
+    MultiStepJob* jobs[dispatchBatchSize];
+    for (size_t i = 0; i < _expired.size();)
+    {
+        auto* jobManager = _expired[i].second;
+        size_t count = 0;
+        for (; i < _expired.size() && _expired[i].second == jobManager && count < dispatchBatchSize; ++i)
+        {
+            jobs[count++] = _expired[i].first;
+        }
+        jobManager->addJobItems(jobs, count);
+    }
+    _expired.clear();
+}
+
+uint32_t TimerQueue::findGroup(uint32_t groupId) const
+{
+    const uint32_t mask = _groups.size() - 1;
+    for (uint32_t position = hashGroup(groupId) & mask; _groups[position].head != npos;
+         position = (position + 1) & mask)
+    {
+        if (_groups[position].groupId == groupId)
+        {
+            return position;
+        }
+    }
+    return npos;
+}
+
+void TimerQueue::addToGroup(uint32_t nodeIndex)
+{
+    auto& node = _nodes[nodeIndex];
+    node.groupPrev = npos;
+    const auto position = findGroup(node.groupId);
+    if (position != npos)
+    {
+        auto& group = _groups[position];
+        node.groupNext = group.head;
+        _nodes[group.head].groupPrev = nodeIndex;
+        group.head = nodeIndex;
+        return;
+    }
+
+    if ((_groupCount + 1) * 2 > _groups.size())
+    {
+        growGroups();
+    }
+
+    const uint32_t mask = _groups.size() - 1;
+    uint32_t freePosition = hashGroup(node.groupId) & mask;
+    while (_groups[freePosition].head != npos)
+    {
+        freePosition = (freePosition + 1) & mask;
+    }
+    node.groupNext = npos;
+    _groups[freePosition] = GroupSlot{node.groupId, nodeIndex};
+    ++_groupCount;
+}
+
+void TimerQueue::removeFromGroup(uint32_t nodeIndex)
+{
+    auto& node = _nodes[nodeIndex];
+    if (node.groupPrev != npos)
+    {
+        _nodes[node.groupPrev].groupNext = node.groupNext;
+    }
+    else
+    {
+        const auto position = findGroup(node.groupId);
+        assert(position != npos);
+        if (node.groupNext == npos)
+        {
+            eraseGroupSlot(position);
+        }
+        else
+        {
+            _groups[position].head = node.groupNext;
+        }
+    }
+
+    if (node.groupNext != npos)
+    {
+        _nodes[node.groupNext].groupPrev = node.groupPrev;
+    }
+}
+
+// backward shift deletion keeps probe sequences intact without tombstones
+void TimerQueue::eraseGroupSlot(uint32_t position)
+{
+    const uint32_t mask = _groups.size() - 1;
+    _groups[position].head = npos;
+    --_groupCount;
+
+    uint32_t hole = position;
+    for (uint32_t i = (position + 1) & mask; _groups[i].head != npos; i = (i + 1) & mask)
+    {
+        const uint32_t home = hashGroup(_groups[i].groupId) & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            _groups[hole] = _groups[i];
+            _groups[i].head = npos;
+            hole = i;
+        }
+    }
+}
+
+void TimerQueue::growGroups()
+{
+    std::vector<GroupSlot> groups(_groups.size() * 2, GroupSlot{0, npos});
+    std::swap(groups, _groups);
+
+    const uint32_t mask = _groups.size() - 1;
+    for (const auto& group : groups)
+    {
+        if (group.head == npos)
+        {
+            continue;
+        }
+        uint32_t position = hashGroup(group.groupId) & mask;
+        while (_groups[position].head != npos)
+        {
+            position = (position + 1) & mask;
+        }
+        _groups[position] = group;
+    }
+}
+
+// Finds the most recently added timer with this group and id. Duplicates are kept further along the probe sequence.
+uint32_t TimerQueue::findTimer(uint32_t groupId, uint32_t id) const
+{
+    const uint32_t mask = _timerIndex.size() - 1;
+    uint32_t found = npos;
+    for (uint32_t position = hashTimer(groupId, id) & mask; _timerIndex[position] != npos;
+         position = (position + 1) & mask)
+    {
+        const auto& node = _nodes[_timerIndex[position]];
+        if (node.groupId == groupId && node.id == id)
+        {
+            found = _timerIndex[position];
+        }
+    }
+    return found;
+}
+
+void TimerQueue::addToIndex(uint32_t nodeIndex)
+{
+    if ((_timerCount + 1) * 2 > _timerIndex.size())
+    {
+        growIndex();
+    }
+
+    const auto& node = _nodes[nodeIndex];
+    const uint32_t mask = _timerIndex.size() - 1;
+    uint32_t position = hashTimer(node.groupId, node.id) & mask;
+    while (_timerIndex[position] != npos)
+    {
+        position = (position + 1) & mask;
+    }
+    _timerIndex[position] = nodeIndex;
+    ++_timerCount;
+}
+
+// backward shift deletion as for the group table
+void TimerQueue::removeFromIndex(uint32_t nodeIndex)
+{
+    const auto& node = _nodes[nodeIndex];
+    const uint32_t mask = _timerIndex.size() - 1;
+    uint32_t hole = hashTimer(node.groupId, node.id) & mask;
+    while (_timerIndex[hole] != nodeIndex)
+    {
+        assert(_timerIndex[hole] != npos);
+        hole = (hole + 1) & mask;
+    }
+    _timerIndex[hole] = npos;
+    --_timerCount;
+
+    for (uint32_t i = (hole + 1) & mask; _timerIndex[i] != npos; i = (i + 1) & mask)
+    {
+        const auto& other = _nodes[_timerIndex[i]];
+        const uint32_t home = hashTimer(other.groupId, other.id) & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            _timerIndex[hole] = _timerIndex[i];
+            _timerIndex[i] = npos;
+            hole = i;
+        }
+    }
+}
+
+void TimerQueue::growIndex()
+{
+    std::vector<uint32_t> timerIndex(_timerIndex.size() * 2, npos);
+    std::swap(timerIndex, _timerIndex);
+
+    const uint32_t mask = _timerIndex.size() - 1;
+    for (const auto nodeIndex : timerIndex)
+    {
+        if (nodeIndex == npos)
+        {
+            continue;
+        }
+        const auto& node = _nodes[nodeIndex];
+        uint32_t position = hashTimer(node.groupId, node.id) & mask;
+        while (_timerIndex[position] != npos)
         {
-            std::make_heap(_timers.begin(), _timers.end());
+            position = (position + 1) & mask;
         }
+        _timerIndex[position] = nodeIndex;
     }
 }
 
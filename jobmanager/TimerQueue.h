@@ -1,6 +1,7 @@
 #pragma once
 #include "concurrency/MpmcQueue.h"
 #include <thread>
+#include <utility>
 #include <vector>
 namespace jobmanager
 {
@@ -8,6 +9,9 @@ class JobManager;
 class MultiStepJob;
 
 // thread safe
+// Timers are kept in a hierarchical timing wheel owned by the timer thread. Changes are posted to that thread.
+// Insert and abort are O(1) as timers are indexed by group and id. Aborting a group only touches the timers of that
+// group. Resolution is 1ms and expired jobs are handed to their JobManager in batches.
 class TimerQueue
 {
 public:
@@ -30,7 +34,7 @@ private:
         MultiStepJob* job;
         JobManager* jobManager;
 
-        TimerEntry() : endTime(0), id(0), groupId(0), job(nullptr) {}
+        TimerEntry() : endTime(0), id(0), groupId(0), job(nullptr), jobManager(nullptr) {}
 
         TimerEntry(uint64_t endTime, uint32_t id, uint32_t groupId, MultiStepJob* jobItem, JobManager* jobManager)
             : endTime(endTime),
@@ -40,11 +44,6 @@ private:
               jobManager(jobManager)
         {
         }
-
-        bool operator<(const TimerEntry& b) const
-        {
-            return (static_cast<int64_t>(b.endTime - endTime) < 0); // sort heap to nearest end
-        }
     };
     struct ChangeTimer
     {
@@ -62,13 +61,63 @@ private:
         ChangeTimer(Type _type, const TimerEntry& _entry) : type(_type), entry(_entry) {}
     };
 
-    bool wait(uint64_t timeoutNs, TimerEntry& entry);
+    static const uint32_t npos = ~0u;
+
+    // Node in a wheel slot list and in the list of its group. Free nodes are chained through next.
+    struct TimerNode
+    {
+        uint64_t expiryTick;
+        uint32_t id;
+        uint32_t groupId;
+        MultiStepJob* job;
+        JobManager* jobManager;
+        uint32_t slot;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t groupPrev;
+        uint32_t groupNext;
+    };
+
+    struct GroupSlot
+    {
+        uint32_t groupId;
+        uint32_t head; // npos if slot is empty
+    };
+
     void run();
     void changeTimer(ChangeTimer& timerJob);
-    bool popTimer(TimerEntry& entry);
+    void insert(const TimerEntry& entry);
+    void place(uint32_t nodeIndex);
+    void unlink(uint32_t nodeIndex);
+    void release(uint32_t nodeIndex);
+    void advance(uint64_t tick);
+    void cascade(uint32_t slot);
+    void expire(uint32_t slot);
+    void dispatchExpired();
+
+    uint32_t findGroup(uint32_t groupId) const;
+    void addToGroup(uint32_t nodeIndex);
+    void removeFromGroup(uint32_t nodeIndex);
+    void eraseGroupSlot(uint32_t position);
+    void growGroups();
+
+    uint32_t findTimer(uint32_t groupId, uint32_t id) const;
+    void addToIndex(uint32_t nodeIndex);
+    void removeFromIndex(uint32_t nodeIndex);
+    void growIndex();
+
     uint64_t getInternalTime();
 
-    std::vector<TimerEntry> _timers; // std::heap
+    std::vector<TimerNode> _nodes;
+    uint32_t _freeNodes;
+    std::vector<uint32_t> _slots; // head node of each wheel slot, all levels
+    std::vector<GroupSlot> _groups; // open addressing, linear probing
+    uint32_t _groupCount;
+    std::vector<uint32_t> _timerIndex; // node of each timer, npos if empty. Open addressing, linear probing
+    uint32_t _timerCount;
+    std::vector<std::pair<MultiStepJob*, JobManager*>> _expired;
+    uint64_t _currentTick; // all ticks up to and including this have expired
+
     concurrency::MpmcQueue<ChangeTimer> _newTimers;
     std::atomic_uint32_t _idCounter;
     std::atomic<bool> _running;
@@ -12,9 +12,12 @@ thread_local jobmanager::WorkerThread* workerThreadHandler = nullptr;
 namespace jobmanager
 {
 
+const uint32_t JobManager::workerQueueSize;
+
 WorkerThread::WorkerThread(jobmanager::JobManager& jobManager, bool yieldEnabled, const char* name)
     : _running(true),
       _jobManager(jobManager),
+      _workerIndex(jobManager.registerWorker()),
       _backgroundJobCount(0),
       _yieldEnabled(yieldEnabled),
       _name(name ? name : "Worker"),
@@ -39,6 +42,11 @@ void WorkerThread::stop()
     _thread.join();
 }
 
+bool WorkerThread::setCpuAffinity(const std::vector<uint32_t>& cpus)
+{
+    return concurrency::setCpuAffinity(_thread, cpus);
+}
+
 uint32_t WorkerThread::processBackgroundJobs()
 {
     uint32_t pendingJobCount = 0;
@@ -112,7 +120,7 @@ bool WorkerThread::processJobs()
     uint32_t processedJobs = 0;
     for (processedJobs = 0; processedJobs < 10; ++processedJobs)
     {
-        auto job = _jobManager.pop();
+        auto job = _jobManager.pop(_workerIndex);
         if (!job)
         {
             break;
@@ -165,4 +173,14 @@ bool WorkerThread::isWorkerThread()
     return workerThreadHandler != nullptr;
 }
 
+uint32_t WorkerThread::getWorkerIndex(const jobmanager::JobManager& jobManager)
+{
+    WorkerThread* wt = workerThreadHandler;
+    if (wt && &wt->_jobManager == &jobManager)
+    {
+        return wt->_workerIndex;
+    }
+    return JobManager::noWorker;
+}
+
 } // namespace jobmanager
@@ -15,18 +15,23 @@ public:
     ~WorkerThread();
 
     void stop();
+    bool setCpuAffinity(const std::vector<uint32_t>& cpus);
 
     static double getWaitTime(); // ms
     static double getWorkTime(); // ms
 
     static bool isWorkerThread();
 
+    // index of calling worker thread in jobManager, or JobManager::noWorker
+    static uint32_t getWorkerIndex(const jobmanager::JobManager& jobManager);
+
     // returns true if there were jobs to process
     static bool yield();
 
 private:
     std::atomic<bool> _running;
     jobmanager::JobManager& _jobManager;
+    const uint32_t _workerIndex;
 
     void run();
     bool processJobs();
@@ -0,0 +1,408 @@
+#include "logger/DeferredFormat.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace logger
+{
+namespace
+{
+enum class ArgumentType
+{
+    INT,
+    LONG,
+    LONG_LONG,
+    SIZE,
+    INTMAX,
+    PTRDIFF,
+    DOUBLE,
+    LONG_DOUBLE,
+    STRING,
+    POINTER,
+    UNSUPPORTED
+};
+
+struct Conversion
+{
+    const char* end; // past conversion character
+    bool widthArgument;
+    bool precisionArgument;
+    int precision; // -1 if not given in format
+    ArgumentType type;
+};
+
+const size_t maxSpecLength = 32;
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// cursor points at a '%' that does not start "%%"
+Conversion parseConversion(const char* cursor)
+{
+    Conversion conversion = {cursor + 1, false, false, -1, ArgumentType::UNSUPPORTED};
+    const char* p = cursor + 1;
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' || *p == '\'')
+    {
+        ++p;
+    }
+
+    if (*p == '*')
+    {
+        conversion.widthArgument = true;
+        ++p;
+    }
+    while (isDigit(*p))
+    {
+        ++p;
+    }
+
+    if (*p == '.')
+    {
+        ++p;
+        if (*p == '*')
+        {
+            conversion.precisionArgument = true;
+            ++p;
+        }
+        else
+        {
+            conversion.precision = 0;
+            while (isDigit(*p))
+            {
+                conversion.precision = conversion.precision * 10 + (*p - '0');
+                ++p;
+            }
+        }
+    }
+
+    ArgumentType integerType = ArgumentType::INT;
+    bool longDouble = false;
+    switch (*p)
+    {
+    case 'h':
+        p += (p[1] == 'h' ? 2 : 1);
+        break;
+    case 'l':
+        integerType = (p[1] == 'l' ? ArgumentType::LONG_LONG : ArgumentType::LONG);
+        p += (p[1] == 'l' ? 2 : 1);
+        break;
+    case 'q':
+        integerType = ArgumentType::LONG_LONG;
+        ++p;
+        break;
+    case 'L':
+        longDouble = true;
+        ++p;
+        break;
+    case 'z':
+        integerType = ArgumentType::SIZE;
+        ++p;
+        break;
+    case 'j':
+        integerType = ArgumentType::INTMAX;
+        ++p;
+        break;
+    case 't':
+        integerType = ArgumentType::PTRDIFF;
+        ++p;
+        break;
+    default:
+        break;
+    }
+
+    switch (*p)
+    {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+        conversion.type = integerType;
+        break;
+    case 'c':
+        conversion.type = ArgumentType::INT;
+        break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        conversion.type = (longDouble ? ArgumentType::LONG_DOUBLE : ArgumentType::DOUBLE);
+        break;
+    case 's':
+        conversion.type = ArgumentType::STRING;
+        break;
+    case 'p':
+        conversion.type = ArgumentType::POINTER;
+        break;
+    default:
+        conversion.end = p;
+        return conversion;
+    }
+
+    conversion.end = p + 1;
+    if (static_cast<size_t>(conversion.end - cursor) >= maxSpecLength)
+    {
+        conversion.type = ArgumentType::UNSUPPORTED;
+    }
+    return conversion;
+}
+
+template <typename T>
+bool put(DeferredLogItem& item, const T& value)
+{
+    if (item.argumentBytes + sizeof(T) > DeferredLogItem::maxArgumentBytes)
+    {
+        return false;
+    }
+    std::memcpy(item.arguments + item.argumentBytes, &value, sizeof(T));
+    item.argumentBytes += sizeof(T);
+    return true;
+}
+
+bool putString(DeferredLogItem& item, const char* value, int precision)
+{
+    if (!value)
+    {
+        value = "(null)";
+    }
+
+    const size_t length = (precision >= 0 ? strnlen(value, precision) : std::strlen(value));
+    if (length > 0xFFFF || item.argumentBytes + sizeof(uint16_t) + length > DeferredLogItem::maxArgumentBytes)
+    {
+        return false;
+    }
+
+    put(item, static_cast<uint16_t>(length));
+    std::memcpy(item.arguments + item.argumentBytes, value, length);
+    item.argumentBytes += length;
+    return true;
+}
+
+template <typename T>
+T get(const DeferredLogItem& item, uint32_t& offset)
+{
+    T value;
+    std::memcpy(&value, item.arguments + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+}
+
+// returns pointer into string buffer, which is valid until next call
+const char* getString(const DeferredLogItem& item, uint32_t& offset, char* buffer)
+{
+    const auto length = get<uint16_t>(item, offset);
+    std::memcpy(buffer, item.arguments + offset, length);
+    buffer[length] = '\0';
+    offset += length;
+    return buffer;
+}
+
+template <typename T>
+int formatValue(char* output,
+    size_t size,
+    const char* spec,
+    const Conversion& conversion,
+    int width,
+    int precision,
+    T value)
+{
+    if (conversion.widthArgument && conversion.precisionArgument)
+    {
+        return snprintf(output, size, spec, width, precision, value);
+    }
+    else if (conversion.widthArgument)
+    {
+        return snprintf(output, size, spec, width, value);
+    }
+    else if (conversion.precisionArgument)
+    {
+        return snprintf(output, size, spec, precision, value);
+    }
+    return snprintf(output, size, spec, value);
+}
+
+} // namespace
+
+bool encodeArguments(DeferredLogItem& item, const char* logGroup, const char* format, va_list args)
+{
+    item.argumentBytes = 0;
+    item.format = format;
+    if (!putString(item, logGroup, -1))
+    {
+        return false;
+    }
+
+    for (const char* p = format; *p; ++p)
+    {
+        if (*p != '%')
+        {
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            ++p;
+            continue;
+        }
+
+        const auto conversion = parseConversion(p);
+        int precision = conversion.precision;
+        if (conversion.widthArgument && !put(item, va_arg(args, int)))
+        {
+            return false;
+        }
+        if (conversion.precisionArgument)
+        {
+            precision = va_arg(args, int);
+            if (!put(item, precision))
+            {
+                return false;
+            }
+        }
+
+        bool stored = false;
+        switch (conversion.type)
+        {
+        case ArgumentType::INT:
+            stored = put(item, va_arg(args, int));
+            break;
+        case ArgumentType::LONG:
+            stored = put(item, va_arg(args, long));
+            break;
+        case ArgumentType::LONG_LONG:
+            stored = put(item, va_arg(args, long long));
+            break;
+        case ArgumentType::SIZE:
+            stored = put(item, va_arg(args, size_t));
+            break;
+        case ArgumentType::INTMAX:
+            stored = put(item, va_arg(args, intmax_t));
+            break;
+        case ArgumentType::PTRDIFF:
+            stored = put(item, va_arg(args, ptrdiff_t));
+            break;
+        case ArgumentType::DOUBLE:
+            stored = put(item, va_arg(args, double));
+            break;
+        case ArgumentType::LONG_DOUBLE:
+            stored = put(item, va_arg(args, long double));
+            break;
+        case ArgumentType::STRING:
+            stored = putString(item, va_arg(args, const char*), precision);
+            break;
+        case ArgumentType::POINTER:
+            stored = put(item, va_arg(args, void*));
+            break;
+        case ArgumentType::UNSUPPORTED:
+            return false;
+        }
+
+        if (!stored)
+        {
+            return false;
+        }
+        p = conversion.end - 1;
+    }
+    return true;
+}
+
+void formatMessage(const DeferredLogItem& item, char* output, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    char stringBuffer[DeferredLogItem::maxArgumentBytes + 1];
+    uint32_t offset = 0;
+    size_t length = std::min(size - 1,
+        static_cast<size_t>(std::max(0, snprintf(output, size, "[%s] ", getString(item, offset, stringBuffer)))));
+
+    const char* p = item.format;
+    while (*p && length + 1 < size)
+    {
+        if (*p != '%')
+        {
+            output[length++] = *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            output[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        const auto conversion = parseConversion(p);
+        if (conversion.type == ArgumentType::UNSUPPORTED)
+        {
+            break; // encode would have failed
+        }
+
+        char spec[maxSpecLength];
+        std::memcpy(spec, p, conversion.end - p);
+        spec[conversion.end - p] = '\0';
+        p = conversion.end;
+
+        const int width = (conversion.widthArgument ? get<int>(item, offset) : 0);
+        const int precision = (conversion.precisionArgument ? get<int>(item, offset) : 0);
+        char* cursor = output + length;
+        const size_t remaining = size - length;
+        int written = 0;
+        switch (conversion.type)
+        {
+        case ArgumentType::INT:
+            written = formatValue(cursor, remaining, spec, conversion, width, precision, get<int>(item, offset));
+            break;
+        case ArgumentType::LONG:
+            written = formatValue(cursor, remaining, spec, conversion, width, precision, get<long>(item, offset));
+            break;
+        case ArgumentType::LONG_LONG:
+            written =
+                formatValue(cursor, remaining, spec, conversion, width, precision, get<long long>(item, offset));
+            break;
+        case ArgumentType::SIZE:
+            written = formatValue(cursor, remaining, spec, conversion, width, precision, get<size_t>(item, offset));
+            break;
+        case ArgumentType::INTMAX:
+            written = formatValue(cursor, remaining, spec, conversion, width, precision, get<intmax_t>(item, offset));
+            break;
+        case ArgumentType::PTRDIFF:
+            written =
+                formatValue(cursor, remaining, spec, conversion, width, precision, get<ptrdiff_t>(item, offset));
+            break;
+        case ArgumentType::DOUBLE:
+            written = formatValue(cursor, remaining, spec, conversion, width, precision, get<double>(item, offset));
+            break;
+        case ArgumentType::LONG_DOUBLE:
+            written =
+                formatValue(cursor, remaining, spec, conversion, width, precision, get<long double>(item, offset));
+            break;
+        case ArgumentType::STRING:
+            written = formatValue(cursor,
+                remaining,
+                spec,
+                conversion,
+                width,
+                precision,
+                getString(item, offset, stringBuffer));
+            break;
+        case ArgumentType::POINTER:
+            written = formatValue(cursor, remaining, spec, conversion, width, precision, get<void*>(item, offset));
+            break;
+        case ArgumentType::UNSUPPORTED:
+            break;
+        }
+
+        length = std::min(size - 1, length + std::max(0, written));
+    }
+    output[std::min(length, size - 1)] = '\0';
+}
+
+} // namespace logger
@@ -0,0 +1,31 @@
+#pragma once
+#include <chrono>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+
+namespace logger
+{
+// Log line captured as format string pointer and raw arguments, formatted later on the logger thread.
+// The format must be a string literal as it is referenced after the log call returns. String arguments
+// and the log group are copied.
+struct DeferredLogItem
+{
+    static const uint32_t maxArgumentBytes = 480;
+
+    std::chrono::system_clock::time_point timestamp;
+    const char* format;
+    const char* logLevel;
+    void* threadId;
+    uint32_t argumentBytes;
+    uint8_t arguments[maxArgumentBytes];
+};
+
+// Stores log group and the arguments referred to by format. Returns false if they do not fit or format
+// has conversions that cannot be deferred, like %n. args is consumed either way.
+bool encodeArguments(DeferredLogItem& item, const char* logGroup, const char* format, va_list args);
+
+// Writes "[logGroup] message" into output, truncating to size.
+void formatMessage(const DeferredLogItem& item, char* output, size_t size);
+
+} // namespace logger
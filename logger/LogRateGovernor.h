@@ -0,0 +1,95 @@
+#pragma once
+
+#include "utils/Time.h"
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+namespace logger
+{
+
+// Limits every log statement, identified by its format string, to a number of lines per second across all
+// threads. Unlike PruneSpam and SuspendSpam it needs no state at the call site. Lines beyond the limit are
+// counted and the count is handed to the next admitted line of the same statement.
+// If the table is crowded, statements that do not find a slot are not limited.
+class LogRateGovernor
+{
+    struct Entry
+    {
+        Entry() : format(nullptr), window(0), count(0), suppressed(0) {}
+
+        std::atomic<const char*> format;
+        std::atomic_uint32_t window;
+        std::atomic_uint32_t count;
+        std::atomic_uint32_t suppressed;
+    };
+
+    static const uint32_t maxProbes = 8;
+
+public:
+    // tableSize must be power of two
+    explicit LogRateGovernor(uint32_t linesPerSecond, uint32_t tableSize = 4096)
+        : _linesPerSecond(linesPerSecond),
+          _mask(tableSize - 1),
+          _entries(new Entry[tableSize])
+    {
+        assert((tableSize & _mask) == 0);
+    }
+
+    bool admit(const char* format, uint64_t timestamp, uint32_t& suppressedCount)
+    {
+        suppressedCount = 0;
+        auto* entry = findEntry(format);
+        if (!entry)
+        {
+            return true;
+        }
+
+        const auto window = static_cast<uint32_t>(timestamp / utils::Time::sec);
+        auto entryWindow = entry->window.load(std::memory_order_relaxed);
+        if (entryWindow != window && entry->window.compare_exchange_strong(entryWindow, window))
+        {
+            entry->count.store(0, std::memory_order_relaxed);
+        }
+
+        if (entry->count.fetch_add(1, std::memory_order_relaxed) < _linesPerSecond)
+        {
+            suppressedCount = entry->suppressed.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        entry->suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+private:
+    Entry* findEntry(const char* format)
+    {
+        const auto hash =
+            static_cast<uint32_t>(((reinterpret_cast<uintptr_t>(format) >> 3) * 0x9E3779B97F4A7C15ull) >> 32);
+        for (uint32_t i = 0; i < maxProbes; ++i)
+        {
+            auto& entry = _entries[(hash + i) & _mask];
+            const char* entryFormat = entry.format.load(std::memory_order_acquire);
+            if (entryFormat == format)
+            {
+                return &entry;
+            }
+            if (!entryFormat && entry.format.compare_exchange_strong(entryFormat, format))
+            {
+                return &entry;
+            }
+            if (entryFormat == format)
+            {
+                return &entry; // another thread claimed it for the same statement
+            }
+        }
+        return nullptr;
+    }
+
+    const uint32_t _linesPerSecond;
+    const uint32_t _mask;
+    std::unique_ptr<Entry[]> _entries;
+};
+
+} // namespace logger
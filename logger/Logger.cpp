@@ -1,4 +1,5 @@
 #include "Logger.h"
+#include "LogRateGovernor.h"
 #include "LoggerThread.h"
 #include "utils/Time.h"
 
@@ -9,12 +10,56 @@ Level _logLevel = Level::INFO;
 std::atomic<size_t> LoggableId::_lastInstanceId;
 
 std::unique_ptr<LoggerThread> _logThread;
+std::unique_ptr<LogRateGovernor> _rateGovernor;
 
-void setup(const char* logFileName, bool logToStdOut, Level level, size_t backlogSize)
+namespace
+{
+bool isGovernedLevel(const char* logLevel)
+{
+    return 0 == std::strcmp(logLevel, "DEBUG") || 0 == std::strcmp(logLevel, "INFO");
+}
+
+void postFormatted(const char* logLevel, const char* logGroup, const bool immediate, const char* format, va_list args)
+{
+    LogItem item;
+    item.timestamp = utils::Time::now();
+    item.logLevel = logLevel;
+    item.threadId = (void*)pthread_self();
+    int consumed = snprintf(item.message, LogItem::maxLineLength, "[%s] ", logGroup);
+    int remain = LogItem::maxLineLength - consumed;
+    vsnprintf(item.message + consumed, remain, format, args);
+
+    if (immediate)
+    {
+        _logThread->immediate(std::move(item));
+    }
+    else
+    {
+        _logThread->post(std::move(item));
+    }
+}
+
+// posted directly as the notices of all statements share one format and would be governed themselves
+void logSuppressed(const char* logLevel, const char* logGroup, const char* format, ...)
+{
+    va_list arglist;
+    va_start(arglist, format);
+    postFormatted(logLevel, logGroup, false, format, arglist);
+    va_end(arglist);
+}
+} // namespace
+
+void setup(const char* logFileName,
+    bool logToStdOut,
+    Level level,
+    size_t backlogSize,
+    bool deferredFormatting,
+    uint32_t linesPerSecond)
 {
     _logLevel = level;
     FILE* logFileHandle = logFileName && strlen(logFileName) > 0 ? fopen(logFileName, "a+") : nullptr;
-    _logThread.reset(new LoggerThread(logFileHandle, logToStdOut, backlogSize));
+    _rateGovernor.reset(linesPerSecond > 0 ? new LogRateGovernor(linesPerSecond) : nullptr);
+    _logThread.reset(new LoggerThread(logFileHandle, logToStdOut, backlogSize, deferredFormatting));
 }
 
 void stop()
@@ -24,28 +69,39 @@ void stop()
         _logThread->stop();
         _logThread.reset();
     }
+    _rateGovernor.reset();
 }
 
 void logv(const char* logLevel, const char* logGroup, const bool immediate, const char* format, va_list args)
 {
     if (_logThread)
     {
-        LogItem item;
-        item.timestamp = utils::Time::now();
-        item.logLevel = logLevel;
-        item.threadId = (void*)pthread_self();
-        int consumed = snprintf(item.message, LogItem::maxLineLength, "[%s] ", logGroup);
-        int remain = LogItem::maxLineLength - consumed;
-        vsnprintf(item.message + consumed, remain, format, args);
-
-        if (immediate)
+        if (_rateGovernor && !immediate && isGovernedLevel(logLevel))
         {
-            _logThread->immediate(std::move(item));
+            uint32_t suppressedCount = 0;
+            if (!_rateGovernor->admit(format, utils::Time::getAbsoluteTime(), suppressedCount))
+            {
+                return;
+            }
+            if (suppressedCount > 0)
+            {
+                logSuppressed(logLevel, logGroup, "suppressed %u lines of \"%s\"", suppressedCount, format);
+            }
         }
-        else
+
+        if (!immediate && _logThread->isDeferredFormatting())
         {
-            _logThread->post(std::move(item));
+            va_list deferredArgs;
+            va_copy(deferredArgs, args);
+            const bool posted = _logThread->postDeferred(logLevel, logGroup, format, deferredArgs);
+            va_end(deferredArgs);
+            if (posted)
+            {
+                return;
+            }
         }
+
+        postFormatted(logLevel, logGroup, immediate, format, args);
     }
 }
 
@@ -16,7 +16,14 @@ enum class Level
 };
 
 extern Level _logLevel;
-void setup(const char* logToFile, bool logToStdOut, Level level, size_t backlogSize = 4096);
+// deferredFormatting moves formatting of queued lines to the logger thread.
+// linesPerSecond limits each DEBUG and INFO log statement, 0 for no limit.
+void setup(const char* logToFile,
+    bool logToStdOut,
+    Level level,
+    size_t backlogSize = 4096,
+    bool deferredFormatting = false,
+    uint32_t linesPerSecond = 0);
 void stop();
 
 void logv(const char* logLevel, const char* logGroup, const bool immediate, const char* format, va_list args);
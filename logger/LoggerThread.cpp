@@ -7,12 +7,42 @@ namespace logger
 {
 
 const auto timeStringLength = 32;
+const uint32_t LoggerThread::deferredQueueSize;
 
-LoggerThread::LoggerThread(FILE* logFile, bool logStdOut, size_t backlogSize)
-    : _running(true),
+namespace
+{
+std::atomic_uint64_t loggerThreadIdCounter(0);
+
+// Holds the deferred queue of the calling thread and releases it for reuse when the thread exits
+struct ThreadDeferredQueue
+{
+    ~ThreadDeferredQueue() { release(); }
+
+    void release()
+    {
+        if (slot)
+        {
+            slot->released.store(true, std::memory_order_release);
+            slot.reset();
+        }
+        loggerThreadId = 0;
+    }
+
+    uint64_t loggerThreadId = 0;
+    std::shared_ptr<DeferredQueueSlot> slot;
+};
+
+thread_local ThreadDeferredQueue threadDeferredQueue;
+} // namespace
+
+LoggerThread::LoggerThread(FILE* logFile, bool logStdOut, size_t backlogSize, bool deferredFormatting)
+    : _id(++loggerThreadIdCounter),
+      _running(true),
       _logQueue(backlogSize),
       _logFile(logFile),
       _logStdOut(logStdOut),
+      _deferredFormatting(deferredFormatting),
+      _deferredQueueCount(0),
       _thread(new std::thread([this] { this->run(); }))
 {
 }
@@ -57,33 +87,151 @@ void logStack(const LogItem& item, const char* localTime, bool logStdOut, FILE*
 }
 } // namespace
 
+void LoggerThread::write(const LogItem& item)
+{
+    char localTime[timeStringLength];
+    formatTime(item, localTime);
+#ifdef DEBUG
+    if (0 == std::strcmp(item.logLevel, "_STK_"))
+    {
+        logStack(item, localTime, _logStdOut, _logFile);
+        return;
+    }
+#endif
+    if (_logStdOut)
+    {
+        formatTo(stdout, localTime, item.logLevel, item.threadId, item.message);
+    }
+    if (_logFile)
+    {
+        formatTo(_logFile, localTime, item.logLevel, item.threadId, item.message);
+    }
+}
+
+// Writes the oldest deferred line if it is older than pendingItem. Returns false if nothing was written.
+bool LoggerThread::writeNextDeferred(const LogItem* pendingItem)
+{
+    const auto queueCount = _deferredQueueCount.load(std::memory_order_acquire);
+    if (queueCount == 0)
+    {
+        return false;
+    }
+
+    while (_deferredConsumer.test_and_set(std::memory_order_acquire)) {}
+
+    DeferredQueue* oldestQueue = nullptr;
+    DeferredLogItem* oldest = nullptr;
+    for (uint32_t i = 0; i < queueCount; ++i)
+    {
+        auto* item = _deferredQueues[i]->queue.front();
+        if (item && (!oldest || item->timestamp < oldest->timestamp))
+        {
+            oldest = item;
+            oldestQueue = &_deferredQueues[i]->queue;
+        }
+    }
+
+    if (!oldest || (pendingItem && pendingItem->timestamp <= oldest->timestamp))
+    {
+        _deferredConsumer.clear(std::memory_order_release);
+        return false;
+    }
+
+    _deferredLine.timestamp = oldest->timestamp;
+    _deferredLine.logLevel = oldest->logLevel;
+    _deferredLine.threadId = oldest->threadId;
+    formatMessage(*oldest, _deferredLine.message, LogItem::maxLineLength);
+    oldestQueue->pop();
+    write(_deferredLine);
+
+    _deferredConsumer.clear(std::memory_order_release);
+    return true;
+}
+
+LoggerThread::DeferredQueue* LoggerThread::getThreadQueue()
+{
+    if (threadDeferredQueue.loggerThreadId == _id)
+    {
+        return &threadDeferredQueue.slot->queue;
+    }
+    threadDeferredQueue.release();
+
+    std::lock_guard<std::mutex> lock(_deferredQueuesLock);
+    const auto count = _deferredQueueCount.load();
+    std::shared_ptr<DeferredQueueSlot> slot;
+    for (uint32_t i = 0; i < count && !slot; ++i)
+    {
+        // the exited producer is done with the queue, so it has a single producer again
+        if (_deferredQueues[i]->released.load(std::memory_order_acquire))
+        {
+            slot = _deferredQueues[i];
+            slot->released.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    if (!slot)
+    {
+        if (count == maxDeferredQueues)
+        {
+            return nullptr;
+        }
+        slot = std::make_shared<DeferredQueueSlot>(deferredQueueSize);
+        _deferredQueues[count] = slot;
+        _deferredQueueCount.store(count + 1, std::memory_order_release);
+    }
+
+    threadDeferredQueue.loggerThreadId = _id;
+    threadDeferredQueue.slot = slot;
+    return &slot->queue;
+}
+
+bool LoggerThread::postDeferred(const char* logLevel, const char* logGroup, const char* format, va_list args)
+{
+    auto* queue = getThreadQueue();
+    if (!queue)
+    {
+        return false;
+    }
+
+    auto* item = queue->beginPush();
+    if (!item)
+    {
+        return true; // dropped as when the log queue is full
+    }
+
+    if (!encodeArguments(*item, logGroup, format, args))
+    {
+        return false;
+    }
+    item->timestamp = utils::Time::now();
+    item->logLevel = logLevel;
+    item->threadId = (void*)pthread_self();
+    queue->commitPush();
+    return true;
+}
+
 void LoggerThread::run()
 {
     concurrency::setThreadName("Logger");
-    char localTime[timeStringLength];
     LogItem item;
+    bool hasItem = false;
     bool gotLogItem = false;
     for (;;)
     {
-        if (_logQueue.pop(item))
+        if (!hasItem)
+        {
+            hasItem = _logQueue.pop(item);
+        }
+
+        if (writeNextDeferred(hasItem ? &item : nullptr))
         {
             gotLogItem = true;
-            formatTime(item, localTime);
-#ifdef DEBUG
-            if (0 == std::strcmp(item.logLevel, "_STK_"))
-            {
-                logStack(item, localTime, _logStdOut, _logFile);
-                continue;
-            }
-#endif
-            if (_logStdOut)
-            {
-                formatTo(stdout, localTime, item.logLevel, item.threadId, item.message);
-            }
-            if (_logFile)
-            {
-                formatTo(_logFile, localTime, item.logLevel, item.threadId, item.message);
-            }
+        }
+        else if (hasItem)
+        {
+            write(item);
+            hasItem = false;
+            gotLogItem = true;
         }
         else
         {
@@ -140,19 +288,19 @@ void LoggerThread::immediate(const LogItem& item)
 void LoggerThread::flush()
 {
     LogItem item;
-    while (_logQueue.pop(item))
+    bool hasItem = _logQueue.pop(item);
+    for (;;)
     {
-        char localTime[timeStringLength];
-        formatTime(item, localTime);
-
-        if (_logStdOut)
+        if (writeNextDeferred(hasItem ? &item : nullptr))
         {
-            formatTo(stdout, localTime, item.logLevel, item.threadId, item.message);
+            continue;
         }
-        if (_logFile)
+        if (!hasItem)
         {
-            formatTo(_logFile, localTime, item.logLevel, item.threadId, item.message);
+            break;
         }
+        write(item);
+        hasItem = _logQueue.pop(item);
     }
 
     if (_logStdOut)
@@ -174,6 +322,19 @@ void LoggerThread::stop()
     }
 }
 
+bool LoggerThread::isDeferredBacklogged(float level) const
+{
+    const auto queueCount = _deferredQueueCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < queueCount; ++i)
+    {
+        if (_deferredQueues[i]->queue.size() > deferredQueueSize * level)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void LoggerThread::formatTime(const LogItem& item, char* output)
 {
     using namespace std::chrono;
@@ -198,12 +359,12 @@ void LoggerThread::formatTime(const LogItem& item, char* output)
 void LoggerThread::awaitLogDrained(float level)
 {
     level = std::max(0.0f, std::min(1.0f, level));
-    if (_logQueue.size() <= _logQueue.capacity() * level)
+    if (_logQueue.size() <= _logQueue.capacity() * level && !isDeferredBacklogged(level))
     {
         return;
     }
 
-    while (!_logQueue.empty())
+    while (!_logQueue.empty() || isDeferredBacklogged(0.0f))
     {
         utils::Time::rawNanoSleep(100000);
     }
@@ -1,7 +1,13 @@
 #pragma once
 #include "concurrency/MpmcQueue.h"
+#include "concurrency/SpscQueue.h"
+#include "logger/DeferredFormat.h"
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstdarg>
+#include <memory>
+#include <mutex>
 #include <thread>
 
 namespace logger
@@ -16,26 +22,60 @@ struct LogItem
     void* threadId;
 };
 
+// Deferred queue of one producer thread. When the thread exits the slot is released and the queue is
+// handed to the next thread that needs one. Lines still queued are written as usual.
+struct DeferredQueueSlot
+{
+    explicit DeferredQueueSlot(uint32_t size) : queue(size), released(false) {}
+
+    concurrency::SpscQueue<DeferredLogItem> queue;
+    std::atomic_bool released;
+};
+
+// Lines are either formatted by the caller and posted as LogItem, or posted as DeferredLogItem into a queue
+// owned by the calling thread and formatted here. Output is merged in timestamp order.
 class LoggerThread
 {
+    using DeferredQueue = concurrency::SpscQueue<DeferredLogItem>;
+    // queues are reused after their thread exits, so this limits threads logging at the same time
+    static const uint32_t maxDeferredQueues = 256;
+    static const uint32_t deferredQueueSize = 1024;
+
 public:
-    LoggerThread(FILE* logFile, bool logStdOut, size_t backlogSize);
+    LoggerThread(FILE* logFile, bool logStdOut, size_t backlogSize, bool deferredFormatting = false);
 
     void post(const LogItem& item) { _logQueue.push(item); }
+    // returns false if the line could not be deferred and must be posted as LogItem
+    bool postDeferred(const char* logLevel, const char* logGroup, const char* format, va_list args);
     void immediate(const LogItem& item);
     void flush();
     void stop();
 
     void awaitLogDrained(float level);
 
+    bool isDeferredFormatting() const { return _deferredFormatting; }
+
 private:
     void run();
     void formatTime(const LogItem& item, char* output);
+    void write(const LogItem& item);
+    DeferredQueue* getThreadQueue();
+    bool writeNextDeferred(const LogItem* pendingItem);
+    bool isDeferredBacklogged(float level) const;
 
+    const uint64_t _id;
     std::atomic_bool _running;
     concurrency::MpmcQueue<LogItem> _logQueue;
     FILE* _logFile;
     bool _logStdOut;
+    const bool _deferredFormatting;
+
+    std::array<std::shared_ptr<DeferredQueueSlot>, maxDeferredQueues> _deferredQueues;
+    std::atomic_uint32_t _deferredQueueCount;
+    std::mutex _deferredQueuesLock;
+    std::atomic_flag _deferredConsumer = ATOMIC_FLAG_INIT;
+    LogItem _deferredLine;
+
     std::unique_ptr<std::thread> _thread;
 };
 } // namespace logger
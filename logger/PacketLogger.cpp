@@ -1,10 +1,41 @@
 #include "PacketLogger.h"
 #include "concurrency/ThreadUtils.h"
+#include "logger/Logger.h"
 #include "rtp/RtpHeader.h"
 #include "utils/Time.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace logger
 {
+namespace
+{
+std::atomic_uint64_t serviceIdCounter(0);
+
+struct CachedThreadBuffer
+{
+    uint64_t serviceId;
+    void* buffer;
+};
+
+thread_local CachedThreadBuffer cachedThreadBuffer = {0, nullptr};
+
+uint32_t makeLogId(uint32_t index, uint16_t generation)
+{
+    return (static_cast<uint32_t>(generation) << 16) | (index + 1);
+}
+
+uint32_t getLogIndex(uint32_t logId)
+{
+    return (logId & 0xFFFFu) - 1;
+}
+
+} // namespace
+
 PacketLogItem::PacketLogItem() : receiveTimestamp(0), transmitTimestamp(0), ssrc(0), sequenceNumber(0), size(0) {}
 
 PacketLogItem::PacketLogItem(const memory::Packet& packet, uint64_t receiveTime) : receiveTimestamp(receiveTime)
@@ -26,33 +57,112 @@ PacketLogItem::PacketLogItem(const memory::Packet& packet, uint64_t receiveTime)
     rtp::getTransmissionTimestamp(packet, 3, transmitTimestamp);
 }
 
-PacketLoggerThread::PacketLoggerThread(FILE* logFile, size_t backlogSize)
-    : _running(true),
-      _logQueue(backlogSize),
-      _logFile(logFile),
-      _thread(new std::thread([this] { this->run(); }))
+PacketLogService::PacketLogService(const std::string& directory,
+    size_t maxFileSize,
+    uint32_t maxLogs,
+    uint32_t threadBacklogSize)
+    : _id(++serviceIdCounter),
+      _directory(directory),
+      _maxRecordCount(
+          std::max(size_t(1), (maxFileSize - std::min(maxFileSize, sizeof(PacketLogHeader))) / sizeof(PacketLogItem))),
+      _threadBacklogSize(threadBacklogSize),
+      _logs(std::min(maxLogs, 0xFFFFu)),
+      _threadBuffers(256),
+      _threadBufferCount(0),
+      _closeRequests(4096),
+      _drainedCount(0),
+      _running(true)
 {
+    _freeLogs.reserve(_logs.size());
+    for (uint32_t i = _logs.size(); i > 0; --i)
+    {
+        _freeLogs.push_back(i - 1);
+    }
+
+    _thread.reset(new std::thread([this] { this->run(); }));
 }
 
-PacketLoggerThread::~PacketLoggerThread()
+PacketLogService::~PacketLogService()
 {
-    if (_running)
+    stop();
+    for (auto& logFile : _logs)
     {
-        stop();
+        unmapFile(logFile);
     }
 }
 
-void PacketLoggerThread::post(const memory::Packet& packet, uint64_t receiveTime)
+uint32_t PacketLogService::openLog(const std::string& name)
 {
-    if (!rtp::isRtpPacket(packet))
+    if (!_running)
+    {
+        return 0;
+    }
+
+    uint32_t index = 0;
+    {
+        std::lock_guard<std::mutex> lock(_logsLock);
+        if (_freeLogs.empty())
+        {
+            logger::warn("no free packet log for %s", "PacketLogService", name.c_str());
+            return 0;
+        }
+        index = _freeLogs.back();
+        _freeLogs.pop_back();
+    }
+
+    // slot is not visible to writer thread until logId is published
+    auto& logFile = _logs[index];
+    logFile.path = _directory + "/" + name;
+    if (!mapFile(logFile))
+    {
+        std::lock_guard<std::mutex> lock(_logsLock);
+        _freeLogs.push_back(index);
+        return 0;
+    }
+
+    const auto logId = makeLogId(index, ++logFile.generation);
+    logFile.logId.store(logId, std::memory_order_release);
+    return logId;
+}
+
+void PacketLogService::closeLog(uint32_t logId)
+{
+    if (logId == 0 || !_running)
     {
         return;
     }
 
-    _logQueue.push(PacketLogItem(packet, receiveTime));
+    while (!_closeRequests.push(logId))
+    {
+        utils::Time::nanoSleep(utils::Time::ms);
+    }
 }
 
-void PacketLoggerThread::stop()
+void PacketLogService::post(uint32_t logId, const memory::Packet& packet, uint64_t receiveTime)
+{
+    if (logId == 0 || !rtp::isRtpPacket(packet))
+    {
+        return;
+    }
+
+    auto* buffer = getThreadBuffer();
+    if (buffer)
+    {
+        buffer->records.push(Record{logId, PacketLogItem(packet, receiveTime)});
+    }
+}
+
+void PacketLogService::flush()
+{
+    // the second pass is certain to have started after this call
+    const auto target = _drainedCount.load() + 2;
+    while (_running.load(std::memory_order_relaxed) && _drainedCount.load() < target)
+    {
+        utils::Time::nanoSleep(utils::Time::ms);
+    }
+}
+
+void PacketLogService::stop()
 {
     if (!_running)
     {
@@ -66,60 +176,229 @@ void PacketLoggerThread::stop()
     }
 }
 
-void PacketLoggerThread::run()
+PacketLogService::ThreadBuffer* PacketLogService::getThreadBuffer()
 {
-    concurrency::setThreadName("PacketLogger");
-    bool gotLogItem = false;
-    PacketLogItem item;
-    for (;;)
+    if (cachedThreadBuffer.serviceId == _id)
+    {
+        return static_cast<ThreadBuffer*>(cachedThreadBuffer.buffer);
+    }
+
+    std::lock_guard<std::mutex> lock(_threadBuffersLock);
+    const auto count = _threadBufferCount.load();
+    ThreadBuffer* buffer = nullptr;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (_threadBuffers[i]->threadId == std::this_thread::get_id())
+        {
+            buffer = _threadBuffers[i].get();
+            break;
+        }
+    }
+
+    if (!buffer)
     {
-        if (_logQueue.pop(item))
+        if (count == _threadBuffers.size())
         {
-            gotLogItem = true;
+            return nullptr;
+        }
+        _threadBuffers[count] = std::make_unique<ThreadBuffer>(_threadBacklogSize);
+        buffer = _threadBuffers[count].get();
+        _threadBufferCount.store(count + 1, std::memory_order_release);
+    }
 
-            if (_logFile)
-            {
-                ::fwrite(&item, sizeof(item), 1, _logFile);
-            }
+    cachedThreadBuffer.serviceId = _id;
+    cachedThreadBuffer.buffer = buffer;
+    return buffer;
+}
+
+bool PacketLogService::mapFile(LogFile& logFile)
+{
+    const size_t fileSize = sizeof(PacketLogHeader) + _maxRecordCount * sizeof(PacketLogItem);
+    logFile.fd = ::open(logFile.path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (logFile.fd < 0)
+    {
+        logger::error("failed to create packet log %s, err %d", "PacketLogService", logFile.path.c_str(), errno);
+        return false;
+    }
+
+    if (::ftruncate(logFile.fd, fileSize) != 0)
+    {
+        logger::error("failed to size packet log %s, err %d", "PacketLogService", logFile.path.c_str(), errno);
+        ::close(logFile.fd);
+        logFile.fd = -1;
+        return false;
+    }
+
+    auto* area = ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, logFile.fd, 0);
+    if (area == MAP_FAILED)
+    {
+        logger::error("failed to map packet log %s, err %d", "PacketLogService", logFile.path.c_str(), errno);
+        ::close(logFile.fd);
+        logFile.fd = -1;
+        return false;
+    }
+
+    logFile.header = reinterpret_cast<PacketLogHeader*>(area);
+    logFile.header->magic = PacketLogHeader::MAGIC;
+    logFile.header->version = PacketLogHeader::VERSION;
+    logFile.header->recordSize = sizeof(PacketLogItem);
+    logFile.header->recordCount = 0;
+    logFile.records = reinterpret_cast<PacketLogItem*>(logFile.header + 1);
+    return true;
+}
+
+// Trims the unused tail so a closed log holds exactly recordCount records.
+void PacketLogService::unmapFile(LogFile& logFile)
+{
+    if (!logFile.header)
+    {
+        return;
+    }
+
+    const size_t usedSize = sizeof(PacketLogHeader) + logFile.header->recordCount * sizeof(PacketLogItem);
+    ::munmap(logFile.header, sizeof(PacketLogHeader) + _maxRecordCount * sizeof(PacketLogItem));
+    if (::ftruncate(logFile.fd, usedSize) != 0)
+    {
+        logger::warn("failed to trim packet log %s, err %d", "PacketLogService", logFile.path.c_str(), errno);
+    }
+    ::close(logFile.fd);
+    logFile.fd = -1;
+    logFile.header = nullptr;
+    logFile.records = nullptr;
+}
+
+void PacketLogService::write(const Record& record)
+{
+    auto& logFile = _logs[getLogIndex(record.logId)];
+    if (logFile.logId.load(std::memory_order_acquire) != record.logId)
+    {
+        return; // closed
+    }
+
+    if (logFile.header->recordCount == _maxRecordCount)
+    {
+        unmapFile(logFile);
+        const auto previousPath = logFile.path + ".1";
+        ::rename(logFile.path.c_str(), previousPath.c_str());
+        if (!mapFile(logFile))
+        {
+            logFile.logId.store(0, std::memory_order_release);
+            return;
         }
-        else
+    }
+
+    logFile.records[logFile.header->recordCount] = record.item;
+    ++logFile.header->recordCount;
+}
+
+void PacketLogService::drainBuffers()
+{
+    Record records[64];
+    const auto bufferCount = _threadBufferCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < bufferCount; ++i)
+    {
+        auto& buffer = _threadBuffers[i]->records;
+        for (size_t count = buffer.pop(records, 64); count > 0; count = buffer.pop(records, 64))
         {
-            if (gotLogItem && _logFile)
+            for (size_t j = 0; j < count; ++j)
             {
-                ::fflush(_logFile);
+                write(records[j]);
             }
-            gotLogItem = false;
+        }
+    }
+}
 
-            if (!_running.load(std::memory_order::memory_order_relaxed))
-            {
-                break;
-            }
-            utils::Time::nanoSleep(50 * utils::Time::ms);
+void PacketLogService::processCloseRequests()
+{
+    uint32_t closeRequests[64];
+    const auto closeCount = _closeRequests.pop(closeRequests, 64);
+
+    // records posted before the close request are in the buffers now
+    drainBuffers();
+
+    for (size_t i = 0; i < closeCount; ++i)
+    {
+        const auto index = getLogIndex(closeRequests[i]);
+        auto& logFile = _logs[index];
+        if (makeLogId(index, logFile.generation) != closeRequests[i])
+        {
+            continue;
         }
+
+        logFile.logId.store(0, std::memory_order_release);
+        unmapFile(logFile);
+
+        std::lock_guard<std::mutex> lock(_logsLock);
+        _freeLogs.push_back(index);
     }
+}
 
-    if (_logFile)
+void PacketLogService::run()
+{
+    concurrency::setThreadName("PacketLogger");
+    for (;;)
     {
-        ::fclose(_logFile);
-        _logFile = nullptr;
+        const bool running = _running.load(std::memory_order_relaxed);
+        processCloseRequests();
+        ++_drainedCount;
+
+        if (!running && _closeRequests.empty())
+        {
+            break;
+        }
+        utils::Time::nanoSleep(10 * utils::Time::ms);
+    }
+
+    for (auto& logFile : _logs)
+    {
+        logFile.logId.store(0, std::memory_order_release);
+        unmapFile(logFile);
     }
 }
 
-PacketLogReader::PacketLogReader(FILE* logFile) : _logFile(logFile) {}
+PacketLogReader::PacketLogReader(FILE* logFile)
+    : _logFile(logFile),
+      _dataOffset(0),
+      _recordCount(~0ull),
+      _remainingCount(~0ull)
+{
+    if (!_logFile)
+    {
+        return;
+    }
+
+    // files without header are plain sequences of records
+    PacketLogHeader header;
+    if (1 == ::fread(&header, sizeof(header), 1, _logFile) && header.magic == PacketLogHeader::MAGIC &&
+        header.recordSize == sizeof(PacketLogItem))
+    {
+        _dataOffset = sizeof(header);
+        _recordCount = header.recordCount;
+    }
+    rewind();
+}
 
 PacketLogReader::~PacketLogReader()
 {
-    ::fclose(_logFile);
+    if (_logFile)
+    {
+        ::fclose(_logFile);
+    }
 }
 
 bool PacketLogReader::getNext(PacketLogItem& item)
 {
-    if (!_logFile)
+    if (!_logFile || _remainingCount == 0)
     {
         return false;
     }
     int readItems = ::fread(&item, sizeof(item), 1, _logFile);
-    return 1 == readItems;
+    if (1 == readItems)
+    {
+        --_remainingCount;
+        return true;
+    }
+    return false;
 }
 
 void PacketLogReader::rewind()
@@ -128,7 +407,8 @@ void PacketLogReader::rewind()
     {
         return;
     }
-    ::rewind(_logFile);
+    ::fseek(_logFile, _dataOffset, SEEK_SET);
+    _remainingCount = _recordCount;
 }
 
-} // namespace logger
\ No newline at end of file
+} // namespace logger
@@ -1,6 +1,10 @@
 #pragma once
 #include "concurrency/MpmcQueue.h"
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace memory
 {
@@ -21,21 +25,97 @@ struct PacketLogItem
     uint16_t size;
 };
 
-class PacketLoggerThread
+// Leads every packet log file. recordCount tells how many PacketLogItem follow, as the mapped file is
+// preallocated and may have an unused tail if the process did not close the log.
+struct PacketLogHeader
+{
+    static const uint32_t MAGIC = 0x474f4c50; // "PLOG"
+    static const uint16_t VERSION = 1;
+
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint64_t recordCount;
+};
+
+/**
+ * Writes packet logs for many transports from one thread. Each log is a memory mapped file of at most maxFileSize
+ * bytes. When it is full it is renamed to <name>.1, replacing any previous one, and a new file is started.
+ * Posting threads write into their own lock free buffer that the writer thread drains. Records are dropped if
+ * the buffer is full.
+ */
+class PacketLogService
 {
 public:
-    PacketLoggerThread(FILE* logFile, size_t backlogSize);
-    ~PacketLoggerThread();
+    PacketLogService(const std::string& directory,
+        size_t maxFileSize,
+        uint32_t maxLogs = 8192,
+        uint32_t threadBacklogSize = 8192);
+    ~PacketLogService();
 
-    void post(const memory::Packet& item, uint64_t receiveTime);
+    // returns log id to post to, or 0 if file could not be created
+    uint32_t openLog(const std::string& name);
+    void closeLog(uint32_t logId);
+
+    void post(uint32_t logId, const memory::Packet& packet, uint64_t receiveTime);
+
+    // blocks until records posted by this thread before the call have been written
+    void flush();
     void stop();
 
+    size_t getMaxRecordCount() const { return _maxRecordCount; }
+
 private:
+    struct Record
+    {
+        uint32_t logId;
+        PacketLogItem item;
+    };
+
+    struct LogFile
+    {
+        LogFile() : logId(0), generation(0), fd(-1), header(nullptr), records(nullptr) {}
+
+        std::atomic_uint32_t logId;
+        uint16_t generation;
+        std::string path;
+        int fd;
+        PacketLogHeader* header;
+        PacketLogItem* records;
+    };
+
+    struct ThreadBuffer
+    {
+        explicit ThreadBuffer(uint32_t backlogSize) : threadId(std::this_thread::get_id()), records(backlogSize) {}
+
+        const std::thread::id threadId;
+        concurrency::MpmcQueue<Record> records;
+    };
+
     void run();
+    ThreadBuffer* getThreadBuffer();
+    bool mapFile(LogFile& logFile);
+    void unmapFile(LogFile& logFile);
+    void write(const Record& record);
+    void drainBuffers();
+    void processCloseRequests();
 
+    const uint64_t _id;
+    const std::string _directory;
+    const size_t _maxRecordCount;
+    const uint32_t _threadBacklogSize;
+
+    std::vector<LogFile> _logs;
+    std::vector<uint32_t> _freeLogs;
+    std::mutex _logsLock;
+
+    std::vector<std::unique_ptr<ThreadBuffer>> _threadBuffers;
+    std::atomic_uint32_t _threadBufferCount;
+    std::mutex _threadBuffersLock;
+
+    concurrency::MpmcQueue<uint32_t> _closeRequests;
+    std::atomic_uint64_t _drainedCount;
     std::atomic_bool _running;
-    concurrency::MpmcQueue<PacketLogItem> _logQueue;
-    FILE* _logFile;
     std::unique_ptr<std::thread> _thread;
 };
 
@@ -51,6 +131,9 @@ public:
 
 private:
     FILE* _logFile;
+    long _dataOffset;
+    uint64_t _recordCount;
+    uint64_t _remainingCount;
 };
 
-} // namespace logger
\ No newline at end of file
+} // namespace logger
@@ -3,6 +3,7 @@
 #include "concurrency/ThreadUtils.h"
 #include "config/Config.h"
 #include "logger/Logger.h"
+#include "memory/PageAllocator.h"
 #include "utils/Time.h"
 #include <execinfo.h>
 #include <iostream>
@@ -137,7 +138,12 @@ int main(int argc, char** argv)
     }
 
     utils::Time::initialize();
-    logger::setup(config->logFile.get().c_str(), config->logStdOut, parseLogLevel(config->logLevel));
+    logger::setup(config->logFile.get().c_str(),
+        config->logStdOut,
+        parseLogLevel(config->logLevel),
+        4096,
+        config->logDeferredFormatting,
+        config->logRateLimit);
     logger::info("Starting httpd on port %u", "main", config->port.get());
     logger::info("Configured udp port range: %s  %u - %u",
         "main",
@@ -146,6 +152,24 @@ int main(int argc, char** argv)
         config->ice.udpPortRangeHigh.get());
     logger::logAlways("log level %s", "main", config->logLevel.get().c_str());
 
+    if (config->affinity.numaNode >= 0 && concurrency::setPreferredNumaNode(config->affinity.numaNode))
+    {
+        logger::info("Allocating memory on NUMA node %d", "main", config->affinity.numaNode.get());
+    }
+
+    if (config->pools.hugePages.get() == "transparent")
+    {
+        memory::setPageBackend(memory::PageBackend::Transparent, config->pools.prefault);
+    }
+    else if (config->pools.hugePages.get() == "hugetlb")
+    {
+        memory::setPageBackend(memory::PageBackend::HugeTlb, config->pools.prefault);
+    }
+    else
+    {
+        memory::setPageBackend(memory::PageBackend::Normal, config->pools.prefault);
+    }
+
     {
         bridge::Bridge environment(*config);
         environment.initialize();
@@ -9,18 +9,19 @@ namespace math
 {
 
 // default is column vector
+// Elements are stored row major in one aligned block. Element wise operations run as a single loop over
+// M * N elements to let the compiler vectorize them.
 template <typename T, uint32_t M, uint32_t N = 1>
 class Matrix
 {
 public:
+    static const uint32_t SIZE = M * N;
+
     Matrix()
     {
-        for (uint32_t c = 0; c < N; ++c)
+        for (uint32_t i = 0; i < SIZE; ++i)
         {
-            for (uint32_t r = 0; r < M; ++r)
-            {
-                _m[r][c] = 0;
-            }
+            data()[i] = 0;
         }
     }
 
@@ -56,28 +57,39 @@ public:
 
     Matrix& operator+=(const Matrix<T, M, N>& m2)
     {
-        for (uint32_t i = 0; i < M; ++i)
+        T* __restrict__ a = data();
+        const T* __restrict__ b = m2.data();
+        for (uint32_t i = 0; i < SIZE; ++i)
         {
-            for (uint32_t j = 0; j < N; ++j)
-            {
-                _m[i][j] = _m[i][j] + m2(i, j);
-            }
+            a[i] += b[i];
+        }
+        return *this;
+    }
+
+    Matrix& operator-=(const Matrix<T, M, N>& m2)
+    {
+        T* __restrict__ a = data();
+        const T* __restrict__ b = m2.data();
+        for (uint32_t i = 0; i < SIZE; ++i)
+        {
+            a[i] -= b[i];
         }
         return *this;
     }
 
     Matrix& operator*=(const T value)
     {
-        for (uint32_t i = 0; i < M; ++i)
+        T* a = data();
+        for (uint32_t i = 0; i < SIZE; ++i)
         {
-            for (uint32_t j = 0; j < N; ++j)
-            {
-                _m[i][j] = _m[i][j] * value;
-            }
+            a[i] *= value;
         }
         return *this;
     }
 
+    T* data() { return &_m[0][0]; }
+    const T* data() const { return &_m[0][0]; }
+
     inline T& operator()(uint32_t r, uint32_t c = 0)
     {
         assert(r < M && c < N);
@@ -111,7 +123,7 @@ public:
     constexpr int rows() const { return M; }
 
 private:
-    T _m[M][N];
+    alignas(16) T _m[M][N];
 };
 
 template <typename T, uint32_t M, uint32_t N, uint32_t P>
@@ -167,28 +179,16 @@ Matrix<T, N, N> outerProduct(const Matrix<T, N, 1>& m1)
 template <typename T, uint32_t M, uint32_t N>
 Matrix<T, M, N> operator+(const Matrix<T, M, N>& m1, const Matrix<T, M, N>& m2)
 {
-    Matrix<T, M, N> r;
-    for (uint32_t i = 0; i < M; ++i)
-    {
-        for (uint32_t j = 0; j < N; ++j)
-        {
-            r(i, j) = m1(i, j) + m2(i, j);
-        }
-    }
+    Matrix<T, M, N> r(m1);
+    r += m2;
     return r;
 }
 
 template <typename T, uint32_t M, uint32_t N>
 Matrix<T, M, N> operator-(const Matrix<T, M, N>& m1, const Matrix<T, M, N>& m2)
 {
-    Matrix<T, M, N> r;
-    for (uint32_t i = 0; i < M; ++i)
-    {
-        for (uint32_t j = 0; j < N; ++j)
-        {
-            r(i, j) = m1(i, j) - m2(i, j);
-        }
-    }
+    Matrix<T, M, N> r(m1);
+    r -= m2;
     return r;
 }
 
@@ -249,14 +249,8 @@ Matrix<T, M, M> choleskyDecompositionLL(const Matrix<T, M, M>& m)
 template <typename T, uint32_t M, uint32_t N>
 Matrix<T, M, N> operator*(const Matrix<T, M, N>& m, T scalar)
 {
-    Matrix<T, M, N> r;
-    for (uint32_t i = 0; i < M; ++i)
-    {
-        for (uint32_t j = 0; j < N; ++j)
-        {
-            r(i, j) = m(i, j) * scalar;
-        }
-    }
+    Matrix<T, M, N> r(m);
+    r *= scalar;
     return r;
 }
 
@@ -269,14 +263,11 @@ Matrix<T, M, N> operator*(T scalar, const Matrix<T, M, N>& m)
 template <typename T, uint32_t M, uint32_t N>
 bool isValid(const Matrix<T, M, N>& m)
 {
-    for (uint32_t i = 0; i < M; ++i)
+    for (uint32_t i = 0; i < Matrix<T, M, N>::SIZE; ++i)
     {
-        for (uint32_t j = 0; j < N; ++j)
+        if (std::isnan(m.data()[i]))
         {
-            if (std::isnan(m(i, j)))
-            {
-                return false;
-            }
+            return false;
         }
     }
     return true;
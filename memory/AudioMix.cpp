@@ -0,0 +1,182 @@
+#include "memory/AudioMix.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+using MixFunction = void (*)(int16_t*, const int16_t*, size_t, int16_t);
+
+struct MixKernels
+{
+    MixFunction mix;
+    MixFunction unmix;
+};
+
+inline int16_t saturate(int32_t value)
+{
+    return static_cast<int16_t>(std::min<int32_t>(std::numeric_limits<int16_t>::max(),
+        std::max<int32_t>(std::numeric_limits<int16_t>::min(), value)));
+}
+
+inline bool isPowerOfTwo(int16_t value)
+{
+    return (value & (value - 1)) == 0;
+}
+
+inline int log2(int16_t value)
+{
+    return __builtin_ctz(static_cast<uint32_t>(value));
+}
+
+template <bool SUBTRACT>
+void mixScalar(int16_t* mixedData, const int16_t* samples, const size_t count, const int16_t scaleFactor)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const int32_t scaled = samples[i] / scaleFactor;
+        mixedData[i] = saturate(SUBTRACT ? mixedData[i] - scaled : mixedData[i] + scaled);
+    }
+}
+
+#if defined(__x86_64__)
+// Truncating integer division is done with a biased arithmetic shift for power of two scale factors. Other scale
+// factors go through float division, which is exact after truncation for all int16 dividends and divisors.
+
+template <bool SUBTRACT>
+void mixSse2(int16_t* mixedData, const int16_t* samples, const size_t count, const int16_t scaleFactor)
+{
+    size_t i = 0;
+    if (isPowerOfTwo(scaleFactor))
+    {
+        const __m128i shift = _mm_cvtsi32_si128(log2(scaleFactor));
+        const __m128i bias = _mm_set1_epi16(scaleFactor - 1);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+            const __m128i negativeBias = _mm_and_si128(_mm_srai_epi16(input, 15), bias);
+            const __m128i scaled = _mm_sra_epi16(_mm_add_epi16(input, negativeBias), shift);
+            const __m128i mixed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mixedData + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(mixedData + i),
+                SUBTRACT ? _mm_subs_epi16(mixed, scaled) : _mm_adds_epi16(mixed, scaled));
+        }
+    }
+    else
+    {
+        const __m128 divisor = _mm_set1_ps(scaleFactor);
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+            const __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(input, input), 16);
+            const __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(input, input), 16);
+            const __m128i scaled = _mm_packs_epi32(_mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(low), divisor)),
+                _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(high), divisor)));
+            const __m128i mixed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mixedData + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(mixedData + i),
+                SUBTRACT ? _mm_subs_epi16(mixed, scaled) : _mm_adds_epi16(mixed, scaled));
+        }
+    }
+
+    mixScalar<SUBTRACT>(mixedData + i, samples + i, count - i, scaleFactor);
+}
+
+template <bool SUBTRACT>
+__attribute__((target("avx2"))) void mixAvx2(int16_t* mixedData,
+    const int16_t* samples,
+    const size_t count,
+    const int16_t scaleFactor)
+{
+    size_t i = 0;
+    if (isPowerOfTwo(scaleFactor))
+    {
+        const __m128i shift = _mm_cvtsi32_si128(log2(scaleFactor));
+        const __m256i bias = _mm256_set1_epi16(scaleFactor - 1);
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+            const __m256i negativeBias = _mm256_and_si256(_mm256_srai_epi16(input, 15), bias);
+            const __m256i scaled = _mm256_sra_epi16(_mm256_add_epi16(input, negativeBias), shift);
+            const __m256i mixed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mixedData + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(mixedData + i),
+                SUBTRACT ? _mm256_subs_epi16(mixed, scaled) : _mm256_adds_epi16(mixed, scaled));
+        }
+    }
+    else
+    {
+        const __m256 divisor = _mm256_set1_ps(scaleFactor);
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+            const __m256i low = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(input));
+            const __m256i high = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(input, 1));
+            const __m256i packed =
+                _mm256_packs_epi32(_mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(low), divisor)),
+                    _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(high), divisor)));
+            // packs works per 128 bit lane, restore sample order
+            const __m256i scaled = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+            const __m256i mixed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mixedData + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(mixedData + i),
+                SUBTRACT ? _mm256_subs_epi16(mixed, scaled) : _mm256_adds_epi16(mixed, scaled));
+        }
+    }
+
+    mixScalar<SUBTRACT>(mixedData + i, samples + i, count - i, scaleFactor);
+}
+#endif
+
+MixKernels selectKernels()
+{
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return {mixAvx2<false>, mixAvx2<true>};
+    }
+    return {mixSse2<false>, mixSse2<true>};
+#else
+    return {mixScalar<false>, mixScalar<true>};
+#endif
+}
+
+const MixKernels& getKernels()
+{
+    static const MixKernels kernels = selectKernels();
+    return kernels;
+}
+
+} // namespace
+
+namespace memory
+{
+
+void mixScaled(int16_t* mixedData, const int16_t* samples, const size_t count, const int16_t scaleFactor)
+{
+    assert(scaleFactor > 0);
+    getKernels().mix(mixedData, samples, count, scaleFactor);
+}
+
+void unmixScaled(int16_t* mixedData, const int16_t* samples, const size_t count, const int16_t scaleFactor)
+{
+    assert(scaleFactor > 0);
+    getKernels().unmix(mixedData, samples, count, scaleFactor);
+}
+
+namespace detail
+{
+
+void mixScaledScalar(int16_t* mixedData, const int16_t* samples, const size_t count, const int16_t scaleFactor)
+{
+    mixScalar<false>(mixedData, samples, count, scaleFactor);
+}
+
+void unmixScaledScalar(int16_t* mixedData, const int16_t* samples, const size_t count, const int16_t scaleFactor)
+{
+    mixScalar<true>(mixedData, samples, count, scaleFactor);
+}
+
+} // namespace detail
+} // namespace memory
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace memory
+{
+
+/**
+ * Adds each sample divided by scaleFactor to mixedData. The division truncates towards zero like the scalar integer
+ * division it replaces and the addition saturates at the int16 range. scaleFactor must be positive.
+ * Uses AVX2 or SSE2 when the cpu supports it.
+ */
+void mixScaled(int16_t* mixedData, const int16_t* samples, size_t count, int16_t scaleFactor);
+
+/**
+ * Subtracts each sample divided by scaleFactor from mixedData, saturating at the int16 range. Counterpart of
+ * mixScaled.
+ */
+void unmixScaled(int16_t* mixedData, const int16_t* samples, size_t count, int16_t scaleFactor);
+
+namespace detail
+{
+// Portable implementations, exposed for verification of the vectorized kernels.
+void mixScaledScalar(int16_t* mixedData, const int16_t* samples, size_t count, int16_t scaleFactor);
+void unmixScaledScalar(int16_t* mixedData, const int16_t* samples, size_t count, int16_t scaleFactor);
+} // namespace detail
+
+} // namespace memory
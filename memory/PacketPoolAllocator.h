@@ -12,7 +12,10 @@ const size_t packetPoolSize = 2048 * 4;
 class PacketPoolAllocator : public PoolAllocator<sizeof(Packet)>
 {
 public:
-    PacketPoolAllocator(size_t elementCount, const std::string&& name) : PoolAllocator(elementCount, std::move(name)) {}
+    PacketPoolAllocator(size_t elementCount, const std::string&& name, const bool threadCache = false)
+        : PoolAllocator(elementCount, std::move(name), threadCache)
+    {
+    }
 
     static bool isCorrupt(Packet* p) { return PoolAllocator<sizeof(Packet)>::isCorrupt(p); }
     static bool isCorrupt(Packet& p) { return PoolAllocator<sizeof(Packet)>::isCorrupt(&p); }
@@ -0,0 +1,157 @@
+#include "memory/PageAllocator.h"
+#include "logger/Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace memory
+{
+namespace
+{
+const size_t hugePageSize = 2 * 1024 * 1024;
+
+std::atomic<PageBackend> pageBackend(PageBackend::Normal);
+std::atomic_bool prefaultPages(false);
+std::atomic_bool hugeTlbFailureLogged(false);
+
+size_t roundUp(size_t size, size_t pageSize)
+{
+    const auto remaining = size % pageSize;
+    return size + (remaining != 0 ? pageSize - remaining : 0);
+}
+
+void* mapAnonymous(size_t size, int extraFlags)
+{
+    auto* start = mmap(nullptr, size, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS | extraFlags), -1, 0);
+    return start == MAP_FAILED ? nullptr : start;
+}
+
+// mmap only guarantees page alignment. The region is over-allocated by one huge page and the slack on either side
+// of the aligned part is unmapped, so every 2MB of it can be backed by a transparent huge page.
+void* mapHugePageAligned(size_t size)
+{
+    auto* start = reinterpret_cast<uint8_t*>(mapAnonymous(size + hugePageSize, 0));
+    if (!start)
+    {
+        return nullptr;
+    }
+
+    const auto address = reinterpret_cast<uintptr_t>(start);
+    const auto headSlack = roundUp(address, hugePageSize) - address;
+    if (headSlack > 0)
+    {
+        munmap(start, headSlack);
+    }
+    const auto tailSlack = hugePageSize - headSlack;
+    if (tailSlack > 0)
+    {
+        munmap(start + headSlack + size, tailSlack);
+    }
+    return start + headSlack;
+}
+
+void prefault(void* start, size_t size)
+{
+    auto* bytes = reinterpret_cast<volatile uint8_t*>(start);
+    const size_t pageSize = getpagesize();
+    for (size_t offset = 0; offset < size; offset += pageSize)
+    {
+        bytes[offset] = 0;
+    }
+}
+} // namespace
+
+void setPageBackend(PageBackend backend, bool prefault)
+{
+    pageBackend = backend;
+    prefaultPages = prefault;
+}
+
+PageBackend getPageBackend()
+{
+    return pageBackend;
+}
+
+void* mapPages(size_t& size)
+{
+    const auto backend = pageBackend.load();
+    void* start = nullptr;
+    if (backend == PageBackend::Normal || size < hugePageSize)
+    {
+        size = roundUp(size, getpagesize());
+        start = mapAnonymous(size, 0);
+    }
+    else
+    {
+#ifdef MAP_HUGETLB
+        if (backend == PageBackend::HugeTlb)
+        {
+            const auto hugeSize = roundUp(size, hugePageSize);
+            start = mapAnonymous(hugeSize, MAP_HUGETLB);
+            if (start)
+            {
+                size = hugeSize;
+            }
+            else if (!hugeTlbFailureLogged.exchange(true))
+            {
+                logger::warn("No reserved huge pages available. Falling back to transparent huge pages", "PageAllocator");
+            }
+        }
+#endif
+        if (!start)
+        {
+            size = roundUp(size, hugePageSize);
+            start = mapHugePageAligned(size);
+#ifdef MADV_HUGEPAGE
+            if (start)
+            {
+                madvise(start, size, MADV_HUGEPAGE);
+            }
+#endif
+        }
+    }
+
+    if (start && prefaultPages)
+    {
+        prefault(start, size);
+    }
+    return start;
+}
+
+void unmapPages(void* start, size_t size)
+{
+    if (start)
+    {
+        munmap(start, size);
+    }
+}
+
+size_t residentBytes(const void* start, size_t size)
+{
+    const size_t pageSize = getpagesize();
+    const size_t chunkPages = 4096;
+#ifdef __APPLE__
+    char residency[chunkPages];
+#else
+    unsigned char residency[chunkPages];
+#endif
+    size_t resident = 0;
+    auto* cursor = reinterpret_cast<uint8_t*>(const_cast<void*>(start));
+    for (size_t offset = 0; offset < size; offset += chunkPages * pageSize)
+    {
+        const auto length = std::min(chunkPages * pageSize, size - offset);
+        if (mincore(cursor + offset, length, residency) != 0)
+        {
+            return 0;
+        }
+        for (size_t i = 0; i < (length + pageSize - 1) / pageSize; ++i)
+        {
+            resident += (residency[i] & 1) * pageSize;
+        }
+    }
+    return std::min(resident, size);
+}
+
+} // namespace memory
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+
+namespace memory
+{
+enum class PageBackend
+{
+    Normal,
+    Transparent, // transparent huge pages via madvise
+    HugeTlb // reserved huge pages, falls back to Transparent if none are available
+};
+
+// Backend for large pool and queue mappings created after this call. Set it at startup before creating pools.
+// With prefault, mappings are touched when created so no page faults occur when the pool is first used.
+void setPageBackend(PageBackend backend, bool prefault);
+PageBackend getPageBackend();
+
+// Maps anonymous read write memory. Mappings smaller than a huge page always use normal pages. size is rounded up to
+// the page size used and must be passed to unmapPages. Returns nullptr on failure.
+void* mapPages(size_t& size);
+void unmapPages(void* start, size_t size);
+
+// Bytes of the mapping that are resident in memory.
+size_t residentBytes(const void* start, size_t size);
+
+} // namespace memory
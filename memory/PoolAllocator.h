@@ -3,6 +3,8 @@
 #include "concurrency/LockFreeList.h"
 #include "concurrency/WaitFreeStack.h"
 #include "logger/Logger.h"
+#include "memory/PageAllocator.h"
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <iterator>
@@ -24,20 +26,77 @@
 namespace memory
 {
 
+namespace detail
+{
+
+const size_t maxThreadCaches = 64;
+
+// Dense index of the calling thread for use with per thread caches. Indices are reused when threads exit. Threads
+// beyond maxThreadCaches get -1.
+class ThreadCacheSlot
+{
+public:
+    ThreadCacheSlot() : index(-1)
+    {
+        auto& used = usedSlots();
+        for (auto current = used.load(std::memory_order_relaxed); ~current != 0;)
+        {
+            const auto slot = __builtin_ctzll(~current);
+            if (used.compare_exchange_weak(current, current | (1ull << slot), std::memory_order_acquire))
+            {
+                index = slot;
+                return;
+            }
+        }
+    }
+
+    ~ThreadCacheSlot()
+    {
+        if (index >= 0)
+        {
+            usedSlots().fetch_and(~(1ull << index), std::memory_order_release);
+            index = -1;
+        }
+    }
+
+    int index;
+
+private:
+    static std::atomic_uint64_t& usedSlots()
+    {
+        static std::atomic_uint64_t used(0);
+        return used;
+    }
+};
+
+inline int getThreadCacheIndex()
+{
+    static thread_local ThreadCacheSlot slot;
+    return slot.index;
+}
+
+} // namespace detail
+
 /**
     @brief
         Manages a pool of S elements of type T. PoolAllocator is thread safe.
+
+        With thread cache enabled, each thread keeps a small magazine of free elements. Allocations and frees are
+        served from the magazine and it is refilled from, or returned to, the shared free queues in batches. Up to
+        maxThreadCaches * threadCacheSize elements may sit in magazines, so only use it for large pools.
 */
 template <size_t ELEMENT_SIZE>
 class PoolAllocator
 {
     static const size_t QCOUNT = 8;
-    static size_t calculateNeededSpace(size_t desiredCount)
+    static const uint32_t threadCacheSize = 32;
+    static const uint32_t threadCacheBatch = threadCacheSize / 2;
+    static size_t calculateNeededSpace(size_t desiredCount) { return calculateSpace(desiredCount * sizeof(Entry)); }
+    static size_t calculateSpace(size_t bytes)
     {
-        auto finalSize = desiredCount * sizeof(Entry);
         const auto pageSize = getpagesize();
-        const auto remaining = finalSize % pageSize;
-        return finalSize + (remaining != 0 ? pageSize - remaining : 0);
+        const auto remaining = bytes % pageSize;
+        return bytes + (remaining != 0 ? pageSize - remaining : 0);
     }
 
 public:
@@ -60,9 +119,17 @@ public:
         PoolAllocator<ELEMENT_SIZE>* _allocator;
     };
 
-    PoolAllocator(size_t elementCount, const std::string&& name)
+    struct ThreadCacheStats
+    {
+        uint32_t cachedItems = 0;
+        uint32_t refills = 0;
+        uint32_t returns = 0;
+    };
+
+    PoolAllocator(size_t elementCount, const std::string&& name, const bool threadCache = false)
         : _deleter(this),
           _name(std::move(name)),
+          _threadCaches(nullptr),
           _size(calculateNeededSpace(elementCount)),
           _originalElementCount(_size / sizeof(Entry))
     {
@@ -73,9 +140,9 @@ public:
         _cacheLineSeparator2[0] = 0;
         _cacheLineSeparator3[0] = 0;
 
-        _elements = reinterpret_cast<Entry*>(
-            mmap(nullptr, _size, (PROT_READ | PROT_WRITE), (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0));
-        assert(reinterpret_cast<intptr_t>(_elements) != -1);
+        _mappedSize = _size;
+        _elements = reinterpret_cast<Entry*>(mapPages(_mappedSize));
+        assert(_elements);
 
         static_assert(sizeof(Entry) % alignof(std::max_align_t) == 0, "ELEMENT_SIZE must be multiple of alignment");
 
@@ -84,12 +151,31 @@ public:
             auto entry = new (&_elements[i]) Entry();
             _freeQueue[i % QCOUNT].push(entry);
         }
+
+        if (threadCache)
+        {
+            _threadCaches = reinterpret_cast<ThreadCache*>(mmap(nullptr,
+                threadCachesSize(),
+                (PROT_READ | PROT_WRITE),
+                (MAP_PRIVATE | MAP_ANONYMOUS),
+                -1,
+                0));
+            assert(reinterpret_cast<intptr_t>(_threadCaches) != -1);
+            for (size_t i = 0; i < detail::maxThreadCaches; ++i)
+            {
+                new (&_threadCaches[i]) ThreadCache();
+            }
+        }
     }
 
     ~PoolAllocator()
     {
         logAllocatedElements();
-        munmap(_elements, _size);
+        if (_threadCaches)
+        {
+            munmap(_threadCaches, threadCachesSize());
+        }
+        unmapPages(_elements, _mappedSize);
     }
 
     Deleter& getDeleter() { return _deleter; }
@@ -121,12 +207,40 @@ public:
 
     size_t size() const { return _count.load(std::memory_order_relaxed); }
     size_t countAllocatedItems() const { return _originalElementCount - size(); }
-    void* allocate()
+
+    bool hasThreadCache() const { return _threadCaches != nullptr; }
+
+    // bytes of the element area that are backed by memory
+    size_t getResidentBytes() const { return residentBytes(_elements, _mappedSize); }
+
+    ThreadCacheStats getThreadCacheStats(const size_t threadIndex) const
     {
-        concurrency::StackItem* item = nullptr;
-        const auto index = _popIndex.fetch_add(1);
+        ThreadCacheStats stats;
+        if (_threadCaches && threadIndex < detail::maxThreadCaches)
+        {
+            const auto& cache = _threadCaches[threadIndex];
+            stats.cachedItems = cache.count.load(std::memory_order_relaxed);
+            stats.refills = cache.refills.load(std::memory_order_relaxed);
+            stats.returns = cache.returns.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
 
-        if (!_freeQueue[index % QCOUNT].pop(item))
+    size_t countCachedItems() const
+    {
+        size_t count = 0;
+        for (size_t i = 0; _threadCaches && i < detail::maxThreadCaches; ++i)
+        {
+            count += _threadCaches[i].count.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    void* allocate()
+    {
+        const auto cacheIndex = _threadCaches ? detail::getThreadCacheIndex() : -1;
+        auto entry = cacheIndex >= 0 ? allocateCached(_threadCaches[cacheIndex]) : popEntry();
+        if (!entry)
         {
 #if DEBUG
             logger::errorImmediate("pool depleted", _name.c_str());
@@ -137,7 +251,6 @@ public:
 #if ENABLE_ALLOCATOR_METRICS
         _count.fetch_sub(1, std::memory_order_relaxed);
 #endif
-        auto entry = reinterpret_cast<Entry*>(item);
 #if POOLALLOC_MEMGUARDS
         assert(entry->_beginGuard == 0xABABABABABABABABLLU);
         assert(entry->_endGuard == 0xBABABABABABABABALLU);
@@ -165,8 +278,16 @@ public:
         entry->_beginGuard = 0xABABABABABABABABLLU;
         entry->_endGuard = 0xBABABABABABABABALLU;
 #endif
-        const auto index = _pushIndex.fetch_add(1) % QCOUNT;
-        _freeQueue[index].push(entry);
+        const auto cacheIndex = _threadCaches ? detail::getThreadCacheIndex() : -1;
+        if (cacheIndex >= 0)
+        {
+            freeCached(_threadCaches[cacheIndex], entry);
+        }
+        else
+        {
+            const auto index = _pushIndex.fetch_add(1) % QCOUNT;
+            _freeQueue[index].push(entry);
+        }
 #if ENABLE_ALLOCATOR_METRICS
         _count.fetch_add(1, std::memory_order_relaxed);
 #endif
@@ -217,9 +338,80 @@ private:
 #endif
     };
 
+    // Only accessed by the thread owning the cache index. Counters are atomic so they can be sampled for metrics.
+    struct alignas(64) ThreadCache
+    {
+        std::atomic_uint32_t count{0};
+        std::atomic_uint32_t refills{0};
+        std::atomic_uint32_t returns{0};
+        Entry* items[threadCacheSize];
+    };
+
+    static size_t threadCachesSize() { return calculateSpace(detail::maxThreadCaches * sizeof(ThreadCache)); }
+
+    Entry* popEntry()
+    {
+        concurrency::StackItem* item = nullptr;
+        const auto index = _popIndex.fetch_add(1);
+        if (!_freeQueue[index % QCOUNT].pop(item))
+        {
+            return nullptr;
+        }
+        return reinterpret_cast<Entry*>(item);
+    }
+
+    Entry* allocateCached(ThreadCache& cache)
+    {
+        auto count = cache.count.load(std::memory_order_relaxed);
+        if (count == 0)
+        {
+            const auto index = _popIndex.fetch_add(1);
+            concurrency::StackItem* item = nullptr;
+            for (size_t i = 0, misses = 0; count < threadCacheBatch && misses < QCOUNT; ++i)
+            {
+                if (_freeQueue[(index + i) % QCOUNT].pop(item))
+                {
+                    cache.items[count++] = reinterpret_cast<Entry*>(item);
+                    misses = 0;
+                }
+                else
+                {
+                    ++misses;
+                }
+            }
+            cache.refills.fetch_add(1, std::memory_order_relaxed);
+            if (count == 0)
+            {
+                return nullptr;
+            }
+        }
+
+        --count;
+        cache.count.store(count, std::memory_order_relaxed);
+        return cache.items[count];
+    }
+
+    void freeCached(ThreadCache& cache, Entry* entry)
+    {
+        auto count = cache.count.load(std::memory_order_relaxed);
+        if (count == threadCacheSize)
+        {
+            const auto index = _pushIndex.fetch_add(1);
+            for (uint32_t i = 0; i < threadCacheBatch; ++i)
+            {
+                _freeQueue[(index + i) % QCOUNT].push(cache.items[--count]);
+            }
+            cache.returns.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        cache.items[count++] = entry;
+        cache.count.store(count, std::memory_order_relaxed);
+    }
+
     Deleter _deleter;
     std::string _name;
     Entry* _elements;
+    ThreadCache* _threadCaches;
     uint64_t _cacheLineSeparator1[6];
     concurrency::WaitFreeStack _freeQueue[QCOUNT];
     std::atomic_uint32_t _popIndex;
@@ -227,6 +419,7 @@ private:
     std::atomic_uint32_t _pushIndex;
     uint64_t _cacheLineSeparator3[5];
     const size_t _size;
+    size_t _mappedSize;
     const size_t _originalElementCount;
     std::atomic_uint32_t _count;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "memory/AudioMix.h"
 #include "utils/ScopedReentrancyBlocker.h"
 #include <cassert>
 #include <cstddef>
@@ -10,6 +11,40 @@
 namespace memory
 {
 
+namespace detail
+{
+
+template <typename T>
+void addScaled(T* mixedData, const T* data, const size_t size, const T scaleFactor)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        mixedData[i] += data[i] / scaleFactor;
+    }
+}
+
+template <typename T>
+void subtractScaled(T* mixedData, const T* data, const size_t size, const T scaleFactor)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        mixedData[i] -= data[i] / scaleFactor;
+    }
+}
+
+// int16 audio goes through the vectorized, saturating kernels
+inline void addScaled(int16_t* mixedData, const int16_t* data, const size_t size, const int16_t scaleFactor)
+{
+    mixScaled(mixedData, data, size, scaleFactor);
+}
+
+inline void subtractScaled(int16_t* mixedData, const int16_t* data, const size_t size, const int16_t scaleFactor)
+{
+    unmixScaled(mixedData, data, size, scaleFactor);
+}
+
+} // namespace detail
+
 /**
  * Not thread safe.
  */
@@ -101,7 +136,7 @@ public:
 
     /**
      * Reads size elements from the buffer and adds each element of the read data to mixedData, scaled with scaleFactor.
-     * Does not move the read head.
+     * Does not move the read head. For int16_t the addition saturates.
      */
     bool addToMix(T* mixedData, const size_t size, const T scaleFactor)
     {
@@ -118,21 +153,12 @@ public:
         if (_readHead + size > S)
         {
             const auto remaining = S - _readHead;
-            for (auto i = _readHead; i < _readHead + remaining; ++i)
-            {
-                mixedData[i - _readHead] += _data[i] / scaleFactor;
-            }
-            for (size_t i = 0; i < size - remaining; ++i)
-            {
-                mixedData[remaining + i] += _data[i] / scaleFactor;
-            }
+            detail::addScaled(mixedData, &_data[_readHead], remaining, scaleFactor);
+            detail::addScaled(&mixedData[remaining], &_data[0], size - remaining, scaleFactor);
         }
         else
         {
-            for (auto i = _readHead; i < _readHead + size; ++i)
-            {
-                mixedData[i - _readHead] += _data[i] / scaleFactor;
-            }
+            detail::addScaled(mixedData, &_data[_readHead], size, scaleFactor);
         }
 
         return true;
@@ -140,7 +166,7 @@ public:
 
     /**
      * Reads size elements from the buffer and subtracts each element of the read data to mixedData, scaled with
-     * scaleFactor. Does not move the read head.
+     * scaleFactor. Does not move the read head. For int16_t the subtraction saturates.
      */
     bool removeFromMix(T* mixedData, const size_t size, const T scaleFactor)
     {
@@ -157,21 +183,12 @@ public:
         if (_readHead + size > S)
         {
             const auto remaining = S - _readHead;
-            for (auto i = _readHead; i < _readHead + remaining; ++i)
-            {
-                mixedData[i - _readHead] -= _data[i] / scaleFactor;
-            }
-            for (size_t i = 0; i < size - remaining; ++i)
-            {
-                mixedData[remaining + i] -= _data[i] / scaleFactor;
-            }
+            detail::subtractScaled(mixedData, &_data[_readHead], remaining, scaleFactor);
+            detail::subtractScaled(&mixedData[remaining], &_data[0], size - remaining, scaleFactor);
         }
         else
         {
-            for (auto i = _readHead; i < _readHead + size; ++i)
-            {
-                mixedData[i - _readHead] -= _data[i] / scaleFactor;
-            }
+            detail::subtractScaled(mixedData, &_data[_readHead], size, scaleFactor);
         }
 
         return true;
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "memory/PacketPoolAllocator.h"
+#include <atomic>
+#include <utility>
+
+namespace memory
+{
+
+/**
+ * Reference counted read only handle to a packet. It lets one inbound packet be handed to many receiver jobs
+ * without copying it once per receiver on the thread that fans it out. A receiver that needs to modify the packet
+ * calls makeWritable, which hands over the original packet if it is the last holder and copies it otherwise.
+ * Copying and destroying handles is thread safe.
+ */
+class SharedPacket
+{
+    struct Storage
+    {
+        explicit Storage(UniquePacket&& packet_) : packet(std::move(packet_)), refCount(1) {}
+
+        UniquePacket packet;
+        std::atomic_uint32_t refCount;
+    };
+
+public:
+    using Allocator = PoolAllocator<sizeof(Storage)>;
+
+    SharedPacket() : _storage(nullptr), _allocator(nullptr) {}
+
+    SharedPacket(const SharedPacket& rhs) : _storage(rhs._storage), _allocator(rhs._allocator)
+    {
+        if (_storage)
+        {
+            _storage->refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    SharedPacket(SharedPacket&& rhs)
+        : _storage(std::exchange(rhs._storage, nullptr)),
+          _allocator(std::exchange(rhs._allocator, nullptr))
+    {
+    }
+
+    SharedPacket& operator=(const SharedPacket& rhs)
+    {
+        if (this != &rhs)
+        {
+            SharedPacket copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    SharedPacket& operator=(SharedPacket&& rhs)
+    {
+        if (this != &rhs)
+        {
+            reset();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    ~SharedPacket() { reset(); }
+
+    const Packet* get() const { return _storage ? _storage->packet.get() : nullptr; }
+    const Packet& operator*() const { return *_storage->packet; }
+    const Packet* operator->() const { return _storage->packet.get(); }
+    explicit operator bool() const { return _storage != nullptr; }
+
+    uint32_t useCount() const { return _storage ? _storage->refCount.load(std::memory_order_relaxed) : 0; }
+
+    /**
+     * Releases this handle and returns a packet that the caller owns. The original packet is returned without
+     * copy if no other handle refers to it. Otherwise a copy is allocated from the provided allocator.
+     */
+    UniquePacket makeWritable(PacketPoolAllocator& allocator)
+    {
+        if (!_storage)
+        {
+            return UniquePacket();
+        }
+
+        if (_storage->refCount.load(std::memory_order_acquire) == 1)
+        {
+            auto packet = std::move(_storage->packet);
+            reset();
+            return packet;
+        }
+
+        auto packet = makeUniquePacket(allocator, *_storage->packet);
+        if (packet)
+        {
+            packet->endpointIdHash = _storage->packet->endpointIdHash;
+        }
+        reset();
+        return packet;
+    }
+
+    void reset()
+    {
+        if (!_storage)
+        {
+            return;
+        }
+
+        if (_storage->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            _storage->~Storage();
+            _allocator->free(_storage);
+        }
+        _storage = nullptr;
+        _allocator = nullptr;
+    }
+
+    void swap(SharedPacket& rhs)
+    {
+        std::swap(_storage, rhs._storage);
+        std::swap(_allocator, rhs._allocator);
+    }
+
+private:
+    friend SharedPacket makeSharedPacket(SharedPacket::Allocator& allocator, UniquePacket& packet);
+
+    SharedPacket(Storage* storage, Allocator* allocator) : _storage(storage), _allocator(allocator) {}
+
+    Storage* _storage;
+    Allocator* _allocator;
+};
+
+using SharedPacketAllocator = SharedPacket::Allocator;
+
+/**
+ * Moves the packet into a shared handle. The packet is left untouched if the allocator is depleted, in which case
+ * an empty handle is returned.
+ */
+inline SharedPacket makeSharedPacket(SharedPacketAllocator& allocator, UniquePacket& packet)
+{
+    if (!packet)
+    {
+        return SharedPacket();
+    }
+
+    auto pointer = allocator.allocate();
+    if (!pointer)
+    {
+        logger::error("Unable to allocate shared packet, no space left in pool %s",
+            "SharedPacket",
+            allocator.getName().c_str());
+        return SharedPacket();
+    }
+
+    auto storage = new (pointer) SharedPacket::Storage(std::move(packet));
+    return SharedPacket(storage, &allocator);
+}
+
+} // namespace memory
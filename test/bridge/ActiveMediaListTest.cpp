@@ -665,6 +665,92 @@ TEST_F(ActiveMediaListTest, userMediaMapUpdatedWithDominantSpeaker)
     EXPECT_TRUE(endpointsContainsId(barbellJson, "audio", "4"));
 }
 
+TEST_F(ActiveMediaListTest, sharedUserMediaMapMatchesMapOfEndpointOutsideIt)
+{
+    for (size_t i = 1; i <= 4; ++i)
+    {
+        auto videoStream = addEngineVideoStream(i);
+        _activeMediaList->addVideoParticipant(i,
+            videoStream->simulcastStream,
+            videoStream->secondarySimulcastStream,
+            std::to_string(i).c_str());
+    }
+
+    bridge::UserMediaMap sharedMap;
+    EXPECT_TRUE(_activeMediaList->makeUserMediaMap(defaultLastN, sharedMap));
+    EXPECT_EQ(defaultLastN, sharedMap.count);
+
+    utils::StringBuilder<1024> sharedMessage;
+    bridge::ActiveMediaList::makeUserMediaMapMessage(sharedMap, sharedMessage);
+
+    EXPECT_TRUE(_activeMediaList->isInSharedMessageRange(defaultLastN, 1));
+    EXPECT_TRUE(_activeMediaList->isInSharedMessageRange(defaultLastN, 2));
+    EXPECT_FALSE(_activeMediaList->isInSharedMessageRange(defaultLastN, 3));
+    EXPECT_FALSE(_activeMediaList->isInSharedMessageRange(defaultLastN, 4));
+
+    for (size_t endpointIdHash = 3; endpointIdHash <= 4; ++endpointIdHash)
+    {
+        utils::StringBuilder<1024> message;
+        _activeMediaList->makeUserMediaMapMessage(defaultLastN, endpointIdHash, 0, _engineVideoStreams, message);
+        EXPECT_STREQ(message.get(), sharedMessage.get());
+    }
+
+    utils::StringBuilder<1024> lastNMessage;
+    utils::StringBuilder<1024> sharedLastNMessage;
+    _activeMediaList->makeLastNListMessage(defaultLastN, 4, 0, lastNMessage);
+    _activeMediaList->makeLastNListMessage(defaultLastN, 0, 0, sharedLastNMessage);
+    EXPECT_STREQ(lastNMessage.get(), sharedLastNMessage.get());
+}
+
+TEST_F(ActiveMediaListTest, userMediaMapDeltaListsChanges)
+{
+    for (size_t i = 1; i <= 4; ++i)
+    {
+        _activeMediaList->addAudioParticipant(i, std::to_string(i).c_str());
+        auto videoStream = addEngineVideoStream(i);
+        addEngineAudioStream(i);
+        _activeMediaList->addVideoParticipant(i,
+            videoStream->simulcastStream,
+            videoStream->secondarySimulcastStream,
+            std::to_string(i).c_str());
+    }
+
+    bridge::UserMediaMap previousMap;
+    _activeMediaList->makeUserMediaMap(defaultLastN, previousMap);
+
+    utils::StringBuilder<1024> noChangeMessage;
+    EXPECT_FALSE(bridge::ActiveMediaList::makeUserMediaMapDeltaMessage(previousMap, previousMap, noChangeMessage));
+
+    uint64_t timestamp = 0;
+    zeroLevels(1);
+    zeroLevels(2);
+    zeroLevels(3);
+    consumeLevels(timestamp);
+    switchDominantSpeaker(timestamp, 4);
+
+    bridge::UserMediaMap map;
+    _activeMediaList->makeUserMediaMap(defaultLastN, map);
+    EXPECT_NE(previousMap, map);
+
+    utils::StringBuilder<1024> deltaMessage;
+    EXPECT_TRUE(bridge::ActiveMediaList::makeUserMediaMapDeltaMessage(previousMap, map, deltaMessage));
+    printf("%s\n", deltaMessage.get());
+
+    const auto messageJson = nlohmann::json::parse(deltaMessage.build());
+    EXPECT_TRUE(endpointsContainsId(messageJson, "4"));
+    for (size_t i = 0; i < previousMap.count; ++i)
+    {
+        EXPECT_FALSE(endpointsContainsId(messageJson, previousMap.entries[i].endpointId.c_str()));
+    }
+
+    const auto& removed = messageJson["removed"];
+    EXPECT_EQ(previousMap.count + 1 - map.count, removed.size());
+    for (const auto& endpointId : removed)
+    {
+        EXPECT_FALSE(endpointsContainsId(messageJson, endpointId.get<std::string>().c_str()));
+    }
+}
+
 TEST_F(ActiveMediaListTest, mutedAreNotSwitchedIn)
 {
     const int memberCount = 9;
@@ -705,3 +791,44 @@ TEST_F(ActiveMediaListTest, mutedAreNotSwitchedIn)
 
     EXPECT_EQ(5, audioRewriteMap.size());
 }
+
+TEST_F(ActiveMediaListTest, loudestSpeakersAreRanked)
+{
+    const size_t numParticipants = 20;
+    for (size_t i = 1; i <= numParticipants; ++i)
+    {
+        _activeMediaList->addAudioParticipant(i, std::to_string(i).c_str());
+        for (const auto element : ActiveMediaListTestLevels::silence)
+        {
+            _activeMediaList->onNewAudioLevel(i, element, false);
+        }
+    }
+
+    bool dominantSpeakerChanged = false;
+    bool videoMapChanged = false;
+    _activeMediaList->process(1000 * utils::Time::ms, dominantSpeakerChanged, videoMapChanged, _audioMapChanged);
+    const auto revision = _activeMediaList->getRankedSpeakersRevision();
+
+    for (size_t i = 1; i <= numParticipants; ++i)
+    {
+        if (i == 12)
+        {
+            for (const auto element : ActiveMediaListTestLevels::longUtterance)
+            {
+                _activeMediaList->onNewAudioLevel(i, element, false);
+            }
+            continue;
+        }
+        for (const auto element : ActiveMediaListTestLevels::silence)
+        {
+            _activeMediaList->onNewAudioLevel(i, element, false);
+        }
+    }
+    _activeMediaList->process(1100 * utils::Time::ms, dominantSpeakerChanged, videoMapChanged, _audioMapChanged);
+
+    size_t rankedCount = 0;
+    const auto* rankedSpeakers = _activeMediaList->getRankedSpeakers(rankedCount);
+    EXPECT_NE(revision, _activeMediaList->getRankedSpeakersRevision());
+    EXPECT_EQ(bridge::ActiveMediaList::maxRankedSpeakers, rankedCount);
+    EXPECT_EQ(12, rankedSpeakers[0]);
+}
@@ -0,0 +1,92 @@
+#include "bridge/engine/EngineStats.h"
+#include "utils/Time.h"
+#include <gtest/gtest.h>
+
+using namespace bridge::EngineStats;
+
+TEST(EngineStatsTest, histogramBuckets)
+{
+    for (uint64_t value = 0; value < 2000000; value = value * 5 / 4 + 1)
+    {
+        const auto bucket = LatencyHistogram::bucketOf(value);
+        if (bucket < LatencyHistogram::bucketCount - 1)
+        {
+            EXPECT_LE(LatencyHistogram::bucketLowerBound(bucket), value);
+            EXPECT_GT(LatencyHistogram::bucketLowerBound(bucket + 1), value);
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketCount - 1, LatencyHistogram::bucketOf(uint64_t(1) << 40));
+}
+
+TEST(EngineStatsTest, histogramPercentiles)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(0, histogram.percentile(0.99));
+
+    for (int i = 0; i < 980; ++i)
+    {
+        histogram.add(100);
+    }
+    for (int i = 0; i < 20; ++i)
+    {
+        histogram.add(9000);
+    }
+
+    EXPECT_EQ(1000, histogram.count());
+    EXPECT_EQ(9000, histogram.maxUs);
+    const auto p50 = histogram.percentile(0.5);
+    EXPECT_GE(p50, 100);
+    EXPECT_LT(p50, 125);
+    EXPECT_EQ(9000, histogram.percentile(0.99));
+
+    LatencyHistogram other;
+    other.add(20000);
+    histogram += other;
+    EXPECT_EQ(1001, histogram.count());
+    EXPECT_EQ(20000, histogram.maxUs);
+}
+
+TEST(EngineStatsTest, tickProfile)
+{
+    TickProfile profile;
+    profile[TickPhase::MIXING].add(3000);
+    profile[TickPhase::RTCP].add(200);
+    profile.total.add(3300);
+    EXPECT_EQ(TickPhase::MIXING, profile.slowestPhase());
+    EXPECT_STREQ("mixing", toString(profile.slowestPhase()));
+
+    TickProfile sum;
+    sum += profile;
+    sum += profile;
+    EXPECT_EQ(2, sum[TickPhase::MIXING].count());
+    EXPECT_EQ(2, sum.total.count());
+}
+
+TEST(EngineStatsTest, cycleCounter)
+{
+    const auto start = utils::Time::getCycleCount();
+    const auto startTime = utils::Time::getRawAbsoluteTime();
+    utils::Time::rawNanoSleep(utils::Time::ms * 5);
+    const auto elapsed = utils::Time::cyclesToNs(utils::Time::getCycleCount() - start);
+    const auto expected = utils::Time::getRawAbsoluteTime() - startTime;
+    EXPECT_NEAR(static_cast<double>(expected), static_cast<double>(elapsed), expected * 0.2);
+}
+
+TEST(EngineStatsTest, engineAggregation)
+{
+    EngineStats busy;
+    busy.mixers = 3;
+    busy.load = 0.75;
+    busy.maxLoad = 0.75;
+    EngineStats idle;
+    idle.mixers = 1;
+    idle.load = 0.05;
+    idle.maxLoad = 0.05;
+
+    EngineStats sum = idle;
+    sum += busy;
+    EXPECT_EQ(2, sum.engines);
+    EXPECT_EQ(4, sum.mixers);
+    EXPECT_DOUBLE_EQ(0.8, sum.load);
+    EXPECT_DOUBLE_EQ(0.75, sum.maxLoad);
+}
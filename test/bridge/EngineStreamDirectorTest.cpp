@@ -1315,3 +1315,27 @@ TEST_F(EngineStreamDirectorTest, pinnedHighQualityStreamIsForwardedAfter5s)
     EXPECT_FALSE(_engineStreamDirector->shouldForwardSsrc(2, 3));
     EXPECT_TRUE(_engineStreamDirector->shouldForwardSsrc(2, 5));
 }
+
+TEST_F(EngineStreamDirectorTest, routingRevisionChangesWithForwardingDecisions)
+{
+    addActiveVideoSender(1, 1);
+    addActiveVideoSender(2, 7);
+
+    auto revision = _engineStreamDirector->getRoutingRevision();
+    EXPECT_FALSE(_engineStreamDirector->shouldForwardSsrc(2, 5));
+    _engineStreamDirector->pin(2, 1);
+    EXPECT_NE(revision, _engineStreamDirector->getRoutingRevision());
+    EXPECT_TRUE(_engineStreamDirector->shouldForwardSsrc(2, 5));
+
+    revision = _engineStreamDirector->getRoutingRevision();
+    _engineStreamDirector->pin(2, 1);
+    _engineStreamDirector->setUplinkEstimateKbps(2, 100000, 6 * utils::Time::sec);
+    EXPECT_EQ(revision, _engineStreamDirector->getRoutingRevision());
+
+    _engineStreamDirector->streamActiveStateChanged(1, 5, false);
+    EXPECT_NE(revision, _engineStreamDirector->getRoutingRevision());
+
+    revision = _engineStreamDirector->getRoutingRevision();
+    _engineStreamDirector->removeParticipant(1);
+    EXPECT_NE(revision, _engineStreamDirector->getRoutingRevision());
+}
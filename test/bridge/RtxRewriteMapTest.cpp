@@ -0,0 +1,138 @@
+#include "bridge/engine/RtxRewriteMap.h"
+#include "bridge/engine/VideoPacketStore.h"
+#include <atomic>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+TEST(RtxRewriteMapTest, findsInboundPacketAndOffsets)
+{
+    auto store = std::make_shared<bridge::VideoPacketStore>("RtxRewriteMapTest", 1);
+    bridge::RtxRewriteMap rewriteMap;
+    utils::Optional<uint8_t> absSendTimeExtId(3);
+
+    rewriteMap.add(0x1FFFF, 500, store, 1000, 5, 2, absSendTimeExtId);
+    rewriteMap.add(0x20000, 501, store, 1000, 5, 2, absSendTimeExtId);
+
+    uint32_t inboundSequenceNumber = 0;
+    const auto* source = rewriteMap.find(0xFFFF, inboundSequenceNumber);
+    ASSERT_NE(nullptr, source);
+    EXPECT_EQ(500, inboundSequenceNumber);
+    EXPECT_EQ(store.get(), source->store.get());
+    EXPECT_EQ(1000, source->timestampOffset);
+    EXPECT_EQ(5, source->picIdOffset);
+    EXPECT_EQ(2, source->tl0PicIdxOffset);
+    EXPECT_EQ(3, source->absSendTimeExtId.get());
+
+    EXPECT_EQ(source, rewriteMap.find(0, inboundSequenceNumber));
+    EXPECT_EQ(501, inboundSequenceNumber);
+    EXPECT_EQ(nullptr, rewriteMap.find(1, inboundSequenceNumber));
+}
+
+TEST(RtxRewriteMapTest, oldEntriesAreReplaced)
+{
+    auto store = std::make_shared<bridge::VideoPacketStore>("RtxRewriteMapTest", 1);
+    bridge::RtxRewriteMap rewriteMap;
+
+    rewriteMap.add(10, 10, store, 0, 0, 0, utils::Optional<uint8_t>());
+    rewriteMap.add(10 + bridge::RtxRewriteMap::maxPackets, 20, store, 0, 0, 0, utils::Optional<uint8_t>());
+
+    uint32_t inboundSequenceNumber = 0;
+    EXPECT_EQ(nullptr, rewriteMap.find(10, inboundSequenceNumber));
+    EXPECT_NE(nullptr, rewriteMap.find(10 + bridge::RtxRewriteMap::maxPackets, inboundSequenceNumber));
+    EXPECT_EQ(20, inboundSequenceNumber);
+}
+
+TEST(RtxRewriteMapTest, switchingSourcesExpiresOldest)
+{
+    std::shared_ptr<bridge::VideoPacketStore> stores[2] = {
+        std::make_shared<bridge::VideoPacketStore>("RtxRewriteMapTest", 1),
+        std::make_shared<bridge::VideoPacketStore>("RtxRewriteMapTest", 2)};
+    bridge::RtxRewriteMap rewriteMap;
+
+    // simulcast switch back and forth, with new offsets each time
+    for (uint32_t i = 0; i <= bridge::RtxRewriteMap::maxSources; ++i)
+    {
+        rewriteMap.add(i, 100 + i, stores[i % 2], i * 3000, i, i, utils::Optional<uint8_t>());
+    }
+
+    uint32_t inboundSequenceNumber = 0;
+    EXPECT_EQ(nullptr, rewriteMap.find(0, inboundSequenceNumber));
+    for (uint32_t i = 1; i <= bridge::RtxRewriteMap::maxSources; ++i)
+    {
+        const auto* source = rewriteMap.find(i, inboundSequenceNumber);
+        ASSERT_NE(nullptr, source);
+        EXPECT_EQ(100 + i, inboundSequenceNumber);
+        EXPECT_EQ(stores[i % 2], source->store);
+        EXPECT_EQ(static_cast<int32_t>(i * 3000), source->timestampOffset);
+    }
+}
+
+TEST(VideoPacketStoreTest, getReturnsStoredPacketUntilReplaced)
+{
+    bridge::VideoPacketStore store("VideoPacketStoreTest", 1);
+    memory::Packet packet;
+    std::memset(packet.get(), 0xAB, 300);
+    packet.setLength(300);
+    store.add(packet, 70000);
+
+    memory::Packet target;
+    EXPECT_FALSE(store.get(70001, target));
+    ASSERT_TRUE(store.get(70000, target));
+    EXPECT_EQ(300, target.getLength());
+    EXPECT_EQ(0, std::memcmp(packet.get(), target.get(), 300));
+
+    packet.setLength(10);
+    store.add(packet, 70000 + bridge::VideoPacketStore::maxPackets);
+    EXPECT_FALSE(store.get(70000, target));
+    ASSERT_TRUE(store.get(70000 + bridge::VideoPacketStore::maxPackets, target));
+    EXPECT_EQ(10, target.getLength());
+}
+
+// The sender keeps replacing slots while a receiver answers NACKs from the same slots. Every packet the receiver gets
+// must be complete and belong to the sequence number asked for.
+TEST(VideoPacketStoreTest, concurrentAddAndGet)
+{
+    bridge::VideoPacketStore store("VideoPacketStoreTest", 1);
+    const uint32_t packetCount = 200000;
+    auto packetLength = [](uint32_t sequenceNumber) { return 100 + (sequenceNumber * 7) % 1100; };
+
+    std::atomic_uint32_t lastAdded(0);
+    std::thread sender([&]() {
+        memory::Packet packet;
+        for (uint32_t sequenceNumber = 1; sequenceNumber <= packetCount; ++sequenceNumber)
+        {
+            std::memset(packet.get(), sequenceNumber & 0xFF, packetLength(sequenceNumber));
+            packet.setLength(packetLength(sequenceNumber));
+            store.add(packet, sequenceNumber);
+            lastAdded.store(sequenceNumber, std::memory_order_release);
+        }
+    });
+
+    uint32_t hitCount = 0;
+    uint32_t corruptCount = 0;
+    memory::Packet target;
+    for (uint32_t i = 0; lastAdded.load(std::memory_order_acquire) < packetCount; ++i)
+    {
+        const auto newest = lastAdded.load(std::memory_order_acquire);
+        // close to the writer to make it likely that the slot is replaced during the copy
+        const auto sequenceNumber = newest - std::min<uint32_t>(newest, i % bridge::VideoPacketStore::maxPackets);
+        if (sequenceNumber == 0 || !store.get(sequenceNumber, target))
+        {
+            continue;
+        }
+
+        ++hitCount;
+        bool intact = (target.getLength() == packetLength(sequenceNumber));
+        for (size_t j = 0; intact && j < target.getLength(); ++j)
+        {
+            intact = (target.get()[j] == (sequenceNumber & 0xFF));
+        }
+        corruptCount += intact ? 0 : 1;
+    }
+    sender.join();
+
+    EXPECT_GT(hitCount, 0u);
+    EXPECT_EQ(0u, corruptCount);
+}
@@ -1,18 +1,33 @@
 #include "bridge/engine/VideoNackReceiveJob.h"
-#include "bridge/engine/PacketCache.h"
+#include "bridge/engine/RtxRewriteMap.h"
 #include "bridge/engine/SsrcOutboundContext.h"
+#include "bridge/engine/VideoPacketStore.h"
+#include "bridge/engine/Vp8Rewriter.h"
+#include "codec/Vp8Header.h"
 #include "jobmanager/JobManager.h"
 #include "memory/PacketPoolAllocator.h"
 #include "test/bridge/DummyRtcTransport.h"
 #include <gtest/gtest.h>
 #include <memory>
 #include <thread>
+#include <vector>
 
 namespace
 {
 
 static const uint32_t mediaSsrc = 12345;
 static const uint32_t rtxSsrc = 54321;
+static const uint32_t inboundSsrc = 1000;
+
+class SendRecordingTransport : public DummyRtcTransport
+{
+public:
+    explicit SendRecordingTransport(jobmanager::JobQueue& jobQueue) : DummyRtcTransport(jobQueue) {}
+
+    void protectAndSend(memory::UniquePacket packet) override { sentPackets.push_back(std::move(packet)); }
+
+    std::vector<memory::UniquePacket> sentPackets;
+};
 
 } // namespace
 
@@ -23,7 +38,7 @@ class VideoNackReceiveJobTest : public ::testing::Test
         _timers = std::make_unique<jobmanager::TimerQueue>(4096 * 8);
         _jobManager = std::make_unique<jobmanager::JobManager>(*_timers);
         _jobQueue = std::make_unique<jobmanager::JobQueue>(*_jobManager);
-        _transport = std::make_unique<DummyRtcTransport>(*_jobQueue);
+        _transport = std::make_unique<SendRecordingTransport>(*_jobQueue);
 
         _allocator = std::make_unique<memory::PacketPoolAllocator>(16, "VideoNackReceiveJobTest");
         _mainOutboundContext = std::make_unique<bridge::SsrcOutboundContext>(mediaSsrc,
@@ -34,12 +49,13 @@ class VideoNackReceiveJobTest : public ::testing::Test
             *_allocator,
             bridge::RtpMap(bridge::RtpMap::Format::VP8RTX));
 
-        _packetCache = std::make_unique<bridge::PacketCache>("VideoNackReceiveJobTest", mediaSsrc);
-        _mainOutboundContext->packetCache.set(_packetCache.get());
+        _packetStore = std::make_shared<bridge::VideoPacketStore>("VideoNackReceiveJobTest", inboundSsrc);
+        _mainOutboundContext->rtxRewriteMap = std::make_unique<bridge::RtxRewriteMap>();
     }
 
     void TearDown() override
     {
+        _transport->sentPackets.clear();
         _mainOutboundContext.reset();
         _rtxOutboundContext.reset();
 
@@ -55,12 +71,48 @@ protected:
     std::unique_ptr<jobmanager::TimerQueue> _timers;
     std::unique_ptr<jobmanager::JobManager> _jobManager;
     std::unique_ptr<jobmanager::JobQueue> _jobQueue;
-    std::unique_ptr<DummyRtcTransport> _transport;
+    std::unique_ptr<SendRecordingTransport> _transport;
 
     std::unique_ptr<memory::PacketPoolAllocator> _allocator;
     std::unique_ptr<bridge::SsrcOutboundContext> _mainOutboundContext;
     std::unique_ptr<bridge::SsrcOutboundContext> _rtxOutboundContext;
-    std::unique_ptr<bridge::PacketCache> _packetCache;
+    std::shared_ptr<bridge::VideoPacketStore> _packetStore;
+
+    // stores an inbound packet and forwards it like VideoForwarderRewriteAndSendJob does, returns the rewritten packet
+    memory::UniquePacket forward(const uint32_t extendedSequenceNumber, const uint32_t timestamp, const uint16_t picId)
+    {
+        auto packet = memory::makeUniquePacket(*_allocator);
+        auto rtpHeader = rtp::RtpHeader::create(*packet);
+        rtpHeader->ssrc = inboundSsrc;
+        rtpHeader->sequenceNumber = extendedSequenceNumber & 0xFFFFu;
+        rtpHeader->timestamp = timestamp;
+        auto payload = rtpHeader->getPayload();
+        std::memset(payload, 0, 100);
+        codec::Vp8Header::setPicId(payload, picId);
+        codec::Vp8Header::setTl0PicIdx(payload, 7);
+        for (size_t i = 10; i < 100; ++i)
+        {
+            payload[i] = static_cast<uint8_t>(i + extendedSequenceNumber);
+        }
+        packet->setLength(rtpHeader->headerLength() + 100);
+        _packetStore->add(*packet, extendedSequenceNumber);
+
+        uint32_t outboundSequenceNumber = 0;
+        bridge::Vp8Rewriter::rewrite(*_mainOutboundContext,
+            *packet,
+            extendedSequenceNumber,
+            "",
+            outboundSequenceNumber);
+        const auto& offset = _mainOutboundContext->rewrite.offset;
+        _mainOutboundContext->rtxRewriteMap->add(outboundSequenceNumber,
+            extendedSequenceNumber,
+            _packetStore,
+            offset.timestamp,
+            offset.picId,
+            offset.tl0PicIdx,
+            utils::Optional<uint8_t>());
+        return packet;
+    }
 };
 
 TEST_F(VideoNackReceiveJobTest, nacksNotAlreadyRespondedToAreHandled)
@@ -158,3 +210,52 @@ TEST_F(VideoNackReceiveJobTest, nacksAlreadyRespondedToOutsideRttAreHandled)
 
     EXPECT_EQ(timestamp, _rtxOutboundContext->lastRespondedNackTimestamp);
 }
+
+TEST_F(VideoNackReceiveJobTest, retransmitsRewrittenPacketFromSenderStore)
+{
+    const uint64_t rtt = 100 * utils::Time::ms;
+    forward(100, 9000, 20);
+    auto forwarded = forward(101, 9000, 20);
+    forward(102, 12000, 21);
+
+    const auto* forwardedHeader = rtp::RtpHeader::fromPacket(*forwarded);
+    bridge::VideoNackReceiveJob(*_rtxOutboundContext,
+        *_transport,
+        *_mainOutboundContext,
+        forwardedHeader->sequenceNumber.get(),
+        0,
+        1000,
+        rtt)
+        .run();
+
+    ASSERT_EQ(1, _transport->sentPackets.size());
+    auto& rtxPacket = *_transport->sentPackets[0];
+    const auto* rtxHeader = rtp::RtpHeader::fromPacket(rtxPacket);
+    EXPECT_EQ(rtxSsrc, rtxHeader->ssrc.get());
+    EXPECT_EQ(forwardedHeader->timestamp.get(), rtxHeader->timestamp.get());
+    ASSERT_EQ(forwarded->getLength() + sizeof(uint16_t), rtxPacket.getLength());
+
+    const auto* rtxPayload = rtxHeader->getPayload();
+    EXPECT_EQ(forwardedHeader->sequenceNumber.get(), (rtxPayload[0] << 8) | rtxPayload[1]);
+    EXPECT_EQ(0,
+        std::memcmp(forwardedHeader->getPayload(),
+            rtxPayload + sizeof(uint16_t),
+            forwarded->getLength() - forwardedHeader->headerLength()));
+}
+
+TEST_F(VideoNackReceiveJobTest, packetsReplacedInStoreAreNotRetransmitted)
+{
+    const uint64_t rtt = 100 * utils::Time::ms;
+    auto forwarded = forward(100, 9000, 20);
+    const auto sequenceNumber = rtp::RtpHeader::fromPacket(*forwarded)->sequenceNumber.get();
+
+    // the sender's store wraps, while the receiver did not get the newer packet
+    auto otherPacket = memory::makeUniquePacket(*_allocator);
+    rtp::RtpHeader::create(*otherPacket);
+    otherPacket->setLength(100);
+    _packetStore->add(*otherPacket, 100 + bridge::VideoPacketStore::maxPackets);
+
+    bridge::VideoNackReceiveJob(*_rtxOutboundContext, *_transport, *_mainOutboundContext, sequenceNumber, 0, 1000, rtt)
+        .run();
+    EXPECT_TRUE(_transport->sentPackets.empty());
+}
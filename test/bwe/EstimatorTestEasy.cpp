@@ -260,3 +260,38 @@ TEST(BweTest, networkPause)
         count++;
     }
 }
+
+TEST(BweTest, packetGroupsFollowPerPacketEstimate)
+{
+    bwe::Config config;
+    bwe::Config groupConfig;
+    groupConfig.packetGroupMs = 5;
+    bwe::BandwidthEstimator estimator(config);
+    bwe::BandwidthEstimator groupEstimator(groupConfig);
+    memory::PacketPoolAllocator allocator(1024, "test");
+
+    auto* link = new fakenet::NetworkLink("EstimatorTestEasyLink", 3800, 256 * 1024, 1500);
+    auto* groupLink = new fakenet::NetworkLink("EstimatorTestEasyLink", 3800, 256 * 1024, 1500);
+    auto* video = new fakenet::FakeVideoSource(allocator, 150, 1);
+    auto* groupVideo = new fakenet::FakeVideoSource(allocator, 150, 1);
+
+    fakenet::Call call(allocator, estimator, link, true, 60 * utils::Time::sec);
+    fakenet::Call groupCall(allocator, groupEstimator, groupLink, true, 60 * utils::Time::sec);
+    call.addSource(video);
+    groupCall.addSource(groupVideo);
+    for (int count = 0; call.run(utils::Time::sec) && groupCall.run(utils::Time::sec); ++count)
+    {
+        logger::debug("%ds: estimate %.0f, grouped %.0f",
+            "",
+            count + 1,
+            call.getEstimate(),
+            groupCall.getEstimate());
+        video->setBandwidth(std::min(4000.0, 0.9 * call.getEstimate()));
+        groupVideo->setBandwidth(std::min(4000.0, 0.9 * groupCall.getEstimate()));
+        if (count > 15)
+        {
+            EXPECT_NEAR(groupCall.getEstimate(), call.getEstimate(), call.getEstimate() * 0.15);
+            EXPECT_LT(groupCall.getEstimate(), 4200.0);
+        }
+    }
+}
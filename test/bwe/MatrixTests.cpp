@@ -27,6 +27,29 @@ TEST(MatrixTest, mul)
     EXPECT_EQ(mk(0, 0), sqrt(m4(0, 0)));
 }
 
+TEST(MatrixTest, elementWise)
+{
+    double y[3][3] = {{1.0, 2.0, 3.0}, {2.0, 3.0, 4.0}, {1.0, 3.5, 0.4}};
+    Matrix<double, 3, 3> m(y);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(m.data()) % 16);
+
+    auto sum = m + m * 2.0;
+    auto difference = sum - m;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            EXPECT_DOUBLE_EQ(sum(i, j), 3.0 * y[i][j]);
+            EXPECT_DOUBLE_EQ(difference(i, j), 2.0 * y[i][j]);
+        }
+    }
+
+    difference -= m;
+    difference *= 0.5;
+    EXPECT_DOUBLE_EQ(difference(2, 1), 1.75);
+    EXPECT_TRUE(isValid(difference));
+}
+
 TEST(MatrixTest, cholesky)
 {
     math::Matrix<double, 3> v({5.6, -156000.0, 19.9});
@@ -1,10 +1,8 @@
+#include "codec/AudioLevel.h"
 #include <cmath>
 #include <gtest/gtest.h>
-
-namespace codec
-{
-int computeAudioLevel(const int16_t* payload, int samples);
-}
+#include <random>
+#include <vector>
 
 TEST(AudioProcess, audiolevel)
 {
@@ -22,4 +20,72 @@ TEST(AudioProcess, audiolevel)
     auto dB = codec::computeAudioLevel(data, samples);
     double dBrms = 20 * std::log10(amplitude / (double(0x8000) * std::sqrt(2)));
     EXPECT_EQ(static_cast<int>(dBrms), -dB);
-}
\ No newline at end of file
+}
+TEST(AudioProcess, sampleEnergy)
+{
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<int32_t> distribution(-32768, 32767);
+    for (int count : {0, 1, 7, 8, 15, 16, 17, 959, 960, 1920})
+    {
+        std::vector<int16_t> data(count);
+        for (auto& sample : data)
+        {
+            sample = distribution(generator);
+        }
+        if (count > 2)
+        {
+            data[0] = -32768;
+            data[1] = -32768;
+        }
+
+        double expected = 0;
+        for (auto sample : data)
+        {
+            expected += double(sample) * double(sample);
+        }
+        EXPECT_EQ(static_cast<uint64_t>(expected), codec::computeSampleEnergy(data.data(), count));
+    }
+}
+
+TEST(AudioProcess, voiceActivity)
+{
+    const double PI = 3.14159;
+    const int samples = 960 * 2;
+    std::mt19937 generator(5);
+    std::normal_distribution<double> noise(0, 100);
+    codec::VoiceActivityDetector vad;
+
+    auto makeFrame = [&](double amplitude) {
+        std::vector<int16_t> frame(samples);
+        for (int i = 0; i < samples; ++i)
+        {
+            frame[i] = static_cast<int16_t>(noise(generator) + sin(2 * PI * i * 300 / 48000.0) * amplitude);
+        }
+        return frame;
+    };
+
+    // steady background noise is not voice
+    for (int i = 0; i < 200; ++i)
+    {
+        auto frame = makeFrame(0);
+        vad.onFrame(frame.data(), samples);
+    }
+    EXPECT_FALSE(vad.isVoiceActive());
+    auto frame = makeFrame(0);
+    EXPECT_EQ(127, vad.onFrame(frame.data(), samples));
+
+    frame = makeFrame(8000);
+    const auto level = vad.onFrame(frame.data(), samples);
+    EXPECT_TRUE(vad.isVoiceActive());
+    EXPECT_EQ(codec::computeAudioLevel(frame.data(), samples), level);
+
+    // hangover keeps short pauses as voice
+    frame = makeFrame(0);
+    EXPECT_LT(vad.onFrame(frame.data(), samples), 127);
+    for (int i = 0; i < 50; ++i)
+    {
+        frame = makeFrame(0);
+        vad.onFrame(frame.data(), samples);
+    }
+    EXPECT_FALSE(vad.isVoiceActive());
+}
@@ -347,3 +347,105 @@ TEST(Mpmc, uniqueptr)
     EXPECT_EQ(counter, 0);
     delete queue;
 }
+
+TEST(Mpmc, batchPop)
+{
+    const uint32_t SIZE = 64;
+    auto queue = std::make_unique<MpmcQueue<Simple>>(SIZE);
+    Simple items[16];
+    EXPECT_EQ(0, queue->pop(items, 16));
+
+    int expectedSeqNo = 0;
+    int seqNo = 0;
+    for (int round = 0; round < 20; ++round)
+    {
+        // pushes 37 per round to make batches wrap around the end of the queue
+        for (int i = 0; i < 37; ++i)
+        {
+            EXPECT_TRUE(queue->push(Simple(1, seqNo++)));
+        }
+
+        size_t popped = 0;
+        for (size_t count = queue->pop(items, 16); count > 0; count = queue->pop(items, 16))
+        {
+            EXPECT_LE(count, 16);
+            for (size_t i = 0; i < count; ++i)
+            {
+                EXPECT_EQ(expectedSeqNo++, items[i].seqNo);
+            }
+            popped += count;
+        }
+        EXPECT_EQ(37, popped);
+        EXPECT_TRUE(queue->empty());
+    }
+}
+
+TEST(Mpmc, batchPopConcurrent)
+{
+    const int producerCount = 4;
+    const int itemsPerProducer = 100000;
+    auto queue = std::make_unique<MpmcQueue<Simple>>(1024);
+    std::atomic_int received[producerCount];
+    for (auto& count : received)
+    {
+        count = 0;
+    }
+
+    std::atomic_bool running(true);
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 2; ++c)
+    {
+        consumers.emplace_back([&]() {
+            Simple items[32];
+            for (;;)
+            {
+                const auto count = queue->pop(items, 32);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    ++received[items[i].ssrc];
+                }
+                if (count == 0)
+                {
+                    if (!running && queue->empty())
+                    {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; ++p)
+    {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < itemsPerProducer;)
+            {
+                if (queue->push(Simple(p, i)))
+                {
+                    ++i;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    running = false;
+    for (auto& consumer : consumers)
+    {
+        consumer.join();
+    }
+
+    for (auto& count : received)
+    {
+        EXPECT_EQ(itemsPerProducer, count.load());
+    }
+}
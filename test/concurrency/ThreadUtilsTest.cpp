@@ -0,0 +1,58 @@
+#include "concurrency/ThreadUtils.h"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(ThreadUtilsTest, parseCpuList)
+{
+    std::vector<uint32_t> cpus;
+    EXPECT_TRUE(concurrency::parseCpuList("", cpus));
+    EXPECT_TRUE(cpus.empty());
+
+    EXPECT_TRUE(concurrency::parseCpuList("0-3,8,10-11", cpus));
+    EXPECT_EQ(std::vector<uint32_t>({0, 1, 2, 3, 8, 10, 11}), cpus);
+
+    EXPECT_TRUE(concurrency::parseCpuList("5", cpus));
+    EXPECT_EQ(std::vector<uint32_t>({5}), cpus);
+
+    EXPECT_FALSE(concurrency::parseCpuList("3-1", cpus));
+    EXPECT_FALSE(concurrency::parseCpuList("1,,2", cpus));
+    EXPECT_FALSE(concurrency::parseCpuList("1;2", cpus));
+    EXPECT_FALSE(concurrency::parseCpuList("a", cpus));
+}
+
+#ifndef __APPLE__
+TEST(ThreadUtilsTest, pinThread)
+{
+    // the test may itself be restricted to some cpus
+    cpu_set_t allowedSet;
+    CPU_ZERO(&allowedSet);
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(allowedSet), &allowedSet));
+    uint32_t cpu = 0;
+    while (cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &allowedSet))
+    {
+        ++cpu;
+    }
+    ASSERT_LT(cpu, static_cast<uint32_t>(CPU_SETSIZE));
+
+    std::atomic_bool running(true);
+    std::thread thread([&running]() {
+        while (running)
+        {
+            std::this_thread::yield();
+        }
+    });
+
+    EXPECT_TRUE(concurrency::setCpuAffinity(thread, {cpu}));
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    EXPECT_EQ(0, pthread_getaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet));
+    EXPECT_EQ(1, CPU_COUNT(&cpuSet));
+    EXPECT_TRUE(CPU_ISSET(cpu, &cpuSet));
+
+    running = false;
+    thread.join();
+}
+#endif
@@ -28,12 +28,15 @@
 #include "transport/TransportFactory.h"
 #include "transport/dtls/SrtpClientFactory.h"
 #include "transport/dtls/SslDtls.h"
+#include "utils/Format.h"
 #include "utils/IdGenerator.h"
 #include "utils/StringBuilder.h"
+#include <algorithm>
 #include <chrono>
 #include <complex>
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <unordered_set>
 
 #define USE_FAKENETWORK 1
@@ -317,3 +320,268 @@ TEST_F(RealTimeTest, localVideoMeeting)
 
     group.awaitPendingJobs(utils::Time::sec * 4);
 }
+
+// Allocates endpoints in several conferences at once, while stats are polled, like the burst of joins at the top of
+// the hour. Several endpoints of each conference are allocated in parallel, so requests contend on the conference
+// lock and on the per endpoint locks. Requests for different conferences and different endpoints should not queue up
+// behind each other. The endpoints are then expired in parallel, and finally the conferences time out and are removed
+// while requests for them are still in flight.
+TEST_F(RealTimeTest, concurrentEndpointAllocation)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    // no media is received, so every conference times out this long after it was created
+    const uint64_t inactivityTimeoutMs = 20000;
+    _bridgeConfig.readFromString(R"({
+        "ip":"127.0.0.1",
+        "ice.preferredIp":"127.0.0.1",
+        "ice.publicIpv4":"127.0.0.1",
+        "mixerInactivityTimeoutMs": )" +
+        std::to_string(inactivityTimeoutMs) + R"(,
+        "log.level": "INFO"
+        })");
+
+    initRealBridge(_bridgeConfig);
+
+    const std::string baseUrl = "http://127.0.0.1:8080";
+    const size_t conferenceCount = 8;
+    const size_t endpointsPerConference = 16;
+    const size_t threadsPerConference = 4;
+
+    std::vector<std::string> conferenceIds;
+    for (size_t conferenceIndex = 0; conferenceIndex < conferenceCount; ++conferenceIndex)
+    {
+        Conference conf(nullptr);
+        conf.create(baseUrl);
+        ASSERT_TRUE(conf.isSuccess());
+        conferenceIds.push_back(conf.getId());
+    }
+
+    std::atomic_bool running(true);
+    std::thread statsPoller([&running, &baseUrl]() {
+        while (running)
+        {
+            nlohmann::json responseBody;
+            awaitResponse<HttpGetRequest>(nullptr, baseUrl + "/stats", 1500 * utils::Time::ms, responseBody);
+            utils::Time::nanoSleep(100 * utils::Time::ms);
+        }
+    });
+
+    const nlohmann::json allocateBody = {{"action", "allocate"},
+        {"bundle-transport", {{"ice-controlling", true}, {"ice", true}, {"dtls", true}, {"rtcp-mux", true}}},
+        {"audio", {{"relay-type", "ssrc-rewrite"}}},
+        {"video", {{"relay-type", "ssrc-rewrite"}}},
+        {"data", nlohmann::json::object()}};
+
+    auto endpointUrl = [&](size_t conferenceIndex, const std::string& id) {
+        return baseUrl + "/conferences/" + conferenceIds[conferenceIndex] + "/" + id;
+    };
+    auto endpointId = [](size_t conferenceIndex, size_t endpointIndex) {
+        return utils::format("endpoint-%zu-%zu", conferenceIndex, endpointIndex);
+    };
+    auto getEndpointCount = [&](size_t conferenceIndex) {
+        nlohmann::json responseBody;
+        if (!awaitResponse<HttpGetRequest>(nullptr,
+                baseUrl + "/conferences/" + conferenceIds[conferenceIndex],
+                3 * utils::Time::sec,
+                responseBody))
+        {
+            return size_t(-1);
+        }
+        return responseBody.size();
+    };
+    // runs work(conferenceIndex, threadIndex) on threadsPerConference threads for every conference at once
+    auto runRequestThreads = [&](auto work) {
+        std::vector<std::thread> threads;
+        for (size_t conferenceIndex = 0; conferenceIndex < conferenceCount; ++conferenceIndex)
+        {
+            for (size_t threadIndex = 0; threadIndex < threadsPerConference; ++threadIndex)
+            {
+                threads.emplace_back([&work, conferenceIndex, threadIndex]() { work(conferenceIndex, threadIndex); });
+            }
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    };
+
+    std::vector<std::vector<uint64_t>> allocationTimes(conferenceCount * threadsPerConference);
+    std::atomic_uint32_t failedRequests(0);
+    runRequestThreads([&](size_t conferenceIndex, size_t threadIndex) {
+        for (size_t i = threadIndex; i < endpointsPerConference; i += threadsPerConference)
+        {
+            nlohmann::json responseBody;
+            const auto start = utils::Time::getAbsoluteTime();
+            if (!awaitResponse<HttpPostRequest>(nullptr,
+                    endpointUrl(conferenceIndex, endpointId(conferenceIndex, i)),
+                    allocateBody.dump(),
+                    9 * utils::Time::sec,
+                    responseBody))
+            {
+                ++failedRequests;
+            }
+            allocationTimes[conferenceIndex * threadsPerConference + threadIndex].push_back(
+                utils::Time::getAbsoluteTime() - start);
+        }
+    });
+
+    EXPECT_EQ(0u, failedRequests.load());
+    for (size_t conferenceIndex = 0; conferenceIndex < conferenceCount; ++conferenceIndex)
+    {
+        EXPECT_EQ(endpointsPerConference, getEndpointCount(conferenceIndex));
+    }
+
+    std::vector<uint64_t> times;
+    for (const auto& threadTimes : allocationTimes)
+    {
+        times.insert(times.end(), threadTimes.begin(), threadTimes.end());
+    }
+    std::sort(times.begin(), times.end());
+    logger::info("%zu endpoint allocations in %zu conferences, p50 %" PRIu64 "ms, p99 %" PRIu64 "ms, max %" PRIu64
+                 "ms",
+        "RealTimeTest",
+        times.size(),
+        conferenceCount,
+        times[times.size() / 2] / utils::Time::ms,
+        times[std::min(times.size() - 1, times.size() * 99 / 100)] / utils::Time::ms,
+        times.back() / utils::Time::ms);
+
+    runRequestThreads([&](size_t conferenceIndex, size_t threadIndex) {
+        for (size_t i = threadIndex; i < endpointsPerConference; i += threadsPerConference)
+        {
+            nlohmann::json responseBody;
+            if (!awaitResponse<HttpDeleteRequest>(nullptr,
+                    endpointUrl(conferenceIndex, endpointId(conferenceIndex, i)),
+                    9 * utils::Time::sec,
+                    responseBody))
+            {
+                ++failedRequests;
+            }
+        }
+    });
+
+    EXPECT_EQ(0u, failedRequests.load());
+    for (size_t conferenceIndex = 0; conferenceIndex < conferenceCount; ++conferenceIndex)
+    {
+        EXPECT_EQ(0u, getEndpointCount(conferenceIndex));
+    }
+
+    // Allocate and expire until the conference is gone. Every request must be answered, either served or with
+    // not found once the conference has been removed.
+    std::atomic_uint32_t unexpectedResponses(0);
+    runRequestThreads([&](size_t conferenceIndex, size_t threadIndex) {
+        const auto url =
+            endpointUrl(conferenceIndex, endpointId(conferenceIndex, endpointsPerConference + threadIndex));
+        const auto deadline = (inactivityTimeoutMs + 10000) * utils::Time::ms;
+        const auto start = utils::Time::getAbsoluteTime();
+        while (utils::Time::diffLT(start, utils::Time::getAbsoluteTime(), deadline))
+        {
+            HttpPostRequest allocateRequest(url.c_str(), allocateBody.dump().c_str());
+            allocateRequest.awaitResponse(9 * utils::Time::sec);
+            if (!allocateRequest.isSuccess())
+            {
+                if (allocateRequest.getCode() != static_cast<int>(httpd::StatusCode::NOT_FOUND))
+                {
+                    ++unexpectedResponses;
+                }
+                break;
+            }
+
+            HttpDeleteRequest expireRequest(url.c_str());
+            expireRequest.awaitResponse(9 * utils::Time::sec);
+            if (!expireRequest.isSuccess() &&
+                expireRequest.getCode() != static_cast<int>(httpd::StatusCode::NOT_FOUND))
+            {
+                ++unexpectedResponses;
+            }
+            utils::Time::nanoSleep(10 * utils::Time::ms);
+        }
+    });
+
+    running = false;
+    statsPoller.join();
+
+    EXPECT_EQ(0u, unexpectedResponses.load());
+
+    // removed mixers leave the list once the engine has let go of them
+    bool conferencesRemoved = false;
+    for (int i = 0; i < 50 && !conferencesRemoved; ++i)
+    {
+        nlohmann::json remainingConferences;
+        ASSERT_TRUE(awaitResponse<HttpGetRequest>(nullptr,
+            baseUrl + "/conferences",
+            3 * utils::Time::sec,
+            remainingConferences));
+        conferencesRemoved = std::none_of(conferenceIds.begin(),
+            conferenceIds.end(),
+            [&remainingConferences](const std::string& conferenceId) {
+                return std::find(remainingConferences.begin(), remainingConferences.end(), conferenceId) !=
+                    remainingConferences.end();
+            });
+        if (!conferencesRemoved)
+        {
+            utils::Time::nanoSleep(100 * utils::Time::ms);
+        }
+    }
+    EXPECT_TRUE(conferencesRemoved);
+}
+
+// Idle conferences cost next to nothing, so the measured engine loads are mostly noise. Placement must still spread
+// the conferences evenly over the engine threads rather than pile them onto the engine that happened to measure
+// the lowest load.
+TEST_F(RealTimeTest, conferencesSpreadOverEngines)
+{
+    _bridgeConfig.readFromString(R"({
+        "ip":"127.0.0.1",
+        "ice.preferredIp":"127.0.0.1",
+        "ice.publicIpv4":"127.0.0.1",
+        "numEngineThreads": 4,
+        "log.level": "INFO"
+        })");
+
+    initRealBridge(_bridgeConfig);
+
+    const std::string baseUrl = "http://127.0.0.1:8080";
+    const size_t engineCount = 4;
+    const size_t conferenceCount = 12;
+
+    for (size_t i = 0; i < conferenceCount; ++i)
+    {
+        Conference conf(nullptr);
+        conf.create(baseUrl);
+        ASSERT_TRUE(conf.isSuccess());
+        if (i == conferenceCount / 2)
+        {
+            // let the engines publish load samples with mixers on them
+            utils::Time::nanoSleep(1500 * utils::Time::ms);
+        }
+    }
+
+    nlohmann::json stats;
+    size_t sampledConferences = 0;
+    for (int attempt = 0; attempt < 40 && sampledConferences != conferenceCount; ++attempt)
+    {
+        utils::Time::nanoSleep(100 * utils::Time::ms);
+        if (!awaitResponse<HttpGetRequest>(nullptr, baseUrl + "/stats", 1500 * utils::Time::ms, stats))
+        {
+            continue;
+        }
+
+        sampledConferences = 0;
+        for (const auto& engineShard : stats["engine_shards"])
+        {
+            sampledConferences += engineShard["mixers"].get<size_t>();
+        }
+    }
+
+    ASSERT_EQ(conferenceCount, sampledConferences);
+    ASSERT_EQ(engineCount, stats["engine_shards"].size());
+    EXPECT_EQ(engineCount, stats["engine_threads"].get<size_t>());
+    for (const auto& engineShard : stats["engine_shards"])
+    {
+        EXPECT_EQ(conferenceCount / engineCount, engineShard["mixers"].get<size_t>());
+        EXPECT_LE(engineShard["load"].get<double>(), stats["engine_load_max"].get<double>());
+    }
+}
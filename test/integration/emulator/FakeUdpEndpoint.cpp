@@ -24,31 +24,54 @@ private:
     transport::Endpoint::IEvents* _listener;
 };
 
-class UnRegisterNotifyListenerJob : public jobmanager::Job
+class RegisterListenerJob : public jobmanager::Job
 {
 public:
-    UnRegisterNotifyListenerJob(FakeUdpEndpoint& endpoint, transport::Endpoint::IEvents& listener)
+    RegisterListenerJob(FakeUdpEndpoint& endpoint,
+        const transport::SocketAddress& remotePort,
+        transport::Endpoint::IEvents* listener)
         : _endpoint(endpoint),
+          _remotePort(remotePort),
           _listener(listener)
     {
     }
 
-    void run() override { _listener.onUnregistered(_endpoint); }
+    void run() override { _endpoint.internalRegisterListener(_remotePort, _listener); }
+
+private:
+    FakeUdpEndpoint& _endpoint;
+    transport::SocketAddress _remotePort;
+    transport::Endpoint::IEvents* _listener;
+};
+
+class UnregisterBarrierJob : public jobmanager::Job
+{
+public:
+    UnregisterBarrierJob(FakeUdpEndpoint& endpoint, transport::Endpoint::IEvents& listener, size_t queueIndex)
+        : _endpoint(endpoint),
+          _listener(listener),
+          _queueIndex(queueIndex)
+    {
+    }
+
+    void run() override { _endpoint.internalUnregisterBarrier(_listener, _queueIndex); }
 
 private:
     FakeUdpEndpoint& _endpoint;
     transport::Endpoint::IEvents& _listener;
+    size_t _queueIndex;
 };
 
 class ReceiveJob : public jobmanager::Job
 {
 public:
-    ReceiveJob(FakeUdpEndpoint& endpoint) : _endpoint(endpoint) {}
+    ReceiveJob(FakeUdpEndpoint& endpoint, size_t queueIndex) : _endpoint(endpoint), _queueIndex(queueIndex) {}
 
-    void run() override { _endpoint.internalReceive(); }
+    void run() override { _endpoint.internalReceive(_queueIndex); }
 
 private:
     FakeUdpEndpoint& _endpoint;
+    size_t _queueIndex;
 };
 
 template <typename KeyType>
@@ -82,18 +105,20 @@ FakeUdpEndpoint::FakeUdpEndpoint(jobmanager::JobManager& jobManager,
       _iceListeners(maxSessionCount * 2),
       _dtlsListeners(maxSessionCount * 16),
       _iceResponseListeners(maxSessionCount * 64),
-      _receiveJobs(jobManager, 16),
+      _receiveJobs(jobManager, isShared ? 256 : 16),
       _sendJobs(jobManager, 16),
       _allocator(allocator),
       _networkLinkAllocator(8092, "networkLink"),
       _sendQueue(maxSessionCount * 256),
-      _receiveQueue(maxSessionCount * 256),
       _defaultListener(nullptr),
       _network(network),
-      _networkLink(std::make_shared<fakenet::NetworkLink>(_name.c_str(), 1500000, 1950 * 1024, 3000))
+      _networkLink(std::make_shared<fakenet::NetworkLink>(_name.c_str(), 1500000, 1950 * 1024, 3000)),
+      _jobManager(jobManager),
+      _receiveQueueSize(maxSessionCount * 256),
+      _unregisteringListeners(maxSessionCount * 2)
 {
     openPort(_localPort.getPort());
-    _pendingRead.clear();
+    _receiveQueues.push_back(std::make_unique<ReceiveQueue>(_jobManager, _receiveQueueSize));
     _networkLink->setStaticDelay(0);
 }
 
@@ -189,8 +214,29 @@ void FakeUdpEndpoint::registerListener(const std::string& stunUserName, IEvents*
     listener->onRegistered(*this);
 }
 
+// Packets are dispatched on the receive queues, so the registration is posted to _receiveJobs where listeners are
+// also unregistered.
 void FakeUdpEndpoint::registerListener(const transport::SocketAddress& srcAddress, IEvents* listener)
 {
+    auto dtlsIt = _dtlsListeners.find(srcAddress);
+    if (dtlsIt != _dtlsListeners.end() && dtlsIt->second == listener)
+    {
+        return;
+    }
+
+    if (!_receiveJobs.addJob<RegisterListenerJob>(*this, srcAddress, listener))
+    {
+        logger::warn("failed to post register job", _name.c_str());
+    }
+}
+
+void FakeUdpEndpoint::internalRegisterListener(const transport::SocketAddress& srcAddress, IEvents* listener)
+{
+    if (_unregisteringListeners.contains(listener))
+    {
+        return; // posted by a receive queue before the listener was removed
+    }
+
     auto dtlsIt = _dtlsListeners.find(srcAddress);
     if (dtlsIt != _dtlsListeners.end())
     {
@@ -202,7 +248,7 @@ void FakeUdpEndpoint::registerListener(const transport::SocketAddress& srcAddres
 
         if (dtlsIt->second)
         {
-            _receiveJobs.addJob<UnRegisterNotifyListenerJob>(*this, *dtlsIt->second);
+            notifyUnregistered(*dtlsIt->second);
         }
         dtlsIt->second = listener;
         listener->onRegistered(*this);
@@ -243,7 +289,10 @@ void FakeUdpEndpoint::stop(IStopEvents* listener)
         _state = STOPPING;
 
         _sendQueue.clear();
-        _receiveQueue.clear();
+        for (auto& receiveQueue : _receiveQueues)
+        {
+            receiveQueue->packets.clear();
+        }
 
         // Would be closing epoll subscription in a job and call a stop callback...
         _state = CREATED;
@@ -294,9 +343,30 @@ bool FakeUdpEndpoint::isGood() const
     return _state != State::CLOSED;
 };
 
+bool FakeUdpEndpoint::configureReceiveQueues(const uint32_t count)
+{
+    if (_state != State::CREATED || _receiveQueues.size() > 1)
+    {
+        return false;
+    }
+
+    while (_receiveQueues.size() < count)
+    {
+        _receiveQueues.push_back(std::make_unique<ReceiveQueue>(_jobManager, _receiveQueueSize));
+    }
+    return true;
+}
+
 EndpointMetrics FakeUdpEndpoint::getMetrics(uint64_t timestamp) const
 {
-    return _rateMetrics.toEndpointMetrics(_sendQueue.size());
+    double receiveRate = 0;
+    for (auto& receiveQueue : _receiveQueues)
+    {
+        receiveRate += receiveQueue->receiveTracker.snapshot.load();
+    }
+    return EndpointMetrics(_sendQueue.size(),
+        receiveRate * 8 * utils::Time::ms,
+        _sendTracker.snapshot.load() * 8 * utils::Time::ms);
 }
 
 void FakeUdpEndpoint::internalUnregisterListener(IEvents* listener)
@@ -308,7 +378,7 @@ void FakeUdpEndpoint::internalUnregisterListener(IEvents* listener)
         if (item.second == listener)
         {
             _iceListeners.erase(item.first);
-            _receiveJobs.addJob<UnRegisterNotifyListenerJob>(*this, *listener);
+            notifyUnregistered(*listener);
         }
     }
 
@@ -326,11 +396,52 @@ void FakeUdpEndpoint::internalUnregisterListener(IEvents* listener)
         if (item.second == listener)
         {
             _dtlsListeners.erase(item.first);
-            _receiveJobs.addJob<UnRegisterNotifyListenerJob>(*this, *listener);
+            notifyUnregistered(*listener);
         }
     }
 }
 
+void FakeUdpEndpoint::notifyUnregistered(IEvents& listener)
+{
+    auto it = _unregisteringListeners.find(&listener);
+    if (it != _unregisteringListeners.end())
+    {
+        ++it->second;
+    }
+    else if (!_unregisteringListeners.emplace(&listener, 1).second)
+    {
+        logger::error("unregistering listener table is full", _name.c_str());
+    }
+
+    if (!_receiveQueues[0]->jobs.addJob<UnregisterBarrierJob>(*this, listener, 0))
+    {
+        logger::error("failed to post unregister job", _name.c_str());
+    }
+}
+
+// Passes through every receive queue, as any of them may be dispatching to the listener, and notifies from
+// _receiveJobs after registrations posted by those queues.
+void FakeUdpEndpoint::internalUnregisterBarrier(IEvents& listener, const size_t queueIndex)
+{
+    if (queueIndex == _receiveQueues.size())
+    {
+        auto it = _unregisteringListeners.find(&listener);
+        if (it != _unregisteringListeners.end() && --it->second == 0)
+        {
+            _unregisteringListeners.erase(&listener);
+        }
+        listener.onUnregistered(*this);
+        return;
+    }
+
+    const auto nextIndex = queueIndex + 1;
+    auto& nextQueue = (nextIndex == _receiveQueues.size() ? _receiveJobs : _receiveQueues[nextIndex]->jobs);
+    if (!nextQueue.addJob<UnregisterBarrierJob>(*this, listener, nextIndex))
+    {
+        logger::error("failed to post unregister job", _name.c_str());
+    }
+}
+
 memory::UniquePacket FakeUdpEndpoint::serializeInbound(const transport::SocketAddress& source,
     const void* data,
     size_t length)
@@ -390,11 +501,14 @@ void FakeUdpEndpoint::process(uint64_t timestamp)
     // Retrieve those packets that are due to releasing after delay.
     for (auto packet = _networkLink->pop(timestamp); packet; packet = _networkLink->pop(timestamp))
     {
-        _receiveQueue.push(deserializeInbound(std::move(packet)));
+        auto inboundPacket = deserializeInbound(std::move(packet));
+        const size_t queueIndex = std::hash<transport::SocketAddress>{}(inboundPacket.address) % _receiveQueues.size();
+        auto& receiveQueue = *_receiveQueues[queueIndex];
+        receiveQueue.packets.push(std::move(inboundPacket));
 
-        if (!_pendingRead.test_and_set())
+        if (!receiveQueue.pendingRead.test_and_set())
         {
-            if (!_receiveJobs.addJob<ReceiveJob>(*this))
+            if (!receiveQueue.jobs.addJob<ReceiveJob>(*this, queueIndex))
             {
                 logger::warn("receive queue full", _name.c_str());
             }
@@ -412,13 +526,14 @@ void FakeUdpEndpoint::process(uint64_t timestamp)
     }
 
     const auto sendTimestamp = utils::Time::getAbsoluteTime();
-    _rateMetrics.sendTracker.update(byteCount, sendTimestamp);
+    _sendTracker.update(byteCount, sendTimestamp);
 }
 
-void FakeUdpEndpoint::internalReceive()
+void FakeUdpEndpoint::internalReceive(const size_t queueIndex)
 {
-    _pendingRead.clear(); // one extra job may be added after us
-    const auto packetCount = _receiveQueue.size();
+    auto& receiveQueue = *_receiveQueues[queueIndex];
+    receiveQueue.pendingRead.clear(); // one extra job may be added after us
+    const auto packetCount = receiveQueue.packets.size();
     if (packetCount <= 0)
     {
         return;
@@ -427,9 +542,9 @@ void FakeUdpEndpoint::internalReceive()
     for (unsigned long i = 0; i < packetCount; ++i)
     {
         InboundPacket packetInfo;
-        if (_receiveQueue.pop(packetInfo) && packetInfo.packet)
+        if (receiveQueue.packets.pop(packetInfo) && packetInfo.packet)
         {
-            _rateMetrics.receiveTracker.update(packetInfo.packet->getLength(), receiveTime);
+            receiveQueue.receiveTracker.update(packetInfo.packet->getLength(), receiveTime);
             dispatchReceivedPacket(packetInfo.address, memory::makeUniquePacket(_allocator, *packetInfo.packet));
         }
     }
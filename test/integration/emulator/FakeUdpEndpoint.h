@@ -53,6 +53,8 @@ public:
     // UdpEndpoint
     bool openPort(uint16_t port) override;
     bool isGood() const override;
+    bool configureReceiveQueues(uint32_t count) override;
+    bool enableUdpOffload() override { return false; }
     EndpointMetrics getMetrics(uint64_t timestamp) const override final;
 
     // NetworkNode
@@ -67,10 +69,12 @@ public:
     std::shared_ptr<fakenet::NetworkLink> getDownlink() override { return _networkLink; }
 
     // Internal job interface.
+    void internalRegisterListener(const transport::SocketAddress& remotePort, IEvents* listener);
     void internalUnregisterListener(IEvents* listener);
+    void internalUnregisterBarrier(IEvents& listener, size_t queueIndex);
 
-    // called on receiveJobs threads
-    void internalReceive();
+    // called on receive queue threads
+    void internalReceive(size_t queueIndex);
     void dispatchReceivedPacket(const transport::SocketAddress& srcAddress, memory::UniquePacket packet);
 
 private:
@@ -89,6 +93,7 @@ private:
 private:
     memory::UniquePacket serializeInbound(const transport::SocketAddress& source, const void* data, size_t length);
     InboundPacket deserializeInbound(memory::UniquePacket packet);
+    void notifyUnregistered(IEvents& listener);
 
 private:
     std::atomic<Endpoint::State> _state;
@@ -104,25 +109,33 @@ private:
     memory::PacketPoolAllocator& _allocator;
     memory::PacketPoolAllocator _networkLinkAllocator;
     concurrency::MpmcQueue<OutboundPacket> _sendQueue;
-    concurrency::MpmcQueue<InboundPacket> _receiveQueue;
 
     std::atomic<IEvents*> _defaultListener;
     std::shared_ptr<fakenet::Gateway> _network;
     std::shared_ptr<fakenet::NetworkLink> _networkLink;
 
-    struct RateMetrics
+    using RateTracker = utils::TrackerWithSnapshot<10, utils::Time::ms * 100, utils::Time::sec>;
+
+    // Emulates SO_REUSEPORT receive sockets. Inbound packets are steered to a queue by hash of source address.
+    struct ReceiveQueue
     {
-        utils::TrackerWithSnapshot<10, utils::Time::ms * 100, utils::Time::sec> receiveTracker;
-        utils::TrackerWithSnapshot<10, utils::Time::ms * 100, utils::Time::sec> sendTracker;
-        EndpointMetrics toEndpointMetrics(size_t queueSize) const
+        ReceiveQueue(jobmanager::JobManager& jobManager, size_t size) : packets(size), jobs(jobManager, 16)
         {
-            return EndpointMetrics(queueSize,
-                receiveTracker.snapshot.load() * 8 * utils::Time::ms,
-                sendTracker.snapshot.load() * 8 * utils::Time::ms);
+            pendingRead.clear();
         }
-    } _rateMetrics;
 
-    std::atomic_flag _pendingRead = ATOMIC_FLAG_INIT;
+        concurrency::MpmcQueue<InboundPacket> packets;
+        jobmanager::JobQueue jobs;
+        std::atomic_flag pendingRead = ATOMIC_FLAG_INIT;
+        RateTracker receiveTracker;
+    };
+
+    RateTracker _sendTracker;
+    jobmanager::JobManager& _jobManager;
+    const size_t _receiveQueueSize;
+    std::vector<std::unique_ptr<ReceiveQueue>> _receiveQueues;
+    // pending unregistered notifications per listener, used on _receiveJobs only
+    concurrency::MpmcHashmap32<IEvents*, uint32_t> _unregisteringListeners;
 };
 
 } // namespace emulator
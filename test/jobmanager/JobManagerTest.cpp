@@ -9,6 +9,7 @@
 #include <random>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 using namespace std;
 using namespace jobmanager;
@@ -392,3 +393,105 @@ TEST_F(JobManagerTest, jobQueueDeletion)
     // in the ~JobQueue and process the remaining queued jobs.
     utils::Time::nanoSleep(utils::Time::ms * 30);
 }
+
+namespace
+{
+// Stands in for per transport state, like srtp contexts, that every job of a serial queue touches.
+struct QueueState
+{
+    explicit QueueState(JobManager& jobManager) : queue(jobManager, 4096), state(32 * 1024, 1), sum(0) {}
+
+    JobQueue queue;
+    std::vector<uint8_t> state;
+    uint64_t sum;
+};
+
+class TouchStateJob : public Job
+{
+public:
+    TouchStateJob(QueueState& owner, std::atomic_int& completed, Semaphore& allowedPending)
+        : _owner(owner),
+          _completed(completed),
+          _allowedPending(allowedPending)
+    {
+    }
+
+    void run() override
+    {
+        for (size_t i = 0; i < _owner.state.size(); i += 64)
+        {
+            _owner.sum += _owner.state[i]++;
+        }
+        ++_completed;
+        _allowedPending.post();
+    }
+
+private:
+    QueueState& _owner;
+    std::atomic_int& _completed;
+    Semaphore& _allowedPending;
+};
+
+// returns ms to run jobCount jobs spread over serial queues, posted from two threads
+double runSerialQueueLoad(bool workerQueues)
+{
+    const int queueCount = 64;
+    const int jobCount = 200000;
+    jobmanager::TimerQueue timers(512);
+    JobManager jobManager(timers, 4096 * 8, workerQueues);
+    vector<unique_ptr<WorkerThread>> workers;
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.emplace_back(make_unique<WorkerThread>(jobManager, true));
+    }
+
+    vector<unique_ptr<QueueState>> queues;
+    for (int i = 0; i < queueCount; ++i)
+    {
+        queues.emplace_back(make_unique<QueueState>(jobManager));
+    }
+
+    std::atomic_int completed(0);
+    Semaphore allowedPending(2048);
+    const auto start = utils::Time::getAbsoluteTime();
+    auto producer = [&](int first) {
+        for (int i = first; i < jobCount; i += 2)
+        {
+            allowedPending.wait();
+            while (!queues[i % queueCount]->queue.addJob<TouchStateJob>(*queues[i % queueCount],
+                completed,
+                allowedPending))
+            {
+                utils::Time::nanoSleep(utils::Time::us * 10);
+            }
+        }
+    };
+    thread producer1(producer, 0);
+    thread producer2(producer, 1);
+    producer1.join();
+    producer2.join();
+    while (completed.load() != jobCount)
+    {
+        utils::Time::nanoSleep(utils::Time::ms);
+    }
+    const auto elapsed = utils::Time::getAbsoluteTime() - start;
+
+    queues.clear();
+    jobManager.stop();
+    for (auto& worker : workers)
+    {
+        worker->stop();
+    }
+    return static_cast<double>(elapsed) / utils::Time::ms;
+}
+} // namespace
+
+TEST(JobManagerPerf, workerQueuesVsSharedQueue)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    const auto sharedMs = runSerialQueueLoad(false);
+    const auto localMs = runSerialQueueLoad(true);
+    logger::info("serial queue load: shared queue %.1fms, worker queues %.1fms", "JobManagerPerf", sharedMs, localMs);
+}
@@ -0,0 +1,253 @@
+#include "jobmanager/JobManager.h"
+#include "logger/Logger.h"
+#include "utils/Time.h"
+#include <atomic>
+#include <cinttypes>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace jobmanager;
+
+namespace
+{
+struct TimerCounters
+{
+    std::atomic_int fired{0};
+    std::atomic_int alive{0};
+};
+
+class CountingJob : public Job
+{
+public:
+    CountingJob(TimerCounters& counters, uint32_t tag, std::vector<uint32_t>* order)
+        : _counters(counters),
+          _tag(tag),
+          _order(order)
+    {
+        ++_counters.alive;
+    }
+    ~CountingJob() { --_counters.alive; }
+
+    void run() override
+    {
+        ++_counters.fired;
+        if (_order)
+        {
+            _order->push_back(_tag);
+        }
+    }
+
+private:
+    TimerCounters& _counters;
+    uint32_t _tag;
+    std::vector<uint32_t>* _order;
+};
+
+// runs the queued jobs on the test thread, returns number of jobs run
+int runJobs(JobManager& jobManager)
+{
+    int count = 0;
+    for (auto* job = jobManager.pop(); job; job = jobManager.pop())
+    {
+        job->runStep();
+        jobManager.freeJob(job);
+        ++count;
+    }
+    return count;
+}
+
+bool waitFor(const std::atomic_int& value, int expected, uint64_t timeoutNs)
+{
+    const auto start = utils::Time::getAbsoluteTime();
+    while (value.load() != expected)
+    {
+        if (utils::Time::diffGE(start, utils::Time::getAbsoluteTime(), timeoutNs))
+        {
+            return false;
+        }
+        utils::Time::nanoSleep(100 * utils::Time::us);
+    }
+    return true;
+}
+} // namespace
+
+struct TimerQueueTest : public ::testing::Test
+{
+    TimerQueueTest() : timers(4096), jobManager(timers) {}
+
+    void TearDown() override
+    {
+        timers.stop();
+        runJobs(jobManager);
+        EXPECT_EQ(0, counters.alive.load());
+    }
+
+    void drainUntilFired(int expected, uint64_t timeoutNs)
+    {
+        const auto start = utils::Time::getAbsoluteTime();
+        while (counters.fired.load() < expected &&
+            utils::Time::diffLT(start, utils::Time::getAbsoluteTime(), timeoutNs))
+        {
+            runJobs(jobManager);
+            utils::Time::nanoSleep(100 * utils::Time::us);
+        }
+    }
+
+    TimerCounters counters;
+    TimerQueue timers;
+    JobManager jobManager;
+};
+
+TEST_F(TimerQueueTest, abortSingleAndGroup)
+{
+    for (uint32_t group = 1; group <= 3; ++group)
+    {
+        for (uint32_t id = 0; id < 5; ++id)
+        {
+            EXPECT_TRUE(jobManager.addTimedJob<CountingJob>(group, id, 20000, counters, group, nullptr));
+        }
+    }
+    jobManager.abortTimedJobs(2);
+    jobManager.abortTimedJob(3, 4);
+    jobManager.abortTimedJob(3, 17); // unknown id
+    jobManager.abortTimedJobs(9); // unknown group
+
+    drainUntilFired(9, utils::Time::sec);
+    utils::Time::nanoSleep(30 * utils::Time::ms);
+    runJobs(jobManager);
+    EXPECT_EQ(9, counters.fired.load());
+    EXPECT_EQ(0, counters.alive.load());
+}
+
+TEST_F(TimerQueueTest, abortSingleInLargeGroups)
+{
+    for (uint32_t id = 0; id < 1000; ++id)
+    {
+        EXPECT_TRUE(jobManager.addTimedJob<CountingJob>(id % 2, id, 20000, counters, id, nullptr));
+    }
+    for (uint32_t id = 0; id < 1000; id += 4)
+    {
+        jobManager.abortTimedJob(id % 2, id);
+        jobManager.abortTimedJob(id % 2, id + 1); // other group
+    }
+
+    drainUntilFired(750, utils::Time::sec);
+    utils::Time::nanoSleep(30 * utils::Time::ms);
+    runJobs(jobManager);
+    EXPECT_EQ(750, counters.fired.load());
+    EXPECT_EQ(0, counters.alive.load());
+}
+
+TEST_F(TimerQueueTest, replaceKeepsOneTimer)
+{
+    std::vector<uint32_t> order;
+    EXPECT_TRUE(jobManager.addTimedJob<CountingJob>(1, 1, 10000, counters, 1, &order));
+    EXPECT_TRUE(jobManager.replaceTimedJob<CountingJob>(1, 1, 40000, counters, 2, &order));
+
+    drainUntilFired(1, utils::Time::sec);
+    utils::Time::nanoSleep(20 * utils::Time::ms);
+    runJobs(jobManager);
+    ASSERT_EQ(1u, order.size());
+    EXPECT_EQ(2u, order[0]);
+}
+
+// timers beyond the first wheel level are cascaded down and still expire in order and on time
+TEST_F(TimerQueueTest, cascadesInOrder)
+{
+    std::vector<uint32_t> order;
+    const uint64_t timeoutsMs[] = {600, 5, 270, 255, 1, 300};
+    const auto start = utils::Time::getAbsoluteTime();
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        EXPECT_TRUE(jobManager.addTimedJob<CountingJob>(1, i, timeoutsMs[i] * 1000, counters, i, &order));
+    }
+
+    drainUntilFired(5, utils::Time::sec);
+    const auto fifthFired = utils::Time::getAbsoluteTime();
+    EXPECT_GE(fifthFired - start, 300 * utils::Time::ms);
+    EXPECT_LT(fifthFired - start, 350 * utils::Time::ms);
+
+    drainUntilFired(6, utils::Time::sec);
+    const std::vector<uint32_t> expected = {4, 1, 3, 2, 5, 0};
+    EXPECT_EQ(expected, order);
+}
+
+TEST_F(TimerQueueTest, expiredTimerFiresImmediately)
+{
+    EXPECT_TRUE(jobManager.addTimedJob<CountingJob>(7, 1, 0, counters, 0, nullptr));
+    drainUntilFired(1, utils::Time::sec);
+    EXPECT_EQ(1, counters.fired.load());
+}
+
+TEST(TimerQueuePerf, hundredThousandTimers)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    const uint32_t timerCount = 100000;
+    const uint32_t groupCount = 10000;
+    TimerCounters counters;
+    TimerQueue timers(256 * 1024);
+    JobManager jobManager(timers, 256 * 1024);
+
+    std::mt19937 generator(1234);
+    std::uniform_int_distribution<uint64_t> longTimeouts(20000000, 40000000); // us
+    std::uniform_int_distribution<uint64_t> shortTimeouts(50000, 150000); // us
+
+    // insert, replace every other timer and abort every other group, with nothing expiring meanwhile
+    auto start = utils::Time::getAbsoluteTime();
+    for (uint32_t i = 0; i < timerCount; ++i)
+    {
+        ASSERT_TRUE(
+            jobManager.addTimedJob<CountingJob>(i % groupCount, i, longTimeouts(generator), counters, i, nullptr));
+    }
+    for (uint32_t i = 0; i < timerCount; i += 2)
+    {
+        ASSERT_TRUE(
+            jobManager.replaceTimedJob<CountingJob>(i % groupCount, i, longTimeouts(generator), counters, i, nullptr));
+    }
+    for (uint32_t group = 1; group < groupCount; group += 2)
+    {
+        jobManager.abortTimedJobs(group);
+    }
+    EXPECT_TRUE(waitFor(counters.alive, timerCount / 2, 10 * utils::Time::sec));
+    const auto changeTime = utils::Time::getAbsoluteTime() - start;
+
+    start = utils::Time::getAbsoluteTime();
+    for (uint32_t group = 0; group < groupCount; group += 2)
+    {
+        jobManager.abortTimedJobs(group);
+    }
+    EXPECT_TRUE(waitFor(counters.alive, 0, 10 * utils::Time::sec));
+    const auto abortTime = utils::Time::getAbsoluteTime() - start;
+
+    start = utils::Time::getAbsoluteTime();
+    for (uint32_t i = 0; i < timerCount; ++i)
+    {
+        ASSERT_TRUE(
+            jobManager.addTimedJob<CountingJob>(i % groupCount, i, shortTimeouts(generator), counters, i, nullptr));
+    }
+    int fired = 0;
+    while (fired < static_cast<int>(timerCount) &&
+        utils::Time::diffLT(start, utils::Time::getAbsoluteTime(), 10 * utils::Time::sec))
+    {
+        fired += runJobs(jobManager);
+        utils::Time::nanoSleep(100 * utils::Time::us);
+    }
+    const auto expireTime = utils::Time::getAbsoluteTime() - start;
+    EXPECT_EQ(static_cast<int>(timerCount), counters.fired.load());
+
+    timers.stop();
+    runJobs(jobManager);
+    EXPECT_EQ(0, counters.alive.load());
+
+    logger::info("%u timers: add+replace+abort %" PRIu64 "us, abort all groups %" PRIu64 "us, add+expire %" PRIu64
+                 "us",
+        "TimerQueuePerf",
+        timerCount,
+        changeTime / utils::Time::us,
+        abortTime / utils::Time::us,
+        expireTime / utils::Time::us);
+}
@@ -0,0 +1,191 @@
+#include "logger/Logger.h"
+#include "memory/AudioMix.h"
+#include "memory/RingBuffer.h"
+#include "utils/Time.h"
+#include <array>
+#include <cinttypes>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+const size_t samplesPerIteration = 960;
+
+std::vector<int16_t> makeSamples(std::mt19937& generator, size_t count, int16_t amplitude)
+{
+    std::uniform_int_distribution<int32_t> distribution(-amplitude, amplitude);
+    std::vector<int16_t> samples(count);
+    for (auto& sample : samples)
+    {
+        sample = static_cast<int16_t>(distribution(generator));
+    }
+    return samples;
+}
+
+// The loops RingBuffer used before the kernels were introduced
+void legacyAddToMix(int16_t* mixedData, const int16_t* data, size_t count, int16_t scaleFactor)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        mixedData[i] += data[i] / scaleFactor;
+    }
+}
+
+void legacyRemoveFromMix(int16_t* mixedData, const int16_t* data, size_t count, int16_t scaleFactor)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        mixedData[i] -= data[i] / scaleFactor;
+    }
+}
+
+} // namespace
+
+TEST(AudioMixTest, bitExactWithLegacyMix)
+{
+    std::mt19937 generator(4711);
+    for (int16_t scaleFactor = 1; scaleFactor <= 7; ++scaleFactor)
+    {
+        for (size_t count : {0, 1, 7, 15, 17, 33, 480, 959, 960})
+        {
+            const auto samples = makeSamples(generator, count, 16000);
+            const auto mixed = makeSamples(generator, count, 16000);
+
+            auto expected = mixed;
+            auto actual = mixed;
+            legacyAddToMix(expected.data(), samples.data(), count, scaleFactor);
+            memory::mixScaled(actual.data(), samples.data(), count, scaleFactor);
+            EXPECT_EQ(expected, actual) << "scaleFactor " << scaleFactor << " count " << count;
+
+            legacyRemoveFromMix(expected.data(), samples.data(), count, scaleFactor);
+            memory::unmixScaled(actual.data(), samples.data(), count, scaleFactor);
+            EXPECT_EQ(mixed, actual);
+            EXPECT_EQ(expected, actual);
+        }
+    }
+}
+
+TEST(AudioMixTest, bitExactWithScalarOnFullRange)
+{
+    std::mt19937 generator(17);
+    for (int16_t scaleFactor : {1, 2, 3, 4, 5, 8, 100, 16384, 32767})
+    {
+        const auto samples = makeSamples(generator, samplesPerIteration + 5, 32767);
+        const auto mixed = makeSamples(generator, samplesPerIteration + 5, 32767);
+
+        auto expected = mixed;
+        auto actual = mixed;
+        memory::detail::mixScaledScalar(expected.data(), samples.data(), expected.size(), scaleFactor);
+        memory::mixScaled(actual.data(), samples.data(), actual.size(), scaleFactor);
+        EXPECT_EQ(expected, actual) << "scaleFactor " << scaleFactor;
+
+        memory::detail::unmixScaledScalar(expected.data(), samples.data(), expected.size(), scaleFactor);
+        memory::unmixScaled(actual.data(), samples.data(), actual.size(), scaleFactor);
+        EXPECT_EQ(expected, actual) << "scaleFactor " << scaleFactor;
+    }
+}
+
+TEST(AudioMixTest, saturates)
+{
+    std::vector<int16_t> samples(40, 32767);
+    std::vector<int16_t> mixed(40, 30000);
+    memory::mixScaled(mixed.data(), samples.data(), mixed.size(), 4);
+    for (auto sample : mixed)
+    {
+        EXPECT_EQ(32767, sample);
+    }
+
+    std::fill(samples.begin(), samples.end(), -32768);
+    std::fill(mixed.begin(), mixed.end(), -30000);
+    memory::mixScaled(mixed.data(), samples.data(), mixed.size(), 2);
+    for (auto sample : mixed)
+    {
+        EXPECT_EQ(-32768, sample);
+    }
+
+    std::fill(samples.begin(), samples.end(), 32767);
+    memory::unmixScaled(mixed.data(), samples.data(), mixed.size(), 3);
+    for (auto sample : mixed)
+    {
+        EXPECT_EQ(-32768, sample);
+    }
+}
+
+TEST(AudioMixTest, ringBufferWrapAround)
+{
+    memory::RingBuffer<int16_t, samplesPerIteration * 2> ringBuffer;
+    std::mt19937 generator(1);
+
+    for (size_t offset : {size_t(0), size_t(1), size_t(9), size_t(500), samplesPerIteration - 3})
+    {
+        const auto samples = makeSamples(generator, samplesPerIteration, 16000);
+        if (offset > 0)
+        {
+            const auto filler = makeSamples(generator, offset, 16000);
+            ASSERT_TRUE(ringBuffer.write(filler.data(), filler.size()));
+            ringBuffer.drop(offset);
+        }
+        ASSERT_TRUE(ringBuffer.write(samples.data(), samples.size()));
+
+        const auto mixed = makeSamples(generator, samplesPerIteration, 16000);
+        auto expected = mixed;
+        auto actual = mixed;
+        legacyAddToMix(expected.data(), samples.data(), samplesPerIteration, 4);
+        EXPECT_TRUE(ringBuffer.addToMix(actual.data(), samplesPerIteration, 4));
+        EXPECT_EQ(expected, actual);
+
+        legacyRemoveFromMix(expected.data(), samples.data(), samplesPerIteration, 4);
+        EXPECT_TRUE(ringBuffer.removeFromMix(actual.data(), samplesPerIteration, 4));
+        EXPECT_EQ(mixed, actual);
+        ringBuffer.drop(samplesPerIteration);
+    }
+}
+
+TEST(AudioMixTest, performance)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    const size_t participants = 100;
+    const int iterations = 1000;
+    std::mt19937 generator(3);
+    std::vector<std::vector<int16_t>> buffers;
+    for (size_t i = 0; i < participants; ++i)
+    {
+        buffers.push_back(makeSamples(generator, samplesPerIteration, 32767));
+    }
+    std::array<int16_t, samplesPerIteration> mixed;
+
+    const auto scalarStart = utils::Time::getAbsoluteTime();
+    for (int i = 0; i < iterations; ++i)
+    {
+        mixed.fill(0);
+        for (auto& buffer : buffers)
+        {
+            memory::detail::mixScaledScalar(mixed.data(), buffer.data(), samplesPerIteration, 4);
+        }
+    }
+    const auto scalarTime = utils::Time::getAbsoluteTime() - scalarStart;
+    const auto scalarFirst = mixed[0];
+
+    const auto kernelStart = utils::Time::getAbsoluteTime();
+    for (int i = 0; i < iterations; ++i)
+    {
+        mixed.fill(0);
+        for (auto& buffer : buffers)
+        {
+            memory::mixScaled(mixed.data(), buffer.data(), samplesPerIteration, 4);
+        }
+    }
+    const auto kernelTime = utils::Time::getAbsoluteTime() - kernelStart;
+    EXPECT_EQ(scalarFirst, mixed[0]);
+
+    logger::info("mixing %zu participants, scalar %" PRIu64 "us, kernel %" PRIu64 "us",
+        "AudioMixTest",
+        participants,
+        scalarTime / utils::Time::us,
+        kernelTime / utils::Time::us);
+    EXPECT_LE(kernelTime, scalarTime);
+}
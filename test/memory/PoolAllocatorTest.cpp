@@ -4,6 +4,7 @@
 #include "test/bridge/DummyRtcTransport.h"
 #include "test/macros.h"
 #include "utils/Time.h"
+#include <cinttypes>
 #include <gtest/gtest.h>
 #include <memory>
 #include <random>
@@ -164,6 +165,119 @@ TEST_F(PoolAllocatorTest, performance)
     }
 }
 
+TEST_F(PoolAllocatorTest, threadCache)
+{
+    TestAllocator allocator(1024, "PoolAllocatorTest", true);
+    ASSERT_TRUE(allocator.hasThreadCache());
+    const auto threadIndex = memory::detail::getThreadCacheIndex();
+    ASSERT_GE(threadIndex, 0);
+
+    std::vector<void*> items;
+    for (auto item = allocator.allocate(); item; item = allocator.allocate())
+    {
+        items.push_back(item);
+    }
+    EXPECT_EQ(1024, items.size());
+    EXPECT_EQ(0, allocator.countCachedItems());
+    EXPECT_GE(allocator.getThreadCacheStats(threadIndex).refills, 1024 / 16);
+
+    for (auto item : items)
+    {
+        allocator.free(item);
+    }
+    const auto stats = allocator.getThreadCacheStats(threadIndex);
+    EXPECT_LE(stats.cachedItems, 32);
+    EXPECT_GT(stats.returns, 0);
+    EXPECT_EQ(stats.cachedItems, allocator.countCachedItems());
+#if ENABLE_ALLOCATOR_METRICS
+    EXPECT_EQ(0, allocator.countAllocatedItems());
+#endif
+
+    // items freed by another thread are served from that thread's cache and the shared queues
+    std::thread other([&allocator]() {
+        auto item = allocator.allocate();
+        EXPECT_TRUE(item);
+        allocator.free(item);
+    });
+    other.join();
+}
+
+TEST_F(PoolAllocatorTest, multiThreadedThreadCache)
+{
+    auto allocator = std::make_unique<TestAllocator>(2048, "PoolAllocatorTest", true);
+    std::vector<std::unique_ptr<std::thread>> threads;
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back(std::make_unique<std::thread>(doRandomAllocations, allocator.get(), i));
+    }
+
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads[i]->join();
+    }
+#if ENABLE_ALLOCATOR_METRICS
+    EXPECT_EQ(0, allocator->countAllocatedItems());
+#endif
+}
+
+namespace
+{
+// Each thread keeps a window of allocations and frees the oldest, like packets passing through a queue
+uint64_t measureContention(const size_t threadCount, const bool threadCache)
+{
+    using SmallAllocator = memory::PoolAllocator<64>;
+    SmallAllocator allocator(128 * 1024, "PoolAllocatorTest", threadCache);
+    const size_t operations = 200000;
+    std::atomic_bool start(false);
+
+    std::vector<std::unique_ptr<std::thread>> threads;
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back(std::make_unique<std::thread>([&allocator, &start]() {
+            void* window[64] = {nullptr};
+            while (!start)
+            {
+            }
+            for (size_t j = 0; j < operations; ++j)
+            {
+                auto& slot = window[j % 64];
+                allocator.free(slot);
+                slot = allocator.allocate();
+            }
+            for (auto* item : window)
+            {
+                allocator.free(item);
+            }
+        }));
+    }
+
+    const auto startTime = utils::Time::getAbsoluteTime();
+    start = true;
+    for (auto& thread : threads)
+    {
+        thread->join();
+    }
+    return (utils::Time::getAbsoluteTime() - startTime) / operations;
+}
+} // namespace
+
+TEST_F(PoolAllocatorTest, threadCacheContention)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    for (size_t threadCount : {1, 2, 4, 8})
+    {
+        const auto shared = measureContention(threadCount, false);
+        const auto cached = measureContention(threadCount, true);
+        logger::info("%zu threads, ns per alloc+free shared %" PRIu64 ", thread cached %" PRIu64,
+            "PoolAllocatorTest",
+            threadCount,
+            shared,
+            cached);
+    }
+}
+
 TEST(PoolAllocatorBasic, leakReport)
 {
     {
@@ -251,3 +365,42 @@ TEST(PoolAllocatorBasic, deleter)
     IncomingPacketAggregate<memory::UniquePacket> aggr2;
     EXPECT_TRUE(recvQueue.pop(aggr2));
 }
+
+TEST(PoolAllocatorBasic, hugePageBackends)
+{
+    const size_t hugePageSize = 2 * 1024 * 1024;
+
+    size_t smallSize = 10000;
+    memory::setPageBackend(memory::PageBackend::Transparent, true);
+    auto* small = memory::mapPages(smallSize);
+    ASSERT_NE(nullptr, small);
+    EXPECT_EQ(0, smallSize % getpagesize());
+    EXPECT_LT(smallSize, hugePageSize);
+    EXPECT_EQ(smallSize, memory::residentBytes(small, smallSize));
+    memory::unmapPages(small, smallSize);
+
+    size_t largeSize = hugePageSize + 1;
+    auto* large = memory::mapPages(largeSize);
+    ASSERT_NE(nullptr, large);
+    EXPECT_EQ(2 * hugePageSize, largeSize);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(large) % hugePageSize);
+    EXPECT_EQ(largeSize, memory::residentBytes(large, largeSize));
+    memory::unmapPages(large, largeSize);
+
+    // works whether or not huge pages are reserved on this host
+    memory::setPageBackend(memory::PageBackend::HugeTlb, false);
+    {
+        memory::PacketPoolAllocator allocator(4096, "hugeTlbPool");
+        auto packet = memory::makeUniquePacket(allocator);
+        ASSERT_NE(nullptr, packet);
+        EXPECT_GT(allocator.getResidentBytes(), 0);
+    }
+
+    memory::setPageBackend(memory::PageBackend::Normal, false);
+    {
+        memory::PacketPoolAllocator allocator(1024, "normalPool");
+        concurrency::MpmcQueue<memory::UniquePacket> queue(4096);
+        EXPECT_TRUE(queue.push(memory::makeUniquePacket(allocator)));
+        EXPECT_EQ(1, queue.size());
+    }
+}
@@ -0,0 +1,136 @@
+#include "memory/SharedPacket.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+memory::UniquePacket makePacket(memory::PacketPoolAllocator& allocator, uint8_t value, size_t length)
+{
+    auto packet = memory::makeUniquePacket(allocator);
+    std::memset(packet->get(), value, length);
+    packet->setLength(length);
+    packet->endpointIdHash = value;
+    return packet;
+}
+
+} // namespace
+
+TEST(SharedPacketTest, lastHolderTakesOriginal)
+{
+    memory::PacketPoolAllocator allocator(16, "SharedPacketTest");
+    memory::SharedPacketAllocator sharedAllocator(16, "SharedPacketTest");
+
+    auto packet = makePacket(allocator, 7, 100);
+    const auto* original = packet.get();
+    auto shared = memory::makeSharedPacket(sharedAllocator, packet);
+    EXPECT_FALSE(packet);
+    ASSERT_TRUE(shared);
+    EXPECT_EQ(1, shared.useCount());
+
+    auto writable = shared.makeWritable(allocator);
+    EXPECT_FALSE(shared);
+    ASSERT_TRUE(writable);
+    EXPECT_EQ(original, writable.get());
+    EXPECT_EQ(100, writable->getLength());
+    EXPECT_EQ(sharedAllocator.countAllocatedItems(), 0);
+}
+
+TEST(SharedPacketTest, copiesWhileShared)
+{
+    memory::PacketPoolAllocator allocator(16, "SharedPacketTest");
+    memory::SharedPacketAllocator sharedAllocator(16, "SharedPacketTest");
+
+    auto packet = makePacket(allocator, 3, 200);
+    const auto* original = packet.get();
+    auto shared = memory::makeSharedPacket(sharedAllocator, packet);
+
+    memory::SharedPacket receiver1(shared);
+    memory::SharedPacket receiver2(shared);
+    EXPECT_EQ(3, shared.useCount());
+    shared.reset();
+    EXPECT_EQ(2, receiver1.useCount());
+
+    auto copy = receiver1.makeWritable(allocator);
+    ASSERT_TRUE(copy);
+    EXPECT_NE(original, copy.get());
+    EXPECT_EQ(200, copy->getLength());
+    EXPECT_EQ(3u, copy->endpointIdHash);
+    EXPECT_EQ(0, std::memcmp(copy->get(), receiver2->get(), 200));
+
+    copy->get()[0] = 9;
+    EXPECT_EQ(3, receiver2->get()[0]);
+
+    auto last = receiver2.makeWritable(allocator);
+    EXPECT_EQ(original, last.get());
+    EXPECT_EQ(sharedAllocator.countAllocatedItems(), 0);
+}
+
+TEST(SharedPacketTest, releasesPacketWhenUnused)
+{
+    memory::PacketPoolAllocator allocator(16, "SharedPacketTest");
+    memory::SharedPacketAllocator sharedAllocator(16, "SharedPacketTest");
+    const auto initialSize = allocator.size();
+
+    {
+        auto packet = makePacket(allocator, 1, 10);
+        auto shared = memory::makeSharedPacket(sharedAllocator, packet);
+        std::vector<memory::SharedPacket> receivers(10, shared);
+        EXPECT_EQ(11, shared.useCount());
+    }
+
+    EXPECT_EQ(initialSize, allocator.size());
+    EXPECT_EQ(sharedAllocator.countAllocatedItems(), 0);
+}
+
+TEST(SharedPacketTest, depletedAllocatorKeepsPacket)
+{
+    memory::PacketPoolAllocator allocator(4096, "SharedPacketTest");
+    memory::SharedPacketAllocator sharedAllocator(1, "SharedPacketTest");
+
+    std::vector<memory::SharedPacket> shared;
+    for (;;)
+    {
+        auto packet = makePacket(allocator, 1, 10);
+        auto sharedPacket = memory::makeSharedPacket(sharedAllocator, packet);
+        if (!sharedPacket)
+        {
+            EXPECT_TRUE(packet);
+            break;
+        }
+        shared.push_back(sharedPacket);
+    }
+}
+
+TEST(SharedPacketTest, multiThreadedRelease)
+{
+    memory::PacketPoolAllocator allocator(4096, "SharedPacketTest");
+    memory::SharedPacketAllocator sharedAllocator(1024, "SharedPacketTest");
+    const auto initialSize = allocator.size();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        auto packet = makePacket(allocator, 1, 1000);
+        auto shared = memory::makeSharedPacket(sharedAllocator, packet);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t)
+        {
+            threads.emplace_back([shared, &allocator]() mutable {
+                auto writable = shared.makeWritable(allocator);
+                EXPECT_TRUE(writable);
+                writable->get()[0] = 2;
+            });
+        }
+        shared.reset();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    EXPECT_EQ(initialSize, allocator.size());
+    EXPECT_EQ(sharedAllocator.countAllocatedItems(), 0);
+}
@@ -11,6 +11,7 @@
 #include "transport/ice/Stun.h"
 #include <atomic>
 #include <gtest/gtest.h>
+#include <thread>
 
 namespace
 {
@@ -348,6 +349,79 @@ TEST(IceTest, build)
     EXPECT_TRUE(msg.isAuthentic(pwd));
 }
 
+TEST(IceTest, keyedHmacReuse)
+{
+    using namespace ice;
+    const std::string pwd = "Hw89ty98masndbn";
+    const crypto::HMAC keyedHmac(pwd.c_str(), pwd.size());
+
+    for (uint64_t i = 0; i < 3; ++i)
+    {
+        ice::StunMessage msg;
+        msg.header.setMethod(ice::StunHeader::BindingRequest);
+        msg.header.transactionId.set(0x1111222233334444ull + i);
+        msg.add(StunGenericAttribute(StunAttribute::USERNAME, "target:sender"));
+        msg.add(StunPriority(912837490u + i));
+
+        uint8_t expected[20];
+        uint8_t actual[20];
+        msg.computeHMAC(pwd, expected);
+        msg.computeHMAC(keyedHmac, actual);
+        EXPECT_EQ(0, std::memcmp(expected, actual, sizeof(expected)));
+
+        msg.addMessageIntegrity(keyedHmac);
+        msg.addFingerprint();
+        EXPECT_TRUE(msg.isValid());
+        EXPECT_TRUE(msg.isAuthentic(pwd));
+        EXPECT_TRUE(msg.isAuthentic(keyedHmac));
+
+        const std::string otherPwd = "Hw89ty98masndbm";
+        const crypto::HMAC otherHmac(otherPwd.c_str(), otherPwd.size());
+        EXPECT_FALSE(msg.isAuthentic(otherHmac));
+    }
+}
+
+// Responses are authenticated on the receive thread while the transport thread may set new remote credentials. The
+// keyed HMAC being replaced must stay alive until the authentication using it has finished.
+TEST(IceTest, setRemoteCredentialsWhileAuthenticating)
+{
+    ice::IceConfig config;
+    ice::IceSession session(1, config, ice::IceComponent::RTP, ice::IceRole::CONTROLLING);
+    const std::pair<std::string, std::string> credentials1("remote1", "Hw89ty98masndbnHw89ty98");
+    const std::pair<std::string, std::string> credentials2("remote2", "Jk12as34qwerzxcvJk12as34");
+    session.setRemoteCredentials(credentials1);
+
+    ice::StunMessage response;
+    response.header.setMethod(ice::StunHeader::BindingResponse);
+    response.header.transactionId.set(0x1111222233334444ull);
+    response.add(ice::StunGenericAttribute(ice::StunAttribute::SOFTWARE, "slice"));
+    response.addMessageIntegrity(credentials1.second);
+    response.addFingerprint();
+    ASSERT_TRUE(session.isResponseAuthentic(&response, response.size()));
+
+    std::atomic_bool running(true);
+    std::atomic_uint32_t checkCount(0);
+    std::thread receiveThread([&]() {
+        while (running)
+        {
+            session.isResponseAuthentic(&response, response.size());
+            ++checkCount;
+        }
+    });
+
+    for (uint32_t i = 0; i < 2000 || checkCount < 2000; ++i)
+    {
+        session.setRemoteCredentials(i % 2 ? credentials2 : credentials1);
+    }
+    running = false;
+    receiveThread.join();
+
+    session.setRemoteCredentials(credentials2);
+    EXPECT_FALSE(session.isResponseAuthentic(&response, response.size()));
+    session.setRemoteCredentials(credentials1);
+    EXPECT_TRUE(session.isResponseAuthentic(&response, response.size()));
+}
+
 class IceSocketAdapter : public ice::IceEndpoint
 {
 public:
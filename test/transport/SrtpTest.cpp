@@ -223,3 +223,32 @@ TEST_F(SrtpTest, sendOutOfOrder)
         EXPECT_TRUE(_srtp2->unprotect(*packet));
     }
 }
+
+TEST_F(SrtpTest, batchProtect)
+{
+    connect();
+
+    const size_t count = 16;
+    memory::UniquePacket packets[count];
+    for (size_t i = 0; i < count; ++i)
+    {
+        packets[i] = memory::makeUniquePacket(_allocator, _audioPacket);
+        auto header = rtp::RtpHeader::fromPacket(*packets[i]);
+        header->ssrc = 4321 + (i % 3);
+        header->timestamp = 1234 + i * 160;
+        header->sequenceNumber = 5678 + i;
+    }
+
+    EXPECT_EQ(count, _srtp1->protect(packets, count));
+    auto replayed = memory::makeUniquePacket(_allocator, *packets[5]);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        ASSERT_TRUE(packets[i]);
+        EXPECT_TRUE(_srtp2->unprotect(*packets[i]));
+        auto header = rtp::RtpHeader::fromPacket(*packets[i]);
+        EXPECT_EQ(5678 + i, header->sequenceNumber.get());
+        EXPECT_TRUE(isDataValid(header->getPayload()));
+    }
+    EXPECT_FALSE(_srtp2->unprotect(*replayed));
+}
@@ -0,0 +1,486 @@
+#include "jobmanager/JobManager.h"
+#include "jobmanager/WorkerThread.h"
+#include "memory/PacketPoolAllocator.h"
+#include "rtp/RtpHeader.h"
+#include "test/integration/emulator/FakeEndpointFactory.h"
+#include "test/transport/FakeNetwork.h"
+#include "transport/EndpointFactoryImpl.h"
+#include "transport/RtcSocket.h"
+#include "transport/RtcePoll.h"
+#include "transport/ice/Stun.h"
+#include "utils/Time.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+using namespace transport;
+
+namespace
+{
+
+// Counts packets of one flow and checks that they arrive in order. Each flow is received on a single queue so
+// no synchronization is needed apart from the shared total.
+class FlowListener : public Endpoint::IEvents
+{
+public:
+    FlowListener(std::atomic_uint32_t& totalCount, std::atomic_uint32_t& unregisteredCount, uint64_t workNs)
+        : receivedCount(0),
+          receivedBytes(0),
+          reorderCount(0),
+          registered(false),
+          _nextSequenceNumber(0),
+          _totalCount(totalCount),
+          _unregisteredCount(unregisteredCount),
+          _workNs(workNs)
+    {
+    }
+
+    void onRtpReceived(Endpoint& endpoint,
+        const SocketAddress& source,
+        const SocketAddress& target,
+        memory::UniquePacket packet) override
+    {
+        auto rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+        if (rtpHeader->sequenceNumber.get() != _nextSequenceNumber)
+        {
+            ++reorderCount;
+        }
+        _nextSequenceNumber = rtpHeader->sequenceNumber.get() + 1;
+
+        // emulates the cost of unprotecting the packet
+        const auto start = utils::Time::getAbsoluteTime();
+        while (utils::Time::diffLT(start, utils::Time::getAbsoluteTime(), _workNs)) {}
+
+        ++receivedCount;
+        receivedBytes += packet->getLength();
+        ++_totalCount;
+    }
+
+    void onDtlsReceived(Endpoint&, const SocketAddress&, const SocketAddress&, memory::UniquePacket) override {}
+    void onRtcpReceived(Endpoint&, const SocketAddress&, const SocketAddress&, memory::UniquePacket) override {}
+    void onIceReceived(Endpoint&, const SocketAddress&, const SocketAddress&, memory::UniquePacket) override {}
+    void onRegistered(Endpoint& endpoint) override { registered = true; }
+    void onUnregistered(Endpoint& endpoint) override { ++_unregisteredCount; }
+
+    uint32_t receivedCount;
+    size_t receivedBytes;
+    uint32_t reorderCount;
+    std::atomic_bool registered;
+
+private:
+    uint16_t _nextSequenceNumber;
+    std::atomic_uint32_t& _totalCount;
+    std::atomic_uint32_t& _unregisteredCount;
+    const uint64_t _workNs;
+};
+
+memory::FixedPacket<1504> makeRtpPacket(uint16_t sequenceNumber, uint32_t ssrc, size_t length = 160)
+{
+    memory::FixedPacket<1504> packet;
+    auto rtpHeader = rtp::RtpHeader::create(packet);
+    rtpHeader->payloadType = 100;
+    rtpHeader->sequenceNumber = sequenceNumber;
+    rtpHeader->ssrc = ssrc;
+    packet.setLength(length);
+    return packet;
+}
+
+// Answers ICE requests the way TransportImpl does, by registering the source address from the receive queue.
+// Nothing may reach the listener after it has been notified that it is unregistered.
+class IceListener : public Endpoint::IEvents
+{
+public:
+    IceListener()
+        : iceCount(0),
+          registeredCount(0),
+          unregisteredCount(0),
+          lateCallbackCount(0),
+          _unregistered(false)
+    {
+    }
+
+    void onIceReceived(Endpoint& endpoint,
+        const SocketAddress& source,
+        const SocketAddress& target,
+        memory::UniquePacket packet) override
+    {
+        if (_unregistered)
+        {
+            ++lateCallbackCount;
+        }
+        endpoint.registerListener(source, this);
+        ++iceCount;
+    }
+
+    void onRtpReceived(Endpoint&, const SocketAddress&, const SocketAddress&, memory::UniquePacket) override {}
+    void onDtlsReceived(Endpoint&, const SocketAddress&, const SocketAddress&, memory::UniquePacket) override {}
+    void onRtcpReceived(Endpoint&, const SocketAddress&, const SocketAddress&, memory::UniquePacket) override {}
+
+    void onRegistered(Endpoint& endpoint) override
+    {
+        if (_unregistered)
+        {
+            ++lateCallbackCount;
+        }
+        ++registeredCount;
+    }
+
+    void onUnregistered(Endpoint& endpoint) override
+    {
+        _unregistered = true;
+        ++unregisteredCount;
+    }
+
+    std::atomic_uint32_t iceCount;
+    std::atomic_uint32_t registeredCount;
+    std::atomic_uint32_t unregisteredCount;
+    std::atomic_uint32_t lateCallbackCount;
+
+private:
+    std::atomic_bool _unregistered;
+};
+
+memory::FixedPacket<1504> makeIceRequest(const std::string& userName, uint64_t transactionId)
+{
+    ice::StunMessage stun;
+    stun.header.setMethod(ice::StunHeader::BindingRequest);
+    stun.header.transactionId.set(transactionId);
+    stun.add(ice::StunGenericAttribute(ice::StunAttribute::USERNAME, userName));
+
+    memory::FixedPacket<1504> packet;
+    packet.append(&stun, stun.size());
+    return packet;
+}
+
+bool waitFor(const std::atomic_uint32_t& counter, uint32_t expectedCount, uint64_t timeout)
+{
+    const auto start = utils::Time::getAbsoluteTime();
+    while (counter < expectedCount && utils::Time::diffLT(start, utils::Time::getAbsoluteTime(), timeout))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return counter >= expectedCount;
+}
+
+// registrations are posted to the main receive queue when the endpoint has several
+bool waitForRegistration(const std::vector<std::unique_ptr<FlowListener>>& listeners, uint64_t timeout)
+{
+    const auto start = utils::Time::getAbsoluteTime();
+    for (auto& listener : listeners)
+    {
+        while (!listener->registered && utils::Time::diffLT(start, utils::Time::getAbsoluteTime(), timeout))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (!listener->registered)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+struct UdpEndpointTest : public testing::Test
+{
+    std::unique_ptr<jobmanager::TimerQueue> _timers;
+    std::unique_ptr<jobmanager::JobManager> _jobManager;
+    std::unique_ptr<memory::PacketPoolAllocator> _allocator;
+    std::unique_ptr<RtcePoll> _rtcePoll;
+    std::vector<std::unique_ptr<jobmanager::WorkerThread>> _workerThreads;
+
+    UdpEndpointTest()
+        : _timers(std::make_unique<jobmanager::TimerQueue>(4096)),
+          _jobManager(std::make_unique<jobmanager::JobManager>(*_timers)),
+          _allocator(std::make_unique<memory::PacketPoolAllocator>(4096 * 32, "UdpEndpointTest")),
+          _rtcePoll(createRtcePoll())
+    {
+        for (size_t i = 0; i < std::max(4u, std::thread::hardware_concurrency()); ++i)
+        {
+            _workerThreads.push_back(std::make_unique<jobmanager::WorkerThread>(*_jobManager, true));
+        }
+    }
+
+    void TearDown() override
+    {
+        _timers->stop();
+        _jobManager->stop();
+        _rtcePoll->stop();
+        for (auto& wt : _workerThreads)
+        {
+            wt->stop();
+        }
+    }
+
+    void waitForClose(Endpoint& endpoint)
+    {
+        for (auto i = 0; i < 1000 && endpoint.getState() == Endpoint::State::STOPPING; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        EXPECT_NE(Endpoint::State::STOPPING, endpoint.getState());
+    }
+};
+
+TEST_F(UdpEndpointTest, reusePortQueuesKeepFlowOrder)
+{
+    const size_t flowCount = 16;
+    const uint16_t packetsPerFlow = 200;
+    const auto localPort = SocketAddress::parse("127.0.0.1", 20300);
+
+    EndpointFactoryImpl endpointFactory;
+    auto endpoint = std::unique_ptr<UdpEndpoint>(
+        endpointFactory.createUdpEndpoint(*_jobManager, 64, *_allocator, localPort, *_rtcePoll, true));
+    ASSERT_TRUE(endpoint->isGood());
+    ASSERT_TRUE(endpoint->configureReceiveQueues(4));
+    ASSERT_TRUE(endpoint->configureBufferSizes(512 * 1024, 2 * 1024 * 1024));
+    EXPECT_FALSE(endpoint->configureReceiveQueues(2));
+
+    std::atomic_uint32_t totalCount(0);
+    std::atomic_uint32_t unregisteredCount(0);
+    std::vector<std::unique_ptr<FlowListener>> listeners;
+    std::vector<std::unique_ptr<RtcSocket>> senders;
+    for (size_t i = 0; i < flowCount; ++i)
+    {
+        const auto sourceAddress = SocketAddress::parse("127.0.0.1", 20310 + i);
+        senders.push_back(std::make_unique<RtcSocket>());
+        ASSERT_EQ(0, senders.back()->open(sourceAddress, sourceAddress.getPort()));
+        listeners.push_back(std::make_unique<FlowListener>(totalCount, unregisteredCount, 0));
+        endpoint->registerListener(sourceAddress, listeners.back().get());
+    }
+    ASSERT_TRUE(waitForRegistration(listeners, utils::Time::sec));
+    endpoint->start();
+
+    for (uint16_t sequenceNumber = 0; sequenceNumber < packetsPerFlow; ++sequenceNumber)
+    {
+        for (size_t i = 0; i < flowCount; ++i)
+        {
+            auto packet = makeRtpPacket(sequenceNumber, i + 1);
+            senders[i]->sendTo(packet.get(), packet.getLength(), localPort);
+        }
+        if (sequenceNumber % 20 == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    EXPECT_TRUE(waitFor(totalCount, flowCount * packetsPerFlow, utils::Time::sec * 5));
+    for (auto& listener : listeners)
+    {
+        EXPECT_EQ(packetsPerFlow, listener->receivedCount);
+        EXPECT_EQ(0, listener->reorderCount);
+    }
+
+    // the endpoint job queues are small so unregister one at a time
+    for (size_t i = 0; i < flowCount; ++i)
+    {
+        endpoint->unregisterListener(listeners[i].get());
+        EXPECT_TRUE(waitFor(unregisteredCount, i + 1, utils::Time::sec));
+    }
+
+    endpoint->stop(nullptr);
+    waitForClose(*endpoint);
+}
+
+// ICE requests keep arriving on all receive queues while the listener is unregistered. Each request makes the
+// listener register its source address from the receive queue, which must neither register it again after it has
+// been removed nor dispatch to it after it was notified.
+TEST_F(UdpEndpointTest, unregisterDuringIceOnReceiveQueues)
+{
+    const size_t flowCount = 16;
+    const uint32_t rounds = 5;
+    const auto localPort = SocketAddress::parse("127.0.0.1", 20500);
+
+    EndpointFactoryImpl endpointFactory;
+    auto endpoint = std::unique_ptr<UdpEndpoint>(
+        endpointFactory.createUdpEndpoint(*_jobManager, 64, *_allocator, localPort, *_rtcePoll, true));
+    ASSERT_TRUE(endpoint->isGood());
+    ASSERT_TRUE(endpoint->configureReceiveQueues(4));
+
+    std::vector<std::unique_ptr<RtcSocket>> senders;
+    for (size_t i = 0; i < flowCount; ++i)
+    {
+        const auto sourceAddress = SocketAddress::parse("127.0.0.1", 20510 + i);
+        senders.push_back(std::make_unique<RtcSocket>());
+        ASSERT_EQ(0, senders.back()->open(sourceAddress, sourceAddress.getPort()));
+    }
+    endpoint->start();
+
+    std::atomic_uint32_t round(0);
+    std::atomic_bool running(true);
+    std::thread sendThread([&]() {
+        for (uint64_t transactionId = 1; running; ++transactionId)
+        {
+            auto packet = makeIceRequest("round" + std::to_string(round.load()) + ":remote", transactionId);
+            for (auto& sender : senders)
+            {
+                sender->sendTo(packet.get(), packet.getLength(), localPort);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+
+    std::vector<std::unique_ptr<IceListener>> listeners;
+    for (uint32_t i = 0; i < rounds; ++i)
+    {
+        listeners.push_back(std::make_unique<IceListener>());
+        auto& listener = *listeners.back();
+        endpoint->registerListener("round" + std::to_string(i), &listener);
+        round = i;
+
+        // one registration for the user name and one per source address
+        EXPECT_TRUE(waitFor(listener.registeredCount, 1 + flowCount, utils::Time::sec * 5));
+        endpoint->unregisterListener(&listener);
+        EXPECT_TRUE(waitFor(listener.unregisteredCount, 1 + flowCount, utils::Time::sec * 5));
+    }
+
+    // requests for the last round keep arriving for a while after it was unregistered
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    running = false;
+    sendThread.join();
+    endpoint->stop(nullptr);
+    waitForClose(*endpoint);
+
+    for (auto& listener : listeners)
+    {
+        EXPECT_GT(listener->iceCount, 0u);
+        EXPECT_EQ(listener->registeredCount.load(), listener->unregisteredCount.load());
+        EXPECT_EQ(0u, listener->lateCallbackCount);
+    }
+}
+
+// Bursts of equally sized packets are coalesced on send and received as super-datagrams if the kernel supports
+// UDP GSO and GRO. Either way every packet must arrive intact and in order.
+TEST_F(UdpEndpointTest, udpOffloadKeepsPacketBoundaries)
+{
+    const auto senderPort = SocketAddress::parse("127.0.0.1", 20400);
+    const auto receiverPort = SocketAddress::parse("127.0.0.1", 20401);
+
+    EndpointFactoryImpl endpointFactory;
+    auto sender = std::unique_ptr<UdpEndpoint>(
+        endpointFactory.createUdpEndpoint(*_jobManager, 64, *_allocator, senderPort, *_rtcePoll, true));
+    auto receiver = std::unique_ptr<UdpEndpoint>(
+        endpointFactory.createUdpEndpoint(*_jobManager, 64, *_allocator, receiverPort, *_rtcePoll, true));
+    ASSERT_TRUE(sender->isGood());
+    ASSERT_TRUE(receiver->isGood());
+    sender->enableUdpOffload();
+    receiver->enableUdpOffload();
+    ASSERT_TRUE(receiver->configureBufferSizes(512 * 1024, 2 * 1024 * 1024));
+
+    std::atomic_uint32_t totalCount(0);
+    std::atomic_uint32_t unregisteredCount(0);
+    FlowListener listener(totalCount, unregisteredCount, 0);
+    receiver->registerListener(senderPort, &listener);
+    sender->start();
+    receiver->start();
+    for (int i = 0; i < 500 && sender->getState() != Endpoint::State::CONNECTED; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(Endpoint::State::CONNECTED, sender->getState());
+
+    uint32_t packetCount = 0;
+    size_t byteCount = 0;
+    for (int burst = 0; burst < 20; ++burst)
+    {
+        for (int i = 0; i < 30; ++i)
+        {
+            const size_t length = (i == 29 ? 700 : 1200 + burst);
+            auto packet = makeRtpPacket(packetCount++, 1, length);
+            byteCount += length;
+            sender->sendTo(receiverPort, memory::makeUniquePacket(*_allocator, packet.get(), packet.getLength()));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    EXPECT_TRUE(waitFor(totalCount, packetCount, utils::Time::sec * 5));
+    EXPECT_EQ(packetCount, listener.receivedCount);
+    EXPECT_EQ(byteCount, listener.receivedBytes);
+    EXPECT_EQ(0, listener.reorderCount);
+
+    receiver->unregisterListener(&listener);
+    EXPECT_TRUE(waitFor(unregisteredCount, 1, utils::Time::sec));
+    sender->stop(nullptr);
+    receiver->stop(nullptr);
+    waitForClose(*sender);
+    waitForClose(*receiver);
+}
+
+// Feeds many flows through the fake network into a shared endpoint where each packet costs a few microseconds to
+// handle, and reports the packet rate with one and with several receive queues.
+TEST_F(UdpEndpointTest, receiveQueueThroughput)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    const size_t flowCount = 64;
+    const uint32_t packetCount = 200000;
+    const uint64_t workNs = 3 * utils::Time::us;
+    const auto localPort = SocketAddress::parse("10.0.0.1", 10000);
+
+    for (uint32_t queueCount : {1u, 2u, 4u})
+    {
+        auto internet = std::make_shared<fakenet::Internet>();
+        emulator::FakeEndpointFactory endpointFactory(internet,
+            [](std::shared_ptr<fakenet::NetworkLink>, const SocketAddress&, const std::string&) {});
+        auto endpoint = std::unique_ptr<UdpEndpoint>(
+            endpointFactory.createUdpEndpoint(*_jobManager, 64, *_allocator, localPort, *_rtcePoll, true));
+        ASSERT_TRUE(endpoint->configureReceiveQueues(queueCount));
+
+        std::atomic_uint32_t totalCount(0);
+        std::atomic_uint32_t unregisteredCount(0);
+        std::vector<std::unique_ptr<FlowListener>> listeners;
+        std::vector<SocketAddress> sources;
+        for (size_t i = 0; i < flowCount; ++i)
+        {
+            sources.push_back(SocketAddress::parse("20.0.0." + std::to_string(1 + i), 5000 + i));
+            listeners.push_back(std::make_unique<FlowListener>(totalCount, unregisteredCount, workNs));
+            endpoint->registerListener(sources.back(), listeners.back().get());
+        }
+        ASSERT_TRUE(waitForRegistration(listeners, utils::Time::sec));
+        endpoint->start();
+
+        const auto start = utils::Time::getAbsoluteTime();
+        for (uint32_t sentCount = 0; sentCount < packetCount;)
+        {
+            // keep the fake network link and its packet pool from overflowing
+            if (sentCount - totalCount.load() < 2048)
+            {
+                for (size_t i = 0; i < 512 && sentCount < packetCount; ++i, ++sentCount)
+                {
+                    const auto flow = sentCount % flowCount;
+                    auto packet = makeRtpPacket(sentCount / flowCount, flow + 1);
+                    internet->sendTo(sources[flow], localPort, packet.get(), packet.getLength(), 0);
+                }
+            }
+            internet->process(utils::Time::getAbsoluteTime());
+        }
+        while (totalCount < packetCount &&
+            utils::Time::diffLT(start, utils::Time::getAbsoluteTime(), utils::Time::sec * 60))
+        {
+            internet->process(utils::Time::getAbsoluteTime());
+            std::this_thread::yield();
+        }
+        const auto duration = utils::Time::diff(start, utils::Time::getAbsoluteTime());
+
+        EXPECT_EQ(packetCount, totalCount.load());
+        for (auto& listener : listeners)
+        {
+            EXPECT_EQ(0, listener->reorderCount);
+        }
+        logger::info("%u receive queues, %u packets in %" PRId64 "ms, %" PRId64 "pps",
+            "UdpEndpointTest",
+            queueCount,
+            totalCount.load(),
+            duration / utils::Time::ms,
+            totalCount.load() * utils::Time::sec / std::max(int64_t(1), duration));
+
+        for (size_t i = 0; i < flowCount; ++i)
+        {
+            endpoint->unregisterListener(listeners[i].get());
+            EXPECT_TRUE(waitFor(unregisteredCount, i + 1, utils::Time::sec));
+        }
+        endpoint->stop(nullptr);
+    }
+}
@@ -1,5 +1,35 @@
 #include "crypto/SslHelper.h"
+#include "logger/Logger.h"
+#include "utils/Time.h"
+#include <cinttypes>
 #include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+// byte at a time, as Crc32 used to do it
+uint32_t referenceCrc(const crypto::Crc32Polynomial& polynomial, const uint8_t* data, size_t length)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i)
+    {
+        crc = polynomial[data[i] ^ (crc & 0xFFu)] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+std::vector<uint8_t> randomData(size_t length)
+{
+    std::mt19937 generator(length);
+    std::vector<uint8_t> data(length);
+    for (auto& value : data)
+    {
+        value = static_cast<uint8_t>(generator());
+    }
+    return data;
+}
+} // namespace
 
 TEST(Crc32, basic)
 {
@@ -10,6 +40,88 @@ TEST(Crc32, basic)
     EXPECT_EQ(crc.compute(), 0xa3830348u);
 }
 
+TEST(Crc32, checkValues)
+{
+    const auto data = reinterpret_cast<const unsigned char*>("123456789");
+
+    crypto::Crc32Polynomial ieee(0x04C11DB7);
+    crypto::Crc32 ieeeCrc(ieee);
+    ieeeCrc.add(data, 9);
+    EXPECT_EQ(0xCBF43926u, ieeeCrc.compute());
+
+    crypto::Crc32Polynomial castagnoli(0x1EDC6F41);
+    crypto::Crc32 castagnoliCrc(castagnoli);
+    castagnoliCrc.add(data, 9);
+    EXPECT_EQ(0xE3069283u, castagnoliCrc.compute());
+}
+
+TEST(Crc32, matchesByteTable)
+{
+    crypto::Crc32Polynomial polynomials[] = {crypto::Crc32Polynomial(0x04C11DB7),
+        crypto::Crc32Polynomial(0x1EDC6F41)};
+    const auto data = randomData(1600);
+
+    for (const auto& polynomial : polynomials)
+    {
+        for (size_t offset = 0; offset < 8; ++offset)
+        {
+            for (size_t length = 0; length < 100; ++length)
+            {
+                crypto::Crc32 crc(polynomial);
+                crc.add(data.data() + offset, length);
+                ASSERT_EQ(referenceCrc(polynomial, data.data() + offset, length), crc.compute());
+            }
+        }
+
+        // in pieces like the sctp checksum is computed
+        crypto::Crc32 crc(polynomial);
+        crc.add(data.data(), 12);
+        crc.add(data.data() + 12, 3);
+        crc.add(data.data() + 15, 1585);
+        EXPECT_EQ(referenceCrc(polynomial, data.data(), data.size()), crc.compute());
+    }
+}
+
+TEST(Crc32Perf, throughput)
+{
+#ifdef NOPERF_TEST
+    GTEST_SKIP();
+#endif
+    crypto::Crc32Polynomial polynomials[] = {crypto::Crc32Polynomial(0x04C11DB7),
+        crypto::Crc32Polynomial(0x1EDC6F41)};
+    const char* names[] = {"crc32", "crc32c"};
+    const auto data = randomData(1200);
+    const int iterations = 100000;
+
+    for (int p = 0; p < 2; ++p)
+    {
+        uint32_t checksum = 0;
+        auto start = utils::Time::getAbsoluteTime();
+        for (int i = 0; i < iterations; ++i)
+        {
+            checksum += referenceCrc(polynomials[p], data.data(), data.size());
+        }
+        const auto referenceTime = utils::Time::getAbsoluteTime() - start;
+
+        start = utils::Time::getAbsoluteTime();
+        for (int i = 0; i < iterations; ++i)
+        {
+            crypto::Crc32 crc(polynomials[p]);
+            crc.add(data.data(), data.size());
+            checksum -= crc.compute();
+        }
+        const auto time = utils::Time::getAbsoluteTime() - start;
+
+        EXPECT_EQ(0u, checksum);
+        logger::info("%s byte table %" PRIu64 " MB/s, now %" PRIu64 " MB/s",
+            "Crc32Perf",
+            names[p],
+            iterations * data.size() * utils::Time::sec / (referenceTime * 1000000),
+            iterations * data.size() * utils::Time::sec / (time * 1000000));
+        EXPECT_LT(time, referenceTime);
+    }
+}
+
 TEST(MD5, msgintegrity)
 {
     const char* userpwd = "user:realm:pass";
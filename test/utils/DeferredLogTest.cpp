@@ -0,0 +1,237 @@
+#include "logger/DeferredFormat.h"
+#include "logger/LoggerThread.h"
+#include "utils/Time.h"
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+__attribute__((format(printf, 3, 4))) bool encode(logger::DeferredLogItem& item,
+    const char* logGroup,
+    const char* format,
+    ...)
+{
+    va_list arglist;
+    va_start(arglist, format);
+    const bool result = logger::encodeArguments(item, logGroup, format, arglist);
+    va_end(arglist);
+    return result;
+}
+
+__attribute__((format(printf, 2, 3))) std::string expected(const char* logGroup, const char* format, ...)
+{
+    char message[1024];
+    const int consumed = snprintf(message, sizeof(message), "[%s] ", logGroup);
+    va_list arglist;
+    va_start(arglist, format);
+    vsnprintf(message + consumed, sizeof(message) - consumed, format, arglist);
+    va_end(arglist);
+    return message;
+}
+
+__attribute__((format(printf, 2, 3))) bool postDeferred(logger::LoggerThread& loggerThread, const char* format, ...)
+{
+    va_list arglist;
+    va_start(arglist, format);
+    const bool result = loggerThread.postDeferred("INFO", "deferred", format, arglist);
+    va_end(arglist);
+    return result;
+}
+
+std::string format(const logger::DeferredLogItem& item)
+{
+    char message[1024];
+    logger::formatMessage(item, message, sizeof(message));
+    return message;
+}
+
+} // namespace
+
+TEST(DeferredLogTest, formatsLikePrintf)
+{
+    logger::DeferredLogItem item;
+    std::string group("Transport-12");
+    char text[] = "temporary";
+    int64_t largeValue = -1234567890123ll;
+    const void* pointer = &item;
+
+    ASSERT_TRUE(encode(item,
+        group.c_str(),
+        "%d %u %ld %lld %zu %" PRIi64 " %x %08X %c %% %5.2f %-10s| %.*s %e %p %hu %Lf",
+        -5,
+        7u,
+        123456789l,
+        -9876543210ll,
+        size_t(42),
+        largeValue,
+        0xbeef,
+        0xcafe,
+        'z',
+        3.14159,
+        text,
+        4,
+        text,
+        1.0e-9,
+        pointer,
+        static_cast<unsigned short>(65535),
+        static_cast<long double>(2.5)));
+
+    // arguments are copied, so later changes do not show
+    group = "changed";
+    text[0] = 'X';
+
+    EXPECT_EQ(expected("Transport-12",
+                  "%d %u %ld %lld %zu %" PRIi64 " %x %08X %c %% %5.2f %-10s| %.*s %e %p %hu %Lf",
+                  -5,
+                  7u,
+                  123456789l,
+                  -9876543210ll,
+                  size_t(42),
+                  largeValue,
+                  0xbeef,
+                  0xcafe,
+                  'z',
+                  3.14159,
+                  "temporary",
+                  4,
+                  "temporary",
+                  1.0e-9,
+                  pointer,
+                  static_cast<unsigned short>(65535),
+                  static_cast<long double>(2.5)),
+        format(item));
+}
+
+TEST(DeferredLogTest, starWidthAndNullString)
+{
+    logger::DeferredLogItem item;
+    const char* nothing = nullptr;
+    ASSERT_TRUE(encode(item, "g", "[%*d] [%-*.*f] %s", 6, 42, 9, 2, 1.005, nothing));
+    EXPECT_EQ(std::string("[g] [    42] [1.00     ] (null)"), format(item));
+}
+
+TEST(DeferredLogTest, rejectsWhatCannotBeDeferred)
+{
+    logger::DeferredLogItem item;
+    const std::string longText(logger::DeferredLogItem::maxArgumentBytes, 'a');
+    EXPECT_FALSE(encode(item, "g", "%s", longText.c_str()));
+
+    int written = 0;
+    EXPECT_FALSE(encode(item, "g", "abc%n", &written));
+}
+
+TEST(DeferredLogTest, loggerThreadWritesAllSources)
+{
+    char fileName[] = "/tmp/deferredlogXXXXXX";
+    const int fd = ::mkstemp(fileName);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+
+    logger::LoggerThread loggerThread(::fopen(fileName, "w"), false, 256, true);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t)
+    {
+        threads.emplace_back([&loggerThread, t]() {
+            for (int i = 0; i < 100; ++i)
+            {
+                if (t == 0)
+                {
+                    // formatted by caller
+                    logger::LogItem textItem;
+                    textItem.timestamp = utils::Time::now();
+                    textItem.logLevel = "INFO";
+                    textItem.threadId = nullptr;
+                    snprintf(textItem.message, logger::LogItem::maxLineLength, "[text] line %d", i);
+                    loggerThread.post(textItem);
+                }
+                else
+                {
+                    EXPECT_TRUE(postDeferred(loggerThread, "thread %d line %d", t, i));
+                }
+                if (i % 10 == 0)
+                {
+                    utils::Time::rawNanoSleep(utils::Time::ms);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    loggerThread.stop();
+
+    std::ifstream logFile(fileName);
+    std::string line;
+    int textCount = 0;
+    int deferredCount[3] = {0};
+    while (std::getline(logFile, line))
+    {
+        int thread = 0;
+        int index = 0;
+        const auto deferredPosition = line.find("[deferred]");
+        if (line.find("[text] line ") != std::string::npos)
+        {
+            ++textCount;
+        }
+        else if (deferredPosition != std::string::npos &&
+            2 == sscanf(line.c_str() + deferredPosition, "[deferred] thread %d line %d", &thread, &index))
+        {
+            ASSERT_LT(thread, 3);
+            EXPECT_EQ(deferredCount[thread]++, index);
+        }
+        else
+        {
+            ADD_FAILURE() << line;
+        }
+    }
+    EXPECT_EQ(100, textCount);
+    EXPECT_EQ(100, deferredCount[1]);
+    EXPECT_EQ(100, deferredCount[2]);
+    ::unlink(fileName);
+}
+
+TEST(DeferredLogTest, exitedThreadsHandBackTheirQueue)
+{
+    char fileName[] = "/tmp/deferredlogXXXXXX";
+    const int fd = ::mkstemp(fileName);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+
+    // more threads over time than there are deferred queues
+    const int threadCount = 1000;
+    logger::LoggerThread loggerThread(::fopen(fileName, "w"), false, 256, true);
+    int deferredCount = 0;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        std::thread thread([&loggerThread, &deferredCount, t]() {
+            if (postDeferred(loggerThread, "thread %d", t))
+            {
+                ++deferredCount;
+            }
+        });
+        thread.join();
+    }
+    loggerThread.stop();
+    EXPECT_EQ(threadCount, deferredCount);
+
+    std::ifstream logFile(fileName);
+    std::string line;
+    int lineCount = 0;
+    while (std::getline(logFile, line))
+    {
+        int thread = -1;
+        const auto deferredPosition = line.find("[deferred]");
+        ASSERT_NE(std::string::npos, deferredPosition);
+        ASSERT_EQ(1, sscanf(line.c_str() + deferredPosition, "[deferred] thread %d", &thread));
+        EXPECT_EQ(lineCount++, thread);
+    }
+    EXPECT_EQ(threadCount, lineCount);
+    ::unlink(fileName);
+}
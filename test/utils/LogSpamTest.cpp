@@ -1,6 +1,11 @@
+#include "logger/LogRateGovernor.h"
+#include "logger/Logger.h"
 #include "logger/PruneSpam.h"
 #include "logger/SuspendSpam.h"
+#include <fstream>
 #include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
 
 TEST(LogSpam, prune)
 {
@@ -33,3 +38,70 @@ TEST(LogSpam, suspend)
 
     EXPECT_EQ(logCount, 40);
 }
+
+TEST(LogSpam, governor)
+{
+    logger::LogRateGovernor governor(5);
+    const char* format1 = "statement %d";
+    const char* format2 = "other statement %d";
+
+    uint32_t logCount = 0;
+    uint32_t suppressedCount = 0;
+    uint64_t timestamp = utils::Time::sec * 100;
+    for (int i = 0; i < 20; ++i)
+    {
+        if (governor.admit(format1, timestamp + i * utils::Time::ms, suppressedCount))
+        {
+            ++logCount;
+            EXPECT_EQ(0, suppressedCount);
+        }
+    }
+    EXPECT_EQ(5, logCount);
+
+    // statements are limited separately
+    EXPECT_TRUE(governor.admit(format2, timestamp, suppressedCount));
+
+    // next second reports what was suppressed
+    EXPECT_TRUE(governor.admit(format1, timestamp + utils::Time::sec, suppressedCount));
+    EXPECT_EQ(15, suppressedCount);
+    EXPECT_TRUE(governor.admit(format1, timestamp + utils::Time::sec, suppressedCount));
+    EXPECT_EQ(0, suppressedCount);
+}
+
+TEST(LogSpam, suppressedNoticesAreNotGoverned)
+{
+    char fileName[] = "/tmp/governedlogXXXXXX";
+    const int fd = ::mkstemp(fileName);
+    ASSERT_GE(fd, 0);
+    ::close(fd);
+
+    logger::stop();
+    logger::setup(fileName, false, logger::Level::DBG, 1024, false, 1);
+
+    // both statements are suppressed in the same second and both notices share one format
+    utils::Time::nanoSleep(utils::Time::sec - utils::Time::getAbsoluteTime() % utils::Time::sec);
+    for (int i = 0; i < 3; ++i)
+    {
+        logger::info("first %d", "LogSpam", i);
+        logger::info("second %d", "LogSpam", i);
+    }
+    utils::Time::nanoSleep(utils::Time::sec - utils::Time::getAbsoluteTime() % utils::Time::sec);
+    logger::info("first %d", "LogSpam", 3);
+    logger::info("second %d", "LogSpam", 3);
+
+    logger::stop();
+    logger::setup("./smb_unit_test.log", true, logger::Level::DBG, 32 * 1024);
+
+    std::ifstream logFile(fileName);
+    std::string line;
+    int noticeCount = 0;
+    while (std::getline(logFile, line))
+    {
+        if (line.find("suppressed 2 lines") != std::string::npos)
+        {
+            ++noticeCount;
+        }
+    }
+    EXPECT_EQ(2, noticeCount);
+    ::unlink(fileName);
+}
@@ -0,0 +1,190 @@
+#include "logger/PacketLogger.h"
+#include "memory/Packet.h"
+#include "rtp/RtpHeader.h"
+#include "utils/Time.h"
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+memory::Packet makeRtpPacket(uint16_t sequenceNumber, uint32_t ssrc)
+{
+    memory::Packet packet;
+    auto rtpHeader = rtp::RtpHeader::create(packet);
+    rtpHeader->payloadType = 100;
+    rtpHeader->sequenceNumber = sequenceNumber;
+    rtpHeader->ssrc = ssrc;
+    packet.setLength(160);
+    return packet;
+}
+
+std::vector<logger::PacketLogItem> readLog(const std::string& fileName)
+{
+    std::vector<logger::PacketLogItem> items;
+    auto file = ::fopen(fileName.c_str(), "r");
+    if (!file)
+    {
+        return items;
+    }
+
+    logger::PacketLogReader reader(file);
+    logger::PacketLogItem item;
+    while (reader.getNext(item))
+    {
+        items.push_back(item);
+    }
+    return items;
+}
+
+class PacketLogTest : public ::testing::Test
+{
+    void SetUp() override
+    {
+        char directory[] = "/tmp/packetlogXXXXXX";
+        ASSERT_NE(nullptr, ::mkdtemp(directory));
+        _directory = directory;
+    }
+
+    void TearDown() override
+    {
+        const auto command = "rm -rf " + _directory;
+        EXPECT_EQ(0, ::system(command.c_str()));
+    }
+
+protected:
+    std::string _directory;
+};
+} // namespace
+
+TEST_F(PacketLogTest, rotatesWhenFull)
+{
+    const size_t fileSize = sizeof(logger::PacketLogHeader) + 10 * sizeof(logger::PacketLogItem);
+    logger::PacketLogService service(_directory, fileSize);
+    ASSERT_EQ(10, service.getMaxRecordCount());
+
+    const auto logId = service.openLog("transport1");
+    ASSERT_NE(0, logId);
+    for (uint16_t i = 0; i < 25; ++i)
+    {
+        service.post(logId, makeRtpPacket(i, 4711), 1000 + i);
+    }
+    service.closeLog(logId);
+    service.flush();
+
+    const auto previous = readLog(_directory + "/transport1.1");
+    ASSERT_EQ(10, previous.size());
+    for (uint16_t i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(10 + i, previous[i].sequenceNumber);
+        EXPECT_EQ(1010 + i, previous[i].receiveTimestamp);
+        EXPECT_EQ(4711, previous[i].ssrc);
+        EXPECT_EQ(160, previous[i].size);
+    }
+
+    const auto current = readLog(_directory + "/transport1");
+    ASSERT_EQ(5, current.size());
+    EXPECT_EQ(20, current.front().sequenceNumber);
+    EXPECT_EQ(24, current.back().sequenceNumber);
+}
+
+TEST_F(PacketLogTest, recordsFromManyThreads)
+{
+    logger::PacketLogService service(_directory, 1024 * 1024);
+
+    std::vector<uint32_t> logIds;
+    for (int i = 0; i < 4; ++i)
+    {
+        logIds.push_back(service.openLog("transport" + std::to_string(i)));
+        ASSERT_NE(0, logIds.back());
+    }
+
+    // each thread posts to every log, so every log is fed from several thread buffers
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&service, &logIds, t]() {
+            for (uint16_t i = 0; i < 1000; ++i)
+            {
+                for (auto logId : logIds)
+                {
+                    service.post(logId, makeRtpPacket(i, t), i);
+                }
+                if (i % 100 == 0)
+                {
+                    utils::Time::nanoSleep(utils::Time::ms);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    service.stop();
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto items = readLog(_directory + "/transport" + std::to_string(i));
+        ASSERT_EQ(4000, items.size());
+
+        uint16_t nextSequenceNumber[4] = {0};
+        for (auto& item : items)
+        {
+            ASSERT_LT(item.ssrc, 4);
+            EXPECT_EQ(nextSequenceNumber[item.ssrc]++, item.sequenceNumber);
+        }
+    }
+}
+
+TEST_F(PacketLogTest, closedLogIgnoresLatePackets)
+{
+    logger::PacketLogService service(_directory, 1024 * 1024, 1);
+
+    const auto logId = service.openLog("transport1");
+    service.post(logId, makeRtpPacket(1, 1), 1);
+    service.closeLog(logId);
+    service.flush();
+
+    // the slot is reused by the new log
+    const auto nextLogId = service.openLog("transport2");
+    ASSERT_NE(0, nextLogId);
+    EXPECT_NE(logId, nextLogId);
+    EXPECT_EQ(0, service.openLog("transport3"));
+
+    service.post(logId, makeRtpPacket(2, 1), 2);
+    service.post(nextLogId, makeRtpPacket(3, 2), 3);
+    service.stop();
+
+    EXPECT_EQ(1, readLog(_directory + "/transport1").size());
+    const auto items = readLog(_directory + "/transport2");
+    ASSERT_EQ(1, items.size());
+    EXPECT_EQ(3, items[0].sequenceNumber);
+}
+
+TEST_F(PacketLogTest, readsHeaderlessLog)
+{
+    const auto fileName = _directory + "/legacy";
+    auto file = ::fopen(fileName.c_str(), "w");
+    ASSERT_NE(nullptr, file);
+    for (uint16_t i = 0; i < 3; ++i)
+    {
+        logger::PacketLogItem item(makeRtpPacket(i, 5), i);
+        ::fwrite(&item, sizeof(item), 1, file);
+    }
+    ::fclose(file);
+
+    logger::PacketLogReader reader(::fopen(fileName.c_str(), "r"));
+    logger::PacketLogItem item;
+    uint32_t count = 0;
+    while (reader.getNext(item))
+    {
+        EXPECT_EQ(count++, item.sequenceNumber);
+    }
+    EXPECT_EQ(3, count);
+
+    reader.rewind();
+    EXPECT_TRUE(reader.getNext(item));
+    EXPECT_EQ(0, item.sequenceNumber);
+}
@@ -1,4 +1,5 @@
 #include "transport/BaseUdpEndpoint.h"
+#include <cstring>
 
 namespace transport
 {
@@ -34,6 +35,40 @@ private:
     int _fd;
 };
 
+class UnregisterBarrierJob : public jobmanager::Job
+{
+public:
+    UnregisterBarrierJob(BaseUdpEndpoint& endpoint, Endpoint::IEvents& listener, size_t queueIndex)
+        : _endpoint(endpoint),
+          _listener(listener),
+          _queueIndex(queueIndex)
+    {
+    }
+
+    void run() override { _endpoint.internalUnregisterBarrier(_listener, _queueIndex); }
+
+private:
+    BaseUdpEndpoint& _endpoint;
+    Endpoint::IEvents& _listener;
+    size_t _queueIndex;
+};
+
+class UnregisterNotifyJob : public jobmanager::Job
+{
+public:
+    UnregisterNotifyJob(BaseUdpEndpoint& endpoint, Endpoint::IEvents& listener)
+        : _endpoint(endpoint),
+          _listener(listener)
+    {
+    }
+
+    void run() override { _listener.onUnregistered(_endpoint); }
+
+private:
+    BaseUdpEndpoint& _endpoint;
+    Endpoint::IEvents& _listener;
+};
+
 class StopPortJob : public jobmanager::Job
 {
 public:
@@ -66,14 +101,16 @@ BaseUdpEndpoint::BaseUdpEndpoint(const char* name,
     : _state(Endpoint::CLOSED),
       _name(name),
       _localPort(localPort),
-      _receiveJobs(jobManager, 16),
+      _receiveJobs(jobManager, isShared ? 256 : 16),
       _sendJobs(jobManager, 16),
       _allocator(allocator),
       _sendQueue(maxSessionCount * 256),
       _epoll(epoll),
       _epollCountdown(2),
       _isShared(isShared),
-      _defaultListener(nullptr)
+      _defaultListener(nullptr),
+      _jobManager(jobManager),
+      _unregisteringListeners(maxSessionCount * 2)
 {
     _pendingRead.clear();
     _pendingSend.clear();
@@ -213,11 +250,18 @@ void BaseUdpEndpoint::stop(Endpoint::IStopEvents* listener)
     {
         _stopListener = listener;
         _state = Endpoint::State::STOPPING;
-        _epollCountdown = 2;
+        _epollCountdown = 2 + _receiveQueues.size();
         if (!_epoll.remove(_socket.fd(), this))
         {
             logger::error("Failed to request epoll unregistration", _name.c_str());
         }
+        for (auto& receiveQueue : _receiveQueues)
+        {
+            if (!_epoll.remove(receiveQueue->socket.fd(), this))
+            {
+                logger::error("Failed to request epoll unregistration", _name.c_str());
+            }
+        }
     }
 }
 
@@ -231,6 +275,16 @@ void BaseUdpEndpoint::onSocketPollStarted(int fd)
 
 void BaseUdpEndpoint::onSocketPollStopped(int fd)
 {
+    auto* receiveQueue = findReceiveQueue(fd);
+    if (receiveQueue)
+    {
+        if (!receiveQueue->jobs.addJob<StopPortJob>(*this, _epollCountdown))
+        {
+            logger::error("failed to add poll stop job", _name.c_str());
+        }
+        return;
+    }
+
     if (!_receiveJobs.addJob<StopPortJob>(*this, _epollCountdown))
     {
         logger::error("failed to add poll stop job", _name.c_str());
@@ -243,6 +297,19 @@ void BaseUdpEndpoint::onSocketPollStopped(int fd)
 
 void BaseUdpEndpoint::onSocketReadable(int fd)
 {
+    auto* receiveQueue = findReceiveQueue(fd);
+    if (receiveQueue)
+    {
+        if (!receiveQueue->pendingRead.test_and_set())
+        {
+            if (!receiveQueue->jobs.addJob<ReceiveJob>(*this, fd))
+            {
+                logger::warn("receive queue full", _name.c_str());
+            }
+        }
+        return;
+    }
+
     if (!_pendingRead.test_and_set())
     {
         if (!_receiveJobs.addJob<ReceiveJob>(*this, fd))
@@ -254,7 +321,75 @@ void BaseUdpEndpoint::onSocketReadable(int fd)
 
 EndpointMetrics BaseUdpEndpoint::getMetrics(uint64_t timestamp) const
 {
-    return _rateMetrics.toEndpointMetrics(_sendQueue.size());
+    double receiveRate = 0;
+    for (auto& receiveQueue : _receiveQueues)
+    {
+        receiveRate += receiveQueue->receiveTracker.snapshot.load();
+    }
+    return _rateMetrics.toEndpointMetrics(_sendQueue.size(), receiveRate);
+}
+
+BaseUdpEndpoint::ReceiveQueue* BaseUdpEndpoint::findReceiveQueue(const int fd)
+{
+    for (auto& receiveQueue : _receiveQueues)
+    {
+        if (receiveQueue->socket.fd() == fd)
+        {
+            return receiveQueue.get();
+        }
+    }
+    return nullptr;
+}
+
+// Listeners are removed from the routing tables on _receiveJobs. With multiple receive queues another queue may
+// still be dispatching to the listener, so the notification has to pass all of them first. It then returns to
+// _receiveJobs, where registrations posted by those dispatches are run, before the listener is notified.
+void BaseUdpEndpoint::notifyUnregistered(IEvents& listener)
+{
+    if (_receiveQueues.empty())
+    {
+        _receiveJobs.addJob<UnregisterNotifyJob>(*this, listener);
+        return;
+    }
+
+    auto it = _unregisteringListeners.find(&listener);
+    if (it != _unregisteringListeners.end())
+    {
+        ++it->second;
+    }
+    else if (!_unregisteringListeners.emplace(&listener, 1).second)
+    {
+        logger::error("unregistering listener table is full", _name.c_str());
+    }
+
+    if (!_receiveQueues[0]->jobs.addJob<UnregisterBarrierJob>(*this, listener, 0))
+    {
+        logger::error("failed to post unregister job", _name.c_str());
+    }
+}
+
+// Runs on receive queue queueIndex and passes on to the next one. Any packet dispatched to the listener before it
+// was removed from the routing tables has been processed once the last queue is passed. Index
+// _receiveQueues.size() is the final step on _receiveJobs.
+void BaseUdpEndpoint::internalUnregisterBarrier(IEvents& listener, const size_t queueIndex)
+{
+    if (queueIndex == _receiveQueues.size())
+    {
+        auto it = _unregisteringListeners.find(&listener);
+        if (it != _unregisteringListeners.end() && --it->second == 0)
+        {
+            _unregisteringListeners.erase(&listener);
+        }
+        listener.onUnregistered(*this);
+        return;
+    }
+
+    const auto nextIndex = queueIndex + 1;
+    auto& nextQueue = (nextIndex == _receiveQueues.size() ? _receiveJobs : _receiveQueues[nextIndex]->jobs);
+    if (!nextQueue.addJob<UnregisterBarrierJob>(*this, listener, nextIndex))
+    {
+        logger::error("failed to post unregister job", _name.c_str());
+    }
 }
 
 namespace
@@ -305,7 +440,17 @@ void BaseUdpEndpoint::internalReceive(const int fd, const uint32_t batchSize)
 
     const int flags = MSG_DONTWAIT;
 
-    _pendingRead.clear(); // one extra job may be added after us
+    auto* receiveQueue = findReceiveQueue(fd);
+    auto& receiveTracker = (receiveQueue ? receiveQueue->receiveTracker : _rateMetrics.receiveTracker);
+    auto& pendingRead = (receiveQueue ? receiveQueue->pendingRead : _pendingRead);
+
+    pendingRead.clear(); // one extra job may be added after us
+    if ((receiveQueue ? receiveQueue->socket : _socket).isReceiveCoalescing())
+    {
+        receiveCoalesced(fd, receiveTracker);
+        return;
+    }
+
     uint32_t packetCount = 0;
     uint32_t limit = 1;
     while (true)
@@ -327,7 +472,7 @@ void BaseUdpEndpoint::internalReceive(const int fd, const uint32_t batchSize)
         if (packetCount == 1)
         {
             ssize_t byteCount = ::recvmsg(fd, &messageHeader[0].msg_hdr, flags);
-            _rateMetrics.receiveTracker.update(byteCount, utils::Time::getAbsoluteTime());
+            receiveTracker.update(byteCount, utils::Time::getAbsoluteTime());
             if (byteCount <= 0)
             {
                 break;
@@ -359,7 +504,7 @@ void BaseUdpEndpoint::internalReceive(const int fd, const uint32_t batchSize)
             const auto receiveTime = utils::Time::getAbsoluteTime();
             for (int i = 0; i < count; ++i)
             {
-                _rateMetrics.receiveTracker.update(messageHeader[i].msg_len, receiveTime);
+                receiveTracker.update(messageHeader[i].msg_len, receiveTime);
                 if (messageHeader[i].msg_len < memory::Packet::size)
                 {
                     receiveMessage[i].packet->setLength(messageHeader[i].msg_len);
@@ -389,6 +534,135 @@ void BaseUdpEndpoint::internalReceive(const int fd, const uint32_t batchSize)
     }
 }
 
+#ifndef __APPLE__
+namespace
+{
+const uint32_t coalescedBatchSize = 8;
+const size_t coalescedBufferSize = 64 * 1024;
+
+// Super-datagrams do not fit in packets. They are received into a buffer per worker thread and split from there.
+thread_local std::unique_ptr<uint8_t[]> coalescedReceiveBuffer;
+
+struct CoalescedMessage
+{
+    transport::RawSockAddress src_addr;
+    iovec iobuffer;
+    union
+    {
+        char buffer[CMSG_SPACE(sizeof(int))];
+        cmsghdr align;
+    } control;
+
+    void link(mmsghdr& header, uint8_t* buffer)
+    {
+        iobuffer.iov_base = buffer;
+        iobuffer.iov_len = coalescedBufferSize;
+
+        header.msg_hdr.msg_control = control.buffer;
+        header.msg_hdr.msg_controllen = sizeof(control.buffer);
+        header.msg_hdr.msg_flags = 0;
+        header.msg_hdr.msg_iov = &iobuffer;
+        header.msg_hdr.msg_iovlen = 1;
+        header.msg_hdr.msg_name = &src_addr;
+        header.msg_hdr.msg_namelen = sizeof(src_addr);
+
+        header.msg_len = 0;
+    }
+
+    size_t getSegmentSize(msghdr& header, size_t length)
+    {
+        for (auto* cmsg = CMSG_FIRSTHDR(&header); cmsg; cmsg = CMSG_NXTHDR(&header, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+            {
+                int segmentSize = 0;
+                std::memcpy(&segmentSize, CMSG_DATA(cmsg), sizeof(segmentSize));
+                return segmentSize > 0 ? segmentSize : length;
+            }
+        }
+        return length;
+    }
+};
+} // namespace
+#endif
+
+// Each received datagram may hold several segments of equal size, the last one possibly shorter.
+void BaseUdpEndpoint::receiveCoalesced(const int fd, RateTracker& receiveTracker)
+{
+#ifndef __APPLE__
+    if (!coalescedReceiveBuffer)
+    {
+        coalescedReceiveBuffer.reset(new uint8_t[coalescedBatchSize * coalescedBufferSize]);
+    }
+
+    CoalescedMessage receiveMessage[coalescedBatchSize];
+    mmsghdr messageHeader[coalescedBatchSize];
+    for (bool depleted = false; !depleted;)
+    {
+        for (uint32_t i = 0; i < coalescedBatchSize; ++i)
+        {
+            receiveMessage[i].link(messageHeader[i], coalescedReceiveBuffer.get() + i * coalescedBufferSize);
+        }
+
+        const auto count = ::recvmmsg(fd, messageHeader, coalescedBatchSize, MSG_DONTWAIT, nullptr);
+        if (count <= 0)
+        {
+            break;
+        }
+
+        const auto receiveTime = utils::Time::getAbsoluteTime();
+        for (int i = 0; i < count && !depleted; ++i)
+        {
+            auto& header = messageHeader[i].msg_hdr;
+            const size_t length = messageHeader[i].msg_len;
+            receiveTracker.update(length, receiveTime);
+            if (header.msg_flags & MSG_TRUNC)
+            {
+                continue;
+            }
+
+            const auto segmentSize = receiveMessage[i].getSegmentSize(header, length);
+            const SocketAddress source(&receiveMessage[i].src_addr.gen, nullptr);
+            const auto* data = reinterpret_cast<const uint8_t*>(receiveMessage[i].iobuffer.iov_base);
+            for (size_t offset = 0; offset < length; offset += segmentSize)
+            {
+                const auto packetLength = std::min(segmentSize, length - offset);
+                if (packetLength >= memory::Packet::size)
+                {
+                    continue; // Attack with Jumbo frame. Discard
+                }
+
+                auto packet = memory::makeUniquePacket(_allocator, data + offset, packetLength);
+                if (!packet)
+                {
+                    logger::warn("cannot receive, packet allocator depleted",
+                        _socket.getBoundPort().toString().c_str());
+                    depleted = true;
+                    break;
+                }
+                dispatchReceivedPacket(source, std::move(packet));
+            }
+        }
+    }
+#endif
+}
+
+bool BaseUdpEndpoint::enableUdpOffload()
+{
+    const bool sendSegmentation = _socket.enableSendSegmentation();
+    bool receiveCoalescing = _socket.enableReceiveCoalescing();
+    for (auto& receiveQueue : _receiveQueues)
+    {
+        receiveCoalescing &= receiveQueue->socket.enableReceiveCoalescing();
+    }
+
+    logger::info("UDP offload, segmentation %s, coalescing %s",
+        _name.c_str(),
+        sendSegmentation ? "on" : "off",
+        receiveCoalescing ? "on" : "off");
+    return sendSegmentation || receiveCoalescing;
+}
+
 // used when routing is not possible and there is a single owner of the endpoint
 void BaseUdpEndpoint::registerDefaultListener(IEvents* defaultListener)
 {
@@ -402,12 +676,67 @@ void BaseUdpEndpoint::start()
     {
         _state = Endpoint::State::CONNECTING;
         _epoll.add(_socket.fd(), this);
+        for (auto& receiveQueue : _receiveQueues)
+        {
+            _epoll.add(receiveQueue->socket.fd(), this);
+        }
     }
 }
 
 bool BaseUdpEndpoint::configureBufferSizes(size_t sendBufferSize, size_t receiveBufferSize)
 {
-    return (0 == _socket.setSendBuffer(sendBufferSize)) && (0 == _socket.setReceiveBuffer(receiveBufferSize));
+    bool success = (0 == _socket.setSendBuffer(sendBufferSize)) && (0 == _socket.setReceiveBuffer(receiveBufferSize));
+    for (auto& receiveQueue : _receiveQueues)
+    {
+        success &= (0 == receiveQueue->socket.setReceiveBuffer(receiveBufferSize));
+    }
+    return success;
+}
+
+// SO_REUSEPORT is enabled on the bound socket and count - 1 sockets join it on the same port. The port is never
+// released in between. Sending is always done on the first socket.
+bool BaseUdpEndpoint::configureReceiveQueues(const uint32_t count)
+{
+    if (_state != Endpoint::State::CREATED || !_receiveQueues.empty())
+    {
+        return false;
+    }
+    if (count <= 1)
+    {
+        return true;
+    }
+
+    const auto port = _localPort.getPort();
+    const auto reuseResult = _socket.setReusePort(true);
+    if (reuseResult != 0)
+    {
+        logger::error("failed to enable SO_REUSEPORT on port %u, %s",
+            _name.c_str(),
+            port,
+            RtcSocket::explain(reuseResult));
+        return false;
+    }
+
+    for (uint32_t i = 1; i < count; ++i)
+    {
+        auto receiveQueue = std::make_unique<ReceiveQueue>(_jobManager);
+        const auto result = receiveQueue->socket.open(_localPort, port, SOCK_DGRAM, true);
+        if (result != 0)
+        {
+            logger::error("failed to open receive queue %u on port %u, %s",
+                _name.c_str(),
+                i,
+                port,
+                RtcSocket::explain(result));
+            _receiveQueues.clear();
+            _socket.setReusePort(false);
+            return false;
+        }
+        _receiveQueues.push_back(std::move(receiveQueue));
+    }
+
+    logger::info("receiving on %u sockets at port %u", _name.c_str(), count, port);
+    return true;
 }
 
 } // namespace transport
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "UdpEndpoint.h"
+#include "concurrency/MpmcHashmap.h"
 #include "concurrency/MpmcQueue.h"
 #include "jobmanager/JobQueue.h"
 #include "memory/PacketPoolAllocator.h"
@@ -8,6 +9,8 @@
 #include "transport/RtcSocket.h"
 #include "transport/RtcePoll.h"
 #include "utils/Trackers.h"
+#include <memory>
+#include <vector>
 
 namespace transport
 {
@@ -32,6 +35,8 @@ public:
     SocketAddress getLocalPort() const override { return _socket.getBoundPort(); }
 
     bool configureBufferSizes(size_t sendBufferSize, size_t receiveBufferSize) override;
+    bool configureReceiveQueues(uint32_t count) override;
+    bool enableUdpOffload() override;
 
     bool isShared() const override { return _isShared; }
 
@@ -53,6 +58,7 @@ public: // internal job interface
     virtual void internalSend();
 
     virtual void internalStopped();
+    void internalUnregisterBarrier(IEvents& listener, size_t queueIndex);
 
 protected:
     std::atomic<Endpoint::State> _state;
@@ -66,24 +72,43 @@ protected:
     void onSocketShutdown(int fd) override {}
     void onSocketWriteable(int fd) override {}
 
+    void notifyUnregistered(IEvents& listener);
+    // true while unregistered notifications to the listener are passing the receive queues
+    bool isUnregistering(IEvents* listener) const { return _unregisteringListeners.contains(listener); }
+
     struct OutboundPacket
     {
         transport::SocketAddress target;
         memory::UniquePacket packet;
     };
 
+    using RateTracker = utils::TrackerWithSnapshot<10, utils::Time::ms * 100, utils::Time::sec>;
+
     struct RateMetrics
     {
-        utils::TrackerWithSnapshot<10, utils::Time::ms * 100, utils::Time::sec> receiveTracker;
-        utils::TrackerWithSnapshot<10, utils::Time::ms * 100, utils::Time::sec> sendTracker;
-        EndpointMetrics toEndpointMetrics(size_t queueSize) const
+        RateTracker receiveTracker;
+        RateTracker sendTracker;
+        EndpointMetrics toEndpointMetrics(size_t queueSize, double additionalReceiveRate) const
         {
             return EndpointMetrics(queueSize,
-                receiveTracker.snapshot.load() * 8 * utils::Time::ms,
+                (receiveTracker.snapshot.load() + additionalReceiveRate) * 8 * utils::Time::ms,
                 sendTracker.snapshot.load() * 8 * utils::Time::ms);
         }
     } _rateMetrics;
 
+    // Additional SO_REUSEPORT socket bound to the same port as _socket. The kernel hashes each flow to a fixed
+    // socket and every socket is drained by its own job queue. Flows are thereby received in parallel while
+    // packets within a flow stay in order.
+    struct ReceiveQueue
+    {
+        explicit ReceiveQueue(jobmanager::JobManager& jobManager) : jobs(jobManager, 16) { pendingRead.clear(); }
+
+        RtcSocket socket;
+        jobmanager::JobQueue jobs;
+        std::atomic_flag pendingRead = ATOMIC_FLAG_INIT;
+        RateTracker receiveTracker;
+    };
+
     jobmanager::JobQueue _receiveJobs;
     jobmanager::JobQueue _sendJobs;
     memory::PacketPoolAllocator& _allocator;
@@ -98,5 +123,13 @@ protected:
     std::atomic_flag _isFull = ATOMIC_FLAG_INIT;
 
     std::atomic<IEvents*> _defaultListener;
+    std::vector<std::unique_ptr<ReceiveQueue>> _receiveQueues;
+    jobmanager::JobManager& _jobManager;
+    // pending unregistered notifications per listener, used on _receiveJobs only
+    concurrency::MpmcHashmap32<IEvents*, uint32_t> _unregisteringListeners;
+
+private:
+    ReceiveQueue* findReceiveQueue(int fd);
+    void receiveCoalesced(int fd, RateTracker& receiveTracker);
 };
 } // namespace transport
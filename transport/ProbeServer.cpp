@@ -24,6 +24,7 @@ ProbeServer::ProbeServer(const ice::IceConfig& iceConfig, const config::Config&
     ice::IceSession::generateCredentialString(_idGenerator, pwd, sizeof(pwd) - 1);
 
     _credentials = std::make_pair<std::string, std::string>(ufrag, pwd);
+    _hmac = std::make_unique<crypto::HMAC>(_credentials.second.c_str(), _credentials.second.size());
 }
 
 // Endpoint::IEvents
@@ -255,13 +256,13 @@ void ProbeServer::replyStunOk(Endpoint& endpoint, const SocketAddress& destinati
     auto* stunMessage = ice::StunMessage::fromPtr(data);
 
     if (stunMessage && stunMessage->isValid() && stunMessage->header.isRequest() &&
-        stunMessage->isAuthentic(_credentials.second))
+        stunMessage->isAuthentic(*_hmac))
     {
         ice::StunMessage response;
         response.header.transactionId = stunMessage->header.transactionId;
         response.header.setMethod(ice::StunHeader::BindingResponse);
         response.add(ice::StunXorMappedAddress(destination, response.header));
-        response.addMessageIntegrity(_credentials.second);
+        response.addMessageIntegrity(*_hmac);
         response.addFingerprint();
 
         endpoint.sendStunTo(destination, response.header.transactionId.get(), &response, response.size(), timestamp);
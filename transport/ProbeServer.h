@@ -1,5 +1,6 @@
 #pragma once
 #include "concurrency/MpmcQueue.h"
+#include "crypto/SslHelper.h"
 #include "ice/IceCandidate.h"
 #include "ice/Stun.h"
 #include "transport/Endpoint.h"
@@ -63,6 +64,7 @@ public:
 
 private:
     std::pair<std::string, std::string> _credentials;
+    std::unique_ptr<crypto::HMAC> _hmac; // keyed with the pwd, cloned per STUN message
     const ice::IceConfig& _iceConfig;
     const config::Config& _config;
     ice::StunTransactionIdGenerator _idGenerator;
@@ -1,6 +1,7 @@
 #include "RtcSocket.h"
 
 #include "utils/StdExtensions.h"
+#include <cstring>
 #include <errno.h>
 #include <fcntl.h>
 #include <ifaddrs.h>
@@ -11,6 +12,7 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
+
 namespace transport
 {
 void RtcSocket::Message::add(const void* data, size_t len)
@@ -21,9 +23,23 @@ void RtcSocket::Message::add(const void* data, size_t len)
     ++fragmentCount;
 }
 
-RtcSocket::RtcSocket() : _boundPort(SocketAddress::parse("0.0.0.0")), _fd(-1), _type(SOCK_DGRAM) {}
+RtcSocket::RtcSocket()
+    : _boundPort(SocketAddress::parse("0.0.0.0")),
+      _fd(-1),
+      _type(SOCK_DGRAM),
+      _sendSegmentation(false),
+      _receiveCoalescing(false)
+{
+}
 
-RtcSocket::RtcSocket(int fd, const SocketAddress& localPort) : _boundPort(localPort), _fd(fd), _type(SOCK_STREAM) {}
+RtcSocket::RtcSocket(int fd, const SocketAddress& localPort)
+    : _boundPort(localPort),
+      _fd(fd),
+      _type(SOCK_STREAM),
+      _sendSegmentation(false),
+      _receiveCoalescing(false)
+{
+}
 
 RtcSocket::~RtcSocket()
 {
@@ -42,9 +58,11 @@ void RtcSocket::close()
         ::close(_fd);
         _fd = -1;
     }
+    _sendSegmentation = false;
+    _receiveCoalescing = false;
 }
 
-int RtcSocket::open(const SocketAddress& address, uint16_t port, int socketType)
+int RtcSocket::open(const SocketAddress& address, uint16_t port, int socketType, bool reusePort)
 {
     close();
     _type = socketType;
@@ -63,7 +81,7 @@ int RtcSocket::open(const SocketAddress& address, uint16_t port, int socketType)
     {
         flags = 0;
     }
-    if (socketType == SOCK_STREAM)
+    if (socketType == SOCK_STREAM || reusePort)
     {
         int val = 1;
         ::setsockopt(_fd, SOL_SOCKET, SO_REUSEPORT, &val, sizeof(val));
@@ -171,6 +189,42 @@ int RtcSocket::setReceiveBuffer(uint32_t size)
     return 0;
 }
 
+int RtcSocket::setReusePort(const bool enable)
+{
+    int val = enable ? 1 : 0;
+    if (0 != ::setsockopt(_fd, SOL_SOCKET, SO_REUSEPORT, &val, sizeof(val)))
+    {
+        return errno;
+    }
+    return 0;
+}
+
+// Kernels before 4.18 reject the option and the socket keeps sending one datagram per message
+bool RtcSocket::enableSendSegmentation()
+{
+#ifdef __APPLE__
+    return false;
+#else
+    int segmentSize = 0;
+    _sendSegmentation = (_type == SOCK_DGRAM && isGood() &&
+        0 == ::setsockopt(_fd, SOL_UDP, UDP_SEGMENT, &segmentSize, sizeof(segmentSize)));
+    return _sendSegmentation;
+#endif
+}
+
+// Kernels before 5.0 reject the option and datagrams are received one by one
+bool RtcSocket::enableReceiveCoalescing()
+{
+#ifdef __APPLE__
+    return false;
+#else
+    int enable = 1;
+    _receiveCoalescing =
+        (_type == SOCK_DGRAM && isGood() && 0 == ::setsockopt(_fd, SOL_UDP, UDP_GRO, &enable, sizeof(enable)));
+    return _receiveCoalescing;
+#endif
+}
+
 bool RtcSocket::isGood() const
 {
     return _fd != -1;
@@ -304,6 +358,11 @@ int RtcSocket::sendMultiple(Message* messages, const size_t count)
     return errorCount;
 
 #else
+    if (_sendSegmentation)
+    {
+        return sendSegmented(messages, count);
+    }
+
     mmsghdr items[count];
     const auto addressSize = static_cast<socklen_t>(messages[0].target->getSockAddrSize());
     for (size_t i = 0; i < count; ++i)
@@ -352,6 +411,135 @@ int RtcSocket::sendMultiple(Message* messages, const size_t count)
     return errorCount;
 }
 
+#ifndef __APPLE__
+namespace
+{
+union SegmentControl
+{
+    char buffer[CMSG_SPACE(sizeof(uint16_t))];
+    cmsghdr align;
+};
+
+bool isSameTarget(const RtcSocket::Message& a, const RtcSocket::Message& b)
+{
+    return a.target == b.target || *a.target == *b.target;
+}
+} // namespace
+
+// Runs of consecutive messages to the same target where all but the last have the same length are sent as one
+// datagram that the kernel, or the NIC, splits into segments. A failed segmented send marks all messages in the run.
+// If the device cannot segment, the kernel reports EIO and the socket falls back to plain sendmmsg.
+int RtcSocket::sendSegmented(Message* messages, const size_t count)
+{
+    mmsghdr items[count];
+    SegmentControl controls[count];
+    iovec fragments[count * std::size(messages[0].fragments)];
+    size_t firstMessage[count + 1];
+
+    const auto addressSize = static_cast<socklen_t>(messages[0].target->getSockAddrSize());
+    size_t itemCount = 0;
+    size_t fragmentCursor = 0;
+    for (size_t i = 0; i < count; ++itemCount)
+    {
+        const auto segmentSize = messages[i].getLength();
+        size_t runLength = 1;
+        size_t runBytes = segmentSize;
+        while (segmentSize > 0 && i + runLength < count && runLength < maxSegmentCount &&
+            isSameTarget(messages[i], messages[i + runLength]))
+        {
+            const auto length = messages[i + runLength].getLength();
+            if (length == 0 || length > segmentSize || runBytes + length > maxSegmentedLength)
+            {
+                break;
+            }
+            runBytes += length;
+            ++runLength;
+            if (length < segmentSize)
+            {
+                break; // only the last segment may be shorter
+            }
+        }
+
+        msghdr& header = items[itemCount].msg_hdr;
+        header.msg_name = const_cast<sockaddr*>(messages[i].target->getSockAddr());
+        header.msg_namelen = addressSize;
+        header.msg_iov = &fragments[fragmentCursor];
+        header.msg_iovlen = 0;
+        for (size_t m = i; m < i + runLength; ++m)
+        {
+            for (int f = 0; f < messages[m].fragmentCount; ++f)
+            {
+                fragments[fragmentCursor++] = messages[m].fragments[f];
+                ++header.msg_iovlen;
+            }
+        }
+
+        header.msg_control = nullptr;
+        header.msg_controllen = 0;
+        if (runLength > 1)
+        {
+            header.msg_control = controls[itemCount].buffer;
+            header.msg_controllen = sizeof(controls[itemCount].buffer);
+            auto* control = CMSG_FIRSTHDR(&header);
+            control->cmsg_level = SOL_UDP;
+            control->cmsg_type = UDP_SEGMENT;
+            control->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            const auto segmentSize16 = static_cast<uint16_t>(segmentSize);
+            std::memcpy(CMSG_DATA(control), &segmentSize16, sizeof(segmentSize16));
+        }
+        header.msg_flags = 0;
+        items[itemCount].msg_len = 0;
+
+        firstMessage[itemCount] = i;
+        i += runLength;
+    }
+    firstMessage[itemCount] = count;
+
+    int errorCount = 0;
+    const int maxSendAttempts = 2;
+    int attemptsLeft = maxSendAttempts;
+    for (size_t sendCursor = 0; sendCursor < itemCount;)
+    {
+        const auto remainingCount = itemCount - sendCursor;
+        int rc = ::sendmmsg(_fd, items + sendCursor, remainingCount, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (rc == static_cast<int>(remainingCount))
+        {
+            return errorCount;
+        }
+        else if (rc < 0)
+        {
+            const int errorCode = errno;
+            if (--attemptsLeft > 0 && (errorCode == EAGAIN || errorCode == EWOULDBLOCK))
+            {
+                continue;
+            }
+
+            const auto messageCursor = firstMessage[sendCursor];
+            const auto messageCount = firstMessage[sendCursor + 1] - messageCursor;
+            if (errorCode == EIO && messageCount > 1)
+            {
+                _sendSegmentation = false;
+                return errorCount + sendMultiple(messages + messageCursor, count - messageCursor);
+            }
+
+            for (size_t m = messageCursor; m < messageCursor + messageCount; ++m)
+            {
+                messages[m].errorCode = errorCode;
+            }
+            errorCount += messageCount;
+            ++sendCursor;
+            attemptsLeft = maxSendAttempts;
+            continue;
+        }
+
+        sendCursor += std::max(1, rc);
+        attemptsLeft = maxSendAttempts;
+    }
+
+    return errorCount;
+}
+#endif
+
 int RtcSocket::listen(int backlog)
 {
     return ::listen(_fd, backlog);
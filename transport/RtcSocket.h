@@ -2,6 +2,19 @@
 #include "utils/SocketAddress.h"
 #include <sys/socket.h>
 
+#ifndef __APPLE__
+#include <netinet/udp.h>
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
 namespace transport
 {
 
@@ -37,7 +50,7 @@ public:
     void detachHandle();
     void close();
 
-    int open(const SocketAddress& address, uint16_t port, int socketType = SOCK_DGRAM);
+    int open(const SocketAddress& address, uint16_t port, int socketType = SOCK_DGRAM, bool reusePort = false);
 
     int listen(int backlog);
     int accept(RtcSocket& serverSocket, SocketAddress& peerAddress);
@@ -47,6 +60,14 @@ public:
     bool isGood() const;
     int setSendBuffer(uint32_t size);
     int setReceiveBuffer(uint32_t size);
+    // SO_REUSEPORT on a bound socket lets sockets bound later with reusePort join its port
+    int setReusePort(bool enable);
+
+    // UDP_SEGMENT. sendMultiple coalesces consecutive equally sized datagrams to the same target into one send.
+    bool enableSendSegmentation();
+    // UDP_GRO. Received datagrams may be super-datagrams that must be split at the segment size.
+    bool enableReceiveCoalescing();
+    bool isReceiveCoalescing() const { return _receiveCoalescing; }
 
     int sendTo(const void* buffer, size_t length, const SocketAddress& target);
     int sendAggregate(const void* buf0,
@@ -70,15 +91,22 @@ public:
 
     static const char* explain(int errorCode);
 
+    static const size_t maxSegmentCount = 64;
+    static const size_t maxSegmentedLength = 63 * 1024;
+
 private:
     int sendAggregate(const struct iovec* messages,
         uint16_t messageCount,
         size_t& bytesSent,
         const SocketAddress& target);
 
+    int sendSegmented(Message* messages, size_t count);
+
     SocketAddress _boundPort;
     int _fd;
     int _type;
+    bool _sendSegmentation;
+    bool _receiveCoalescing;
 };
 
 } // namespace transport
@@ -33,6 +33,10 @@ namespace jobmanager
 {
 class JobQueue;
 }
+namespace logger
+{
+class PacketLogService;
+}
 
 namespace transport
 {
@@ -119,7 +123,8 @@ std::shared_ptr<RtcTransport> createTransport(jobmanager::JobManager& jobmanager
     const bwe::RateControllerConfig& rateControllerConfig,
     const Endpoints& rtpEndPoints,
     const Endpoints& rtcpEndPoints,
-    memory::PacketPoolAllocator& allocator);
+    memory::PacketPoolAllocator& allocator,
+    const std::shared_ptr<logger::PacketLogService>& packetLogService);
 
 std::shared_ptr<RtcTransport> createTransport(jobmanager::JobManager& jobmanager,
     SrtpClientFactory& srtpClientFactory,
@@ -137,6 +142,7 @@ std::shared_ptr<RtcTransport> createTransport(jobmanager::JobManager& jobmanager
     size_t expectedInboundStreamCount,
     size_t expectedOutboundStreamCount,
     bool enableUplinkEstimation,
-    bool enableDownlinkEstimation);
+    bool enableDownlinkEstimation,
+    const std::shared_ptr<logger::PacketLogService>& packetLogService);
 
 } // namespace transport
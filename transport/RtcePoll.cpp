@@ -42,6 +42,11 @@ public:
     bool remove(int fd, RtcePoll::IEventListener* listener) override;
     bool isRunning() const override { return _running; }
 
+    bool setCpuAffinity(const std::vector<uint32_t>& cpus) override
+    {
+        return _networkThread && concurrency::setCpuAffinity(*_networkThread, cpus);
+    }
+
 private:
     int _kernel_fd;
 #ifdef __APPLE__
@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include <memory>
+#include <vector>
 namespace transport
 {
 
@@ -28,6 +30,8 @@ public:
     virtual bool remove(int fd, IEventListener* listener) = 0;
 
     virtual bool isRunning() const = 0;
+
+    virtual bool setCpuAffinity(const std::vector<uint32_t>& cpus) = 0;
 };
 
 std::unique_ptr<RtcePoll> createRtcePoll();
@@ -1,13 +1,14 @@
 #include "transport/TransportFactory.h"
 #include "concurrency/MpmcHashmap.h"
 #include "config/Config.h"
+#include "logger/PacketLogger.h"
 #include "memory/PacketPoolAllocator.h"
 #include "transport/RecordingTransport.h"
 #include "transport/RtcTransport.h"
 #include "transport/TcpEndpoint.h"
 #include "transport/TcpServerEndpoint.h"
 #include "transport/UdpEndpointImpl.h"
-#include "utils/MersienneRandom.h"
+#include "utils/SsrcGenerator.h"
 
 namespace transport
 {
@@ -73,6 +74,12 @@ public:
 #else
         const size_t receiveBufferSize = 40 * 1024 * 1024;
 #endif
+        if (!config.bwe.packetLogLocation.get().empty())
+        {
+            _packetLogService = std::make_shared<logger::PacketLogService>(config.bwe.packetLogLocation,
+                config.bwe.packetLogFileSizeKb * size_t(1024));
+        }
+
         if (config.ice.singlePort != 0)
         {
             for (uint32_t portOffset = 0; portOffset < std::max(1u, config.ice.sharedPorts.get()); ++portOffset)
@@ -86,8 +93,20 @@ public:
                             ->createUdpEndpoint(jobManager, 1024, _mainAllocator, portAddress, _rtcePoll, true),
                         getDeleter());
 
+                    if (endPoint->isGood() && !endPoint->configureReceiveQueues(config.ice.receiveQueues))
+                    {
+                        logger::warn("failed to open %u receive queues on main media port %s",
+                            _name,
+                            config.ice.receiveQueues.get(),
+                            portAddress.toString().c_str());
+                    }
+
                     if (endPoint->isGood())
                     {
+                        if (config.ice.udpOffload && !endPoint->enableUdpOffload())
+                        {
+                            logger::info("UDP offload not supported on %s", _name, portAddress.toString().c_str());
+                        }
                         if (!endPoint->configureBufferSizes(2 * 1024 * 1024, receiveBufferSize))
                         {
                             logger::error("failed to set socket send buffer %d", _name, errno);
@@ -358,7 +377,8 @@ public:
                 16,
                 256,
                 false,
-                false);
+                false,
+                _packetLogService);
         }
 
         return nullptr;
@@ -389,7 +409,8 @@ public:
             expectedInboundStreamCount,
             expectedOutboundStreamCount,
             enableUplinkEstimation,
-            enableDownlinkEstimation);
+            enableDownlinkEstimation,
+            _packetLogService);
     }
 
     std::shared_ptr<RtcTransport> createOnSharedPort(const ice::IceRole iceRole,
@@ -413,7 +434,8 @@ public:
             16,
             256,
             true,
-            true);
+            true,
+            _packetLogService);
     }
 
     std::shared_ptr<RtcTransport> create(const size_t sendPoolSize, const size_t endpointId) override
@@ -431,7 +453,8 @@ public:
                 _rateControllerConfig,
                 rtpPorts,
                 rtcpPorts,
-                _mainAllocator);
+                _mainAllocator,
+                _packetLogService);
         }
 
         return nullptr;
@@ -596,13 +619,14 @@ private:
     std::atomic_uint32_t _sharedEndpointListIndex;
     ServerEndpoints _tcpServerEndpoints;
     memory::PacketPoolAllocator& _mainAllocator;
-    mutable utils::MersienneRandom<uint32_t> _randomGenerator;
+    mutable utils::SsrcGenerator _randomGenerator; // openPorts runs concurrently for different conferences
     std::atomic_uint32_t _pendingTasks;
 
     std::vector<std::vector<std::shared_ptr<RecordingEndpoint>>> _sharedRecordingEndpoints;
     std::atomic_uint32_t _sharedRecordingEndpointListIndex;
     bool _good;
     std::shared_ptr<transport::EndpointFactory> _endpointFactory;
+    std::shared_ptr<logger::PacketLogService> _packetLogService;
     static const char* _name;
     jobmanager::JobQueue _garbageQueue; // must be last
 };
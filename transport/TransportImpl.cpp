@@ -35,6 +35,8 @@
 namespace transport
 {
 constexpr uint32_t Mbps100 = 100000;
+// packets protected as one batch when draining the pacing queue
+constexpr size_t maxSendBurst = 32;
 // we have to serialize operations on srtp client
 // timers, start and receive must be done from same serialized jobmanager.
 class PacketReceiveJob : public jobmanager::Job
@@ -365,7 +367,8 @@ std::shared_ptr<RtcTransport> createTransport(jobmanager::JobManager& jobmanager
     size_t expectedInboundStreamCount,
     size_t expectedOutboundStreamCount,
     bool enableUplinkEstimation,
-    bool enableDownlinkEstimation)
+    bool enableDownlinkEstimation,
+    const std::shared_ptr<logger::PacketLogService>& packetLogService)
 {
     return std::make_shared<TransportImpl>(jobmanager,
         srtpClientFactory,
@@ -383,7 +386,8 @@ std::shared_ptr<RtcTransport> createTransport(jobmanager::JobManager& jobmanager
         expectedInboundStreamCount,
         expectedOutboundStreamCount,
         enableUplinkEstimation,
-        enableDownlinkEstimation);
+        enableDownlinkEstimation,
+        packetLogService);
 }
 
 std::shared_ptr<RtcTransport> createTransport(jobmanager::JobManager& jobmanager,
@@ -395,7 +399,8 @@ std::shared_ptr<RtcTransport> createTransport(jobmanager::JobManager& jobmanager
     const bwe::RateControllerConfig& rateControllerConfig,
     const Endpoints& rtpEndPoints,
     const Endpoints& rtcpEndPoints,
-    memory::PacketPoolAllocator& allocator)
+    memory::PacketPoolAllocator& allocator,
+    const std::shared_ptr<logger::PacketLogService>& packetLogService)
 {
     return std::make_shared<TransportImpl>(jobmanager,
         srtpClientFactory,
@@ -406,7 +411,8 @@ std::shared_ptr<RtcTransport> createTransport(jobmanager::JobManager& jobmanager
         rateControllerConfig,
         rtpEndPoints,
         rtcpEndPoints,
-        allocator);
+        allocator,
+        packetLogService);
 }
 
 TransportImpl::TransportImpl(jobmanager::JobManager& jobmanager,
@@ -418,7 +424,8 @@ TransportImpl::TransportImpl(jobmanager::JobManager& jobmanager,
     const bwe::RateControllerConfig& rateControllerConfig,
     const Endpoints& rtpEndPoints,
     const Endpoints& rtcpEndPoints,
-    memory::PacketPoolAllocator& allocator)
+    memory::PacketPoolAllocator& allocator,
+    const std::shared_ptr<logger::PacketLogService>& packetLogService)
     : _isInitialized(false),
       _loggableId("Transport"),
       _endpointIdHash(endpointIdHash),
@@ -449,6 +456,8 @@ TransportImpl::TransportImpl(jobmanager::JobManager& jobmanager,
       _rtxProbeSsrc(0),
       _rtxProbeSequenceCounter(nullptr),
       _pacingInUse(false),
+      _packetLogService(packetLogService),
+      _packetLogId(0),
       _iceState(ice::IceSession::State::IDLE),
       _dtlsState(SrtpClient::State::IDLE),
       _rtcpProducer(_loggableId, _config, _outboundSsrcCounters, _inboundSsrcCounters, _mainAllocator, *this),
@@ -521,7 +530,8 @@ TransportImpl::TransportImpl(jobmanager::JobManager& jobmanager,
     const size_t expectedInboundStreamCount,
     const size_t expectedOutboundStreamCount,
     const bool enableUplinkEstimation,
-    const bool enableDownlinkEstimation)
+    const bool enableDownlinkEstimation,
+    const std::shared_ptr<logger::PacketLogService>& packetLogService)
     : _isInitialized(false),
       _loggableId("Transport"),
       _endpointIdHash(endpointIdHash),
@@ -552,6 +562,8 @@ TransportImpl::TransportImpl(jobmanager::JobManager& jobmanager,
       _rtxProbeSsrc(0),
       _rtxProbeSequenceCounter(nullptr),
       _pacingInUse(false),
+      _packetLogService(packetLogService),
+      _packetLogId(0),
       _rtcpProducer(_loggableId, _config, _outboundSsrcCounters, _inboundSsrcCounters, _mainAllocator, *this),
       _uplinkEstimationEnabled(enableUplinkEstimation && _config.rctl.enable),
       _downlinkEstimationEnabled(enableDownlinkEstimation && _config.bwe.enable)
@@ -663,11 +675,9 @@ TransportImpl::TransportImpl(jobmanager::JobManager& jobmanager,
         _downlinkEstimationEnabled ? "on" : "off",
         _uplinkEstimationEnabled ? "on" : "off");
 
-    if (!_config.bwe.packetLogLocation.get().empty())
+    if (_packetLogService)
     {
-        const auto fileName = _config.bwe.packetLogLocation.get() + "/" + _loggableId.c_str();
-        auto logFile = ::fopen(fileName.c_str(), "wr");
-        _packetLogger.reset(new logger::PacketLoggerThread(logFile, 512));
+        _packetLogId = _packetLogService->openLog(_loggableId.c_str());
     }
 }
 // When ref counter has been assigned, the inbound data from sockets can be handled
@@ -696,6 +706,11 @@ TransportImpl::~TransportImpl()
             _jobCounter.load(),
             _jobQueue.getCount());
     }
+
+    if (_packetLogService)
+    {
+        _packetLogService->closeLog(_packetLogId);
+    }
 }
 
 void TransportImpl::stop()
@@ -822,9 +837,9 @@ void TransportImpl::internalRtpReceived(Endpoint& endpoint,
     bool rembReady = false;
     if (_absSendTimeExtensionId)
     {
-        if (_packetLogger)
+        if (_packetLogService)
         {
-            _packetLogger->post(*packet, timestamp);
+            _packetLogService->post(_packetLogId, *packet, timestamp);
         }
         uint32_t absSendTime = 0;
 
@@ -1419,14 +1434,35 @@ void TransportImpl::doProtectAndSend(uint64_t timestamp,
     const SocketAddress& target,
     Endpoint* endpoint)
 {
-    _outboundMetrics.bytesCount += packet->getLength();
-    ++_outboundMetrics.packetCount;
+    doProtectAndSend(timestamp, &packet, 1, target, endpoint);
+}
+
+// packets are protected as one batch before any of them is sent
+void TransportImpl::doProtectAndSend(uint64_t timestamp,
+    memory::UniquePacket* packets,
+    const size_t count,
+    const SocketAddress& target,
+    Endpoint* endpoint)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        _outboundMetrics.bytesCount += packets[i]->getLength();
+        ++_outboundMetrics.packetCount;
+        assert(packets[i]->getLength() + 24 <= _config.mtu);
+    }
+
+    if (!endpoint || _srtpClient->protect(packets, count) == 0)
+    {
+        return;
+    }
 
-    assert(packet->getLength() + 24 <= _config.mtu);
-    if (endpoint && _srtpClient->protect(*packet))
+    for (size_t i = 0; i < count; ++i)
     {
-        _sendRateTracker.update(packet->getLength(), timestamp);
-        endpoint->sendTo(target, std::move(packet));
+        if (packets[i])
+        {
+            _sendRateTracker.update(packets[i]->getLength(), timestamp);
+            endpoint->sendTo(target, std::move(packets[i]));
+        }
     }
 }
 
@@ -1577,14 +1613,21 @@ void TransportImpl::sendReports(uint64_t timestamp, bool rembReady)
 
 void TransportImpl::protectAndSendRtp(uint64_t timestamp, memory::UniquePacket packet)
 {
-    const auto* rtpHeader = rtp::RtpHeader::fromPacket(*packet);
+    prepareRtpForSend(timestamp, *packet);
+    doProtectAndSend(timestamp, std::move(packet), _peerRtpPort, _selectedRtp);
+}
+
+// send side bookkeeping and header extensions, done before the packet is protected
+void TransportImpl::prepareRtpForSend(uint64_t timestamp, memory::Packet& packet)
+{
+    const auto* rtpHeader = rtp::RtpHeader::fromPacket(packet);
     const auto payloadType = rtpHeader->payloadType;
     const auto isAudio = (payloadType <= 8 || payloadType == _audio.payloadType);
     const uint32_t rtpFrequency = isAudio ? _audio.rtpFrequency : 90000;
 
     if (_absSendTimeExtensionId)
     {
-        rtp::setTransmissionTimestamp(*packet, _absSendTimeExtensionId, timestamp);
+        rtp::setTransmissionTimestamp(packet, _absSendTimeExtensionId, timestamp);
     }
 
     auto& ssrcState = getOutboundSsrc(rtpHeader->ssrc, rtpFrequency);
@@ -1598,10 +1641,10 @@ void TransportImpl::protectAndSendRtp(uint64_t timestamp, memory::UniquePacket p
             ssrcState.getSentSequenceNumber() & 0xFFFFu);
     }
 
-    ssrcState.onRtpSent(timestamp, *packet);
+    ssrcState.onRtpSent(timestamp, packet);
     if (_uplinkEstimationEnabled)
     {
-        _rateController.onRtpSent(timestamp, rtpHeader->ssrc, rtpHeader->sequenceNumber, packet->getLength());
+        _rateController.onRtpSent(timestamp, rtpHeader->ssrc, rtpHeader->sequenceNumber, packet.getLength());
     }
 
 #if DEBUG_RTP
@@ -1613,8 +1656,6 @@ void TransportImpl::protectAndSendRtp(uint64_t timestamp, memory::UniquePacket p
             rtpHeader->sequenceNumber.get());
     }
 #endif
-
-    doProtectAndSend(timestamp, std::move(packet), _peerRtpPort, _selectedRtp);
 }
 
 void TransportImpl::sendRtcp(memory::UniquePacket rtcpPacket, const uint64_t timestamp)
@@ -2305,10 +2346,23 @@ memory::UniquePacket TransportImpl::tryFetchPriorityPacket(size_t budget)
 void TransportImpl::drainPacingBuffer(uint64_t timestamp, DrainPacingBufferMode mode)
 {
     auto budget = DrainPacingBufferMode::UseBudget == mode ? _rateController.getPacingBudget(timestamp) : SIZE_MAX;
+    memory::UniquePacket burst[maxSendBurst];
+    size_t count = 0;
     while (auto packet = tryFetchPriorityPacket(budget))
     {
         budget -= packet->getLength() + _config.ipOverhead;
-        protectAndSendRtp(timestamp, std::move(packet));
+        prepareRtpForSend(timestamp, *packet);
+        burst[count++] = std::move(packet);
+        if (count == maxSendBurst)
+        {
+            doProtectAndSend(timestamp, burst, count, _peerRtpPort, _selectedRtp);
+            count = 0;
+        }
+    }
+
+    if (count > 0)
+    {
+        doProtectAndSend(timestamp, burst, count, _peerRtpPort, _selectedRtp);
     }
 }
 
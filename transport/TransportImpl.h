@@ -26,7 +26,7 @@
 
 namespace logger
 {
-class PacketLoggerThread;
+class PacketLogService;
 }
 
 namespace bwe
@@ -71,7 +71,8 @@ public:
         size_t expectedInboundStreamCount,
         size_t expectedOutboundStreamCount,
         bool enableUplinkEstimation,
-        bool enableDownlinkEstimation);
+        bool enableDownlinkEstimation,
+        const std::shared_ptr<logger::PacketLogService>& packetLogService);
 
     TransportImpl(jobmanager::JobManager& jobmanager,
         SrtpClientFactory& srtpClientFactory,
@@ -82,7 +83,8 @@ public:
         const bwe::RateControllerConfig& rateControllerConfig,
         const Endpoints& rtpEndPoints,
         const Endpoints& rtcpEndPoints,
-        memory::PacketPoolAllocator& allocator);
+        memory::PacketPoolAllocator& allocator,
+        const std::shared_ptr<logger::PacketLogService>& packetLogService);
 
     ~TransportImpl() override;
 
@@ -295,10 +297,16 @@ private:
     };
 
     void protectAndSendRtp(uint64_t timestamp, memory::UniquePacket packet);
+    void prepareRtpForSend(uint64_t timestamp, memory::Packet& packet);
     void doProtectAndSend(uint64_t timestamp,
         memory::UniquePacket packet,
         const SocketAddress& target,
         Endpoint* endpoint);
+    void doProtectAndSend(uint64_t timestamp,
+        memory::UniquePacket* packets,
+        size_t count,
+        const SocketAddress& target,
+        Endpoint* endpoint);
     void sendPadding(uint64_t timestamp);
 
     void processRtcpReport(const rtp::RtcpHeader& packet,
@@ -433,7 +441,8 @@ private:
     PacingQueue _rtxPacingQueue;
     std::atomic_bool _pacingInUse;
 
-    std::unique_ptr<logger::PacketLoggerThread> _packetLogger;
+    std::shared_ptr<logger::PacketLogService> _packetLogService;
+    uint32_t _packetLogId;
     std::atomic<ice::IceSession::State> _iceState;
     std::atomic<SrtpClient::State> _dtlsState;
     std::atomic<utils::Optional<ice::TransportType>> _transportType;
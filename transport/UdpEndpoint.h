@@ -13,6 +13,10 @@ public:
     // auxilary
     virtual bool openPort(uint16_t port) = 0;
     virtual bool isGood() const = 0;
+    // Opens count receive queues on the bound port. Must be called before start.
+    virtual bool configureReceiveQueues(uint32_t count) = 0;
+    // Enables UDP GSO and GRO where supported. Returns false if neither is available.
+    virtual bool enableUdpOffload() = 0;
     virtual EndpointMetrics getMetrics(uint64_t timestamp) const = 0;
 };
 } // namespace transport
\ No newline at end of file
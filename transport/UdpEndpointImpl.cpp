@@ -30,20 +30,22 @@ private:
     Endpoint::IEvents* _listener;
 };
 
-class UnRegisterNotifyListenerJob : public jobmanager::Job
+class RegisterListenerJob : public jobmanager::Job
 {
 public:
-    UnRegisterNotifyListenerJob(UdpEndpointImpl& endpoint, Endpoint::IEvents& listener)
+    RegisterListenerJob(UdpEndpointImpl& endpoint, const SocketAddress& remotePort, Endpoint::IEvents* listener)
         : _endpoint(endpoint),
+          _remotePort(remotePort),
           _listener(listener)
     {
     }
 
-    void run() override { _listener.onUnregistered(_endpoint); }
+    void run() override { _endpoint.internalRegisterListener(_remotePort, _listener); }
 
 private:
     UdpEndpointImpl& _endpoint;
-    Endpoint::IEvents& _listener;
+    SocketAddress _remotePort;
+    Endpoint::IEvents* _listener;
 };
 
 } // namespace
@@ -128,7 +130,7 @@ void UdpEndpointImpl::internalUnregisterListener(IEvents* listener)
         if (item.second == listener)
         {
             _iceListeners.erase(item.first);
-            _receiveJobs.addJob<UnRegisterNotifyListenerJob>(*this, *listener);
+            notifyUnregistered(*listener);
         }
     }
 
@@ -146,7 +148,7 @@ void UdpEndpointImpl::internalUnregisterListener(IEvents* listener)
         if (item.second == listener)
         {
             _dtlsListeners.erase(item.first);
-            _receiveJobs.addJob<UnRegisterNotifyListenerJob>(*this, *listener);
+            notifyUnregistered(*listener);
         }
     }
 }
@@ -262,9 +264,37 @@ void UdpEndpointImpl::registerListener(const std::string& stunUserName, IEvents*
     listener->onRegistered(*this);
 }
 
-/** If using ICE, must be called from receive job queue to sync unregister */
+/**
+ * If using ICE, must be called from a receive job queue to sync with unregister. With several receive queues the
+ * registration is posted to _receiveJobs, where listeners are also unregistered.
+ */
 void UdpEndpointImpl::registerListener(const SocketAddress& srcAddress, IEvents* listener)
 {
+    if (_receiveQueues.empty())
+    {
+        internalRegisterListener(srcAddress, listener);
+        return;
+    }
+
+    auto dtlsIt = _dtlsListeners.find(srcAddress);
+    if (dtlsIt != _dtlsListeners.end() && dtlsIt->second == listener)
+    {
+        return;
+    }
+
+    if (!_receiveJobs.addJob<RegisterListenerJob>(*this, srcAddress, listener))
+    {
+        logger::warn("failed to post register job", _name.c_str());
+    }
+}
+
+void UdpEndpointImpl::internalRegisterListener(const SocketAddress& srcAddress, IEvents* listener)
+{
+    if (isUnregistering(listener))
+    {
+        return; // posted by a receive queue before the listener was removed
+    }
+
     auto dtlsIt = _dtlsListeners.find(srcAddress);
     if (dtlsIt != _dtlsListeners.end())
     {
@@ -276,7 +306,7 @@ void UdpEndpointImpl::registerListener(const SocketAddress& srcAddress, IEvents*
 
         if (dtlsIt->second)
         {
-            _receiveJobs.addJob<UnRegisterNotifyListenerJob>(*this, *dtlsIt->second);
+            notifyUnregistered(*dtlsIt->second);
         }
         dtlsIt->second = listener;
         listener->onRegistered(*this);
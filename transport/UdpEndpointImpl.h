@@ -42,6 +42,7 @@ public:
 public: // internal job interface
     void dispatchReceivedPacket(const SocketAddress& srcAddress, memory::UniquePacket packet) override;
 
+    void internalRegisterListener(const SocketAddress& remotePort, IEvents* listener);
     void internalUnregisterListener(IEvents* listener);
     void internalUnregisterStunListener(__uint128_t transactionId);
 
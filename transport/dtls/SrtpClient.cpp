@@ -339,10 +339,48 @@ bool SrtpClient::protect(memory::Packet& packet)
         return false;
     }
 
-    // srtp_protect assumes data is word aligned
-    assert(reinterpret_cast<uintptr_t>(packet.get()) % 4 == 0);
+    DBGCHECK_SINGLETHREADED(_mutexGuard);
+    return protectPacket(packet);
+}
+
+size_t SrtpClient::protect(memory::UniquePacket* packets, const size_t count)
+{
+    assert(_isInitialized);
+
+    if (_nullCipher)
+    {
+        return count;
+    }
+
+    if (!_localSrtp || !_remoteSrtp || _state != State::CONNECTED)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            packets[i].reset();
+        }
+        return 0;
+    }
 
     DBGCHECK_SINGLETHREADED(_mutexGuard);
+    size_t protectedCount = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (packets[i] && protectPacket(*packets[i]))
+        {
+            ++protectedCount;
+        }
+        else
+        {
+            packets[i].reset();
+        }
+    }
+    return protectedCount;
+}
+
+bool SrtpClient::protectPacket(memory::Packet& packet)
+{
+    // srtp_protect assumes data is word aligned
+    assert(reinterpret_cast<uintptr_t>(packet.get()) % 4 == 0);
 
     auto bufferLength = utils::checkedCast<int32_t>(packet.getLength());
     assert(bufferLength > 0);
@@ -49,6 +49,10 @@ public:
 
     bool unprotect(memory::Packet& packet);
     bool protect(memory::Packet& packet);
+
+    // Batch version for packets of this session. Session state is checked once for the whole batch. Packets that
+    // fail are released and left as nullptr. Returns number of packets that succeeded.
+    size_t protect(memory::UniquePacket* packets, size_t count);
     void removeLocalSsrc(const uint32_t ssrc);
     bool setRemoteRolloverCounter(const uint32_t ssrc, const uint32_t rolloverCounter);
     bool setLocalRolloverCounter(const uint32_t ssrc, const uint32_t rolloverCounter);
@@ -67,6 +71,7 @@ public:
     void sendApplicationData(const void* data, size_t length);
 
 private:
+    bool protectPacket(memory::Packet& packet);
     void dtlsHandShake();
     void logSslError(const char* msg, int sslCode);
     bool _isInitialized;
@@ -32,7 +32,7 @@ IceSession::IceSession(size_t sessionId,
 
     generateCredentialString(_idGenerator, ufrag, sizeof(ufrag) - 1);
     generateCredentialString(_idGenerator, pwd, sizeof(pwd) - 1);
-    _credentials.local = std::make_pair<std::string, std::string>(ufrag, pwd);
+    _credentials.setLocal(std::make_pair<std::string, std::string>(ufrag, pwd));
 }
 
 // add most preferred UDP end point first. It will affect prioritization of candidates
@@ -366,7 +366,7 @@ bool IceSession::isRequestAuthentic(const void* data, size_t len) const
     const auto* stunMessage = StunMessage::fromPtr(data);
 
     if (stunMessage && stunMessage->isValid() && stunMessage->header.isRequest() &&
-        stunMessage->isAuthentic(_credentials.local.second))
+        stunMessage->isAuthentic(*_credentials.getLocalHmac()))
     {
         const auto* attribute = stunMessage->getAttribute<StunUserName>(StunAttribute::USERNAME);
         return attribute && attribute->isTargetUser(_credentials.local.first.c_str());
@@ -379,7 +379,7 @@ bool IceSession::isResponseAuthentic(const void* data, size_t len) const
 {
     const auto* stunMessage = StunMessage::fromPtr(data);
     return stunMessage && stunMessage->isValid() && stunMessage->header.isResponse() &&
-        stunMessage->isAuthentic(_credentials.remote.second);
+        stunMessage->isAuthentic(*_credentials.getRemoteHmac());
 }
 
 void IceSession::onRequestReceived(IceEndpoint* endpoint,
@@ -405,7 +405,7 @@ void IceSession::onRequestReceived(IceEndpoint* endpoint,
             "Unknown user " + userNames.first + ":" + userNames.second);
         return;
     }
-    if (!msg.isAuthentic(_credentials.local.second))
+    if (!msg.isAuthentic(*_credentials.getLocalHmac()))
     {
         sendResponse(endpoint, sender, StunError::Code::Unauthorized, msg, now, "Unauthorized");
         return;
@@ -533,7 +533,7 @@ void IceSession::onResponseReceived(IceEndpoint* endpoint,
 
     if (_state != State::GATHERING)
     {
-        if (!msg.isAuthentic(_credentials.remote.second))
+        if (!msg.isAuthentic(*_credentials.getRemoteHmac()))
         {
             return;
         }
@@ -692,7 +692,7 @@ void IceSession::sendResponse(IceEndpoint* endpoint,
             StunGenericAttribute(StunAttribute::USERNAME, _credentials.local.first + ":" + _credentials.remote.first));
     }
 
-    response.addMessageIntegrity(_credentials.local.second);
+    response.addMessageIntegrity(*_credentials.getLocalHmac());
     response.addFingerprint();
     endpoint->sendStunTo(target, response.header.transactionId.get(), &response, response.size(), timestamp);
 }
@@ -980,17 +980,41 @@ const std::pair<std::string, std::string>& IceSession::getLocalCredentials() con
 // only used if you need same credentials for multiple sessions
 void IceSession::setLocalCredentials(const std::pair<std::string, std::string>& credentials)
 {
-    _credentials.local = credentials;
+    _credentials.setLocal(credentials);
 }
 
 void IceSession::setRemoteCredentials(const std::string& ufrag, const std::string& pwd)
 {
-    _credentials.remote = std::make_pair(ufrag, pwd);
+    _credentials.setRemote(std::make_pair(ufrag, pwd));
 }
 
 void IceSession::setRemoteCredentials(const std::pair<std::string, std::string>& credentials)
 {
-    _credentials.remote = credentials;
+    _credentials.setRemote(credentials);
+}
+
+IceSession::SessionCredentials::SessionCredentials(ice::IceRole role_, uint64_t tieBreaker_)
+    : role(role_),
+      tieBreaker(tieBreaker_)
+{
+    setLocal(local);
+    setRemote(remote);
+}
+
+void IceSession::SessionCredentials::setLocal(const std::pair<std::string, std::string>& credentials)
+{
+    local = credentials;
+    std::shared_ptr<const crypto::HMAC> keyedHmac =
+        std::make_shared<crypto::HMAC>(local.second.c_str(), local.second.size());
+    std::atomic_store(&localHmac, keyedHmac);
+}
+
+void IceSession::SessionCredentials::setRemote(const std::pair<std::string, std::string>& credentials)
+{
+    remote = credentials;
+    std::shared_ptr<const crypto::HMAC> keyedHmac =
+        std::make_shared<crypto::HMAC>(remote.second.c_str(), remote.second.size());
+    std::atomic_store(&remoteHmac, keyedHmac);
 };
 
 // targetBuffer must be length + 1 for null termination
@@ -1144,7 +1168,7 @@ void IceSession::CandidatePair::send(const uint64_t now)
 
     if (!gatheringProbe)
     {
-        stunMessage.addMessageIntegrity(_credentials.remote.second);
+        stunMessage.addMessageIntegrity(*_credentials.getRemoteHmac());
         stunMessage.addFingerprint();
     }
 
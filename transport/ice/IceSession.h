@@ -2,6 +2,7 @@
 #include "IceCandidate.h"
 #include "Stun.h"
 #include "concurrency/ScopedMutexGuard.h"
+#include "crypto/SslHelper.h"
 #include "utils/SocketAddress.h"
 #include <deque>
 namespace ice
@@ -166,10 +167,21 @@ public:
 private:
     struct SessionCredentials
     {
-        SessionCredentials(ice::IceRole role_, uint64_t tieBreaker_) : role(role_), tieBreaker(tieBreaker_) {}
+        SessionCredentials(ice::IceRole role_, uint64_t tieBreaker_);
+
+        void setLocal(const std::pair<std::string, std::string>& credentials);
+        void setRemote(const std::pair<std::string, std::string>& credentials);
+
+        // the receive thread authenticates while credentials may be set on the transport thread
+        std::shared_ptr<const crypto::HMAC> getLocalHmac() const { return std::atomic_load(&localHmac); }
+        std::shared_ptr<const crypto::HMAC> getRemoteHmac() const { return std::atomic_load(&remoteHmac); }
 
         std::pair<std::string, std::string> local;
         std::pair<std::string, std::string> remote;
+        // keyed with the pwd and cloned for every STUN message, to avoid repeating the key schedule. Replaced with
+        // atomic_store and read with atomic_load.
+        std::shared_ptr<const crypto::HMAC> localHmac;
+        std::shared_ptr<const crypto::HMAC> remoteHmac;
         IceRole role;
         const uint64_t tieBreaker;
     };
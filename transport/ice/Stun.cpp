@@ -236,7 +236,15 @@ uint32_t StunMessage::computeFingerprint() const
 // pwd is a=ice-pwd: from SDP
 void StunMessage::computeHMAC(const std::string& pwd, uint8_t* hmac20b) const
 {
-    crypto::HMAC hmac(pwd.c_str(), pwd.size());
+    const crypto::HMAC keyedHmac(pwd.c_str(), pwd.size());
+    computeHMAC(keyedHmac, hmac20b);
+}
+
+// keyedHmac is an HMAC that has been keyed with the ice-pwd but not fed any data. It is cloned so it can be reused and
+// shared between threads.
+void StunMessage::computeHMAC(const crypto::HMAC& keyedHmac, uint8_t* hmac20b) const
+{
+    crypto::HMAC hmac(keyedHmac);
     const auto start = reinterpret_cast<const uint8_t*>(this);
 
     // if there is no message-integrity attribute yet, we assume that is going to be the next one added
@@ -260,10 +268,16 @@ void StunMessage::computeHMAC(const std::string& pwd, uint8_t* hmac20b) const
 }
 
 void StunMessage::addMessageIntegrity(const std::string& pwd)
+{
+    const crypto::HMAC keyedHmac(pwd.c_str(), pwd.size());
+    addMessageIntegrity(keyedHmac);
+}
+
+void StunMessage::addMessageIntegrity(const crypto::HMAC& keyedHmac)
 {
     StunMessageIntegrity attribute;
     uint8_t hmac[20];
-    computeHMAC(pwd, hmac);
+    computeHMAC(keyedHmac, hmac);
     attribute.setHmac(hmac);
     add(attribute);
 }
@@ -322,6 +336,12 @@ bool StunMessage::isValid() const
 }
 
 bool StunMessage::isAuthentic(const std::string& pwd) const
+{
+    const crypto::HMAC keyedHmac(pwd.c_str(), pwd.size());
+    return isAuthentic(keyedHmac);
+}
+
+bool StunMessage::isAuthentic(const crypto::HMAC& keyedHmac) const
 {
     for (auto& attribute : *this)
     {
@@ -332,7 +352,7 @@ bool StunMessage::isAuthentic(const std::string& pwd) const
                 return false;
             }
             uint8_t hmac[20];
-            computeHMAC(pwd, hmac);
+            computeHMAC(keyedHmac, hmac);
             return reinterpret_cast<const StunMessageIntegrity&>(attribute).isMatch(hmac);
         }
     }
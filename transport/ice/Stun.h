@@ -7,6 +7,11 @@
 #include <random>
 #include <type_traits>
 
+namespace crypto
+{
+class HMAC;
+}
+
 namespace ice
 {
 const size_t MTU = 1280; // rfc states 576B for ipv4 and 1280 for ipv6
@@ -302,7 +307,9 @@ public:
 
     uint32_t computeFingerprint() const;
     void computeHMAC(const std::string& pwd, uint8_t* hash20b) const;
+    void computeHMAC(const crypto::HMAC& keyedHmac, uint8_t* hash20b) const;
     void addMessageIntegrity(const std::string& pwd);
+    void addMessageIntegrity(const crypto::HMAC& keyedHmac);
     void addFingerprint();
     static const StunMessage* fromPtr(const void* ptr);
     size_t size() const { return header.length + sizeof(header); }
@@ -322,6 +329,7 @@ public:
 
     bool isValid() const;
     bool isAuthentic(const std::string& pwd) const;
+    bool isAuthentic(const crypto::HMAC& keyedHmac) const;
 
     StunMessage& operator=(const StunMessage& b);
 
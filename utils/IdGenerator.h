@@ -2,12 +2,24 @@
 
 #include "MersienneRandom.h"
 #include <cstdint>
+#include <mutex>
 #include <random>
 namespace utils
 {
 
-class IdGenerator : public utils::MersienneRandom<uint64_t>
+// Shared by all mixers. Thread safe as API requests for different conferences run concurrently.
+class IdGenerator
 {
+public:
+    uint64_t next()
+    {
+        std::lock_guard<std::mutex> locker(_lock);
+        return _random.next();
+    }
+
+private:
+    std::mutex _lock;
+    MersienneRandom<uint64_t> _random;
 };
 
 } // namespace utils
@@ -1,13 +1,25 @@
 #pragma once
 
 #include <cstdint>
+#include <mutex>
 #include <random>
 #include "MersienneRandom.h"
 namespace utils
 {
 
-class SsrcGenerator : public MersienneRandom<uint32_t>
+// Shared by all mixers. Thread safe as API requests for different conferences run concurrently.
+class SsrcGenerator
 {
+public:
+    uint32_t next()
+    {
+        std::lock_guard<std::mutex> locker(_lock);
+        return _random.next();
+    }
+
+private:
+    std::mutex _lock;
+    MersienneRandom<uint32_t> _random;
 };
 
 } // namespace utils
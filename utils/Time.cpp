@@ -25,6 +25,7 @@ namespace Time
 {
 // global time source
 utils::TimeSource* _timeSource = nullptr;
+double _nsPerCycle = 1.0;
 
 class TimeSourceImpl final : public utils::TimeSource
 {
@@ -69,6 +70,18 @@ void formatTime(const TimeSource& timeSource, char out[32])
         currentLocalTime.tm_sec);
 }
 
+void calibrateCycleCounter()
+{
+#if defined(__x86_64__)
+    const auto startTime = rawAbsoluteTime();
+    const auto startCycles = getCycleCount();
+    rawNanoSleep(2 * ms);
+    const auto cycles = getCycleCount() - startCycles;
+    const auto elapsed = rawAbsoluteTime() - startTime;
+    _nsPerCycle = cycles > 0 ? static_cast<double>(elapsed) / cycles : 1.0;
+#endif
+}
+
 void initialize(TimeSource& timeSource)
 {
     char oldLocalTime[32];
@@ -104,6 +117,7 @@ void initialize(TimeSource& timeSource)
 #ifdef __APPLE__
         mach_timebase_info(&machTimeBase);
 #endif
+        calibrateCycleCounter();
     }
 
     _timeSource = &timeSource;
@@ -181,6 +195,11 @@ uint64_t rawAbsoluteTime()
 #endif
 }
 
+uint64_t cyclesToNs(const uint64_t cycles)
+{
+    return static_cast<uint64_t>(cycles * _nsPerCycle);
+}
+
 uint64_t toNtp(const std::chrono::system_clock::time_point timestamp)
 {
     uint64_t ntp = 0;
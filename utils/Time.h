@@ -46,6 +46,20 @@ std::chrono::system_clock::time_point now();
 void rawNanoSleep(int64_t ns);
 uint64_t rawAbsoluteTime();
 
+/**
+ * Cpu cycle counter for cheap profiling of short intervals. Not affected by the time source. Intervals are
+ * converted with cyclesToNs, which is calibrated against the monotonic clock in initialize.
+ */
+inline uint64_t getCycleCount()
+{
+#if defined(__x86_64__)
+    return __builtin_ia32_rdtsc();
+#else
+    return rawAbsoluteTime();
+#endif
+}
+uint64_t cyclesToNs(uint64_t cycles);
+
 uint64_t toNtp(std::chrono::system_clock::time_point timestamp);
 inline uint32_t toNtp32(const std::chrono::system_clock::time_point timestamp)
 {